@@ -385,7 +385,7 @@ namespace ams::ldr::oc::pcv
         if (C.marikoGpuUV == 3 || C.eristaGpuUV == 3)
         {
             cvb_entry_t *entry = static_cast<cvb_entry_t *>(gpu_cvb_table_head);
-            for (size_t i = 0; i < customize_entry_count; i++)
+            for (size_t i = 0; i < customize_entry_count; i++, entry++)
             {
                 if (isMariko)
                 {
@@ -408,7 +408,6 @@ namespace ams::ldr::oc::pcv
                 PATCH_OFFSET(&(entry->cvb_pll_param.c3), 0);
                 PATCH_OFFSET(&(entry->cvb_pll_param.c4), 0);
                 PATCH_OFFSET(&(entry->cvb_pll_param.c5), 0);
-                entry++;
             }
         }
         else if (C.commonGpuVoltOffset)
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * CVB table evaluator
+ *
+ * Evaluates the DVFS tables built into customize.cpp the way pcv does on the
+ * console: speedo polynomial (scale 100) plus the thermal term (scale 10) for
+ * GPU entries, the loader's own patches (CPU max volt, GPU volt offset, UV3
+ * volt array), rounding up to the rail step and clamping to vmin/vmax.
+ *
+ * Next to the V/F curve it prints a dynamic power estimate P ~ f * V^2
+ * (leakage ignored) relative to the top entry, perf/W relative to the best
+ * entry and the marginal cost dP%/df% of each step. Entries on the
+ * efficiency frontier (no faster entry runs at the same or lower voltage)
+ * are marked '*', steps costing more than -k times their perf gain '!'.
+ *
+ *   make && ./cvb_eval [-c cpu speedo] [-g gpu speedo] [-t temp,...] [-k ratio] [-r step mV] [table]...
+ */
+
+#ifndef ATMOSPHERE_IS_STRATOSPHERE
+
+#include <getopt.h>
+#include <vector>
+
+#include "../pcv/pcv.hpp"
+
+namespace ams::ldr::oc::tools {
+
+    using pcv::cvb_entry_t;
+    using pcv::cvb_coefficients;
+
+    enum class Rail { CpuMariko, CpuErista, GpuMariko, GpuErista };
+
+    struct Table {
+        const char* name;
+        Rail rail;
+        const volatile cvb_entry_t* entries;
+        bool custom;    // built from the UV3 volt array instead of cvb coefficients
+    };
+
+    struct Options {
+        int cpuSpeedo = 1650;
+        int gpuSpeedo = 1600;
+        std::vector<int> temps = { 20, 50, 80 };
+        double costRatio = 3.0;
+        int stepMv = 5;
+    };
+
+    struct Point {
+        u32 khz;
+        std::vector<int> mv;    // per temperature
+        bool capped;            // needed more than vmax
+    };
+
+    // DIV_ROUND_CLOSEST
+    int64_t RoundClosest(int64_t value, int64_t scale) {
+        return value > 0 ? (value + scale / 2) / scale : (value - scale / 2) / scale;
+    }
+
+    // Speedo part, in uV
+    int64_t CvbVoltage(const cvb_coefficients& c, int speedo) {
+        int64_t uv = RoundClosest((int64_t)c.c2 * speedo, 100);
+        return RoundClosest((uv + c.c1) * speedo, 100) + c.c0;
+    }
+
+    // Temperature part, in uV
+    int64_t CvbThermalVoltage(const cvb_coefficients& c, int speedo, int temp) {
+        int64_t uv = RoundClosest((int64_t)c.c3 * speedo, 100) + c.c4 + RoundClosest((int64_t)c.c5 * temp, 10);
+        return RoundClosest(uv * temp, 10);
+    }
+
+    bool IsCpu(Rail rail) {
+        return rail == Rail::CpuMariko || rail == Rail::CpuErista;
+    }
+
+    bool IsMariko(Rail rail) {
+        return rail == Rail::CpuMariko || rail == Rail::GpuMariko;
+    }
+
+    int Vmin(Rail rail, bool slt) {
+        switch (rail) {
+            case Rail::CpuMariko: return slt && C.marikoCpuLowVmin ? C.marikoCpuLowVmin : pcv::mariko::CpuMinVolts[2];
+            case Rail::CpuErista: return pcv::erista::CpuMinVolts[2];
+            case Rail::GpuMariko: return C.marikoGpuVmin ? C.marikoGpuVmin : pcv::mariko::gpuVmin;
+            case Rail::GpuErista: return C.eristaGpuVmin ? C.eristaGpuVmin : pcv::erista::gpuVmin;
+        }
+        return 0;
+    }
+
+    int Vmax(Rail rail) {
+        switch (rail) {
+            case Rail::CpuMariko: return C.marikoCpuMaxVolt ? C.marikoCpuMaxVolt : pcv::mariko::CpuVoltOfficial;
+            case Rail::CpuErista: return C.eristaCpuMaxVolt ? C.eristaCpuMaxVolt : pcv::erista::CpuVoltOfficial;
+            case Rail::GpuMariko: return C.marikoGpuVmax ? C.marikoGpuVmax : pcv::mariko::gpuVmax;
+            case Rail::GpuErista: return 0;
+        }
+        return 0;
+    }
+
+    // Mirrors the entry patches of pcv::CpuFreqCvbTable / GpuFreqCvbTable
+    cvb_entry_t PatchEntry(const Table& table, size_t index) {
+        cvb_entry_t entry;
+        std::memcpy(&entry, const_cast<const cvb_entry_t*>(&table.entries[index]), sizeof(entry));
+
+        if (table.rail == Rail::CpuMariko || table.rail == Rail::CpuErista) {
+            bool mariko = table.rail == Rail::CpuMariko;
+            u32 maxVolt = mariko ? C.marikoCpuMaxVolt : C.eristaCpuMaxVolt;
+            u32 threshold = mariko ? (C.marikoCpuUV ? 2193'000 : 2091'000)
+                                   : (maxVolt >= 1300 ? 1887'000 : 1428'000);
+            if (maxVolt && entry.freq >= threshold) {
+                if (mariko) {
+                    entry.cvb_pll_param.c0 = maxVolt * 1000;
+                } else {
+                    entry.cvb_dfll_param.c0 = maxVolt * 1000;
+                }
+            }
+            return entry;
+        }
+
+        if (table.custom) {
+            const volatile u32* volts = IsMariko(table.rail) ? C.marikoGpuVoltArray : C.eristaGpuVoltArray;
+            if (volts[index]) {
+                entry.cvb_pll_param = {};
+                entry.cvb_pll_param.c0 = volts[index] * 1000;
+            }
+        } else if (C.commonGpuVoltOffset) {
+            entry.cvb_pll_param.c0 -= C.commonGpuVoltOffset * 1000;
+        }
+        return entry;
+    }
+
+    int RoundToStep(int64_t uv, int stepMv) {
+        int64_t step = (int64_t)stepMv * 1000;
+        return (int)(((uv + step - 1) / step) * step / 1000);
+    }
+
+    std::vector<Point> Evaluate(const Table& table, const Options& opt, bool slt) {
+        std::vector<Point> points;
+        size_t count = pcv::GetDvfsTableEntryCount(table.entries);
+        int vmin = Vmin(table.rail, slt), vmax = Vmax(table.rail);
+        bool cpu = IsCpu(table.rail);
+
+        for (size_t i = 0; i < count; i++) {
+            cvb_entry_t entry = PatchEntry(table, i);
+            Point point = { (u32)entry.freq, {}, false };
+
+            for (int temp : opt.temps) {
+                int64_t uv;
+                if (cpu) {
+                    // DFLL mode; on Mariko the pll c0 holds the ceiling
+                    uv = CvbVoltage(entry.cvb_dfll_param, opt.cpuSpeedo);
+                    if (table.rail == Rail::CpuMariko && entry.cvb_pll_param.c0 && uv > entry.cvb_pll_param.c0) {
+                        uv = entry.cvb_pll_param.c0;
+                    }
+                } else {
+                    uv = CvbVoltage(entry.cvb_pll_param, opt.gpuSpeedo) +
+                         CvbThermalVoltage(entry.cvb_pll_param, opt.gpuSpeedo, temp);
+                }
+
+                int mv = std::max(RoundToStep(uv, opt.stepMv), vmin);
+                if (vmax && mv > vmax) {
+                    mv = vmax;
+                    point.capped = true;
+                }
+                point.mv.push_back(mv);
+
+                // CPU tables have no thermal coefficients
+                if (cpu) {
+                    break;
+                }
+            }
+            points.push_back(point);
+        }
+        return points;
+    }
+
+    void Print(const Table& table, const Options& opt) {
+        bool cpu = IsCpu(table.rail);
+        bool slt = table.rail == Rail::CpuMariko && std::strstr(table.name, "SLT");
+        std::vector<Point> points = Evaluate(table, opt, slt);
+        if (points.empty()) {
+            return;
+        }
+
+        printf("\n== %s (%s %s, speedo %d, vmin %d mV", table.name, IsMariko(table.rail) ? "Mariko" : "Erista",
+               cpu ? "CPU" : "GPU", cpu ? opt.cpuSpeedo : opt.gpuSpeedo, Vmin(table.rail, slt));
+        if (Vmax(table.rail)) {
+            printf(", vmax %d mV", Vmax(table.rail));
+        }
+        printf(") ==\n     MHz |");
+        if (cpu) {
+            printf("    mV");
+        } else {
+            for (int temp : opt.temps) {
+                printf("  %3dC", temp);
+            }
+        }
+        printf(" |  rel P  perf/W  dP/df\n");
+
+        // Worst case voltage drives the power estimate
+        std::vector<double> power;
+        double maxPower = 0., bestEfficiency = 0.;
+        for (const auto& point : points) {
+            int mv = *std::max_element(point.mv.begin(), point.mv.end());
+            power.push_back(point.khz * (double)mv * mv);
+            maxPower = std::max(maxPower, power.back());
+            bestEfficiency = std::max(bestEfficiency, point.khz / power.back());
+        }
+
+        for (size_t i = 0; i < points.size(); i++) {
+            const Point& point = points[i];
+            int mv = *std::max_element(point.mv.begin(), point.mv.end());
+
+            bool frontier = true;
+            for (size_t j = i + 1; j < points.size(); j++) {
+                if (*std::max_element(points[j].mv.begin(), points[j].mv.end()) <= mv) {
+                    frontier = false;
+                    break;
+                }
+            }
+
+            double cost = 0.;
+            if (i > 0 && point.khz > points[i - 1].khz) {
+                double df = (double)point.khz / points[i - 1].khz - 1.;
+                double dp = power[i] / power[i - 1] - 1.;
+                cost = dp / df;
+            }
+
+            printf("  %6.1f |", point.khz / 1000.);
+            for (int v : point.mv) {
+                printf("  %4d", v);
+            }
+            printf(" |  %5.3f   %5.3f  %5.2f %s%s%s\n", power[i] / maxPower,
+                   (point.khz / power[i]) / bestEfficiency, cost,
+                   frontier ? "*" : " ", cost > opt.costRatio ? "!" : " ", point.capped ? " cap" : "");
+        }
+    }
+
+    std::vector<Table> AllTables() {
+        return {
+            { "eristaCpuDvfsTable",      Rail::CpuErista, C.eristaCpuDvfsTable,      false },
+            { "marikoCpuDvfsTable",      Rail::CpuMariko, C.marikoCpuDvfsTable,      false },
+            { "marikoCpuDvfsTableSLT",   Rail::CpuMariko, C.marikoCpuDvfsTableSLT,   false },
+            { "eristaGpuDvfsTable",      Rail::GpuErista, C.eristaGpuDvfsTable,      false },
+            { "eristaGpuDvfsTableSLT",   Rail::GpuErista, C.eristaGpuDvfsTableSLT,   false },
+            { "eristaGpuDvfsTableHigh",  Rail::GpuErista, C.eristaGpuDvfsTableHigh,  false },
+            { "eristaGpuVoltArray",      Rail::GpuErista, C.eristaGpuDvfsTableHigh,  true  },
+            { "marikoGpuDvfsTable",      Rail::GpuMariko, C.marikoGpuDvfsTable,      false },
+            { "marikoGpuDvfsTableSLT",   Rail::GpuMariko, C.marikoGpuDvfsTableSLT,   false },
+            { "marikoGpuDvfsTableHiOPT", Rail::GpuMariko, C.marikoGpuDvfsTableHiOPT, false },
+            { "marikoGpuVoltArray",      Rail::GpuMariko, C.marikoGpuDvfsTableHiOPT, true  },
+        };
+    }
+
+}
+
+int main(int argc, char** argv) {
+    using namespace ams::ldr::oc::tools;
+
+    Options opt;
+    int c;
+    while ((c = getopt(argc, argv, "c:g:t:k:r:")) != -1) {
+        switch (c) {
+            case 'c': opt.cpuSpeedo = atoi(optarg); break;
+            case 'g': opt.gpuSpeedo = atoi(optarg); break;
+            case 'k': opt.costRatio = atof(optarg); break;
+            case 'r': opt.stepMv = std::max(1, atoi(optarg)); break;
+            case 't':
+                opt.temps.clear();
+                for (char* tok = strtok(optarg, ","); tok; tok = strtok(nullptr, ",")) {
+                    opt.temps.push_back(atoi(tok));
+                }
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-c cpu speedo] [-g gpu speedo] [-t temp,...] [-k ratio] [-r step mV] [table]...\n", argv[0]);
+                return 2;
+        }
+    }
+    if (opt.temps.empty()) {
+        opt.temps.push_back(50);
+    }
+
+    int printed = 0;
+    for (const auto& table : AllTables()) {
+        bool wanted = optind == argc;
+        for (int i = optind; i < argc; i++) {
+            wanted |= std::strcmp(argv[i], table.name) == 0;
+        }
+        if (wanted) {
+            Print(table, opt);
+            printed++;
+        }
+    }
+
+    if (!printed) {
+        fprintf(stderr, "No such table\n");
+        return 1;
+    }
+    return 0;
+}
+
+#endif
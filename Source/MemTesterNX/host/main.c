@@ -0,0 +1,303 @@
+/*
+ * MemTesterNX host runner
+ *
+ * Runs the test core and worker pool on a Linux host with pthreads, so
+ * kernels and pool changes can be checked and benchmarked off-device.
+ *
+ *   ./memtester-host [-t workers] [-m MB per worker] [-l loops] [-q] [-s] [-n] [-b] [-c]
+ *                    [-e [-T test mask] [-F fault hz] [-o report.json]]
+ *
+ * -e runs the EMC stability ladder against the sys-clk manager's pc_shim;
+ * -F makes an extra test flip a bit whenever the MEM override is at or
+ * above the given frequency, to exercise the failure path.
+ *
+ * Licensed under the terms of the GNU General Public License version 2 (only).
+ * See the file COPYING for details.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "types.h"
+#include "tests.h"
+#include "memtester.h"
+#include "worker_pool.h"
+#include "emc_ladder.h"
+#include "sizes.h"
+
+#define ONE_BIT ((ul) 1)
+
+unsigned short dividend = 1;
+int use_phys = 0;
+off_t physaddrbase = 0;
+
+double gettime(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1000000.;
+}
+
+static void usage(const char *me)
+{
+    fprintf(stderr, "usage: %s [-t workers (1-%d)] [-m MB per worker] [-l loops] [-q] [-s] [-n] [-b] [-c]\n"
+                    "  -q  fast test (same as X on the console)\n"
+                    "  -s  stress tests (same as Y on the console)\n"
+                    "  -n  use the NEON kernels\n"
+                    "  -b  benchmark scalar and NEON kernels side by side\n"
+                    "  -c  check that both compares catch the same injected errors\n"
+                    "  -e  EMC stability ladder over the pc_shim frequencies\n"
+                    "  -T  ladder test subset, bit i selects test i (default: a short subset)\n"
+                    "  -F  ladder: inject a bit error at or above this MEM frequency (Hz)\n"
+                    "  -o  ladder: JSON report path (default: stdout)\n",
+            me, POOL_MAX_WORKERS);
+}
+
+/* Corrupts single bits at offsets around block boundaries and in the tail,
+ * and checks that compare_regions and compare_regions_neon agree. */
+static int check_compare(void)
+{
+    static const size_t counts[] = { 7, 8, 64, 1000, 4099 };
+    int failed = 0;
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        size_t count = counts[c];
+        ulv *a = malloc(count * sizeof(ul));
+        ulv *b = malloc(count * sizeof(ul));
+
+        for (size_t i = 0; i < count; i++)
+            a[i] = b[i] = rand_ul();
+
+        if (compare_regions(a, b, count) || compare_regions_neon(a, b, count))
+        {
+            printf("count %zu: false positive\n", count);
+            failed++;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            for (int bit = 0; bit < UL_LEN; bit += 21)
+            {
+                b[i] ^= ONE_BIT << bit;
+                if (!compare_regions(a, b, count) || !compare_regions_neon(a, b, count))
+                {
+                    printf("count %zu: missed error at word %zu bit %d\n", count, i, bit);
+                    failed++;
+                }
+                b[i] ^= ONE_BIT << bit;
+            }
+        }
+
+        free((void *)a);
+        free((void *)b);
+    }
+
+    printf("compare check: %s\n", failed ? "FAILED" : "ok");
+    return failed ? 1 : 0;
+}
+
+static u32 fault_hz = 0;
+
+static int test_injected_fault(ulv *bufa, ulv *bufb, size_t count)
+{
+    SysClkContext ctx;
+    size_t i;
+
+    sysclkIpcGetCurrentContext(&ctx);
+    for (i = 0; i < count; i++)
+        bufa[i] = bufb[i] = i;
+
+    if (fault_hz && ctx.overrideFreqs[SysClkModule_MEM] >= fault_hz)
+        bufa[count / 3] ^= ONE_BIT << 17;
+
+    return compare_regions(bufa, bufb, count);
+}
+
+static void ladder_progress(u32 hz, const char *name, int passed, void *user)
+{
+    (void)user;
+    if (passed < 0)
+        fprintf(stderr, "  %4u MHz %-20s: ", (unsigned)(hz / 1000000), name);
+    else
+        fprintf(stderr, "%s\n", passed ? "ok" : "FAILED");
+}
+
+static int run_ladder(struct test *table, unsigned long mask, const char *report)
+{
+    static struct test ladder_table[LADDER_MAX_TESTS + 1];
+    static struct ladder_result res;
+    struct ladder_options opt = {
+        .table = ladder_table,
+        .test_mask = mask ? mask : ladder_default_mask(table),
+        .stuck_address = true,
+        .passes = 1,
+        .settle_ms = 0,
+        .stop_on_fail = true,
+        .progress = ladder_progress,
+    };
+    int n = 0;
+
+    while (table[n].name && n < LADDER_MAX_TESTS - 1)
+    {
+        ladder_table[n] = table[n];
+        n++;
+    }
+    if (fault_hz)
+    {
+        ladder_table[n].name = "Injected Fault";
+        ladder_table[n].fp = test_injected_fault;
+        opt.test_mask |= 1UL << n;
+        n++;
+    }
+    ladder_table[n].name = NULL;
+
+    sysclkIpcInitialize();
+    Result rc = ladder_run(&opt, &res);
+    sysclkIpcExit();
+
+    FILE *f = report ? fopen(report, "w") : stdout;
+    if (!f)
+    {
+        perror(report);
+        return 1;
+    }
+    ladder_write_json(f, &opt, &res);
+    if (report)
+        fclose(f);
+
+    fprintf(stderr, "stable up to %u MHz\n", (unsigned)(res.stable_hz / 1000000));
+    return R_FAILED(rc) ? 1 : 0;
+}
+
+/* Runs every test once with each table and prints both region throughputs */
+static int bench_kernels(void)
+{
+    printf("  %-20s  %10s  %10s  %6s\n", "region", "scalar", "NEON", "");
+
+    for (int i = 0; tests[i].name; i++)
+    {
+        double gbps[2];
+        struct test *t[2] = { &tests[i], &tests_neon[i] };
+
+        for (int k = 0; k < 2; k++)
+        {
+            if (pool_run(t[k]))
+            {
+                printf("  %-20s: FAILED (%s)\n", tests[i].name, k ? "NEON" : "scalar");
+                return 1;
+            }
+            gbps[k] = pool_total_gbps();
+        }
+
+        printf("  %-20s: %5.2f GB/s  %5.2f GB/s  x%.2f\n", tests[i].name, gbps[0], gbps[1],
+               gbps[0] > 0. ? gbps[1] / gbps[0] : 0.);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int workers = 3, loops = 1, bench = 0, ladder = 0, opt;
+    unsigned long ladder_mask = 0;
+    const char *report = NULL;
+    size_t mb = 64;
+    struct test *test_select = tests;
+    ulv *regions[POOL_MAX_WORKERS];
+    size_t bytes[POOL_MAX_WORKERS];
+
+    while ((opt = getopt(argc, argv, "t:m:l:qsnbceT:F:o:")) != -1)
+    {
+        switch (opt)
+        {
+            case 't': workers = atoi(optarg); break;
+            case 'm': mb = strtoul(optarg, NULL, 0); break;
+            case 'l': loops = atoi(optarg); break;
+            case 'q': dividend = 4; break;
+            case 's': dividend = 16; test_select = stress_tests; break;
+            case 'n': test_select = tests_neon; break;
+            case 'b': bench = 1; break;
+            case 'c': return check_compare();
+            case 'e': ladder = 1; break;
+            case 'T': ladder_mask = strtoul(optarg, NULL, 0); break;
+            case 'F': fault_hz = strtoul(optarg, NULL, 0); break;
+            case 'o': report = optarg; break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+
+    if (workers < 1 || workers > POOL_MAX_WORKERS || !mb || loops < 1)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    for (int i = 0; i < workers; i++)
+    {
+        bytes[i] = mb << 20;
+        if (posix_memalign((void **)&regions[i], getpagesize(), bytes[i]))
+        {
+            fprintf(stderr, "Alloc %d: failed to allocate %zuMB\n", i + 1, mb);
+            return 1;
+        }
+    }
+
+    if (pool_init(workers, regions, bytes) != workers)
+        return 1;
+
+    printf("%d workers, %zuMB each\n", workers, mb);
+
+    if (bench || ladder)
+    {
+        int rc = bench ? bench_kernels() : run_ladder(test_select, ladder_mask, report);
+        pool_exit();
+        return rc;
+    }
+
+    int failed = 0;
+    for (int loop = 1; loop <= loops && !failed; loop++)
+    {
+        printf("Loop %d:\n", loop);
+
+        printf("  %-20s: ", "Stuck Address");
+        fflush(stdout);
+        if ((failed = pool_run(NULL)))
+            break;
+        printf("ok\n");
+
+        for (int i = 0; test_select[i].name; i++)
+        {
+            printf("  %-20s: ", test_select[i].name);
+            fflush(stdout);
+
+            double start = gettime();
+            if ((failed = pool_run(&test_select[i])))
+                break;
+
+            printf("ok %6.2fs %7.2f GB/s region |", gettime() - start, pool_total_gbps());
+            for (int j = 0; j < workers; j++)
+                printf(" [%d] %.2f", j + 1, pool_get_report(j)->gbps);
+            printf("\n");
+        }
+    }
+
+    if (failed)
+    {
+        printf("FAILED\n");
+        for (int j = 0; j < workers; j++)
+        {
+            if (pool_get_report(j)->rc)
+                printf("Alloc %d/%d: Error detected!\n", j + 1, workers);
+        }
+    }
+
+    pool_exit();
+
+    for (int i = 0; i < workers; i++)
+        free((void *)regions[i]);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,27 @@
+/*
+ * MemTesterNX NEON pattern kernels
+ *
+ * Licensed under the terms of the GNU General Public License version 2 (only).
+ * See the file COPYING for details.
+ *
+ */
+
+#ifndef MEMTESTER_AARCH64_TESTS_H
+#define MEMTESTER_AARCH64_TESTS_H
+
+#include <stddef.h>
+
+#include "types.h"
+
+/* All sizes are in bytes and must be a non-zero multiple of 64. */
+
+void memtest_fill_q_aarch64(ulv *bufa, ulv *bufb, size_t size, ul even, ul odd);
+void memtest_seq_q_aarch64(ulv *bufa, ulv *bufb, size_t size, ul start);
+size_t memtest_compare_q_aarch64(ulv *bufa, ulv *bufb, size_t size);
+
+void memtest_xor_q_aarch64(ulv *buf, size_t size, ul q);
+void memtest_sub_q_aarch64(ulv *buf, size_t size, ul q);
+void memtest_or_q_aarch64(ulv *buf, size_t size, ul q);
+void memtest_and_q_aarch64(ulv *buf, size_t size, ul q);
+
+#endif
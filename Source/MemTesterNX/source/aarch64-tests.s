@@ -0,0 +1,162 @@
+/*
+ * MemTesterNX NEON pattern kernels
+ *
+ * 128-bit ldp/stp building blocks for the tests in tests-neon.c, modelled
+ * on the TinyMemBenchNX copy/fill kernels. Every kernel works on 64 byte
+ * blocks and expects a non-zero, 64 byte aligned SIZE.
+ *
+ * Licensed under the terms of the GNU General Public License version 2 (only).
+ * See the file COPYING for details.
+ *
+ */
+
+#ifdef __aarch64__
+
+    .cpu cortex-a57+fp+simd
+    .text
+    .align 2
+
+.macro asm_function function_name
+    .global \function_name
+    .type \function_name,%function 
+.func \function_name
+\function_name:
+.endm
+
+/*
+ * void memtest_fill_q_aarch64(ulv *bufa, ulv *bufb, size_t size, ul even, ul odd)
+ *
+ * Writes the word pair {even, odd} over both buffers with non-temporal
+ * stores, so word i gets even for even i and odd for odd i.
+ */
+asm_function memtest_fill_q_aarch64
+    BUFA        .req x0
+    BUFB        .req x1
+    SIZE        .req x2
+    fmov        d0, x3
+    mov         v0.d[1], x4
+    mov         v1.16b, v0.16b
+0:
+    stnp        q0,  q1, [BUFA, #(0 * 32)]
+    stnp        q0,  q1, [BUFA, #(1 * 32)]
+    stnp        q0,  q1, [BUFB, #(0 * 32)]
+    stnp        q0,  q1, [BUFB, #(1 * 32)]
+    add         BUFA, BUFA, #64
+    add         BUFB, BUFB, #64
+    subs        SIZE, SIZE, #64
+    bgt         0b
+    dmb         ish
+    ret
+    .unreq      BUFA
+    .unreq      BUFB
+    .unreq      SIZE
+.endfunc
+
+/*
+ * void memtest_seq_q_aarch64(ulv *bufa, ulv *bufb, size_t size, ul start)
+ *
+ * Writes start + i to word i of both buffers with non-temporal stores.
+ */
+asm_function memtest_seq_q_aarch64
+    BUFA        .req x0
+    BUFB        .req x1
+    SIZE        .req x2
+    fmov        d0, x3
+    add         x4, x3, #1
+    mov         v0.d[1], x4
+    mov         x5, #2
+    dup         v16.2d, x5
+    mov         x5, #8
+    dup         v17.2d, x5
+0:
+    add         v1.2d, v0.2d, v16.2d
+    add         v2.2d, v1.2d, v16.2d
+    add         v3.2d, v2.2d, v16.2d
+    stnp        q0,  q1, [BUFA, #(0 * 32)]
+    stnp        q2,  q3, [BUFA, #(1 * 32)]
+    stnp        q0,  q1, [BUFB, #(0 * 32)]
+    stnp        q2,  q3, [BUFB, #(1 * 32)]
+    add         v0.2d, v0.2d, v17.2d
+    add         BUFA, BUFA, #64
+    add         BUFB, BUFB, #64
+    subs        SIZE, SIZE, #64
+    bgt         0b
+    dmb         ish
+    ret
+    .unreq      BUFA
+    .unreq      BUFB
+    .unreq      SIZE
+.endfunc
+
+/*
+ * size_t memtest_compare_q_aarch64(ulv *bufa, ulv *bufb, size_t size)
+ *
+ * Returns the offset of the first 64 byte block which differs between
+ * the buffers, or size if they are identical.
+ */
+asm_function memtest_compare_q_aarch64
+    BUFA        .req x0
+    BUFB        .req x1
+    SIZE        .req x2
+    OFFS        .req x5
+    mov         OFFS, #0
+0:
+    ldp         q0,  q1, [BUFA, #(0 * 32)]
+    ldp         q2,  q3, [BUFA, #(1 * 32)]
+    ldp         q4,  q5, [BUFB, #(0 * 32)]
+    ldp         q6,  q7, [BUFB, #(1 * 32)]
+    eor         v0.16b, v0.16b, v4.16b
+    eor         v1.16b, v1.16b, v5.16b
+    eor         v2.16b, v2.16b, v6.16b
+    eor         v3.16b, v3.16b, v7.16b
+    orr         v0.16b, v0.16b, v1.16b
+    orr         v2.16b, v2.16b, v3.16b
+    orr         v0.16b, v0.16b, v2.16b
+    umaxp       v0.4s, v0.4s, v0.4s
+    fmov        x6, d0
+    cbnz        x6, 1f
+    add         BUFA, BUFA, #64
+    add         BUFB, BUFB, #64
+    add         OFFS, OFFS, #64
+    cmp         OFFS, SIZE
+    blo         0b
+1:
+    mov         x0, OFFS
+    ret
+    .unreq      BUFA
+    .unreq      BUFB
+    .unreq      SIZE
+    .unreq      OFFS
+.endfunc
+
+/*
+ * void memtest_<op>_q_aarch64(ulv *buf, size_t size, ul q)
+ *
+ * In place read-modify-write of every word with q. The data is read back
+ * right after, so these use regular stores.
+ */
+.macro rmw_function function_name, op, t
+asm_function \function_name
+    dup         v16.2d, x2
+0:
+    ldp         q0,  q1, [x0, #(0 * 32)]
+    ldp         q2,  q3, [x0, #(1 * 32)]
+    \op         v0.\t, v0.\t, v16.\t
+    \op         v1.\t, v1.\t, v16.\t
+    \op         v2.\t, v2.\t, v16.\t
+    \op         v3.\t, v3.\t, v16.\t
+    stp         q0,  q1, [x0, #(0 * 32)]
+    stp         q2,  q3, [x0, #(1 * 32)]
+    add         x0, x0, #64
+    subs        x1, x1, #64
+    bgt         0b
+    ret
+.endfunc
+.endm
+
+rmw_function memtest_xor_q_aarch64, eor, 16b
+rmw_function memtest_sub_q_aarch64, sub, 2d
+rmw_function memtest_or_q_aarch64,  orr, 16b
+rmw_function memtest_and_q_aarch64, and, 16b
+
+#endif
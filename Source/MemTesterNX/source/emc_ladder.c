@@ -0,0 +1,246 @@
+/*
+ * MemTesterNX EMC stability ladder
+ *
+ * Licensed under the terms of the GNU General Public License version 2 (only).
+ * See the file COPYING for details.
+ *
+ */
+
+#include <string.h>
+#include <unistd.h>
+
+#include "emc_ladder.h"
+#include "worker_pool.h"
+#include "memtester.h"
+
+#define LADDER_POLL_MS      50
+#define LADDER_POLL_TRIES   40
+
+static const char *default_tests[] = {
+    "Random Value",
+    "Compare XOR",
+    "Sequential Increment",
+    "Solid Bits",
+    "Checkerboard",
+    "Walking Ones",
+    "Walking Zeroes",
+    NULL
+};
+
+unsigned long ladder_default_mask(const struct test *table)
+{
+    unsigned long mask = 0;
+
+    for (int i = 0; table[i].name && i < LADDER_MAX_TESTS; i++)
+    {
+        for (int j = 0; default_tests[j]; j++)
+        {
+            if (!strcmp(table[i].name, default_tests[j]))
+                mask |= 1UL << i;
+        }
+    }
+    return mask;
+}
+
+static void sort_freqs(u32 *list, u32 count)
+{
+    for (u32 i = 1; i < count; i++)
+    {
+        u32 hz = list[i];
+        u32 j = i;
+        while (j > 0 && list[j - 1] > hz)
+        {
+            list[j] = list[j - 1];
+            j--;
+        }
+        list[j] = hz;
+    }
+}
+
+/* Waits for the sysmodule to pick up the override, then lets the clock settle */
+static Result apply_override(const struct ladder_options *opt, struct ladder_step *step)
+{
+    SysClkContext ctx;
+    Result rc = sysclkIpcSetOverride(SysClkModule_MEM, step->hz);
+    if (R_FAILED(rc))
+        return rc;
+
+    for (int i = 0; i < LADDER_POLL_TRIES; i++)
+    {
+        rc = sysclkIpcGetCurrentContext(&ctx);
+        if (R_FAILED(rc))
+            return rc;
+        if (ctx.overrideFreqs[SysClkModule_MEM] == step->hz)
+            break;
+        usleep(LADDER_POLL_MS * 1000);
+    }
+
+    if (opt->settle_ms)
+        usleep(opt->settle_ms * 1000);
+
+    rc = sysclkIpcGetCurrentContext(&ctx);
+    if (R_SUCCEEDED(rc))
+        step->real_hz = ctx.realFreqs[SysClkModule_MEM];
+    return rc;
+}
+
+static void collect_failures(struct ladder_step *step)
+{
+    for (int w = 0; w < pool_workers(); w++)
+    {
+        const struct fail_log *log = &pool_get_report(w)->failures;
+        size_t recorded = log->count < FAIL_LOG_MAX ? log->count : FAIL_LOG_MAX;
+
+        step->failures += log->count;
+        step->mask |= log->mask;
+
+        for (size_t i = 0; i < recorded && step->record_count < LADDER_MAX_RECORDS; i++)
+        {
+            struct ladder_record *r = &step->records[step->record_count++];
+            r->worker = w;
+            r->rec = log->records[i];
+            r->offset = (size_t)r->rec.addr_a - (size_t)pool_get_base(w);
+        }
+    }
+}
+
+static void run_test(const struct ladder_options *opt, struct ladder_step *step, const struct test *t)
+{
+    const char *name = t ? t->name : "Stuck Address";
+    struct ladder_test_result *res = NULL;
+
+    for (int i = 0; i < step->test_count; i++)
+    {
+        if (step->tests[i].name == name)
+            res = &step->tests[i];
+    }
+    if (!res)
+    {
+        res = &step->tests[step->test_count++];
+        res->name = name;
+        res->passed = true;
+        res->gbps = 0.;
+    }
+
+    if (opt->progress)
+        opt->progress(step->hz, name, -1, opt->user);
+
+    bool passed = pool_run(t) == 0;
+    res->gbps = pool_total_gbps();
+    if (!passed)
+    {
+        res->passed = false;
+        step->passed = false;
+        collect_failures(step);
+    }
+
+    if (opt->progress)
+        opt->progress(step->hz, name, passed, opt->user);
+}
+
+Result ladder_run(const struct ladder_options *opt, struct ladder_result *out)
+{
+    u32 freqs[SYSCLK_FREQ_LIST_MAX];
+    u32 count = 0;
+    bool stable = true;
+
+    memset(out, 0, sizeof(*out));
+
+    out->rc = sysclkIpcGetFreqList(SysClkModule_MEM, freqs, SYSCLK_FREQ_LIST_MAX, &count);
+    if (R_FAILED(out->rc))
+        return out->rc;
+
+    sort_freqs(freqs, count);
+
+    for (u32 f = 0; f < count && out->step_count < LADDER_MAX_STEPS; f++)
+    {
+        if ((opt->min_hz && freqs[f] < opt->min_hz) || (opt->max_hz && freqs[f] > opt->max_hz))
+            continue;
+
+        struct ladder_step *step = &out->steps[out->step_count++];
+        step->hz = freqs[f];
+        step->passed = true;
+
+        out->rc = apply_override(opt, step);
+        if (R_FAILED(out->rc))
+            break;
+
+        double start = gettime();
+        for (int pass = 0; pass < opt->passes; pass++)
+        {
+            if (opt->stuck_address)
+                run_test(opt, step, NULL);
+
+            for (int i = 0; opt->table[i].name && i < LADDER_MAX_TESTS; i++)
+            {
+                if (opt->test_mask & (1UL << i))
+                    run_test(opt, step, &opt->table[i]);
+            }
+        }
+        step->seconds = gettime() - start;
+
+        if (step->passed && stable)
+            out->stable_hz = step->hz;
+        else
+            stable = false;
+
+        if (!step->passed && opt->stop_on_fail)
+            break;
+    }
+
+    Result rc = sysclkIpcRemoveOverride(SysClkModule_MEM);
+    if (R_SUCCEEDED(out->rc))
+        out->rc = rc;
+
+    return out->rc;
+}
+
+void ladder_write_json(FILE *f, const struct ladder_options *opt, const struct ladder_result *res)
+{
+    fprintf(f, "{\n");
+    fprintf(f, "  \"module\": \"MEM\",\n");
+    fprintf(f, "  \"workers\": %d,\n", pool_workers());
+    fprintf(f, "  \"passes\": %d,\n", opt->passes);
+    fprintf(f, "  \"rc\": %u,\n", (unsigned)res->rc);
+    fprintf(f, "  \"stable_hz\": %u,\n", (unsigned)res->stable_hz);
+    fprintf(f, "  \"steps\": [\n");
+
+    for (int s = 0; s < res->step_count; s++)
+    {
+        const struct ladder_step *step = &res->steps[s];
+
+        fprintf(f, "    {\n");
+        fprintf(f, "      \"hz\": %u,\n", (unsigned)step->hz);
+        fprintf(f, "      \"real_hz\": %u,\n", (unsigned)step->real_hz);
+        fprintf(f, "      \"passed\": %s,\n", step->passed ? "true" : "false");
+        fprintf(f, "      \"seconds\": %.3f,\n", step->seconds);
+        fprintf(f, "      \"failures\": %zu,\n", step->failures);
+        fprintf(f, "      \"mask\": \"0x%016llx\",\n", (unsigned long long)step->mask);
+
+        fprintf(f, "      \"tests\": [");
+        for (int i = 0; i < step->test_count; i++)
+        {
+            const struct ladder_test_result *t = &step->tests[i];
+            fprintf(f, "%s\n        { \"name\": \"%s\", \"passed\": %s, \"region_gbps\": %.3f }",
+                    i ? "," : "", t->name, t->passed ? "true" : "false", t->gbps);
+        }
+        fprintf(f, "%s],\n", step->test_count ? "\n      " : "");
+
+        fprintf(f, "      \"errors\": [");
+        for (int i = 0; i < step->record_count; i++)
+        {
+            const struct ladder_record *r = &step->records[i];
+            fprintf(f, "%s\n        { \"worker\": %d, \"address\": \"0x%llx\", \"offset\": \"0x%zx\", "
+                       "\"value\": \"0x%016llx\", \"expected\": \"0x%016llx\", \"mask\": \"0x%016llx\" }",
+                    i ? "," : "", r->worker, (unsigned long long)(size_t)r->rec.addr_a, r->offset,
+                    (unsigned long long)r->rec.value_a, (unsigned long long)r->rec.value_b,
+                    (unsigned long long)(r->rec.value_a ^ r->rec.value_b));
+        }
+        fprintf(f, "%s]\n", step->record_count ? "\n      " : "");
+
+        fprintf(f, "    }%s\n", s + 1 < res->step_count ? "," : "");
+    }
+
+    fprintf(f, "  ]\n");
+    fprintf(f, "}\n");
+}
@@ -0,0 +1,87 @@
+/*
+ * MemTesterNX EMC stability ladder
+ *
+ * Steps the memory clock through the frequencies horizon:oc reports, from
+ * the lowest up, and runs a subset of the tests on every worker at each
+ * step. The result records, per step, which tests passed and the failing
+ * addresses and bit masks, and can be written out as JSON.
+ *
+ * Only the sysclkIpc* client API is used, so on a host the sweep runs
+ * against the sys-clk manager's pc_shim.
+ *
+ * Licensed under the terms of the GNU General Public License version 2 (only).
+ * See the file COPYING for details.
+ *
+ */
+
+#ifndef MEMTESTER_EMC_LADDER_H
+#define MEMTESTER_EMC_LADDER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <sysclk/client/ipc.h>
+
+#include "types.h"
+#include "tests.h"
+
+#define LADDER_MAX_STEPS    SYSCLK_FREQ_LIST_MAX
+#define LADDER_MAX_TESTS    32
+#define LADDER_MAX_RECORDS  16
+
+struct ladder_options {
+    const struct test *table;   /* NULL terminated, usually tests[] or tests_neon[] */
+    unsigned long test_mask;    /* bit i selects table[i] */
+    bool stuck_address;         /* run the stuck address test first */
+    int passes;                 /* passes over the subset at each step */
+    u32 min_hz, max_hz;         /* 0 for no limit */
+    u32 settle_ms;              /* wait after each clock change */
+    bool stop_on_fail;          /* don't go any higher after a failing step */
+
+    /* Optional, called before (passed < 0) and after every test */
+    void (*progress)(u32 hz, const char *name, int passed, void *user);
+    void *user;
+};
+
+struct ladder_test_result {
+    const char *name;
+    bool passed;
+    double gbps;    /* region throughput, see struct pool_report */
+};
+
+struct ladder_record {
+    int worker;
+    size_t offset;              /* of addr_a from the start of the worker's region */
+    struct fail_record rec;
+};
+
+struct ladder_step {
+    u32 hz;                     /* requested override */
+    u32 real_hz;                /* as reported by the context once applied */
+    bool passed;
+    double seconds;
+    int test_count;
+    struct ladder_test_result tests[LADDER_MAX_TESTS];
+    size_t failures;            /* total mismatches over every worker and test */
+    ul mask;                    /* every bit that failed at this step */
+    int record_count;
+    struct ladder_record records[LADDER_MAX_RECORDS];
+};
+
+struct ladder_result {
+    Result rc;                  /* first IPC error, 0 if none */
+    u32 stable_hz;              /* highest step with every step below passing, 0 if none */
+    int step_count;
+    struct ladder_step steps[LADDER_MAX_STEPS];
+};
+
+/* Default subset: short tests which are the most sensitive to bad timings. */
+unsigned long ladder_default_mask(const struct test *table);
+
+/* Runs the sweep with the workers started by pool_init(). The MEM override
+ * is removed afterwards. Returns the first IPC error, 0 on success. */
+Result ladder_run(const struct ladder_options *opt, struct ladder_result *out);
+
+void ladder_write_json(FILE *f, const struct ladder_options *opt, const struct ladder_result *res);
+
+#endif
@@ -30,6 +30,8 @@
  #include "types.h"
  #include "sizes.h"
  #include "tests.h"
+ #include "worker_pool.h"
+ #include "emc_ladder.h"
  #include <switch.h>
  
  /* Some helpful typedefs used throughout the file (used by original code) */
@@ -88,36 +90,6 @@
      return (double)((int64_t)tv.tv_sec * 1000000 + tv.tv_usec) / 1000000.;
  }
  
- struct test tests[] = {
-     { "Random Value", test_random_value },
-     { "Compare XOR", test_xor_comparison },
-     { "Compare SUB", test_sub_comparison },
-     { "Compare MUL", test_mul_comparison },
-     { "Compare DIV", test_div_comparison },
-     { "Compare OR", test_or_comparison },
-     { "Compare AND", test_and_comparison },
-     { "Sequential Increment", test_seqinc_comparison },
-     { "Solid Bits", test_solidbits_comparison },
-     { "Block Sequential", test_blockseq_comparison },
-     { "Checkerboard", test_checkerboard_comparison },
-     { "Bit Spread", test_bitspread_comparison },
-     { "Bit Flip (Slow)", test_bitflip_comparison },
-     { "Walking Ones", test_walkbits1_comparison },
-     { "Walking Zeroes", test_walkbits0_comparison },
- #ifdef TEST_NARROW_WRITES    
-     { "8-bit Writes", test_8bit_wide_random },
-     { "16-bit Writes", test_16bit_wide_random },
- #endif
-     { NULL, NULL }
- };
- 
- struct test stress_tests[] = {
-     { "Stress memcpy x128", test_stress_memcpy },
-     { "Stress memset x128", test_stress_memset },
-     { "Stress memcmp x 32", test_stress_memcmp },
-     { NULL, NULL }
- };
- 
  int memtester_pagesize(void) {
      printf("using pagesize of 4096\n");
      return 4096;
@@ -126,73 +98,92 @@
  /* Global vars - so tests have access to this information */
  int use_phys = 0;
  off_t physaddrbase = 0;
- int testJobId[4] = {0};
- int testWorkerReport[4] = {0};
- size_t bufsize[4], wantbytes[4];
- void volatile *aligned[4];
- Thread threads[5];
+ size_t bufsize[POOL_MAX_WORKERS], wantbytes[POOL_MAX_WORKERS];
+ ulv *aligned[POOL_MAX_WORKERS];
+ Thread keyListenerThread;
  struct test* test_select = tests;
  
- void testWorker(int div)
+ /* Prints the failing workers and waits for exit if the phase failed */
+ bool phaseFailed(int failed, unsigned short testThreads)
  {
-     /* Wait until main sets this worker to ready (-2) */
-     while (testJobId[div] != -2)
-         svcSleepThread(10000000ULL);
+     if (!failed)
+         return false;
  
-     while (true)
+     printf("\n");
+     for (int j = 0; j < testThreads; j++)
      {
-         int currentJobId = -1;
+         if (pool_get_report(j)->rc)
+             printf("Alloc %d/%d: Error detected!\n", j+1, testThreads);
+     }
+     printf("Press any key to exit.\n");
+     consoleUpdate(NULL);
+     waitForAnyKey();
+     return true;
+ }
  
-         /* Wait until main moves us to the stuck-address job (-1) */
-         while (testJobId[div] != currentJobId)
-             svcSleepThread(10000000ULL);
+ void printWorkerThroughput(unsigned short testThreads)
+ {
+     printf("  %-20s  ", "region, per worker");
+     for (int j = 0; j < testThreads; j++)
+         printf(" [%d] %.2f GB/s", j+1, pool_get_report(j)->gbps);
+     printf("\n");
+ }
  
-         /* Stuck address test: bufsize is in bytes, test_stuck_address expects count in ul units */
-         if (!test_stuck_address(aligned[div], bufsize[div] / sizeof(ul)))
-         {
-             testWorkerReport[div] = 1;
-             currentJobId++;
-         }
-         else
-         {
-             testWorkerReport[div] = -1;
-             return;
-         }
+ void ladderProgress(u32 hz, const char *name, int passed, void *user)
+ {
+     if (passed < 0)
+         printf("  %4u MHz %-20s: ...", hz / 1000000, name);
+     else
+         printf("\b\b\b%s\n", passed ? "ok" : "FAILED");
+     consoleUpdate(NULL);
+ }
  
-         /* Now iterate over the selected tests */
-         while (test_select[currentJobId].name)
-         {
-             while (testJobId[div] != currentJobId)
-                 svcSleepThread(10000000ULL);
+ /* Steps the memory clock through the horizon:oc frequency list and writes the results to LADDER_REPORT */
+ #define LADDER_REPORT "sdmc:/MemTesterNX-ladder.json"
  
-             /* Ensure second pointer argument is a pointer (not integer) */
-             void volatile *second_ptr = (void volatile *)((size_t)aligned[div] + bufsize[div] / 2);
-             int test_rc = test_select[currentJobId].fp(aligned[div], second_ptr, (bufsize[div] / sizeof(ul)) / 2);
-             if (!test_rc)
-             {
-                 testWorkerReport[div] = 1;
-                 currentJobId++;
-             }
-             else
-             {
-                 testWorkerReport[div] = -1;
-                 return;
-             }
-         }
+ void runLadder(struct test *table)
+ {
+     static struct ladder_result res;
+     struct ladder_options opt = {
+         .table = table,
+         .test_mask = ladder_default_mask(table),
+         .stuck_address = true,
+         .passes = 1,
+         .settle_ms = 500,
+         .stop_on_fail = true,
+         .progress = ladderProgress,
+     };
+ 
+     if (!sysclkIpcRunning() || R_FAILED(sysclkIpcInitialize()))
+     {
+         printf("horizon:oc is not running, can't change the memory clock.\n");
+         return;
      }
- }
  
- void testWorker0(void*) { testWorker(0); }
- void testWorker1(void*) { testWorker(1); }
- void testWorker2(void*) { testWorker(2); }
- void testWorker3(void*) { testWorker(3); }
+     Result rc = ladder_run(&opt, &res);
+     sysclkIpcExit();
+ 
+     if (R_FAILED(rc))
+         printf("horizon:oc IPC failed: 0x%X\n", rc);
+ 
+     FILE *f = fopen(LADDER_REPORT, "w");
+     if (f)
+     {
+         ladder_write_json(f, &opt, &res);
+         fclose(f);
+         printf("Report written to " LADDER_REPORT "\n");
+     }
  
- void* workers[] = {
-     testWorker0,
-     testWorker1,
-     testWorker2,
-     testWorker3,
- };
+     for (int s = 0; s < res.step_count; s++)
+     {
+         const struct ladder_step *step = &res.steps[s];
+         printf("%4u MHz: %s", step->hz / 1000000, step->passed ? "pass" : "FAIL");
+         if (!step->passed)
+             printf(" (%zu errors, mask 0x%016lx)", step->failures, step->mask);
+         printf("\n");
+     }
+     printf("Stable up to %u MHz\n", res.stable_hz / 1000000);
+ }
  
  void LblUpdate()
  {
@@ -242,9 +233,11 @@
      ull loop;
      size_t i;
      unsigned short div, testThreads = 3;
+     bool testThreadsSet = false;
+     bool useNeon = false, benchKernels = false, ladderMode = false;
      size_t pagesize, wantraw, wantbytes_orig;
      ptrdiff_t pagesizemask;
-     void volatile *buf[4];
+     void volatile *buf[POOL_MAX_WORKERS];
      int memshift;
      ull totalmem = 0;
      int numOfMallocs = 0;
@@ -253,11 +246,15 @@
      printf("MemTesterNX version " __version__ " (%d-bit)\n"\
             "Based on memtester. Copyright (C) 2001-2020 Charles Cazabon, 2021 KazushiMe.\n"\
             "Licensed under the GNU General Public License version 2 (only).\n\n"\
-            "Support full RAM test (up to 8GB) with 3-4 threads.\n"\
+            "Support full RAM test (up to 8GB) with 1-4 threads.\n"\
             "It will be looping forever until error occurs or user exits to HOME screen.\n\n"\
             "Press A: long test\n"\
             "Press X: fast test\n"\
             "Press Y: stress DRAM (memcpy, memset and memcmp)\n"\
+            "Press ZR: fast test, scalar and NEON kernels side by side\n"\
+            "Press ZL: EMC stability ladder (steps MEM clock via horizon:oc)\n"\
+            "Press Up/Down: change worker count (default: 3)\n"\
+            "Press L/R: toggle scalar/NEON kernels (default: scalar)\n"\
             "Press any other key: exit\n\n",
             MACHINE_BITS);
  
@@ -282,6 +279,32 @@
              test_select = stress_tests;
              break;
          }
+         else if (kDown & HidNpadButton_ZL)
+         {
+             dividend = 4;
+             ladderMode = true;
+             break;
+         }
+         else if (kDown & HidNpadButton_ZR)
+         {
+             dividend = 4;
+             benchKernels = true;
+             break;
+         }
+         else if (kDown & (HidNpadButton_L | HidNpadButton_R))
+         {
+             useNeon = !useNeon;
+             printf("Kernels: %s\n", useNeon ? "NEON" : "scalar");
+         }
+         else if (kDown & (HidNpadButton_Up | HidNpadButton_Down))
+         {
+             if ((kDown & HidNpadButton_Up) && testThreads < POOL_MAX_WORKERS)
+                 testThreads++;
+             else if ((kDown & HidNpadButton_Down) && testThreads > 1)
+                 testThreads--;
+             testThreadsSet = true;
+             printf("Workers: %d\n", testThreads);
+         }
          else if (kDown)
          {
              consoleExit(NULL);
@@ -291,6 +314,9 @@
          consoleUpdate(NULL);
      }
  
+     if (useNeon && test_select == tests)
+         test_select = tests_neon;
+ 
      // Disable auto sleep and request CPU Boost mode
      appletSetAutoSleepDisabled(true);
      appletSetCpuBoostMode(ApmCpuBoostMode_FastLoad);
@@ -335,35 +361,22 @@
      if ((totalmem >> memshift) > 3 * 2047)
      {
          isDevKit8GB = true;
-         testThreads = 4;
+         if (!testThreadsSet)
+             testThreads = 4;
      }
  
-     // Create workers
-     for (div = 0; div < testThreads; div++)
-     {
-         Result rc;
-         rc = threadCreate(&threads[div], workers[div], NULL, NULL, 0x1000, 0x2C, div == 3 ? -2 : div);
-         if (R_FAILED(rc))
-         {
-             printf("Fatal: threadCreate[%d] failed: 0x%X\n", div, rc);
-             consoleUpdate(NULL);
-         }
-         else
-         {
-             totalmem -= 0x1000;
-         }
-     }
+     // Reserve worker and keyListener stacks
+     totalmem -= (ull)testThreads * POOL_STACK_SIZE + 0x1000;
  
      // keyListener
      {
-         const int kl = testThreads;
-         Result rc = threadCreate(&threads[kl], keyListener, NULL, NULL, 0x1000, 0x20, -2);
+         Result rc = threadCreate(&keyListenerThread, keyListener, NULL, NULL, 0x1000, 0x20, -2);
          if (R_FAILED(rc))
          {
-             printf("Fatal: threadCreate[%d] failed: 0x%X\n", kl, rc);
+             printf("Fatal: threadCreate[%d] failed: 0x%X\n", testThreads, rc);
              consoleUpdate(NULL);
          }
-         threadStart(&threads[kl]);
+         threadStart(&keyListenerThread);
      }
  
      printf("\nTotal RAM available: %lluMB\n\n", (unsigned long long)(totalmem >> memshift));
@@ -373,7 +386,7 @@
      for (div = 0; div < testThreads; div++)
      {
          buf[div] = NULL;
-         if (isDevKit8GB)
+         if (isDevKit8GB && testThreads == 4)
          {
              if (div != 3)
                  wantbytes[div] = totalmem / 3;
@@ -385,6 +398,10 @@
              wantbytes[div] = totalmem / testThreads;
          }
  
+         /* A single allocation can't exceed the HOS limit */
+         if (wantbytes[div] > wantbytes_orig)
+             wantbytes[div] = wantbytes_orig;
+ 
          while (!buf[div] && wantbytes[div]) {
              buf[div] = (void volatile *) malloc(wantbytes[div]);
              if (!buf[div])
@@ -395,10 +412,10 @@
  
          /* Do alignment here as well */
          if ((size_t) buf[div] % pagesize) {
-             aligned[div] = (void volatile *) (((size_t) buf[div] & pagesizemask) + pagesize);
+             aligned[div] = (ulv *) (((size_t) buf[div] & pagesizemask) + pagesize);
              bufsize[div] -= ((size_t) aligned[div] - (size_t) buf[div]);
          } else {
-             aligned[div] = buf[div];
+             aligned[div] = (ulv *) buf[div];
          }
  
          printf("Alloc %d: got  %lluMB (%llu bytes)\n", div+1, (unsigned long long)(wantbytes[div] >> memshift), (unsigned long long)wantbytes[div]);
@@ -406,50 +423,32 @@
      }
  
      // Start workers
-     for (div = 0; div < testThreads; div++)
+     if (pool_init(testThreads, aligned, bufsize) != testThreads)
      {
-         Result rc;
-         rc = threadStart(&threads[div]);
-         if (R_FAILED(rc))
-         {
-             printf("Fatal: threadStart[%d] failed: 0x%X\n", div, rc);
-             consoleUpdate(NULL);
-         }
+         consoleUpdate(NULL);
+         waitForAnyKey();
+         consoleExit(NULL);
+         return 0;
      }
  
-     for(loop=1;;loop++)
+     if (ladderMode)
      {
-         // Set testJobId to -2 (Ready)
-         for (int j = 0; j < testThreads; j++)
-             testJobId[j] = -2;
+         runLadder(test_select);
+         printf("Press any key to exit.\n");
+         consoleUpdate(NULL);
+         waitForAnyKey();
+         goto exit;
+     }
  
+     for(loop=1;;loop++)
+     {
          printf("Loop %llu:\n", (unsigned long long)loop);
  
-         // Stuck address (-1)
+         // Stuck address
          printf("  %-20s: ", "Stuck Address");
          consoleUpdate(NULL);
-         for (int j = 0; j < testThreads; j++)
-             testJobId[j] = -1;
- 
-         for (int j = 0; j < testThreads; )
-         {
-             switch (testWorkerReport[j])
-             {
-                 case 0:
-                     svcSleepThread(10000000ULL);
-                     break;
-                 case -1:
-                     printf("Alloc %d/%d: Error detected!\nPress any key to exit.\n", j+1, testThreads);
-                     consoleUpdate(NULL);
-                     waitForAnyKey();
-                     consoleExit(NULL);
-                     return 0;
-                 case 1:
-                     testWorkerReport[j] = 0;
-                     j++;
-                     continue;
-             }
-         }
+         if (phaseFailed(pool_run(NULL), testThreads))
+             break;
          printf("ok\n");
          consoleUpdate(NULL);
  
@@ -460,37 +459,36 @@
  
              printf("  %-20s: ...", test_select[i].name);
              consoleUpdate(NULL);
-             for (int j = 0; j < testThreads; j++)
-                 testJobId[j] = (int)i;
  
-             double start_sec = gettime();
-             for (int j = 0; j < testThreads; )
+             if (benchKernels)
              {
-                 switch (testWorkerReport[j])
+                 double gbps[2];
+                 for (int k = 0; k < 2; k++)
                  {
-                     case 0:
-                         svcSleepThread(10000000ULL);
-                         continue;
-                     case -1:
-                         printf("Alloc %d/%d: Error detected!\nPress any key to exit.\n", j+1, testThreads);
-                         consoleUpdate(NULL);
-                         waitForAnyKey();
-                         consoleExit(NULL);
-                         return 0;
-                     case 1:
-                         testWorkerReport[j] = 0;
-                         j++;
-                         continue;
+                     if (phaseFailed(pool_run(k ? &tests_neon[i] : &tests[i]), testThreads))
+                         goto exit;
+                     gbps[k] = pool_total_gbps();
                  }
+                 printf("\b\b\bok! region scalar %.2f GB/s, NEON %.2f GB/s\n", gbps[0], gbps[1]);
+                 consoleUpdate(NULL);
+                 continue;
              }
+ 
+             double start_sec = gettime();
+             if (phaseFailed(pool_run(&test_select[i]), testThreads))
+                 goto exit;
              double end_sec = gettime();
-             printf("\b\b\bok! finished in %.1fs\n", end_sec - start_sec);
+ 
+             printf("\b\b\bok! finished in %.1fs (region %.2f GB/s)\n", end_sec - start_sec, pool_total_gbps());
+             printWorkerThroughput(testThreads);
              consoleUpdate(NULL);
          }
      }
  
+ exit:
+     pool_exit();
+ 
      // Deinitialize and clean up resources used by the console (important!)
      consoleExit(NULL);
      return 0;
  }
- 
\ No newline at end of file
@@ -20,3 +20,5 @@
 extern int use_phys;
 extern off_t physaddrbase;
 
+double gettime(void);
+
@@ -0,0 +1,351 @@
+/*
+ * MemTesterNX NEON tests
+ *
+ * Same patterns, loop counts and pass/fail semantics as the scalar tests in
+ * tests.c, but the bulk of every fill and compare goes through the 128-bit
+ * kernels in aarch64-tests.s so a pass is bound by the EMC instead of by
+ * single-word volatile accesses. Whenever the vector compare sees a
+ * difference the scalar compare_regions takes over from that block, so
+ * errors are detected exactly as in the scalar tests.
+ *
+ * Licensed under the terms of the GNU General Public License version 2 (only).
+ * See the file COPYING for details.
+ *
+ */
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "tests.h"
+#include "types.h"
+#include "sizes.h"
+#include "memtester.h"
+
+extern unsigned short dividend;
+
+#define ONE 0x00000001L
+#define BLOCK_MASK ((size_t) 63)
+
+#ifdef __aarch64__
+#include "aarch64-tests.h"
+
+#define fill_q      memtest_fill_q_aarch64
+#define seq_q       memtest_seq_q_aarch64
+#define compare_q   memtest_compare_q_aarch64
+#define xor_q       memtest_xor_q_aarch64
+#define sub_q       memtest_sub_q_aarch64
+#define or_q        memtest_or_q_aarch64
+#define and_q       memtest_and_q_aarch64
+#else
+/* Portable versions of the kernels, so the NEON tests can be run and
+ * benchmarked on a host. Plain pointers let the compiler vectorise them. */
+
+#define KERNEL __attribute__((noinline))
+
+static KERNEL void fill_q(ulv *bufa, ulv *bufb, size_t size, ul even, ul odd) {
+    ul *p1 = (ul *) bufa;
+    ul *p2 = (ul *) bufb;
+    size_t i;
+
+    for (i = 0; i < size / sizeof(ul); i += 2) {
+        p1[i] = p2[i] = even;
+        p1[i + 1] = p2[i + 1] = odd;
+    }
+    __asm__ volatile("" ::: "memory");
+}
+
+static KERNEL void seq_q(ulv *bufa, ulv *bufb, size_t size, ul start) {
+    ul *p1 = (ul *) bufa;
+    ul *p2 = (ul *) bufb;
+    size_t i;
+
+    for (i = 0; i < size / sizeof(ul); i++) {
+        p1[i] = p2[i] = i + start;
+    }
+    __asm__ volatile("" ::: "memory");
+}
+
+static KERNEL size_t compare_q(ulv *bufa, ulv *bufb, size_t size) {
+    const ul *p1 = (const ul *) bufa;
+    const ul *p2 = (const ul *) bufb;
+    size_t offs, i;
+
+    for (offs = 0; offs < size; offs += 64) {
+        ul diff = 0;
+        for (i = 0; i < 64 / sizeof(ul); i++) {
+            diff |= p1[i] ^ p2[i];
+        }
+        if (diff) {
+            break;
+        }
+        p1 += 64 / sizeof(ul);
+        p2 += 64 / sizeof(ul);
+    }
+    return offs;
+}
+
+#define RMW_KERNEL(name, op) \
+    static KERNEL void name(ulv *buf, size_t size, ul q) { \
+        ul *p = (ul *) buf; \
+        size_t i; \
+        for (i = 0; i < size / sizeof(ul); i++) { \
+            p[i] op q; \
+        } \
+        __asm__ volatile("" ::: "memory"); \
+    }
+
+RMW_KERNEL(xor_q, ^=)
+RMW_KERNEL(sub_q, -=)
+RMW_KERNEL(or_q, |=)
+RMW_KERNEL(and_q, &=)
+#endif
+
+/* Helpers: the kernels handle whole 64 byte blocks, the scalar code the tail. */
+
+static size_t vector_bytes(size_t count) {
+    return (count * sizeof(ul)) & ~BLOCK_MASK;
+}
+
+int compare_regions_neon(ulv *bufa, ulv *bufb, size_t count) {
+    size_t bytes = vector_bytes(count);
+    size_t offs = bytes ? compare_q(bufa, bufb, bytes) : 0;
+    size_t i = offs / sizeof(ul);
+
+    if (offs < bytes) {
+        /* Rescan from the failing block so the failure is reported,
+         * but fail even if the error didn't show up a second time */
+        compare_regions(bufa + i, bufb + i, count - i);
+        return -1;
+    }
+    return compare_regions(bufa + i, bufb + i, count - i);
+}
+
+static void neon_fill(ulv *bufa, ulv *bufb, size_t count, ul even, ul odd) {
+    size_t bytes = vector_bytes(count);
+    size_t i;
+
+    if (bytes) {
+        fill_q(bufa, bufb, bytes, even, odd);
+    }
+    for (i = bytes / sizeof(ul); i < count; i++) {
+        bufa[i] = bufb[i] = (i % 2) == 0 ? even : odd;
+    }
+}
+
+/* Read-modify-write tests: the same op is applied to both buffers with q */
+#define RMW_TEST(name, kernel, op) \
+    int name(ulv *bufa, ulv *bufb, size_t count) { \
+        size_t bytes = vector_bytes(count); \
+        size_t i; \
+        ul q = rand_ul(); \
+        if (bytes) { \
+            kernel(bufa, bytes, q); \
+            kernel(bufb, bytes, q); \
+        } \
+        for (i = bytes / sizeof(ul); i < count; i++) { \
+            bufa[i] op q; \
+            bufb[i] op q; \
+        } \
+        return compare_regions_neon(bufa, bufb, count); \
+    }
+
+/* Function definitions. */
+
+int test_random_value_neon(ulv *bufa, ulv *bufb, size_t count) {
+    ulv *p1 = bufa;
+    ulv *p2 = bufb;
+    size_t i;
+
+    /* rand_ul() is the bottleneck here, only the compare is vectorised */
+    for (i = 0; i < count; i++) {
+        *p1++ = *p2++ = rand_ul();
+    }
+    return compare_regions_neon(bufa, bufb, count);
+}
+
+RMW_TEST(test_xor_comparison_neon, xor_q, ^=)
+RMW_TEST(test_sub_comparison_neon, sub_q, -=)
+RMW_TEST(test_or_comparison_neon, or_q, |=)
+RMW_TEST(test_and_comparison_neon, and_q, &=)
+
+/* NEON has no 64-bit lane multiply or divide, keep the scalar ops */
+
+int test_mul_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    ulv *p1 = bufa;
+    ulv *p2 = bufb;
+    size_t i;
+    ul q = rand_ul();
+
+    for (i = 0; i < count; i++) {
+        *p1++ *= q;
+        *p2++ *= q;
+    }
+    return compare_regions_neon(bufa, bufb, count);
+}
+
+int test_div_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    ulv *p1 = bufa;
+    ulv *p2 = bufb;
+    size_t i;
+    ul q = rand_ul();
+
+    for (i = 0; i < count; i++) {
+        if (!q) {
+            q++;
+        }
+        *p1++ /= q;
+        *p2++ /= q;
+    }
+    return compare_regions_neon(bufa, bufb, count);
+}
+
+int test_seqinc_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    size_t bytes = vector_bytes(count);
+    size_t i;
+    ul q = rand_ul();
+
+    if (bytes) {
+        seq_q(bufa, bufb, bytes, q);
+    }
+    for (i = bytes / sizeof(ul); i < count; i++) {
+        bufa[i] = bufb[i] = (i + q);
+    }
+    return compare_regions_neon(bufa, bufb, count);
+}
+
+int test_solidbits_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    unsigned int j;
+    ul q;
+
+    for (j = 0; j < (64 / dividend / dividend); j++) {
+        q = (j % 2) == 0 ? UL_ONEBITS : 0;
+        neon_fill(bufa, bufb, count, q, ~q);
+        if (compare_regions_neon(bufa, bufb, count)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int test_checkerboard_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    unsigned int j;
+    ul q;
+
+    for (j = 0; j < (64 / dividend / dividend); j++) {
+        q = (j % 2) == 0 ? CHECKERBOARD1 : CHECKERBOARD2;
+        neon_fill(bufa, bufb, count, q, ~q);
+        if (compare_regions_neon(bufa, bufb, count)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int test_blockseq_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    unsigned int j;
+
+    for (j = 0; j < (64 / dividend / dividend); j++) {
+        neon_fill(bufa, bufb, count, (ul) UL_BYTE(j), (ul) UL_BYTE(j));
+        if (compare_regions_neon(bufa, bufb, count)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int test_walkbits0_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    unsigned int j;
+    ul q;
+
+    for (j = 0; j < (UL_LEN * 2 / dividend / dividend); j++) {
+        if (j < UL_LEN) { /* Walk it up. */
+            q = ONE << j;
+        } else { /* Walk it back down. */
+            q = ONE << (UL_LEN * 2 - j - 1);
+        }
+        neon_fill(bufa, bufb, count, q, q);
+        if (compare_regions_neon(bufa, bufb, count)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int test_walkbits1_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    unsigned int j;
+    ul q;
+
+    for (j = 0; j < (UL_LEN * 2 / dividend / dividend); j++) {
+        if (j < UL_LEN) { /* Walk it up. */
+            q = UL_ONEBITS ^ (ONE << j);
+        } else { /* Walk it back down. */
+            q = UL_ONEBITS ^ (ONE << (UL_LEN * 2 - j - 1));
+        }
+        neon_fill(bufa, bufb, count, q, q);
+        if (compare_regions_neon(bufa, bufb, count)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int test_bitspread_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    unsigned int j;
+    ul q;
+
+    for (j = 0; j < (UL_LEN * 2 / dividend / dividend); j++) {
+        if (j < UL_LEN) { /* Walk it up. */
+            q = (ONE << j) | (ONE << (j + 2));
+        } else { /* Walk it back down. */
+            q = (ONE << (UL_LEN * 2 - 1 - j)) | (ONE << (UL_LEN * 2 + 1 - j));
+        }
+        neon_fill(bufa, bufb, count, q, UL_ONEBITS ^ q);
+        if (compare_regions_neon(bufa, bufb, count)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int test_bitflip_comparison_neon(ulv *bufa, ulv *bufb, size_t count) {
+    unsigned int j, k;
+    ul q;
+
+    for (k = 0; k < (UL_LEN / dividend / dividend); k++) {
+        q = ONE << k;
+        for (j = 0; j < 8; j++) {
+            q = ~q;
+            neon_fill(bufa, bufb, count, q, ~q);
+            if (compare_regions_neon(bufa, bufb, count)) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Same names and order as tests[], so the two tables can be run side by side */
+struct test tests_neon[] = {
+    { "Random Value", test_random_value_neon },
+    { "Compare XOR", test_xor_comparison_neon },
+    { "Compare SUB", test_sub_comparison_neon },
+    { "Compare MUL", test_mul_comparison_neon },
+    { "Compare DIV", test_div_comparison_neon },
+    { "Compare OR", test_or_comparison_neon },
+    { "Compare AND", test_and_comparison_neon },
+    { "Sequential Increment", test_seqinc_comparison_neon },
+    { "Solid Bits", test_solidbits_comparison_neon },
+    { "Block Sequential", test_blockseq_comparison_neon },
+    { "Checkerboard", test_checkerboard_comparison_neon },
+    { "Bit Spread", test_bitspread_comparison_neon },
+    { "Bit Flip (Slow)", test_bitflip_comparison_neon },
+    { "Walking Ones", test_walkbits1_comparison_neon },
+    { "Walking Zeroes", test_walkbits0_comparison_neon },
+#ifdef TEST_NARROW_WRITES    
+    { "8-bit Writes", test_8bit_wide_random },
+    { "16-bit Writes", test_16bit_wide_random },
+#endif
+    { NULL, NULL }
+};
@@ -23,7 +23,6 @@
 #include "types.h"
 #include "sizes.h"
 #include "memtester.h"
-#include <switch.h>
 
 extern unsigned short dividend;
 
@@ -42,6 +41,30 @@ union {
     ul val;
 } mword16;
 
+_Thread_local struct fail_log *test_fail_log = NULL;
+
+void fail_log_reset(struct fail_log *log) {
+    log->count = 0;
+    log->mask = 0;
+}
+
+static void fail_log_add(ulv *addr_a, ulv *addr_b, ul value_a, ul value_b) {
+    struct fail_log *log = test_fail_log;
+
+    if (!log)
+        return;
+
+    if (log->count < FAIL_LOG_MAX) {
+        struct fail_record *r = &log->records[log->count];
+        r->addr_a = addr_a;
+        r->addr_b = addr_b;
+        r->value_a = value_a;
+        r->value_b = value_b;
+    }
+    log->count++;
+    log->mask |= value_a ^ value_b;
+}
+
 /* Function definitions. */
 
 int compare_regions(ulv *bufa, ulv *bufb, size_t count) {
@@ -52,7 +75,9 @@ int compare_regions(ulv *bufa, ulv *bufb, size_t count) {
     // off_t physaddr;
 
     for (i = 0; i < count; i++, p1++, p2++) {
-        if (*p1 != *p2) {
+        ul a = *p1, b = *p2;
+        if (a != b) {
+            fail_log_add(p1, p2, a, b);
             // if (use_phys) {
                 // physaddr = physaddrbase + (i * sizeof(ul));
                 // printf("FAILURE: 0x%08lx != 0x%08lx at physical address 0x%08lx.\n", (ul) *p1, (ul) *p2, physaddr);
@@ -85,7 +110,10 @@ int test_stuck_address(ulv *bufa, size_t count) {
         // printf("testing %3u", j);
         p1 = (ulv *) bufa;
         for (i = 0; i < count; i++, p1++) {
-            if (*p1 != (((j + i) % 2) == 0 ? (ul) p1 : ~((ul) p1))) {
+            ul expect = ((j + i) % 2) == 0 ? (ul) p1 : ~((ul) p1);
+            ul got = *p1;
+            if (got != expect) {
+                fail_log_add(p1, NULL, got, expect);
                 // if (use_phys) {
                 //     physaddr = physaddrbase + (i * sizeof(ul));
                     // printf("FAILURE: possible bad address line at physical address 0x%08lx.\n", physaddr);
@@ -530,3 +558,34 @@ int test_16bit_wide_random(ulv* bufa, ulv* bufb, size_t count) {
     return 0;
 }
 #endif
+
+struct test tests[] = {
+    { "Random Value", test_random_value },
+    { "Compare XOR", test_xor_comparison },
+    { "Compare SUB", test_sub_comparison },
+    { "Compare MUL", test_mul_comparison },
+    { "Compare DIV", test_div_comparison },
+    { "Compare OR", test_or_comparison },
+    { "Compare AND", test_and_comparison },
+    { "Sequential Increment", test_seqinc_comparison },
+    { "Solid Bits", test_solidbits_comparison },
+    { "Block Sequential", test_blockseq_comparison },
+    { "Checkerboard", test_checkerboard_comparison },
+    { "Bit Spread", test_bitspread_comparison },
+    { "Bit Flip (Slow)", test_bitflip_comparison },
+    { "Walking Ones", test_walkbits1_comparison },
+    { "Walking Zeroes", test_walkbits0_comparison },
+#ifdef TEST_NARROW_WRITES    
+    { "8-bit Writes", test_8bit_wide_random },
+    { "16-bit Writes", test_16bit_wide_random },
+#endif
+    { NULL, NULL }
+};
+
+struct test stress_tests[] = {
+    { "Stress memcpy x128", test_stress_memcpy },
+    { "Stress memset x128", test_stress_memset },
+    { "Stress memcmp x 32", test_stress_memcmp },
+    { NULL, NULL }
+};
+
@@ -14,8 +14,38 @@
  *
  */
 
+#ifndef MEMTESTER_TESTS_H
+#define MEMTESTER_TESTS_H
+
+#include <stddef.h>
+
+#include "types.h"
+
+/* Failures seen by compare_regions() and test_stuck_address(). Each worker
+ * thread points test_fail_log at its own log, NULL disables logging. */
+#define FAIL_LOG_MAX 16
+
+struct fail_record {
+    ulv *addr_a;    /* word in the first buffer (or the stuck address) */
+    ulv *addr_b;    /* matching word in the second buffer, NULL for stuck address */
+    ul value_a;
+    ul value_b;     /* value read from addr_b, or the expected value */
+};
+
+struct fail_log {
+    size_t count;   /* total mismatches, only the first FAIL_LOG_MAX are recorded */
+    ul mask;        /* every bit that ever differed */
+    struct fail_record records[FAIL_LOG_MAX];
+};
+
+extern _Thread_local struct fail_log *test_fail_log;
+
+void fail_log_reset(struct fail_log *log);
+
 /* Function declaration. */
 
+int compare_regions(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int compare_regions_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
 int test_stuck_address(unsigned long volatile *bufa, size_t count);
 int test_random_value(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
 int test_xor_comparison(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
@@ -39,4 +69,28 @@ int test_16bit_wide_random(unsigned long volatile *bufa, unsigned long volatile
 
 int test_stress_memcpy(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
 int test_stress_memset(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
-int test_stress_memcmp(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
\ No newline at end of file
+int test_stress_memcmp(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+
+/* NEON versions, see tests-neon.c. */
+int test_random_value_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_xor_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_sub_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_mul_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_div_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_or_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_and_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_seqinc_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_solidbits_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_checkerboard_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_blockseq_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_walkbits0_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_walkbits1_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_bitspread_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+int test_bitflip_comparison_neon(unsigned long volatile *bufa, unsigned long volatile *bufb, size_t count);
+
+/* Test tables, terminated by a NULL entry. */
+extern struct test tests[];
+extern struct test tests_neon[];
+extern struct test stress_tests[];
+
+#endif
@@ -12,6 +12,9 @@
  *
  */
 
+#ifndef MEMTESTER_TYPES_H
+#define MEMTESTER_TYPES_H
+
 #include "sizes.h"
 
 typedef unsigned long ul;
@@ -24,3 +27,5 @@ struct test {
     char *name;
     int (*fp)();
 };
+
+#endif
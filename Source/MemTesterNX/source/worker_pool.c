@@ -0,0 +1,276 @@
+/*
+ * MemTesterNX worker pool
+ *
+ * Builds against libnx primitives on the Switch and against pthreads
+ * everywhere else, so the test core can be benchmarked on a Linux host.
+ *
+ * Licensed under the terms of the GNU General Public License version 2 (only).
+ * See the file COPYING for details.
+ *
+ */
+
+#if !defined(__SWITCH__) && defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "worker_pool.h"
+#include "tests.h"
+#include "memtester.h"
+
+#ifdef __SWITCH__
+#include <switch.h>
+
+typedef Mutex   pool_mutex_t;
+typedef CondVar pool_cond_t;
+typedef Thread  pool_thread_t;
+
+#define pool_mutex_init(m)      mutexInit(m)
+#define pool_lock(m)            mutexLock(m)
+#define pool_unlock(m)          mutexUnlock(m)
+#define pool_cond_init(c)       condvarInit(c)
+#define pool_cond_wait(c, m)    condvarWait(c, m)
+#define pool_cond_signal(c)     condvarWakeOne(c)
+#define pool_cond_broadcast(c)  condvarWakeAll(c)
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+typedef pthread_mutex_t pool_mutex_t;
+typedef pthread_cond_t  pool_cond_t;
+typedef pthread_t       pool_thread_t;
+
+#define pool_mutex_init(m)      pthread_mutex_init(m, NULL)
+#define pool_lock(m)            pthread_mutex_lock(m)
+#define pool_unlock(m)          pthread_mutex_unlock(m)
+#define pool_cond_init(c)       pthread_cond_init(c, NULL)
+#define pool_cond_wait(c, m)    pthread_cond_wait(c, m)
+#define pool_cond_signal(c)     pthread_cond_signal(c)
+#define pool_cond_broadcast(c)  pthread_cond_broadcast(c)
+#endif
+
+struct pool_worker {
+    int id;
+    ulv *base;
+    size_t bytes;
+    pool_thread_t thread;
+    struct pool_report report;
+};
+
+static struct {
+    pool_mutex_t lock;
+    pool_cond_t start;      /* main -> workers: a new phase is available */
+    pool_cond_t done;       /* last worker -> main: phase barrier reached */
+    unsigned generation;    /* bumped once per phase */
+    int pending;            /* workers still running the current phase */
+    int quit;
+    int count;
+    const struct test *phase;
+    struct pool_worker workers[POOL_MAX_WORKERS];
+} g_pool;
+
+static void pool_worker_loop(struct pool_worker *w)
+{
+    unsigned seen = 0;
+
+    test_fail_log = &w->report.failures;
+
+    while (1)
+    {
+        pool_lock(&g_pool.lock);
+        while (g_pool.generation == seen && !g_pool.quit)
+            pool_cond_wait(&g_pool.start, &g_pool.lock);
+
+        if (g_pool.quit)
+        {
+            pool_unlock(&g_pool.lock);
+            return;
+        }
+
+        seen = g_pool.generation;
+        const struct test *t = g_pool.phase;
+        pool_unlock(&g_pool.lock);
+
+        fail_log_reset(&w->report.failures);
+
+        double start = gettime();
+        int rc;
+        if (!t)
+        {
+            /* bytes is in bytes, test_stuck_address expects count in ul units */
+            rc = test_stuck_address(w->base, w->bytes / sizeof(ul));
+        }
+        else
+        {
+            ulv *second = (ulv *)((size_t)w->base + w->bytes / 2);
+            rc = t->fp(w->base, second, (w->bytes / sizeof(ul)) / 2);
+        }
+        double seconds = gettime() - start;
+
+        pool_lock(&g_pool.lock);
+        w->report.rc = rc ? -1 : 0;
+        w->report.seconds = seconds;
+        w->report.gbps = seconds > 0. ? (double)w->bytes / seconds / 1000000000. : 0.;
+        if (--g_pool.pending == 0)
+            pool_cond_signal(&g_pool.done);
+        pool_unlock(&g_pool.lock);
+    }
+}
+
+#ifdef __SWITCH__
+static void pool_worker_entry(void *arg)
+{
+    pool_worker_loop((struct pool_worker *)arg);
+}
+
+static int pool_start_thread(struct pool_worker *w)
+{
+    /* Cores 0-2 are ours, the fourth worker floats on the default core */
+    int cpuid = w->id < 3 ? w->id : -2;
+    Result rc = threadCreate(&w->thread, pool_worker_entry, w, NULL, POOL_STACK_SIZE, 0x2C, cpuid);
+    if (R_FAILED(rc))
+    {
+        printf("Fatal: threadCreate[%d] failed: 0x%X\n", w->id, rc);
+        return -1;
+    }
+
+    rc = threadStart(&w->thread);
+    if (R_FAILED(rc))
+    {
+        printf("Fatal: threadStart[%d] failed: 0x%X\n", w->id, rc);
+        threadClose(&w->thread);
+        return -1;
+    }
+    return 0;
+}
+
+static void pool_join_thread(struct pool_worker *w)
+{
+    threadWaitForExit(&w->thread);
+    threadClose(&w->thread);
+}
+#else
+static void *pool_worker_entry(void *arg)
+{
+    pool_worker_loop((struct pool_worker *)arg);
+    return NULL;
+}
+
+static int pool_start_thread(struct pool_worker *w)
+{
+    int rc = pthread_create(&w->thread, NULL, pool_worker_entry, w);
+    if (rc)
+    {
+        printf("Fatal: pthread_create[%d] failed: %d\n", w->id, rc);
+        return -1;
+    }
+
+#ifdef __linux__
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(w->id % cpus, &set);
+        pthread_setaffinity_np(w->thread, sizeof(set), &set);
+    }
+#endif
+    return 0;
+}
+
+static void pool_join_thread(struct pool_worker *w)
+{
+    pthread_join(w->thread, NULL);
+}
+#endif
+
+int pool_init(int workers, ulv **regions, size_t *bytes)
+{
+    if (workers > POOL_MAX_WORKERS)
+        workers = POOL_MAX_WORKERS;
+
+    memset(&g_pool, 0, sizeof(g_pool));
+    pool_mutex_init(&g_pool.lock);
+    pool_cond_init(&g_pool.start);
+    pool_cond_init(&g_pool.done);
+
+    for (int i = 0; i < workers; i++)
+    {
+        struct pool_worker *w = &g_pool.workers[g_pool.count];
+        w->id = g_pool.count;
+        w->base = regions[i];
+        w->bytes = bytes[i];
+
+        if (pool_start_thread(w))
+        {
+            pool_exit();
+            break;
+        }
+
+        g_pool.count++;
+    }
+
+    return g_pool.count;
+}
+
+int pool_run(const struct test *t)
+{
+    int failed = 0;
+
+    pool_lock(&g_pool.lock);
+    g_pool.phase = t;
+    g_pool.pending = g_pool.count;
+    g_pool.generation++;
+    pool_cond_broadcast(&g_pool.start);
+
+    while (g_pool.pending)
+        pool_cond_wait(&g_pool.done, &g_pool.lock);
+
+    for (int i = 0; i < g_pool.count; i++)
+    {
+        if (g_pool.workers[i].report.rc)
+            failed++;
+    }
+    pool_unlock(&g_pool.lock);
+
+    return failed;
+}
+
+const struct pool_report *pool_get_report(int worker)
+{
+    return &g_pool.workers[worker].report;
+}
+
+ulv *pool_get_base(int worker)
+{
+    return g_pool.workers[worker].base;
+}
+
+double pool_total_gbps(void)
+{
+    double total = 0.;
+    for (int i = 0; i < g_pool.count; i++)
+        total += g_pool.workers[i].report.gbps;
+    return total;
+}
+
+int pool_workers(void)
+{
+    return g_pool.count;
+}
+
+void pool_exit(void)
+{
+    pool_lock(&g_pool.lock);
+    g_pool.quit = 1;
+    pool_cond_broadcast(&g_pool.start);
+    pool_unlock(&g_pool.lock);
+
+    for (int i = 0; i < g_pool.count; i++)
+        pool_join_thread(&g_pool.workers[i]);
+
+    g_pool.count = 0;
+}
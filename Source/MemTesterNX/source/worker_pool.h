@@ -0,0 +1,59 @@
+/*
+ * MemTesterNX worker pool
+ *
+ * Persistent test workers, one per core, driven phase by phase from the
+ * main thread. Each phase is started with a condition variable broadcast
+ * and ends on a barrier: the last worker to finish wakes the main thread,
+ * so no thread ever polls.
+ *
+ * Licensed under the terms of the GNU General Public License version 2 (only).
+ * See the file COPYING for details.
+ *
+ */
+
+#ifndef MEMTESTER_WORKER_POOL_H
+#define MEMTESTER_WORKER_POOL_H
+
+#include <stddef.h>
+
+#include "types.h"
+#include "tests.h"
+
+#define POOL_MAX_WORKERS  4
+#define POOL_STACK_SIZE   0x4000
+
+struct pool_report {
+    int rc;         /* 0 on success, -1 if the worker detected an error */
+    double seconds; /* wall time spent in the last phase */
+    double gbps;    /* region throughput: region size / seconds, in GB/s (1GB = 10^9 bytes).
+                     * The tests make several passes over the region, so the bytes actually
+                     * moved are a multiple of this. Compare it across clocks or kernels for
+                     * the same test, not across tests. */
+    struct fail_log failures;   /* mismatches seen in the last phase */
+};
+
+/* Creates and starts `workers` threads, worker i testing regions[i] of bytes[i].
+ * Returns the number of workers started: all of them, or 0 if one could not be
+ * started, in which case the ones already running are stopped and joined. */
+int pool_init(int workers, ulv **regions, size_t *bytes);
+
+/* Runs one phase on every worker and waits for all of them to finish.
+ * A NULL test runs the stuck address test over the whole region, otherwise
+ * the test is given both halves of the region.
+ * Returns the number of workers which reported an error. */
+int pool_run(const struct test *t);
+
+const struct pool_report *pool_get_report(int worker);
+
+/* Start of the region tested by a worker. */
+ulv *pool_get_base(int worker);
+
+/* Sum of all workers' region throughput for the last phase. */
+double pool_total_gbps(void);
+
+int pool_workers(void);
+
+/* Stops and joins all workers. */
+void pool_exit(void);
+
+#endif
@@ -4,7 +4,9 @@
  */
 
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include "kip_schema.hpp"
 
 class KipHandler;
 
@@ -12,7 +14,7 @@ class Defaults {
 public:
     template<typename T>
     static void initDefaults(T& data) {
-        data.custRev = 0;
+        data.custRev = KIP_SCHEMA_REV;
         data.mtcConf = 0;
         data.commonCpuBoostClock = 1785000;
         data.commonEmcMemVolt = 1175000;
@@ -26,7 +28,7 @@ public:
         data.eristaCpuUV = 0;
         data.eristaGpuUV = 0;
         data.commonGpuVoltOffset = 0;
-        data.marikoEmcDvbShift = 0;
+        data.EmcDvbShift = 0;
         
         // Memory timings
         data.t1_tRCD = 0;
@@ -40,51 +42,29 @@ public:
         data.mem_burst_latency = 2;
         
         // Additional voltages
-        data.marikoCpuVmin = 0;
+        data.marikoCpuHighVmin = 0;
+        data.marikoCpuLowVmin = 0;
         data.eristaGpuVmin = 0;
         data.marikoGpuVmin = 0;
         data.marikoGpuVmax = 0;
         
-        // Initialize all GPU voltages to 600 (default safe value)
-        data.g_volt_76800 = 600;
-        data.g_volt_153600 = 600;
-        data.g_volt_230400 = 600;
-        data.g_volt_307200 = 600;
-        data.g_volt_384000 = 600;
-        data.g_volt_460800 = 600;
-        data.g_volt_537600 = 600;
-        data.g_volt_614400 = 600;
-        data.g_volt_691200 = 600;
-        data.g_volt_768000 = 600;
-        data.g_volt_844800 = 605;
-        data.g_volt_921600 = 635;
-        data.g_volt_998400 = 665;
-        data.g_volt_1075200 = 695;
-        data.g_volt_1152000 = 730;
-        data.g_volt_1228800 = 760;
-        data.g_volt_1267200 = 785;
-        data.g_volt_1305600 = 800;
-        data.g_volt_1344000 = 0;
-        data.g_volt_1382400 = 0;
-        data.g_volt_1420800 = 0;
-        data.g_volt_1459200 = 0;
-        data.g_volt_1497600 = 0;
-        data.g_volt_1536000 = 0;
+        // Mariko GPU voltages, 76.8 MHz to 1536 MHz (600 is the safe floor)
+        static constexpr uint32_t marikoGpuVolts[24] = {
+            600, 600, 600, 600, 600, 600, 600, 600, 600, 600, 605, 635,
+            665, 695, 730, 760, 785, 800, 0, 0, 0, 0, 0, 0,
+        };
         
-        // Erista GPU voltages
-        data.g_volt_e_76800 = 700;
-        data.g_volt_e_153600 = 700;
-        data.g_volt_e_230400 = 700;
-        data.g_volt_e_307200 = 700;
-        data.g_volt_e_384000 = 700;
-        data.g_volt_e_460800 = 700;
-        data.g_volt_e_537600 = 700;
-        data.g_volt_e_614400 = 700;
-        data.g_volt_e_691200 = 700;
-        data.g_volt_e_768000 = 700;
-        data.g_volt_e_844800 = 710;
-        data.g_volt_e_921600 = 740;
-        data.g_volt_e_998400 = 770;
-        data.g_volt_e_1075200 = 800;
+        // Erista GPU voltages, entries past 1075.2 MHz keep the stock table (0)
+        static constexpr uint32_t eristaGpuVolts[27] = {
+            700, 700, 700, 700, 700, 700, 700, 700, 700, 700, 710, 740,
+            770, 800,
+        };
+        
+        for (size_t i = 0; i < sizeof(marikoGpuVolts) / sizeof(marikoGpuVolts[0]); i++) {
+            data.marikoGpuVoltArray[i] = marikoGpuVolts[i];
+        }
+        for (size_t i = 0; i < sizeof(eristaGpuVolts) / sizeof(eristaGpuVolts[0]); i++) {
+            data.eristaGpuVoltArray[i] = eristaGpuVolts[i];
+        }
     }
 };
\ No newline at end of file
@@ -0,0 +1,82 @@
+/*
+ * HOC Configurator - KIP Field Schema
+ * Copyright (C) Dominatorul, Souldbminer
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Layout revision of the table below, has to match CUST_REV in the loader
+#define KIP_SCHEMA_REV 11
+
+// The CustomizeTable fields following the CUST magic, in order, as defined in
+// Atmosphere/stratosphere/loader/source/oc/customize.hpp. The DVFS tables after
+// the GPU volt arrays are left alone. Every field is a little endian u32.
+// KipData and the field table are both generated from this list, so keep it
+// in sync with the loader and nothing else needs to change.
+#define KIP_SCHEMA(FIELD, ARRAY)            \
+    FIELD(custRev)                          \
+    FIELD(mtcConf)                          \
+    FIELD(commonCpuBoostClock)              \
+    FIELD(commonEmcMemVolt)                 \
+    FIELD(eristaCpuMaxVolt)                 \
+    FIELD(eristaEmcMaxClock)                \
+    FIELD(marikoCpuMaxVolt)                 \
+    FIELD(marikoEmcMaxClock)                \
+    FIELD(marikoEmcVddqVolt)                \
+    FIELD(marikoCpuUV)                      \
+    FIELD(marikoGpuUV)                      \
+    FIELD(eristaCpuUV)                      \
+    FIELD(eristaGpuUV)                      \
+    FIELD(commonGpuVoltOffset)              \
+    FIELD(EmcDvbShift)                      \
+    FIELD(t1_tRCD)                          \
+    FIELD(t2_tRP)                           \
+    FIELD(t3_tRAS)                          \
+    FIELD(t4_tRRD)                          \
+    FIELD(t5_tRFC)                          \
+    FIELD(t6_tRTW)                          \
+    FIELD(t7_tWTR)                          \
+    FIELD(t8_tREFI)                         \
+    FIELD(mem_burst_latency)                \
+    FIELD(marikoCpuHighVmin)                \
+    FIELD(marikoCpuLowVmin)                 \
+    FIELD(eristaGpuVmin)                    \
+    FIELD(marikoGpuVmin)                    \
+    FIELD(marikoGpuVmax)                    \
+    ARRAY(marikoGpuVoltArray, 24)           \
+    ARRAY(eristaGpuVoltArray, 27)
+
+// Byte for byte image of the table in the KIP, so it is read and written as is
+struct KipData {
+#define KIP_DECLARE_FIELD(name) uint32_t name;
+#define KIP_DECLARE_ARRAY(name, count) uint32_t name[count];
+    KIP_SCHEMA(KIP_DECLARE_FIELD, KIP_DECLARE_ARRAY)
+#undef KIP_DECLARE_FIELD
+#undef KIP_DECLARE_ARRAY
+};
+
+struct KipField {
+    const char* name;
+    uint32_t offset;    // bytes from custRev
+    uint32_t count;     // u32 words
+};
+
+inline constexpr KipField KIP_FIELDS[] = {
+#define KIP_DESCRIBE_FIELD(name) { #name, offsetof(KipData, name), 1 },
+#define KIP_DESCRIBE_ARRAY(name, count) { #name, offsetof(KipData, name), count },
+    KIP_SCHEMA(KIP_DESCRIBE_FIELD, KIP_DESCRIBE_ARRAY)
+#undef KIP_DESCRIBE_FIELD
+#undef KIP_DESCRIBE_ARRAY
+};
+
+constexpr size_t kipSchemaWords() {
+    size_t words = 0;
+    for (const auto& field : KIP_FIELDS) {
+        words += field.count;
+    }
+    return words;
+}
+
+static_assert(sizeof(KipData) == kipSchemaWords() * sizeof(uint32_t), "KipData must not have padding");
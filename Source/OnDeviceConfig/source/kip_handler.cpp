@@ -4,243 +4,147 @@
  */
 
 #include "kip_handler.hpp"
-#include <fstream>
 #include <cstring>
-#include <vector>
 
-bool KipHandler::readKip() {
-    std::ifstream file(kipPath, std::ios::binary);
-    if (!file.is_open()) {
-        return false;
+namespace {
+    constexpr size_t SCAN_CHUNK = 0x4000;
+}
+
+// Scans the file for the CUST magic a chunk at a time, returns the offset
+// just after it or -1
+long KipHandler::findTable(FILE* file) {
+    static uint8_t chunk[SCAN_CHUNK + sizeof(MAGIC) - 1];
+    size_t carry = 0;
+    long base = 0;
+    
+    if (fseek(file, 0, SEEK_SET) != 0) {
+        return -1;
     }
     
-    // Read entire file
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    std::vector<uint8_t> buffer(fileSize);
-    file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
-    file.close();
-    
-    // Find CUST magic
-    size_t magicPos = 0;
-    bool found = false;
-    for (size_t i = 0; i < fileSize - 4; i++) {
-        if (memcmp(&buffer[i], MAGIC, 4) == 0) {
-            magicPos = i + 4;
-            found = true;
-            break;
+    while (true) {
+        size_t got = fread(chunk + carry, 1, SCAN_CHUNK, file);
+        size_t len = carry + got;
+        if (len < sizeof(MAGIC)) {
+            return -1;
         }
+        
+        const uint8_t* p = chunk;
+        const uint8_t* end = chunk + len - sizeof(MAGIC) + 1;
+        while ((p = (const uint8_t*)memchr(p, MAGIC[0], end - p)) != nullptr) {
+            if (memcmp(p, MAGIC, sizeof(MAGIC)) == 0) {
+                return base + (long)(p - chunk) + (long)sizeof(MAGIC);
+            }
+            p++;
+        }
+        
+        if (got < SCAN_CHUNK) {
+            return -1;
+        }
+        
+        // Keep the tail in case the magic straddles two chunks
+        carry = sizeof(MAGIC) - 1;
+        memmove(chunk, chunk + len - carry, carry);
+        base += (long)(len - carry);
     }
+}
+
+// Checks the magic is still where it was found last time
+bool KipHandler::checkTable(FILE* file) {
+    uint8_t magic[sizeof(MAGIC)];
     
-    if (!found) {
+    if (tableOffset < (long)sizeof(MAGIC) ||
+        fseek(file, tableOffset - (long)sizeof(MAGIC), SEEK_SET) != 0 ||
+        fread(magic, 1, sizeof(magic), file) != sizeof(magic)) {
+        return false;
+    }
+    return memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool KipHandler::readKip() {
+    FILE* file = fopen(kipPath.c_str(), "rb");
+    if (!file) {
+        error = "Can't open " + kipPath;
         return false;
     }
     
-    // Read structure (assuming packed uint32_t structure)
-    size_t offset = magicPos;
-    auto readU32 = [&]() -> uint32_t {
-        uint32_t val;
-        memcpy(&val, &buffer[offset], sizeof(uint32_t));
-        offset += sizeof(uint32_t);
-        return val;
-    };
-    
-    data.custRev = readU32();
-    data.mtcConf = readU32();
-    data.commonCpuBoostClock = readU32();
-    data.commonEmcMemVolt = readU32();
-    data.eristaCpuMaxVolt = readU32();
-    data.eristaEmcMaxClock = readU32();
-    data.marikoCpuMaxVolt = readU32();
-    data.marikoEmcMaxClock = readU32();
-    data.marikoEmcVddqVolt = readU32();
-    data.marikoCpuUV = readU32();
-    data.marikoGpuUV = readU32();
-    data.eristaCpuUV = readU32();
-    data.eristaGpuUV = readU32();
-    data.commonGpuVoltOffset = readU32();
-    data.marikoEmcDvbShift = readU32();
+    if (!checkTable(file)) {
+        tableOffset = findTable(file);
+    }
     
-    // Memory timings
-    data.t1_tRCD = readU32();
-    data.t2_tRP = readU32();
-    data.t3_tRAS = readU32();
-    data.t4_tRRD = readU32();
-    data.t5_tRFC = readU32();
-    data.t6_tRTW = readU32();
-    data.t7_tWTR = readU32();
-    data.t8_tREFI = readU32();
-    data.mem_burst_latency = readU32();
+    if (tableOffset < 0) {
+        fclose(file);
+        error = "CUST table not found";
+        return false;
+    }
     
-    // Additional voltages
-    data.marikoCpuVmin = readU32();
-    data.eristaGpuVmin = readU32();
-    data.marikoGpuVmin = readU32();
-    data.marikoGpuVmax = readU32();
+    KipData table;
+    bool ok = fseek(file, tableOffset, SEEK_SET) == 0 &&
+              fread(&table, 1, sizeof(table), file) == sizeof(table);
+    fclose(file);
     
-    // GPU voltages Mariko
-    data.g_volt_76800 = readU32();
-    data.g_volt_153600 = readU32();
-    data.g_volt_230400 = readU32();
-    data.g_volt_307200 = readU32();
-    data.g_volt_384000 = readU32();
-    data.g_volt_460800 = readU32();
-    data.g_volt_537600 = readU32();
-    data.g_volt_614400 = readU32();
-    data.g_volt_691200 = readU32();
-    data.g_volt_768000 = readU32();
-    data.g_volt_844800 = readU32();
-    data.g_volt_921600 = readU32();
-    data.g_volt_998400 = readU32();
-    data.g_volt_1075200 = readU32();
-    data.g_volt_1152000 = readU32();
-    data.g_volt_1228800 = readU32();
-    data.g_volt_1267200 = readU32();
-    data.g_volt_1305600 = readU32();
-    data.g_volt_1344000 = readU32();
-    data.g_volt_1382400 = readU32();
-    data.g_volt_1420800 = readU32();
-    data.g_volt_1459200 = readU32();
-    data.g_volt_1497600 = readU32();
-    data.g_volt_1536000 = readU32();
+    if (!ok) {
+        error = "CUST table is truncated";
+        return false;
+    }
     
-    // GPU voltages Erista
-    data.g_volt_e_76800 = readU32();
-    data.g_volt_e_153600 = readU32();
-    data.g_volt_e_230400 = readU32();
-    data.g_volt_e_307200 = readU32();
-    data.g_volt_e_384000 = readU32();
-    data.g_volt_e_460800 = readU32();
-    data.g_volt_e_537600 = readU32();
-    data.g_volt_e_614400 = readU32();
-    data.g_volt_e_691200 = readU32();
-    data.g_volt_e_768000 = readU32();
-    data.g_volt_e_844800 = readU32();
-    data.g_volt_e_921600 = readU32();
-    data.g_volt_e_998400 = readU32();
-    data.g_volt_e_1075200 = readU32();
+    // Any other revision has a different layout, editing it would corrupt it
+    if (table.custRev != KIP_SCHEMA_REV) {
+        error = "Unsupported CUST revision " + std::to_string(table.custRev) +
+                " (expected " + std::to_string(KIP_SCHEMA_REV) + ")";
+        return false;
+    }
     
+    data = table;
+    onDisk = table;
+    error.clear();
     return true;
 }
 
+bool KipHandler::isDirty() const {
+    return memcmp(&data, &onDisk, sizeof(KipData)) != 0;
+}
+
 bool KipHandler::writeKip() {
-    std::fstream file(kipPath, std::ios::in | std::ios::out | std::ios::binary);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    // Read entire file
-    file.seekg(0, std::ios::end);
-    size_t fileSize = file.tellg();
-    file.seekg(0, std::ios::beg);
-    
-    std::vector<uint8_t> buffer(fileSize);
-    file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+    const uint32_t* now = reinterpret_cast<const uint32_t*>(&data);
+    const uint32_t* was = reinterpret_cast<const uint32_t*>(&onDisk);
+    size_t words = sizeof(KipData) / sizeof(uint32_t);
+    size_t first = 0, last = words;
     
-    // Find CUST magic
-    size_t magicPos = 0;
-    bool found = false;
-    for (size_t i = 0; i < fileSize - 4; i++) {
-        if (memcmp(&buffer[i], MAGIC, 4) == 0) {
-            magicPos = i + 4;
-            found = true;
-            break;
-        }
+    while (first < words && now[first] == was[first]) {
+        first++;
+    }
+    if (first == words) {
+        return true;
+    }
+    while (now[last - 1] == was[last - 1]) {
+        last--;
     }
     
-    if (!found) {
-        file.close();
+    FILE* file = fopen(kipPath.c_str(), "r+b");
+    if (!file) {
+        error = "Can't open " + kipPath;
         return false;
     }
     
-    // Write structure
-    size_t offset = magicPos;
-    auto writeU32 = [&](uint32_t val) {
-        memcpy(&buffer[offset], &val, sizeof(uint32_t));
-        offset += sizeof(uint32_t);
-    };
-    
-    writeU32(data.custRev);
-    writeU32(data.mtcConf);
-    writeU32(data.commonCpuBoostClock);
-    writeU32(data.commonEmcMemVolt);
-    writeU32(data.eristaCpuMaxVolt);
-    writeU32(data.eristaEmcMaxClock);
-    writeU32(data.marikoCpuMaxVolt);
-    writeU32(data.marikoEmcMaxClock);
-    writeU32(data.marikoEmcVddqVolt);
-    writeU32(data.marikoCpuUV);
-    writeU32(data.marikoGpuUV);
-    writeU32(data.eristaCpuUV);
-    writeU32(data.eristaGpuUV);
-    writeU32(data.commonGpuVoltOffset);
-    writeU32(data.marikoEmcDvbShift);
-    
-    // Memory timings
-    writeU32(data.t1_tRCD);
-    writeU32(data.t2_tRP);
-    writeU32(data.t3_tRAS);
-    writeU32(data.t4_tRRD);
-    writeU32(data.t5_tRFC);
-    writeU32(data.t6_tRTW);
-    writeU32(data.t7_tWTR);
-    writeU32(data.t8_tREFI);
-    writeU32(data.mem_burst_latency);
-    
-    // Additional voltages
-    writeU32(data.marikoCpuVmin);
-    writeU32(data.eristaGpuVmin);
-    writeU32(data.marikoGpuVmin);
-    writeU32(data.marikoGpuVmax);
-    
-    // GPU voltages Mariko
-    writeU32(data.g_volt_76800);
-    writeU32(data.g_volt_153600);
-    writeU32(data.g_volt_230400);
-    writeU32(data.g_volt_307200);
-    writeU32(data.g_volt_384000);
-    writeU32(data.g_volt_460800);
-    writeU32(data.g_volt_537600);
-    writeU32(data.g_volt_614400);
-    writeU32(data.g_volt_691200);
-    writeU32(data.g_volt_768000);
-    writeU32(data.g_volt_844800);
-    writeU32(data.g_volt_921600);
-    writeU32(data.g_volt_998400);
-    writeU32(data.g_volt_1075200);
-    writeU32(data.g_volt_1152000);
-    writeU32(data.g_volt_1228800);
-    writeU32(data.g_volt_1267200);
-    writeU32(data.g_volt_1305600);
-    writeU32(data.g_volt_1344000);
-    writeU32(data.g_volt_1382400);
-    writeU32(data.g_volt_1420800);
-    writeU32(data.g_volt_1459200);
-    writeU32(data.g_volt_1497600);
-    writeU32(data.g_volt_1536000);
+    // The KIP may have been replaced since it was read
+    if (!checkTable(file)) {
+        fclose(file);
+        tableOffset = -1;
+        error = "KIP changed on disk, reload it first";
+        return false;
+    }
     
-    // GPU voltages Erista
-    writeU32(data.g_volt_e_76800);
-    writeU32(data.g_volt_e_153600);
-    writeU32(data.g_volt_e_230400);
-    writeU32(data.g_volt_e_307200);
-    writeU32(data.g_volt_e_384000);
-    writeU32(data.g_volt_e_460800);
-    writeU32(data.g_volt_e_537600);
-    writeU32(data.g_volt_e_614400);
-    writeU32(data.g_volt_e_691200);
-    writeU32(data.g_volt_e_768000);
-    writeU32(data.g_volt_e_844800);
-    writeU32(data.g_volt_e_921600);
-    writeU32(data.g_volt_e_998400);
-    writeU32(data.g_volt_e_1075200);
+    size_t bytes = (last - first) * sizeof(uint32_t);
+    bool ok = fseek(file, tableOffset + (long)(first * sizeof(uint32_t)), SEEK_SET) == 0 &&
+              fwrite(now + first, 1, bytes, file) == bytes;
+    ok = (fclose(file) == 0) && ok;
     
-    // Write back to file
-    file.seekp(0, std::ios::beg);
-    file.write(reinterpret_cast<char*>(buffer.data()), fileSize);
-    file.close();
+    if (!ok) {
+        error = "Write to " + kipPath + " failed";
+        return false;
+    }
     
+    memcpy(&onDisk, &data, sizeof(KipData));
+    error.clear();
     return true;
-}
\ No newline at end of file
+}
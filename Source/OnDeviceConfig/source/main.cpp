@@ -50,7 +50,7 @@ int main(int argc, char* argv[]) {
             ui.setStatus("KIP loaded successfully from " + config.kipPath);
             ui.setKipLoaded(true);
         } else {
-            ui.setStatus("ERROR: Failed to parse KIP file!");
+            ui.setStatus("ERROR: Failed to parse KIP file! " + kipHandler->getError());
             ui.setKipLoaded(false);
         }
     } else if (config.checkAtmosphereExists()) {
@@ -143,7 +143,8 @@ void UI::renderCPUMenu() {
     auto& data = kipHandler->getData();
     std::vector<std::string> menuItems = {
         "CPU Boost Frequency: " + std::to_string(data.commonCpuBoostClock / 1000) + " MHz",
-        "Mariko CPU vMin: " + (data.marikoCpuVmin == 0 ? "Default" : std::to_string(data.marikoCpuVmin) + "mV"),
+        "Mariko CPU vMin (High/Low): " + (data.marikoCpuHighVmin == 0 ? std::string("Default") : std::to_string(data.marikoCpuHighVmin) + "mV") +
+            " / " + (data.marikoCpuLowVmin == 0 ? std::string("Default") : std::to_string(data.marikoCpuLowVmin) + "mV"),
         "Mariko CPU vMax: " + (data.marikoCpuMaxVolt == 0 ? "Disabled" : std::to_string(data.marikoCpuMaxVolt) + "mV"),
         "Erista CPU vMax: " + (data.eristaCpuMaxVolt == 0 ? "Disabled" : std::to_string(data.eristaCpuMaxVolt) + "mV"),
         "Mariko CPU Undervolt: UV" + std::to_string(data.marikoCpuUV),
@@ -177,7 +178,7 @@ void UI::renderRAMMenu() {
         "RAM Max Frequency (Erista): " + std::to_string(data.eristaEmcMaxClock / 1000) + " MHz",
         "RAM Primary Voltage (VDD2): " + std::to_string(data.commonEmcMemVolt / 1000) + " mV",
         "RAM Secondary Voltage (VDDQ): " + std::to_string(data.marikoEmcVddqVolt / 1000) + " mV",
-        "SoC DVB Shift: " + std::to_string(data.marikoEmcDvbShift),
+        "SoC DVB Shift: " + std::to_string(data.EmcDvbShift),
         "Base Latency: " + std::to_string(data.mem_burst_latency),
         "t1 tRCD: " + std::to_string(data.t1_tRCD),
         "t2 tRP: " + std::to_string(data.t2_tRP),
@@ -473,10 +474,12 @@ void UI::handleSettingsMenuInput(u64 kDown) {
                 break;
             case 1: // Save KIP Now
                 if (kipHandler && kipLoaded) {
-                    if (kipHandler->writeKip()) {
+                    if (!kipHandler->isDirty()) {
+                        setStatus("No changes to save");
+                    } else if (kipHandler->writeKip()) {
                         setStatus("KIP saved successfully!");
                     } else {
-                        setStatus("ERROR: Failed to save KIP!");
+                        setStatus("ERROR: Failed to save KIP! " + kipHandler->getError());
                     }
                 } else {
                     setStatus("ERROR: No KIP loaded!");
@@ -488,7 +491,7 @@ void UI::handleSettingsMenuInput(u64 kDown) {
                         setStatus("KIP reloaded successfully!");
                         kipLoaded = true;
                     } else {
-                        setStatus("ERROR: Failed to reload KIP!");
+                        setStatus("ERROR: Failed to reload KIP! " + kipHandler->getError());
                         kipLoaded = false;
                     }
                 } else {
@@ -0,0 +1,204 @@
+/*
+ * TinyMemBenchNX host runner
+ *
+ * Runs the benchmark core on a Linux host with the native kernels (the
+ * NEON ones on aarch64 hosts). Clock changes go to the sys-clk manager's
+ * pc_shim, so sweep sequencing and output can be checked off-device.
+ *
+ *   ./tinymembench-host [-t threads] [-b] [-l]
+ *   ./tinymembench-host -s [-c] [-m] [-t min[-max]] [-k kernel]... [-r repeats]
+ *                       [-L latency MB] [-j out.json] [-o out.csv]
+ *   ./tinymembench-host -C [-M max MB] [-S steps] [-r repeats] [-o out.csv]
+ *   ./tinymembench-host -X [-H hogs] [-k kernel]... [-L latency MB] [-o out.csv]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "sweep.h"
+#include "latency_curve.h"
+#include "contention.h"
+
+#define MAX_KERNELS 16
+
+static void usage(const char *me)
+{
+    fprintf(stderr, "usage: %s [-t threads] [-b] [-l]\n"
+                    "       %s -s [-c] [-m] [-t min[-max]] [-k kernel]... [-r repeats] [-L MB] [-j json] [-o csv]\n"
+                    "       %s -C [-M MB] [-S steps] [-r repeats] [-o csv]\n"
+                    "       %s -X [-H hogs] [-k kernel]... [-L MB] [-o csv]\n"
+                    "  -b  bandwidth tests\n"
+                    "  -l  latency test\n"
+                    "  -s  frequency sweep (-c CPU, -m MEM, both by default)\n"
+                    "  -k  sweep kernel by description (default: NEON copy/fills and C copy/fill)\n"
+                    "  -L  sweep latency working set in MB, 0 to skip (default: 64)\n"
+                    "  -C  latency curve from 4KB to -M MB (default: 1024), -S steps per octave\n"
+                    "  -X  latency under 0..-H bandwidth hogs (default: 2) running each -k kernel\n",
+            me, me, me, me);
+}
+
+int main(int argc, char *argv[])
+{
+    int min_threads = 1, max_threads = 3, opt;
+    int bandwidth = 0, latency = 0, sweep = 0, curve = 0, contention = 0;
+    const char *kernels[MAX_KERNELS + 1];
+    int kernel_count = 0;
+    struct sweep_options sw = {
+        .kernels = sweep_default_kernels,
+        .latency_size = 64 * 1024 * 1024,
+        .latency_count = LATBENCH_COUNT / 10,
+        .repeats = 3,
+    };
+    struct latcurve_options lc = {
+        .min_size = 4 * 1024,
+        .max_size = 1024 * 1024 * 1024,
+        .steps_per_octave = 4,
+        .count = 1000000,
+        .repeats = 3,
+    };
+    struct contention_options ct = {
+        .kernels = contention_default_kernels,
+        .max_hogs = 2,
+        .latency_size = 64 * 1024 * 1024,
+        .samples = 20000,
+        .burst = 256,
+    };
+    const char *json = NULL, *csv = NULL;
+
+    while ((opt = getopt(argc, argv, "t:blscmk:r:L:j:o:CM:S:XH:")) != -1)
+    {
+        switch (opt)
+        {
+            case 't':
+                if (sscanf(optarg, "%d-%d", &min_threads, &max_threads) != 2)
+                    max_threads = min_threads = atoi(optarg);
+                break;
+            case 'b': bandwidth = 1; break;
+            case 'l': latency = 1; break;
+            case 's': sweep = 1; break;
+            case 'c': sw.sweep_cpu = true; break;
+            case 'm': sw.sweep_mem = true; break;
+            case 'k':
+                if (kernel_count < MAX_KERNELS)
+                    kernels[kernel_count++] = optarg;
+                break;
+            case 'r': sw.repeats = lc.repeats = atoi(optarg); break;
+            case 'L':
+                sw.latency_size = atoi(optarg) * 1024 * 1024;
+                ct.latency_size = sw.latency_size;
+                break;
+            case 'j': json = optarg; break;
+            case 'o': csv = optarg; break;
+            case 'C': curve = 1; break;
+            case 'M': lc.max_size = (size_t)atoi(optarg) * 1024 * 1024; break;
+            case 'S': lc.steps_per_octave = atoi(optarg); break;
+            case 'X': contention = 1; break;
+            case 'H': ct.max_hogs = atoi(optarg); break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+
+    if (min_threads < 1 || max_threads < min_threads)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (kernel_count)
+    {
+        kernels[kernel_count] = NULL;
+        sw.kernels = ct.kernels = kernels;
+    }
+
+    if (sweep)
+    {
+        if (!sw.sweep_cpu && !sw.sweep_mem)
+            sw.sweep_cpu = sw.sweep_mem = true;
+        sw.min_threads = min_threads;
+        sw.max_threads = max_threads;
+        sw.json = json ? fopen(json, "w") : NULL;
+        sw.csv = csv ? fopen(csv, "w") : NULL;
+        if ((json && !sw.json) || (csv && !sw.csv))
+        {
+            perror("fopen");
+            return 1;
+        }
+
+        sysclkIpcInitialize();
+        Result rc = sweep_run(&sw);
+        sysclkIpcExit();
+        bench_pool_exit();
+
+        if (sw.json)
+            fclose(sw.json);
+        if (sw.csv)
+            fclose(sw.csv);
+        return R_FAILED(rc) ? 1 : 0;
+    }
+
+    if (curve)
+    {
+        lc.csv = csv ? fopen(csv, "w") : NULL;
+        if (csv && !lc.csv)
+        {
+            perror("fopen");
+            return 1;
+        }
+
+        int points = latcurve_run(&lc);
+
+        if (lc.csv)
+            fclose(lc.csv);
+        return points < 0 ? 1 : 0;
+    }
+
+    if (contention)
+    {
+        ct.csv = csv ? fopen(csv, "w") : NULL;
+        if ((csv && !ct.csv) || ct.latency_size <= 0)
+        {
+            perror("fopen");
+            return 1;
+        }
+
+        int rows = contention_run(&ct);
+        bench_pool_exit();
+
+        if (ct.csv)
+            fclose(ct.csv);
+        return rows < 0 ? 1 : 0;
+    }
+
+    if (!bandwidth && !latency)
+        bandwidth = latency = 1;
+
+    if (bandwidth)
+    {
+        int64_t *srcbuf, *dstbuf, *tmpbuf;
+        void *poolbuf = alloc_four_nonaliased_buffers((void **)&srcbuf, SIZE * max_threads,
+                                                      (void **)&dstbuf, SIZE * max_threads,
+                                                      (void **)&tmpbuf, BLOCKSIZE * max_threads,
+                                                      NULL, 0);
+
+        printf("== Thread: %d ==\n", max_threads);
+        bandwidth_bench(max_threads, dstbuf, srcbuf, tmpbuf, SIZE, BLOCKSIZE, " ", c_benchmarks);
+        printf(" ---\n");
+        bandwidth_bench(max_threads, dstbuf, srcbuf, tmpbuf, SIZE, BLOCKSIZE, " ", libc_benchmarks);
+        bench_info *bi = get_asm_benchmarks();
+        if (bi->f)
+        {
+            printf(" ---\n");
+            bandwidth_bench(max_threads, dstbuf, srcbuf, tmpbuf, SIZE, BLOCKSIZE, " ", bi);
+        }
+        free(poolbuf);
+    }
+
+    if (latency)
+        latency_bench(SIZE * 2, LATBENCH_COUNT, 0, 0);
+
+    bench_pool_exit();
+    return 0;
+}
@@ -0,0 +1,894 @@
+/*
+ * Copyright © 2011 Siarhei Siamashka <siarhei.siamashka@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ * 
+ * pthread fork by sun409 (https://github.com/sun409/tinymembench-pthread)
+ *
+ * Switch port by Kazushi and built with libnx.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include "bench.h"
+#include "bench_pool.h"
+#include "aarch64-asm.h"
+
+static char *align_up(char *ptr, int align)
+{
+    return (char *)(((uintptr_t)ptr + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+void aligned_block_copy(int64_t * __restrict dst_,
+                        int64_t * __restrict src,
+                        int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t t1, t2, t3, t4;
+    while ((size -= 64) >= 0)
+    {
+        t1 = *src++;
+        t2 = *src++;
+        t3 = *src++;
+        t4 = *src++;
+        *dst++ = t1;
+        *dst++ = t2;
+        *dst++ = t3;
+        *dst++ = t4;
+        t1 = *src++;
+        t2 = *src++;
+        t3 = *src++;
+        t4 = *src++;
+        *dst++ = t1;
+        *dst++ = t2;
+        *dst++ = t3;
+        *dst++ = t4;
+    }
+}
+
+void aligned_block_copy_backwards(int64_t * __restrict dst_,
+                                  int64_t * __restrict src,
+                                  int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t t1, t2, t3, t4;
+    src += size / 8 - 1;
+    dst += size / 8 - 1;
+    while ((size -= 64) >= 0)
+    {
+        t1 = *src--;
+        t2 = *src--;
+        t3 = *src--;
+        t4 = *src--;
+        *dst-- = t1;
+        *dst-- = t2;
+        *dst-- = t3;
+        *dst-- = t4;
+        t1 = *src--;
+        t2 = *src--;
+        t3 = *src--;
+        t4 = *src--;
+        *dst-- = t1;
+        *dst-- = t2;
+        *dst-- = t3;
+        *dst-- = t4;
+    }
+}
+
+void aligned_block_copy_backwards_bs32(int64_t * __restrict dst_,
+                                       int64_t * __restrict src,
+                                       int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t t1, t2, t3, t4;
+    src += size / 8 - 8;
+    dst += size / 8 - 8;
+    while ((size -= 64) >= 0)
+    {
+        t1 = src[4];
+        t2 = src[5];
+        t3 = src[6];
+        t4 = src[7];
+        dst[4] = t1;
+        dst[5] = t2;
+        dst[6] = t3;
+        dst[7] = t4;
+        t1 = src[0];
+        t2 = src[1];
+        t3 = src[2];
+        t4 = src[3];
+        dst[0] = t1;
+        dst[1] = t2;
+        dst[2] = t3;
+        dst[3] = t4;
+        src -= 8;
+        dst -= 8;
+    }
+}
+
+void aligned_block_copy_backwards_bs64(int64_t * __restrict dst_,
+                                       int64_t * __restrict src,
+                                       int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t t1, t2, t3, t4;
+    src += size / 8 - 8;
+    dst += size / 8 - 8;
+    while ((size -= 64) >= 0)
+    {
+        t1 = src[0];
+        t2 = src[1];
+        t3 = src[2];
+        t4 = src[3];
+        dst[0] = t1;
+        dst[1] = t2;
+        dst[2] = t3;
+        dst[3] = t4;
+        t1 = src[4];
+        t2 = src[5];
+        t3 = src[6];
+        t4 = src[7];
+        dst[4] = t1;
+        dst[5] = t2;
+        dst[6] = t3;
+        dst[7] = t4;
+        src -= 8;
+        dst -= 8;
+    }
+}
+
+void aligned_block_copy_pf32(int64_t * __restrict dst_,
+                             int64_t * __restrict src,
+                             int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t t1, t2, t3, t4;
+    while ((size -= 64) >= 0)
+    {
+        __builtin_prefetch(src + 32, 0, 0);
+        t1 = *src++;
+        t2 = *src++;
+        t3 = *src++;
+        t4 = *src++;
+        *dst++ = t1;
+        *dst++ = t2;
+        *dst++ = t3;
+        *dst++ = t4;
+        __builtin_prefetch(src + 32, 0, 0);
+        t1 = *src++;
+        t2 = *src++;
+        t3 = *src++;
+        t4 = *src++;
+        *dst++ = t1;
+        *dst++ = t2;
+        *dst++ = t3;
+        *dst++ = t4;
+    }
+}
+
+void aligned_block_copy_pf64(int64_t * __restrict dst_,
+                             int64_t * __restrict src,
+                             int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t t1, t2, t3, t4;
+    while ((size -= 64) >= 0)
+    {
+        __builtin_prefetch(src + 32, 0, 0);
+        t1 = *src++;
+        t2 = *src++;
+        t3 = *src++;
+        t4 = *src++;
+        *dst++ = t1;
+        *dst++ = t2;
+        *dst++ = t3;
+        *dst++ = t4;
+        t1 = *src++;
+        t2 = *src++;
+        t3 = *src++;
+        t4 = *src++;
+        *dst++ = t1;
+        *dst++ = t2;
+        *dst++ = t3;
+        *dst++ = t4;
+    }
+}
+
+void aligned_block_fetch(int64_t * __restrict dst,
+                         int64_t * __restrict src_,
+                         int                  size)
+{
+    volatile int64_t *src = src_;
+    while ((size -= 64) >= 0)
+    {
+        *src++;
+        *src++;
+        *src++;
+        *src++;
+        *src++;
+        *src++;
+        *src++;
+        *src++;
+    }
+}
+
+void aligned_block_fill(int64_t * __restrict dst_,
+                        int64_t * __restrict src,
+                        int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t data = *src;
+    while ((size -= 64) >= 0)
+    {
+        *dst++ = data;
+        *dst++ = data;
+        *dst++ = data;
+        *dst++ = data;
+        *dst++ = data;
+        *dst++ = data;
+        *dst++ = data;
+        *dst++ = data;
+    }
+}
+
+void aligned_block_fill_shuffle16(int64_t * __restrict dst_,
+                                  int64_t * __restrict src,
+                                  int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t data = *src;
+    while ((size -= 64) >= 0)
+    {
+        dst[0 + 0] = data;
+        dst[1 + 0] = data;
+        dst[1 + 2] = data;
+        dst[0 + 2] = data;
+        dst[1 + 4] = data;
+        dst[0 + 4] = data;
+        dst[0 + 6] = data;
+        dst[1 + 6] = data;
+        dst += 8;
+    }
+}
+
+void aligned_block_fill_shuffle32(int64_t * __restrict dst_,
+                                  int64_t * __restrict src,
+                                  int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t data = *src;
+    while ((size -= 64) >= 0)
+    {
+        dst[3 + 0] = data;
+        dst[0 + 0] = data;
+        dst[2 + 0] = data;
+        dst[1 + 0] = data;
+        dst[3 + 4] = data;
+        dst[0 + 4] = data;
+        dst[2 + 4] = data;
+        dst[1 + 4] = data;
+        dst += 8;
+    }
+}
+
+void aligned_block_fill_shuffle64(int64_t * __restrict dst_,
+                                  int64_t * __restrict src,
+                                  int                  size)
+{
+    volatile int64_t *dst = dst_;
+    int64_t data = *src;
+    while ((size -= 64) >= 0)
+    {
+        dst[5] = data;
+        dst[2] = data;
+        dst[7] = data;
+        dst[6] = data;
+        dst[1] = data;
+        dst[3] = data;
+        dst[0] = data;
+        dst[4] = data;
+        dst += 8;
+    }
+}
+
+double gettime(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)((int64_t)tv.tv_sec * 1000000 + tv.tv_usec) / 1000000.;
+}
+
+static double bandwidth_bench_measure(int threads,
+                                      int64_t *dstbuf, int64_t *srcbuf,
+                                      int64_t *tmpbuf,
+                                      int size, int blocksize,
+                                      int use_tmpbuf,
+                                      void (*f)(int64_t *, int64_t *, int),
+                                      int repeats, double *stddev,
+                                      bench_thread_stats *stats)
+{
+    int i, j, loopcount, innerloopcount, n;
+    double t, t1, t2;
+    double speed, maxspeed;
+    double s, s0, s1, s2;
+    struct bench_work work[BENCH_POOL_MAX];
+    struct bench_timing timing[BENCH_POOL_MAX];
+    double thread_t[BENCH_POOL_MAX];
+    double start_skew, finish_skew;
+
+    if (!use_tmpbuf)
+    {
+        threads = bench_pool_init(threads);
+        if (threads <= 0)
+            return 0.;
+
+        for (int pt = 0; pt < threads; pt++)
+        {
+            work[pt].func = f;
+            work[pt].arg1 = dstbuf + size * pt / sizeof(int64_t);
+            work[pt].arg2 = srcbuf + size * pt / sizeof(int64_t);
+            work[pt].arg3 = size;
+            work[pt].loops = 1;
+        }
+
+        /* Warm up caches and TLB, and wake every core up */
+        bench_pool_run(threads, work, timing);
+    }
+
+    if (stats)
+        memset(stats, 0, sizeof(*stats));
+
+    /* do up to repeats measurements */
+    s = s0 = s1 = s2 = 0.;
+    maxspeed = 0.;
+    for (n = 0; n < repeats; n++)
+    {
+        loopcount = 0;
+        innerloopcount = 1;
+        t = 0.;
+        start_skew = finish_skew = 0.;
+        memset(thread_t, 0, sizeof(thread_t));
+        do
+        {
+            loopcount += innerloopcount;
+            if (use_tmpbuf)
+            {
+                for (i = 0; i < innerloopcount; i++)
+                {
+                    t1 = gettime();
+                    for (j = 0; j < size; j += blocksize)
+                    {
+                        f(tmpbuf, srcbuf + j / sizeof(int64_t), blocksize);
+                        f(dstbuf + j / sizeof(int64_t), tmpbuf, blocksize);
+                    }
+                    t2 = gettime();
+                    t += t2 - t1;
+                }
+            }
+            else
+            {
+                /* The whole batch is one run: the workers time themselves
+                   between the start line and their last call */
+                for (int pt = 0; pt < threads; pt++)
+                    work[pt].loops = innerloopcount;
+
+                double skew = bench_pool_run(threads, work, timing);
+                double first = timing[0].start, last = timing[0].end, earliest_end = timing[0].end;
+                for (int pt = 0; pt < threads; pt++)
+                {
+                    thread_t[pt] += timing[pt].end - timing[pt].start;
+                    if (timing[pt].start < first)
+                        first = timing[pt].start;
+                    if (timing[pt].end > last)
+                        last = timing[pt].end;
+                    if (timing[pt].end < earliest_end)
+                        earliest_end = timing[pt].end;
+                }
+                t += last - first;
+
+                if (skew > start_skew)
+                    start_skew = skew;
+                if (last - earliest_end > finish_skew)
+                    finish_skew = last - earliest_end;
+            }
+            innerloopcount *= 2;
+        } while (t < 0.5);
+        speed = (double)size * (use_tmpbuf ? 1 : threads) * loopcount / t / 1000000.;
+
+        s0 += 1.;
+        s1 += speed;
+        s2 += speed * speed;
+
+        if (speed > maxspeed)
+        {
+            maxspeed = speed;
+            if (stats && !use_tmpbuf)
+            {
+                stats->threads = threads;
+                for (int pt = 0; pt < threads; pt++)
+                    stats->thread_mbps[pt] = thread_t[pt] > 0. ? (double)size * loopcount / thread_t[pt] / 1000000. : 0.;
+                stats->start_skew = start_skew;
+                stats->finish_skew = finish_skew;
+            }
+        }
+
+        if (s0 > 2.)
+        {
+            s = sqrt((s0 * s2 - s1 * s1) / (s0 * (s0 - 1)));
+            if (s < maxspeed / 1000.)
+                break;
+        }
+    }
+
+    if (stddev)
+        *stddev = s;
+    return maxspeed;
+}
+
+double bandwidth_bench_run(int threads,
+                           int64_t *dstbuf, int64_t *srcbuf, int64_t *tmpbuf,
+                           int size, int blocksize, const bench_info *bi,
+                           int repeats, bench_thread_stats *stats)
+{
+    return bandwidth_bench_measure(threads, dstbuf, srcbuf, tmpbuf, size, blocksize,
+                                   bi->use_tmpbuf, bi->f, repeats, NULL, stats);
+}
+
+static double bandwidth_bench_helper(int threads,
+                                     int64_t *dstbuf, int64_t *srcbuf,
+                                     int64_t *tmpbuf,
+                                     int size, int blocksize,
+                                     const char *indent_prefix,
+                                     int use_tmpbuf,
+                                     void (*f)(int64_t *, int64_t *, int),
+                                     const char *description)
+{
+    double s, maxspeed;
+    bench_thread_stats stats;
+
+    maxspeed = bandwidth_bench_measure(threads, dstbuf, srcbuf, tmpbuf, size, blocksize,
+                                       use_tmpbuf, f, MAXREPEATS, &s, &stats);
+
+    if (maxspeed > 0 && s / maxspeed * 100. >= 0.1)
+    {
+        printf("%s%-40s : %8.1f MB/s (%.1f%%)\n", indent_prefix, description,
+                                               maxspeed, s / maxspeed * 100.);
+    }
+    else
+    {
+        printf("%s%-40s : %8.1f MB/s\n", indent_prefix, description, maxspeed);
+    }
+
+    if (stats.threads > 1)
+        bench_print_thread_stats(indent_prefix, &stats);
+
+    bench_flush();
+    return maxspeed;
+}
+
+void bench_print_thread_stats(const char *indent_prefix, const bench_thread_stats *stats)
+{
+    printf("%s   per thread:", indent_prefix);
+    for (int pt = 0; pt < stats->threads; pt++)
+        printf("%s %.1f", pt ? " /" : "", stats->thread_mbps[pt]);
+    printf(" MB/s, skew start %.1f us, end %.1f us\n", stats->start_skew * 1000000., stats->finish_skew * 1000000.);
+}
+
+void bandwidth_bench(int threads,
+                     int64_t *dstbuf, int64_t *srcbuf, int64_t *tmpbuf,
+                     int size, int blocksize, const char *indent_prefix,
+                     bench_info *bi)
+{
+    while (bi->f)
+    {
+        bandwidth_bench_helper(threads,
+                               dstbuf, srcbuf, tmpbuf, size, blocksize,
+                               indent_prefix, bi->use_tmpbuf,
+                               bi->f,
+                               bi->description);
+        bi++;
+    }
+}
+
+void memcpy_wrapper(int64_t *dst, int64_t *src, int size)
+{
+    memcpy(dst, src, size);
+}
+
+void memset_wrapper(int64_t *dst, int64_t *src, int size)
+{
+    memset(dst, src[0], size);
+}
+
+static bench_info aarch64_neon[] =
+{
+#ifdef __aarch64__
+    { "NEON LDP (READ)", 0, aligned_block_read_ldp_q_aarch64 },
+    { "NEON LDP/STP copy (COPY)", 0, aligned_block_copy_ldpstp_q_aarch64 },
+    { "NEON LDP/STP copy pldl2strm (32B step)", 0, aligned_block_copy_ldpstp_q_pf32_l2strm_aarch64 },
+    { "NEON LDP/STP copy pldl2strm (64B step)", 0, aligned_block_copy_ldpstp_q_pf64_l2strm_aarch64 },
+    { "NEON LDP/STP copy pldl1keep (32B step)", 0, aligned_block_copy_ldpstp_q_pf32_l1keep_aarch64 },
+    { "NEON LDP/STP copy pldl1keep (64B step)", 0, aligned_block_copy_ldpstp_q_pf64_l1keep_aarch64 },
+    { "NEON LD1/ST1 copy", 0, aligned_block_copy_ld1st1_aarch64 },
+    { "NEON STP fill (WRITE)", 0, aligned_block_fill_stp_q_aarch64 },
+    { "NEON STNP fill", 0, aligned_block_fill_stnp_q_aarch64 },
+    { "ARM LDP", 0, aligned_block_read_ldp_x_aarch64 },
+    { "ARM LDP/STP copy", 0, aligned_block_copy_ldpstp_x_aarch64 },
+    { "ARM STP fill", 0, aligned_block_fill_stp_x_aarch64 },
+    { "ARM STNP fill", 0, aligned_block_fill_stnp_x_aarch64 },
+#endif
+    { NULL, 0, NULL }
+};
+
+bench_info *get_asm_benchmarks(void)
+{
+    return aarch64_neon;
+}
+
+bench_info c_benchmarks[] =
+{
+    { "C copy backwards", 0, aligned_block_copy_backwards },
+    { "C copy backwards (32B blocks)", 0, aligned_block_copy_backwards_bs32 },
+    { "C copy backwards (64B blocks)", 0, aligned_block_copy_backwards_bs64 },
+    { "C copy", 0, aligned_block_copy },
+    { "C copy prefetched (32B step)", 0, aligned_block_copy_pf32 },
+    { "C copy prefetched (64B step)", 0, aligned_block_copy_pf64 },
+    // { "C 2-pass copy", 1, aligned_block_copy },
+    // { "C 2-pass copy prefetched (32B step)", 1, aligned_block_copy_pf32 },
+    // { "C 2-pass copy prefetched (64B step)", 1, aligned_block_copy_pf64 },
+    { "C fetch", 0, aligned_block_fetch },
+    { "C fill", 0, aligned_block_fill },
+    { "C fill (shuffle within 16B blocks)", 0, aligned_block_fill_shuffle16 },
+    { "C fill (shuffle within 32B blocks)", 0, aligned_block_fill_shuffle32 },
+    { "C fill (shuffle within 64B blocks)", 0, aligned_block_fill_shuffle64 },
+    { NULL, 0, NULL }
+};
+
+bench_info libc_benchmarks[] =
+{
+    { "standard memcpy", 0, memcpy_wrapper },
+    { "standard memset", 0, memset_wrapper },
+    { NULL, 0, NULL }
+};
+
+const bench_info *bench_find(const char *description)
+{
+    bench_info *tables[] = { get_asm_benchmarks(), c_benchmarks, libc_benchmarks };
+
+    for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); t++)
+    {
+        for (bench_info *bi = tables[t]; bi->f; bi++)
+        {
+            if (!strcmp(bi->description, description))
+                return bi;
+        }
+    }
+    return NULL;
+}
+
+void *alloc_four_nonaliased_buffers(void **buf1_, int size1,
+                                    void **buf2_, int size2,
+                                    void **buf3_, int size3,
+                                    void **buf4_, int size4)
+{
+    char **buf1 = (char **)buf1_, **buf2 = (char **)buf2_;
+    char **buf3 = (char **)buf3_, **buf4 = (char **)buf4_;
+    int antialias_pattern_mask = (ALIGN_PADDING - 1) & ~(CACHE_LINE_SIZE - 1);
+    char *buf, *ptr;
+
+    if (!buf1 || size1 < 0)
+        size1 = 0;
+    if (!buf2 || size2 < 0)
+        size2 = 0;
+    if (!buf3 || size3 < 0)
+        size3 = 0;
+    if (!buf4 || size4 < 0)
+        size4 = 0;
+
+    ptr = buf = 
+        (char *)malloc(size1 + size2 + size3 + size4 + 9 * ALIGN_PADDING);
+    memset(buf, 0xCC, size1 + size2 + size3 + size4 + 9 * ALIGN_PADDING);
+
+    ptr = align_up(ptr, ALIGN_PADDING);
+    if (buf1)
+    {
+        *buf1 = ptr + (0xAAAAAAAA & antialias_pattern_mask);
+        ptr = align_up(*buf1 + size1, ALIGN_PADDING);
+    }
+    if (buf2)
+    {
+        *buf2 = ptr + (0x55555555 & antialias_pattern_mask);
+        ptr = align_up(*buf2 + size2, ALIGN_PADDING);
+    }
+    if (buf3)
+    {
+        *buf3 = ptr + (0xCCCCCCCC & antialias_pattern_mask);
+        ptr = align_up(*buf3 + size3, ALIGN_PADDING);
+    }
+    if (buf4)
+    {
+        *buf4 = ptr + (0x33333333 & antialias_pattern_mask);
+    }
+
+    return buf;
+}
+
+#pragma GCC diagnostic push
+static void __attribute__((noinline)) random_read_test(char *zerobuffer,
+                                                       int count, int nbits)
+{
+    uint32_t seed = 0;
+    uintptr_t addrmask = (1 << nbits) - 1;
+    uint32_t v;
+
+    #pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+    static volatile uint32_t dummy;
+
+    #define RANDOM_MEM_ACCESS()                 \
+        seed = seed * 1103515245 + 12345;       \
+        v = (seed >> 16) & 0xFF;                \
+        seed = seed * 1103515245 + 12345;       \
+        v |= (seed >> 8) & 0xFF00;              \
+        seed = seed * 1103515245 + 12345;       \
+        v |= seed & 0x7FFF0000;                 \
+        seed |= zerobuffer[v & addrmask];
+
+    while (count >= 16) {
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        count -= 16;
+    }
+    dummy = seed;
+    #undef RANDOM_MEM_ACCESS
+}
+
+static void __attribute__((noinline)) random_dual_read_test(char *zerobuffer,
+                                                            int count, int nbits)
+{
+    uint32_t seed = 0;
+    uintptr_t addrmask = (1 << nbits) - 1;
+    uint32_t v1, v2;
+
+    #pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+    static volatile uint32_t dummy;
+
+    #define RANDOM_MEM_ACCESS()                 \
+        seed = seed * 1103515245 + 12345;       \
+        v1 = (seed >> 8) & 0xFF00;              \
+        seed = seed * 1103515245 + 12345;       \
+        v2 = (seed >> 8) & 0xFF00;              \
+        seed = seed * 1103515245 + 12345;       \
+        v1 |= seed & 0x7FFF0000;                \
+        seed = seed * 1103515245 + 12345;       \
+        v2 |= seed & 0x7FFF0000;                \
+        seed = seed * 1103515245 + 12345;       \
+        v1 |= (seed >> 16) & 0xFF;              \
+        v2 |= (seed >> 24);                     \
+        v2 &= addrmask;                         \
+        v1 ^= v2;                               \
+        seed |= zerobuffer[v2];                 \
+        seed += zerobuffer[v1 & addrmask];
+
+    while (count >= 16) {
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        RANDOM_MEM_ACCESS();
+        count -= 16;
+    }
+    dummy = seed;
+    #undef RANDOM_MEM_ACCESS
+}
+#pragma GCC diagnostic pop
+
+static uint32_t rand32()
+{
+    static int seed = 0;
+    uint32_t hi, lo;
+    hi = (seed = seed * 1103515245 + 12345) >> 16;
+    lo = (seed = seed * 1103515245 + 12345) >> 16;
+    return (hi << 16) + lo;
+}
+
+/* Extra time per access over the no-access baseline, in seconds, for a
+ * testsize = 1 << nbits working set at a random offset in the buffer */
+static void latency_measure(char *buffer, int size, int count, int nbits,
+                            double t_noaccess, double t_noaccess2,
+                            double *out_t, double *out_t2)
+{
+    double t, t2, t_before, t_after;
+    double xs, xs1, xs2;
+    double ys, ys1, ys2;
+    double min_t = 0, min_t2 = 0;
+    int n;
+
+    int testsize = 1 << nbits;
+    xs1 = xs2 = ys = ys1 = ys2 = 0;
+    for (n = 1; n <= MAXREPEATS; n++)
+    {
+        int testoffs = (rand32() % (size / testsize)) * testsize;
+
+        t_before = gettime();
+        random_read_test(buffer + testoffs, count, nbits);
+        t_after = gettime();
+        t = t_after - t_before - t_noaccess;
+        if (t < 0) t = 0;
+
+        xs1 += t;
+        xs2 += t * t;
+
+        if (n == 1 || t < min_t)
+            min_t = t;
+
+        t_before = gettime();
+        random_dual_read_test(buffer + testoffs, count, nbits);
+        t_after = gettime();
+        t2 = t_after - t_before - t_noaccess2;
+        if (t2 < 0) t2 = 0;
+
+        ys1 += t2;
+        ys2 += t2 * t2;
+
+        if (n == 1 || t2 < min_t2)
+            min_t2 = t2;
+
+        if (n > 2)
+        {
+            xs = sqrt((xs2 * n - xs1 * xs1) / (n * (n - 1)));
+            ys = sqrt((ys2 * n - ys1 * ys1) / (n * (n - 1)));
+            if (xs < min_t / 1000. && ys < min_t2 / 1000.)
+                break;
+        }
+    }
+
+    *out_t = min_t;
+    *out_t2 = min_t2;
+}
+
+/* Time of the access pattern alone, with every access hitting the same line */
+static void latency_baseline(char *buffer, int count, double *t_noaccess, double *t_noaccess2)
+{
+    double t_before, t_after;
+
+    for (int n = 1; n <= MAXREPEATS; n++)
+    {
+        t_before = gettime();
+        random_read_test(buffer, count, 1);
+        t_after = gettime();
+        if (n == 1 || t_after - t_before < *t_noaccess)
+            *t_noaccess = t_after - t_before;
+
+        t_before = gettime();
+        random_dual_read_test(buffer, count, 1);
+        t_after = gettime();
+        if (n == 1 || t_after - t_before < *t_noaccess2)
+            *t_noaccess2 = t_after - t_before;
+    }
+}
+
+int latency_bench(int size, int count, int use_hugepage, int quick)
+{
+    double t_noaccess = 0, t_noaccess2 = 0;
+    double min_t, min_t2;
+    int nbits;
+    char *buffer, *buffer_alloc;
+#if !defined(__linux__) || !defined(MADV_HUGEPAGE)
+    if (use_hugepage)
+        return 0;
+    buffer_alloc = (char *)malloc(size + 4095);
+    if (!buffer_alloc)
+        return 0;
+    buffer = (char *)(((uintptr_t)buffer_alloc + 4095) & ~(uintptr_t)4095);
+#else
+    if (posix_memalign((void **)&buffer_alloc, 4 * 1024 * 1024, size) != 0)
+        return 0;
+    buffer = buffer_alloc;
+    if (use_hugepage && madvise(buffer, size, use_hugepage > 0 ?
+                                MADV_HUGEPAGE : MADV_NOHUGEPAGE) != 0)
+    {
+        free(buffer_alloc);
+        return 0;
+    }
+#endif
+    memset(buffer, 0, size);
+
+    latency_baseline(buffer, count, &t_noaccess, &t_noaccess2);
+
+    printf("\nblock size : single random read / dual random read");
+    if (use_hugepage > 0)
+        printf(", [MADV_HUGEPAGE]\n");
+    else if (use_hugepage < 0)
+        printf(", [MADV_NOHUGEPAGE]\n");
+    else
+        printf("\n");
+
+    bench_flush();
+
+    int start = quick ? 20 : 10;
+    for (nbits = start; (1 << nbits) <= size; nbits++)
+    {
+        latency_measure(buffer, size, count, nbits, t_noaccess, t_noaccess2, &min_t, &min_t2);
+
+        printf("%10d : %6.1f ns          /  %6.1f ns \n", (1 << nbits),
+            min_t * 1000000000. / count,  min_t2 * 1000000000. / count);
+
+        bench_flush();
+    }
+    free(buffer_alloc);
+    return 1;
+}
+
+int latency_bench_point(int size, int count, double *single_ns, double *dual_ns)
+{
+    double t_noaccess = 0, t_noaccess2 = 0;
+    double min_t, min_t2;
+    int nbits = 0;
+    char *buffer, *buffer_alloc;
+
+    while ((2 << nbits) <= size)
+        nbits++;
+
+    buffer_alloc = (char *)malloc(size + 4095);
+    if (!buffer_alloc)
+        return 0;
+    buffer = (char *)(((uintptr_t)buffer_alloc + 4095) & ~(uintptr_t)4095);
+    memset(buffer, 0, size);
+
+    latency_baseline(buffer, count, &t_noaccess, &t_noaccess2);
+    latency_measure(buffer, size, count, nbits, t_noaccess, t_noaccess2, &min_t, &min_t2);
+
+    *single_ns = min_t * 1000000000. / count;
+    *dual_ns = min_t2 * 1000000000. / count;
+
+    free(buffer_alloc);
+    return 1;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright © 2011 Siarhei Siamashka <siarhei.siamashka@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice (including the next
+ * paragraph) shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ * 
+ * pthread fork by sun409 (https://github.com/sun409/tinymembench-pthread)
+ *
+ * Switch port by Kazushi and built with libnx.
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdint.h>
+
+#include "bench_pool.h"
+
+#define SIZE             (32 * 1024 * 1024)
+#define BLOCKSIZE        2048
+#ifndef MAXREPEATS
+# define MAXREPEATS      10
+#endif
+#ifndef LATBENCH_COUNT
+# define LATBENCH_COUNT  10000000
+#endif
+
+#define ALIGN_PADDING    0x100000
+#define CACHE_LINE_SIZE  128
+
+#ifdef __SWITCH__
+#include <switch.h>
+#define bench_flush()    consoleUpdate(NULL)
+#else
+#define bench_flush()    fflush(stdout)
+#endif
+
+typedef struct
+{
+    const char *description;
+    int use_tmpbuf;
+    void (*f)(int64_t *, int64_t *, int);
+} bench_info;
+
+extern bench_info c_benchmarks[];
+extern bench_info libc_benchmarks[];
+bench_info *get_asm_benchmarks(void);
+
+/* Looks a kernel up by description in all the tables, NULL if this build doesn't have it */
+const bench_info *bench_find(const char *description);
+
+double gettime(void);
+
+void *alloc_four_nonaliased_buffers(void **buf1_, int size1,
+                                    void **buf2_, int size2,
+                                    void **buf3_, int size3,
+                                    void **buf4_, int size4);
+
+/* Per-thread view of the best repetition of a multithreaded run */
+typedef struct
+{
+    int threads;
+    double thread_mbps[BENCH_POOL_MAX];
+    double start_skew;      /* worst spread of the workers' start times, seconds */
+    double finish_skew;     /* worst spread of the workers' end times, seconds */
+} bench_thread_stats;
+
+void bandwidth_bench(int threads,
+                     int64_t *dstbuf, int64_t *srcbuf, int64_t *tmpbuf,
+                     int size, int blocksize, const char *indent_prefix,
+                     bench_info *bi);
+
+/* Best of up to repeats measurements of one kernel, in MB/s, without printing.
+ * stats may be NULL. */
+double bandwidth_bench_run(int threads,
+                           int64_t *dstbuf, int64_t *srcbuf, int64_t *tmpbuf,
+                           int size, int blocksize, const bench_info *bi,
+                           int repeats, bench_thread_stats *stats);
+
+void bench_print_thread_stats(const char *indent_prefix, const bench_thread_stats *stats);
+
+int latency_bench(int size, int count, int use_hugepage, int quick);
+
+/* Single and dual random read latency over a size byte working set, in ns */
+int latency_bench_point(int size, int count, double *single_ns, double *dual_ns);
+
+#endif
@@ -0,0 +1,300 @@
+/*
+ * TinyMemBenchNX persistent worker pool
+ *
+ * Workers sleep on a condition variable between runs. Once woken they
+ * spin (yielding, as a worker may share its core with the main thread)
+ * until everybody has arrived, so the timed part starts at the same time
+ * on every core.
+ */
+
+#if !defined(__SWITCH__) && defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+
+#include "bench_pool.h"
+
+#ifdef __SWITCH__
+#include <switch.h>
+
+#define POOL_STACK_SIZE 0x10000
+
+typedef Mutex   pool_mutex_t;
+typedef CondVar pool_cond_t;
+typedef Thread  pool_thread_t;
+
+#define pool_mutex_init(m)      mutexInit(m)
+#define pool_lock(m)            mutexLock(m)
+#define pool_unlock(m)          mutexUnlock(m)
+#define pool_cond_init(c)       condvarInit(c)
+#define pool_cond_wait(c, m)    condvarWait(c, m)
+#define pool_cond_signal(c)     condvarWakeOne(c)
+#define pool_cond_broadcast(c)  condvarWakeAll(c)
+#define pool_relax()            svcSleepThread(YieldType_WithoutCoreMigration)
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+typedef pthread_mutex_t pool_mutex_t;
+typedef pthread_cond_t  pool_cond_t;
+typedef pthread_t       pool_thread_t;
+
+#define pool_mutex_init(m)      pthread_mutex_init(m, NULL)
+#define pool_lock(m)            pthread_mutex_lock(m)
+#define pool_unlock(m)          pthread_mutex_unlock(m)
+#define pool_cond_init(c)       pthread_cond_init(c, NULL)
+#define pool_cond_wait(c, m)    pthread_cond_wait(c, m)
+#define pool_cond_signal(c)     pthread_cond_signal(c)
+#define pool_cond_broadcast(c)  pthread_cond_broadcast(c)
+#define pool_relax()            sched_yield()
+#endif
+
+struct pool_worker
+{
+    int id;
+    pool_thread_t thread;
+    struct bench_work work;
+    struct bench_timing timing;
+};
+
+static struct
+{
+    int initialized;
+    pool_mutex_t lock;
+    pool_cond_t start;          /* main -> workers: a new run is available */
+    pool_cond_t done;           /* last worker -> main: run finished */
+    unsigned generation;
+    int quit;
+    int active;                 /* workers taking part in the current run */
+    int pending;
+    atomic_int arrived;         /* start line barrier */
+    int count;
+    struct pool_worker workers[BENCH_POOL_MAX];
+} g_pool;
+
+double bench_pool_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1000000000.;
+}
+
+static void pool_worker_loop(struct pool_worker *w)
+{
+    unsigned seen = 0;
+
+    while (1)
+    {
+        pool_lock(&g_pool.lock);
+        while ((g_pool.generation == seen || w->id >= g_pool.active) && !g_pool.quit)
+        {
+            seen = g_pool.generation;
+            pool_cond_wait(&g_pool.start, &g_pool.lock);
+        }
+
+        if (g_pool.quit)
+        {
+            pool_unlock(&g_pool.lock);
+            return;
+        }
+
+        seen = g_pool.generation;
+        int active = g_pool.active;
+        struct bench_work work = w->work;
+        pool_unlock(&g_pool.lock);
+
+        /* Start line */
+        atomic_fetch_add(&g_pool.arrived, 1);
+        while (atomic_load(&g_pool.arrived) < active)
+            pool_relax();
+
+        long calls = 0;
+        double start = bench_pool_time();
+        if (work.func && work.stop)
+        {
+            for (; !*work.stop; calls++)
+                work.func(work.arg1, work.arg2, work.arg3);
+        }
+        else if (work.func)
+        {
+            for (; calls < work.loops; calls++)
+                work.func(work.arg1, work.arg2, work.arg3);
+        }
+        double end = bench_pool_time();
+
+        pool_lock(&g_pool.lock);
+        w->timing.start = start;
+        w->timing.end = end;
+        w->timing.calls = calls;
+        if (--g_pool.pending == 0)
+            pool_cond_signal(&g_pool.done);
+        pool_unlock(&g_pool.lock);
+    }
+}
+
+#ifdef __SWITCH__
+static void pool_worker_entry(void *arg)
+{
+    pool_worker_loop((struct pool_worker *)arg);
+}
+
+static int pool_start_thread(struct pool_worker *w)
+{
+    /* Applications own cores 0-2 */
+    Result rc = threadCreate(&w->thread, pool_worker_entry, w, NULL, POOL_STACK_SIZE, 0x2C, w->id % 3);
+    if (R_FAILED(rc))
+    {
+        printf("threadCreate[%d] failed: 0x%X\n", w->id, rc);
+        return -1;
+    }
+
+    rc = threadStart(&w->thread);
+    if (R_FAILED(rc))
+    {
+        printf("threadStart[%d] failed: 0x%X\n", w->id, rc);
+        threadClose(&w->thread);
+        return -1;
+    }
+    return 0;
+}
+
+static void pool_join_thread(struct pool_worker *w)
+{
+    threadWaitForExit(&w->thread);
+    threadClose(&w->thread);
+}
+#else
+static void *pool_worker_entry(void *arg)
+{
+    pool_worker_loop((struct pool_worker *)arg);
+    return NULL;
+}
+
+static int pool_start_thread(struct pool_worker *w)
+{
+    int rc = pthread_create(&w->thread, NULL, pool_worker_entry, w);
+    if (rc)
+    {
+        printf("pthread_create[%d] failed: %d\n", w->id, rc);
+        return -1;
+    }
+
+#ifdef __linux__
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(w->id % cpus, &set);
+        pthread_setaffinity_np(w->thread, sizeof(set), &set);
+    }
+#endif
+    return 0;
+}
+
+static void pool_join_thread(struct pool_worker *w)
+{
+    pthread_join(w->thread, NULL);
+}
+#endif
+
+int bench_pool_init(int threads)
+{
+    if (!g_pool.initialized)
+    {
+        memset(&g_pool, 0, sizeof(g_pool));
+        pool_mutex_init(&g_pool.lock);
+        pool_cond_init(&g_pool.start);
+        pool_cond_init(&g_pool.done);
+        g_pool.initialized = 1;
+    }
+
+    if (threads > BENCH_POOL_MAX)
+        threads = BENCH_POOL_MAX;
+
+    while (g_pool.count < threads)
+    {
+        struct pool_worker *w = &g_pool.workers[g_pool.count];
+        w->id = g_pool.count;
+
+        if (pool_start_thread(w))
+            break;
+
+        g_pool.count++;
+    }
+
+    return g_pool.count;
+}
+
+int bench_pool_start(int threads, const struct bench_work *work)
+{
+    threads = bench_pool_init(threads);
+
+    pool_lock(&g_pool.lock);
+    for (int i = 0; i < threads; i++)
+        g_pool.workers[i].work = work[i];
+    g_pool.active = threads;
+    g_pool.pending = threads;
+    atomic_store(&g_pool.arrived, 0);
+    g_pool.generation++;
+    pool_cond_broadcast(&g_pool.start);
+    pool_unlock(&g_pool.lock);
+
+    /* Yielding lets a worker sharing our core get to the start line */
+    while (atomic_load(&g_pool.arrived) < threads)
+        pool_relax();
+
+    return threads;
+}
+
+double bench_pool_wait(int threads, struct bench_timing *timing)
+{
+    double first = 0., last = 0.;
+
+    pool_lock(&g_pool.lock);
+    while (g_pool.pending)
+        pool_cond_wait(&g_pool.done, &g_pool.lock);
+
+    if (threads > g_pool.active)
+        threads = g_pool.active;
+
+    for (int i = 0; i < threads; i++)
+    {
+        timing[i] = g_pool.workers[i].timing;
+        if (i == 0 || timing[i].start < first)
+            first = timing[i].start;
+        if (i == 0 || timing[i].start > last)
+            last = timing[i].start;
+    }
+    pool_unlock(&g_pool.lock);
+
+    return last - first;
+}
+
+double bench_pool_run(int threads, const struct bench_work *work, struct bench_timing *timing)
+{
+    threads = bench_pool_start(threads, work);
+    return bench_pool_wait(threads, timing);
+}
+
+void bench_pool_exit(void)
+{
+    if (!g_pool.initialized)
+        return;
+
+    pool_lock(&g_pool.lock);
+    g_pool.quit = 1;
+    pool_cond_broadcast(&g_pool.start);
+    pool_unlock(&g_pool.lock);
+
+    for (int i = 0; i < g_pool.count; i++)
+        pool_join_thread(&g_pool.workers[i]);
+
+    g_pool.count = 0;
+    g_pool.initialized = 0;
+}
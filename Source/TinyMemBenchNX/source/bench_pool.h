@@ -0,0 +1,51 @@
+/*
+ * TinyMemBenchNX persistent worker pool
+ *
+ * One worker per core, created once and pinned. For every run all the
+ * workers meet at a barrier, the last one to arrive stamps the start line
+ * and they all start together; each worker times its own part of the run,
+ * so thread creation and wakeup latency never lands in a measurement.
+ */
+
+#ifndef __BENCH_POOL_H__
+#define __BENCH_POOL_H__
+
+#include <stdint.h>
+
+#define BENCH_POOL_MAX 8
+
+struct bench_work
+{
+    void (*func)(int64_t *, int64_t *, int);
+    int64_t *arg1;
+    int64_t *arg2;
+    int      arg3;
+    int      loops;         /* calls of func in one run */
+    const volatile int *stop;   /* if set, call func until *stop instead */
+};
+
+struct bench_timing
+{
+    double start;           /* seconds, monotonic */
+    double end;
+    long   calls;
+};
+
+/* Makes sure at least threads workers are running, returns how many are */
+int bench_pool_init(int threads);
+
+/* Runs work[i] on worker i for i < threads and waits for all of them.
+ * Returns the start skew (latest minus earliest start), in seconds. */
+double bench_pool_run(int threads, const struct bench_work *work, struct bench_timing *timing);
+
+/* bench_pool_run in two halves, so the calling thread can work alongside the
+ * pool. Start returns once every worker is past the start line; a worker
+ * with a NULL func just checks in and finishes. Wait returns the skew. */
+int bench_pool_start(int threads, const struct bench_work *work);
+double bench_pool_wait(int threads, struct bench_timing *timing);
+
+void bench_pool_exit(void);
+
+double bench_pool_time(void);
+
+#endif
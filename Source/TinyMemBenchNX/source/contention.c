@@ -0,0 +1,172 @@
+/*
+ * TinyMemBenchNX EMC contention benchmark
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bench.h"
+#include "bench_pool.h"
+#include "latency_curve.h"
+#include "contention.h"
+
+const char *const contention_default_kernels[] =
+{
+    "NEON LDP/STP copy (COPY)",
+    "NEON STP fill (WRITE)",
+    "C copy",
+    "C fill",
+    NULL
+};
+
+static void **volatile contention_sink;
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, int count, double p)
+{
+    int i = (int)(p * (count - 1) + 0.5);
+    return sorted[i];
+}
+
+/* Runs the latency bursts with hogs workers (1..hogs) busy on kernel f */
+static void contention_measure(const struct contention_options *opt, void **chain,
+                               double *samples, int hogs,
+                               void (*f)(int64_t *, int64_t *, int),
+                               int64_t *dstbuf, int64_t *srcbuf,
+                               struct contention_result *res)
+{
+    struct bench_work work[BENCH_POOL_MAX];
+    struct bench_timing timing[BENCH_POOL_MAX];
+    volatile int stop = 0;
+    int threads = hogs + 1;
+    void **p = chain;
+
+    memset(res, 0, sizeof(*res));
+    memset(work, 0, sizeof(work));
+
+    if (hogs)
+    {
+        /* Worker 0 shares the core with us and only checks in */
+        for (int i = 1; i < threads; i++)
+        {
+            work[i].func = f;
+            work[i].arg1 = dstbuf + (size_t)SIZE * (i - 1) / sizeof(int64_t);
+            work[i].arg2 = srcbuf + (size_t)SIZE * (i - 1) / sizeof(int64_t);
+            work[i].arg3 = SIZE;
+            work[i].stop = &stop;
+        }
+        threads = bench_pool_start(threads, work);
+    }
+
+    /* Warm up the chain and let the hogs reach full speed */
+    p = latcurve_chase(p, opt->burst * 64);
+
+    for (int n = 0; n < opt->samples; n++)
+    {
+        double t = bench_pool_time();
+        p = latcurve_chase(p, opt->burst);
+        samples[n] = (bench_pool_time() - t) * 1000000000. / opt->burst;
+        res->mean_ns += samples[n];
+    }
+    contention_sink = p;
+
+    if (hogs)
+    {
+        stop = 1;
+        bench_pool_wait(threads, timing);
+
+        for (int i = 1; i < threads; i++)
+        {
+            double seconds = timing[i].end - timing[i].start;
+            if (seconds > 0.)
+                res->hog_mbps += (double)SIZE * timing[i].calls / seconds / 1000000.;
+        }
+    }
+
+    qsort(samples, opt->samples, sizeof(double), compare_double);
+    res->mean_ns /= opt->samples;
+    res->p50_ns = percentile(samples, opt->samples, 0.50);
+    res->p90_ns = percentile(samples, opt->samples, 0.90);
+    res->p99_ns = percentile(samples, opt->samples, 0.99);
+    res->max_ns = samples[opt->samples - 1];
+}
+
+static void contention_print(const struct contention_options *opt, const char *load, int hogs,
+                             const struct contention_result *res)
+{
+    printf(" %-28s %4d : %6.1f %6.1f %6.1f %7.1f : %8.1f\n", load, hogs,
+           res->p50_ns, res->p90_ns, res->p99_ns, res->max_ns, res->hog_mbps);
+    bench_flush();
+
+    if (opt->csv)
+    {
+        fprintf(opt->csv, "%s,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.1f\n", load, hogs, res->mean_ns,
+                res->p50_ns, res->p90_ns, res->p99_ns, res->max_ns, res->hog_mbps);
+        fflush(opt->csv);
+    }
+}
+
+int contention_run(const struct contention_options *opt)
+{
+    int64_t *srcbuf, *dstbuf;
+    struct contention_result res;
+    int max_hogs = opt->max_hogs;
+    int rows = 0;
+
+    if (max_hogs > BENCH_POOL_MAX - 1)
+        max_hogs = BENCH_POOL_MAX - 1;
+    if (opt->samples <= 0 || opt->burst < 16)
+        return -1;
+
+    char *chain_alloc = (char *)malloc(opt->latency_size + LATCURVE_PAGE_SIZE - 1);
+    double *samples = (double *)malloc(opt->samples * sizeof(double));
+    void *poolbuf = max_hogs ? alloc_four_nonaliased_buffers((void **)&srcbuf, SIZE * max_hogs,
+                                                             (void **)&dstbuf, SIZE * max_hogs,
+                                                             NULL, 0, NULL, 0) : NULL;
+    if (!chain_alloc || !samples || (max_hogs && !poolbuf))
+    {
+        free(chain_alloc);
+        free(samples);
+        free(poolbuf);
+        return -1;
+    }
+
+    char *chain_buf = (char *)(((uintptr_t)chain_alloc + LATCURVE_PAGE_SIZE - 1) & ~(uintptr_t)(LATCURVE_PAGE_SIZE - 1));
+    void **chain = latcurve_build_chain(chain_buf, opt->latency_size, LATCURVE_RANDOM);
+
+    printf("\n %-28s hogs :    p50    p90    p99     max : hog MB/s  (ns per load)\n", "load");
+    bench_flush();
+
+    if (opt->csv)
+        fprintf(opt->csv, "load,hogs,mean_ns,p50_ns,p90_ns,p99_ns,max_ns,hog_mbps\n");
+
+    contention_measure(opt, chain, samples, 0, NULL, NULL, NULL, &res);
+    contention_print(opt, "idle", 0, &res);
+    rows++;
+
+    for (int k = 0; opt->kernels[k]; k++)
+    {
+        const bench_info *bi = bench_find(opt->kernels[k]);
+        if (!bi || bi->use_tmpbuf)
+            continue;
+
+        for (int hogs = 1; hogs <= max_hogs; hogs++)
+        {
+            contention_measure(opt, chain, samples, hogs, bi->f, dstbuf, srcbuf, &res);
+            contention_print(opt, bi->description, hogs, &res);
+            rows++;
+        }
+    }
+
+    free(poolbuf);
+    free(samples);
+    free(chain_alloc);
+    return rows;
+}
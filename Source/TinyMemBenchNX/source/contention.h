@@ -0,0 +1,42 @@
+/*
+ * TinyMemBenchNX EMC contention benchmark
+ *
+ * The calling thread chases pointers through a random chain in short timed
+ * bursts while 0..max_hogs pool workers run a bandwidth kernel flat out on
+ * the other cores. The distribution of the burst latencies under each load
+ * shows how the memory controller arbitration shares DRAM between a
+ * latency-bound core and streaming ones.
+ *
+ * On the Switch the main thread sits on core 0 and the hogs on cores 1-2.
+ */
+
+#ifndef __CONTENTION_H__
+#define __CONTENTION_H__
+
+#include <stdio.h>
+#include <stddef.h>
+
+struct contention_options
+{
+    const char *const *kernels;     /* hog kernels by bench_info description, NULL terminated */
+    int max_hogs;
+    size_t latency_size;            /* working set of the chase */
+    int samples;                    /* timed bursts per load level */
+    int burst;                      /* loads per burst, a multiple of 16 */
+    FILE *csv;                      /* may be NULL */
+};
+
+struct contention_result
+{
+    double mean_ns, p50_ns, p90_ns, p99_ns, max_ns;
+    double hog_mbps;                /* sum over the hogs */
+};
+
+/* NEON copy and fill, plus the C versions for non-aarch64 hosts */
+extern const char *const contention_default_kernels[];
+
+/* Prints a table as it goes. Returns the number of rows, -1 if the buffers
+ * could not be allocated. */
+int contention_run(const struct contention_options *opt);
+
+#endif
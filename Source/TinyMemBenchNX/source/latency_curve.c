@@ -0,0 +1,248 @@
+/*
+ * TinyMemBenchNX latency curve
+ *
+ * Each pattern is built as a single cycle of pointers stored inside the
+ * buffer, so the loads are fully dependent and the chase never leaves the
+ * pattern. Random cycles use Sattolo's shuffle on indices stored in the
+ * nodes themselves, which are then turned into pointers in place: a 1GB
+ * working set needs no side table.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "bench.h"
+#include "latency_curve.h"
+
+#define KNEE_RATIO 1.25
+
+/* Keeps the chase from being optimised away */
+static void **volatile chase_sink;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t rng_next(void)
+{
+    uint64_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return rng_state = x;
+}
+
+/* Node i of a pattern lives at node_offset(i) */
+static size_t node_offset(enum latcurve_pattern pattern, size_t i)
+{
+    switch (pattern)
+    {
+        case LATCURVE_STRIDED:
+            return i * LATCURVE_STRIDE;
+        case LATCURVE_PAGE:
+            /* Stagger the line so all the pages don't fight for the same cache sets */
+            return i * LATCURVE_PAGE_SIZE + (i % (LATCURVE_PAGE_SIZE / LATCURVE_LINE_SIZE)) * LATCURVE_LINE_SIZE;
+        default:
+            return i * LATCURVE_LINE_SIZE;
+    }
+}
+
+static size_t node_count(enum latcurve_pattern pattern, size_t size)
+{
+    switch (pattern)
+    {
+        case LATCURVE_STRIDED:
+            return size / LATCURVE_STRIDE;
+        case LATCURVE_PAGE:
+            return size / LATCURVE_PAGE_SIZE;
+        default:
+            return size / LATCURVE_LINE_SIZE;
+    }
+}
+
+void **latcurve_build_chain(char *buffer, size_t size, enum latcurve_pattern pattern)
+{
+    size_t n = node_count(pattern, size);
+
+    if (pattern == LATCURVE_SEQ || pattern == LATCURVE_STRIDED)
+    {
+        for (size_t i = 0; i < n; i++)
+            *(void **)(buffer + node_offset(pattern, i)) = buffer + node_offset(pattern, (i + 1) % n);
+        return (void **)buffer;
+    }
+
+    /* Sattolo: a uniformly random permutation made of one single cycle */
+    for (size_t i = 0; i < n; i++)
+        *(uintptr_t *)(buffer + node_offset(pattern, i)) = i;
+
+    for (size_t i = n - 1; i > 0; i--)
+    {
+        size_t j = rng_next() % i;
+        uintptr_t *a = (uintptr_t *)(buffer + node_offset(pattern, i));
+        uintptr_t *b = (uintptr_t *)(buffer + node_offset(pattern, j));
+        uintptr_t tmp = *a;
+        *a = *b;
+        *b = tmp;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        uintptr_t *node = (uintptr_t *)(buffer + node_offset(pattern, i));
+        *node = (uintptr_t)(buffer + node_offset(pattern, *node));
+    }
+
+    return (void **)buffer;
+}
+
+void ** __attribute__((noinline)) latcurve_chase(void **p, int count)
+{
+    #define CHASE() p = (void **)*p;
+
+    while (count >= 16)
+    {
+        CHASE(); CHASE(); CHASE(); CHASE();
+        CHASE(); CHASE(); CHASE(); CHASE();
+        CHASE(); CHASE(); CHASE(); CHASE();
+        CHASE(); CHASE(); CHASE(); CHASE();
+        count -= 16;
+    }
+    #undef CHASE
+
+    return p;
+}
+
+/* Best of repeats, in ns per load */
+static double measure_chain(void **start, size_t nodes, int count, int repeats)
+{
+    double best = 0.;
+    int warmup = nodes < (size_t)count ? (int)nodes : count;
+
+    void **p = latcurve_chase(start, warmup + 16);
+    for (int n = 0; n < repeats; n++)
+    {
+        double t = gettime();
+        p = latcurve_chase(p, count);
+        t = gettime() - t;
+
+        if (n == 0 || t < best)
+            best = t;
+    }
+    chase_sink = p;
+
+    return best * 1000000000. / count;
+}
+
+static double measure_pattern(char *buffer, size_t size, enum latcurve_pattern pattern,
+                              int count, int repeats)
+{
+    size_t nodes = node_count(pattern, size);
+    if (nodes < 2)
+        return 0.;
+
+    void **start = latcurve_build_chain(buffer, size, pattern);
+    return measure_chain(start, nodes, count, repeats);
+}
+
+void latcurve_measure(char *buffer, size_t size, int count, int repeats,
+                      struct latcurve_point *point)
+{
+    memset(point, 0, sizeof(*point));
+    point->size = size;
+
+    for (int p = 0; p < LATCURVE_PATTERNS; p++)
+        point->ns[p] = measure_pattern(buffer, size, p, count, repeats);
+
+    /* Same data footprint as the page pattern, but packed into few pages */
+    size_t packed = size / (LATCURVE_PAGE_SIZE / LATCURVE_LINE_SIZE);
+    double reference = point->ns[LATCURVE_RANDOM];
+    if (packed >= LATCURVE_PAGE_SIZE)
+        reference = measure_pattern(buffer, packed, LATCURVE_RANDOM, count, repeats);
+
+    point->tlb_ns = point->ns[LATCURVE_PAGE] - reference;
+    if (point->tlb_ns < 0.)
+        point->tlb_ns = 0.;
+    point->notlb_ns = point->ns[LATCURVE_RANDOM] - point->tlb_ns;
+    if (point->notlb_ns < 0.)
+        point->notlb_ns = 0.;
+}
+
+static void print_size(char *out, size_t len, size_t size)
+{
+    if (size >= 1024 * 1024 && size % (1024 * 1024) == 0)
+        snprintf(out, len, "%zu MB", size / (1024 * 1024));
+    else if (size >= 1024 * 1024)
+        snprintf(out, len, "%.1f MB", size / (1024. * 1024.));
+    else
+        snprintf(out, len, "%zu KB", size / 1024);
+}
+
+int latcurve_run(const struct latcurve_options *opt)
+{
+    size_t max_size = opt->max_size;
+    char *buffer_alloc = NULL;
+    int points = 0;
+
+    while (max_size >= opt->min_size)
+    {
+        buffer_alloc = (char *)malloc(max_size + LATCURVE_PAGE_SIZE - 1);
+        if (buffer_alloc)
+            break;
+        max_size /= 2;
+    }
+    if (!buffer_alloc)
+        return -1;
+
+    char *buffer = (char *)(((uintptr_t)buffer_alloc + LATCURVE_PAGE_SIZE - 1) & ~(uintptr_t)(LATCURVE_PAGE_SIZE - 1));
+    memset(buffer, 0, max_size);
+
+    printf("\n    size :    seq  stride    page  random :    tlb  no-tlb  (ns per load)\n");
+    bench_flush();
+
+    if (opt->csv)
+        fprintf(opt->csv, "size,seq_ns,stride_ns,page_ns,random_ns,tlb_ns,notlb_ns,knee\n");
+
+    int steps = opt->steps_per_octave > 0 ? opt->steps_per_octave : 1;
+    double prev_random = 0.;
+    size_t prev_size = 0;
+
+    for (int octave = 0; ; octave++)
+    {
+        size_t base = opt->min_size << octave;
+        if (base > max_size || base < opt->min_size)
+            break;
+
+        for (int step = 0; step < steps; step++)
+        {
+            /* base * 2^(step/steps), rounded down to whole pages */
+            size_t size = (size_t)((double)base * pow(2., (double)step / steps));
+            size &= ~(size_t)(LATCURVE_PAGE_SIZE - 1);
+            if (size > max_size || size == prev_size)
+                continue;
+
+            struct latcurve_point pt;
+            latcurve_measure(buffer, size, opt->count, opt->repeats, &pt);
+            pt.knee = prev_random > 0. && pt.ns[LATCURVE_RANDOM] > prev_random * KNEE_RATIO;
+            prev_random = pt.ns[LATCURVE_RANDOM];
+            prev_size = size;
+
+            char name[24];
+            print_size(name, sizeof(name), size);
+            printf("%8s : %6.1f  %6.1f  %6.1f  %6.1f : %6.1f  %6.1f%s\n", name,
+                   pt.ns[LATCURVE_SEQ], pt.ns[LATCURVE_STRIDED], pt.ns[LATCURVE_PAGE],
+                   pt.ns[LATCURVE_RANDOM], pt.tlb_ns, pt.notlb_ns, pt.knee ? "  <" : "");
+            bench_flush();
+
+            if (opt->csv)
+            {
+                fprintf(opt->csv, "%zu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%d\n", size,
+                        pt.ns[LATCURVE_SEQ], pt.ns[LATCURVE_STRIDED], pt.ns[LATCURVE_PAGE],
+                        pt.ns[LATCURVE_RANDOM], pt.tlb_ns, pt.notlb_ns, pt.knee);
+                fflush(opt->csv);
+            }
+            points++;
+        }
+    }
+
+    free(buffer_alloc);
+    return points;
+}
@@ -0,0 +1,74 @@
+/*
+ * TinyMemBenchNX latency curve
+ *
+ * Dependent pointer chasing over working sets from a few KB up to the
+ * largest buffer that can be allocated, a few steps per octave, with four
+ * access patterns:
+ *
+ *   seq     every cache line in order (prefetcher friendly)
+ *   stride  every LATCURVE_STRIDE bytes in order
+ *   page    one line per page, pages in random order; line offsets are
+ *           staggered so the data itself is only size / 64 bytes
+ *   random  every line in random order
+ *
+ * The page pattern touches as many pages as random but has 1/64 of its
+ * data, so page(size) - random(size / 64) is the cost of the page walks
+ * and random(size) minus that is what the access costs with a TLB hit,
+ * i.e. the cache or DRAM latency alone.
+ *
+ * Plain C, so it runs the same on the Switch and on any host.
+ */
+
+#ifndef __LATENCY_CURVE_H__
+#define __LATENCY_CURVE_H__
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define LATCURVE_PAGE_SIZE  4096
+#define LATCURVE_LINE_SIZE  64
+#define LATCURVE_STRIDE     256
+
+enum latcurve_pattern
+{
+    LATCURVE_SEQ,
+    LATCURVE_STRIDED,
+    LATCURVE_PAGE,
+    LATCURVE_RANDOM,
+    LATCURVE_PATTERNS,
+};
+
+struct latcurve_point
+{
+    size_t size;
+    double ns[LATCURVE_PATTERNS];   /* per dependent load */
+    double tlb_ns;                  /* page walk share of a random access */
+    double notlb_ns;                /* random access with a TLB hit */
+    int knee;                       /* random latency jumped from the previous size */
+};
+
+struct latcurve_options
+{
+    size_t min_size, max_size;      /* max_size is halved until it can be allocated */
+    int steps_per_octave;
+    int count;                      /* loads per measurement */
+    int repeats;                    /* best of */
+    FILE *csv;                      /* may be NULL */
+};
+
+/* Prints the curve as it is measured. Returns the number of points, -1 if
+ * no buffer could be allocated. */
+int latcurve_run(const struct latcurve_options *opt);
+
+/* Builds pattern over size bytes of a page aligned buffer as one cycle of
+ * pointers, returns the first node */
+void **latcurve_build_chain(char *buffer, size_t size, enum latcurve_pattern pattern);
+
+/* Follows count (a multiple of 16) pointers, returns where it stopped */
+void **latcurve_chase(void **p, int count);
+
+/* One point, buffer must hold point->size bytes and be page aligned */
+void latcurve_measure(char *buffer, size_t size, int count, int repeats,
+                      struct latcurve_point *point);
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * TinyMemBenchNX frequency sweep
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sweep.h"
+#include "bench.h"
+
+const char *const sweep_default_kernels[] =
+{
+    "NEON LDP/STP copy (COPY)",
+    "NEON STP fill (WRITE)",
+    "NEON STNP fill",
+    "C copy",
+    "C fill",
+    NULL
+};
+
+struct sweep_writer
+{
+    FILE *json, *csv;
+    int rows;
+};
+
+static void writer_begin(struct sweep_writer *w, const struct sweep_options *opt)
+{
+    w->json = opt->json;
+    w->csv = opt->csv;
+    w->rows = 0;
+
+    if (w->json)
+        fprintf(w->json, "{\n  \"results\": [");
+    if (w->csv)
+        fprintf(w->csv, "cpu_mhz,mem_mhz,threads,test,mbps,latency_ns\n");
+}
+
+static void writer_row(struct sweep_writer *w, u32 cpu_hz, u32 mem_hz, int threads,
+                       const char *test, double mbps, double latency_ns)
+{
+    if (w->json)
+    {
+        fprintf(w->json, "%s\n    { \"cpu_hz\": %u, \"mem_hz\": %u, \"threads\": %d, \"test\": \"%s\", ",
+                w->rows ? "," : "", (unsigned)cpu_hz, (unsigned)mem_hz, threads, test);
+        if (latency_ns >= 0)
+            fprintf(w->json, "\"latency_ns\": %.2f }", latency_ns);
+        else
+            fprintf(w->json, "\"mbps\": %.1f }", mbps);
+        fflush(w->json);
+    }
+    if (w->csv)
+    {
+        fprintf(w->csv, "%.1f,%.1f,%d,%s,", cpu_hz / 1000000., mem_hz / 1000000., threads, test);
+        if (latency_ns >= 0)
+            fprintf(w->csv, ",%.2f\n", latency_ns);
+        else
+            fprintf(w->csv, "%.1f,\n", mbps);
+        fflush(w->csv);
+    }
+    w->rows++;
+}
+
+static void writer_end(struct sweep_writer *w, Result rc)
+{
+    if (w->json)
+        fprintf(w->json, "%s  ],\n  \"rc\": %u\n}\n", w->rows ? "\n" : "", (unsigned)rc);
+}
+
+/* Frequencies to visit for a module: the whole list, or just the current clock (0) */
+static Result sweep_freqs(SysClkModule module, bool sweep, u32 *list, u32 *count)
+{
+    if (!sweep)
+    {
+        list[0] = 0;
+        *count = 1;
+        return 0;
+    }
+    return sysclkIpcGetFreqList(module, list, SYSCLK_FREQ_LIST_MAX, count);
+}
+
+static Result sweep_set(SysClkModule module, u32 hz, u32 *out_hz)
+{
+    SysClkContext ctx;
+    Result rc;
+
+    if (hz)
+    {
+        rc = sysclkIpcSetOverride(module, hz);
+        if (R_FAILED(rc))
+            return rc;
+        *out_hz = hz;
+        return 0;
+    }
+
+    rc = sysclkIpcGetCurrentContext(&ctx);
+    if (R_SUCCEEDED(rc))
+        *out_hz = ctx.realFreqs[module] ? ctx.realFreqs[module] : ctx.freqs[module];
+    return rc;
+}
+
+Result sweep_run(const struct sweep_options *opt)
+{
+    u32 cpu_freqs[SYSCLK_FREQ_LIST_MAX], mem_freqs[SYSCLK_FREQ_LIST_MAX];
+    u32 cpu_count = 0, mem_count = 0;
+    struct sweep_writer w;
+    int64_t *srcbuf, *dstbuf, *tmpbuf;
+    void *poolbuf;
+    Result rc;
+
+    writer_begin(&w, opt);
+
+    rc = sweep_freqs(SysClkModule_CPU, opt->sweep_cpu, cpu_freqs, &cpu_count);
+    if (R_SUCCEEDED(rc))
+        rc = sweep_freqs(SysClkModule_MEM, opt->sweep_mem, mem_freqs, &mem_count);
+    if (R_FAILED(rc))
+    {
+        writer_end(&w, rc);
+        return rc;
+    }
+
+    poolbuf = alloc_four_nonaliased_buffers((void **)&srcbuf, SIZE * opt->max_threads,
+                                            (void **)&dstbuf, SIZE * opt->max_threads,
+                                            (void **)&tmpbuf, BLOCKSIZE * opt->max_threads,
+                                            NULL, 0);
+
+    for (u32 c = 0; c < cpu_count && R_SUCCEEDED(rc); c++)
+    {
+        for (u32 m = 0; m < mem_count && R_SUCCEEDED(rc); m++)
+        {
+            u32 cpu_hz = 0, mem_hz = 0;
+
+            rc = sweep_set(SysClkModule_CPU, cpu_freqs[c], &cpu_hz);
+            if (R_SUCCEEDED(rc))
+                rc = sweep_set(SysClkModule_MEM, mem_freqs[m], &mem_hz);
+            if (R_FAILED(rc))
+                break;
+
+            if (opt->settle_ms)
+                usleep(opt->settle_ms * 1000);
+
+            printf("== CPU: %.1f MHz, MEM: %.1f MHz ==\n", cpu_hz / 1000000., mem_hz / 1000000.);
+            bench_flush();
+
+            for (int k = 0; opt->kernels[k]; k++)
+            {
+                const bench_info *bi = bench_find(opt->kernels[k]);
+                if (!bi)
+                    continue;
+
+                for (int threads = opt->min_threads; threads <= opt->max_threads; threads++)
+                {
+                    double mbps = bandwidth_bench_run(threads, dstbuf, srcbuf, tmpbuf,
+                                                      SIZE, BLOCKSIZE, bi, opt->repeats, NULL);
+                    printf(" %-32s x%d : %8.1f MB/s\n", bi->description, threads, mbps);
+                    bench_flush();
+                    writer_row(&w, cpu_hz, mem_hz, threads, bi->description, mbps, -1);
+                }
+            }
+
+            if (opt->latency_size)
+            {
+                double single_ns, dual_ns;
+                if (latency_bench_point(opt->latency_size, opt->latency_count, &single_ns, &dual_ns))
+                {
+                    printf(" %-32s    : %6.1f ns / %6.1f ns\n", "latency (single/dual)", single_ns, dual_ns);
+                    bench_flush();
+                    writer_row(&w, cpu_hz, mem_hz, 1, "latency single", 0, single_ns);
+                    writer_row(&w, cpu_hz, mem_hz, 1, "latency dual", 0, dual_ns);
+                }
+            }
+        }
+    }
+
+    free(poolbuf);
+
+    if (opt->sweep_cpu)
+        sysclkIpcRemoveOverride(SysClkModule_CPU);
+    if (opt->sweep_mem)
+        sysclkIpcRemoveOverride(SysClkModule_MEM);
+
+    writer_end(&w, rc);
+    return rc;
+}
@@ -0,0 +1,38 @@
+/*
+ * TinyMemBenchNX frequency sweep
+ *
+ * Steps the CPU and/or MEM clock through the frequencies horizon:oc reports
+ * and runs a set of bandwidth kernels (at every thread count) and a latency
+ * point at each step. Results are streamed as a JSON and/or CSV matrix.
+ *
+ * Clocks are only changed through the sysclkIpc* client API, so on a host
+ * the sweep runs against the sys-clk manager's pc_shim.
+ */
+
+#ifndef __SWEEP_H__
+#define __SWEEP_H__
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <sysclk/client/ipc.h>
+
+struct sweep_options
+{
+    const char *const *kernels;     /* bench_info descriptions, NULL terminated */
+    int min_threads, max_threads;
+    bool sweep_cpu, sweep_mem;      /* false keeps the current clock */
+    int latency_size;               /* working set of the latency point, 0 to skip */
+    int latency_count;
+    int repeats;                    /* bandwidth measurements per point */
+    unsigned int settle_ms;         /* wait after each clock change */
+    FILE *json, *csv;               /* either may be NULL */
+};
+
+/* Default kernels: NEON copy and fills, plus C versions for non-aarch64 hosts */
+extern const char *const sweep_default_kernels[];
+
+/* Returns the first IPC error, 0 on success. Overrides are removed afterwards. */
+Result sweep_run(const struct sweep_options *opt);
+
+#endif
@@ -47,7 +47,9 @@ typedef std::uint16_t u16;
 #include "sysclk/apm.h"
 #include "sysclk/config.h"
 #include "sysclk/errors.h"
+#ifdef __SWITCH__
 #include "sysclk/psm_ext.h"
+#endif
 
 #ifdef __cplusplus
 }
@@ -77,9 +77,12 @@ typedef enum
     SysClkPartLoad_EMC = 0,
     SysClkPartLoad_EMCCpu,
     HocClkPartLoad_GPU,
+    HocClkPartLoad_CPU,     // mean of the application cores
     SysClkPartLoad_EnumMax
 } SysClkPartLoad;
 
+#define HOCCLK_CPU_CORE_COUNT 4
+
 typedef enum
 {
     ReverseNX_NotFound = 0,
@@ -143,6 +146,23 @@ static inline const char* sysclkFormatPowerSensor(SysClkPowerSensor powSensor, b
     }
 }
 
+static inline const char* sysclkFormatPartLoad(SysClkPartLoad loadSource, bool pretty)
+{
+    switch(loadSource)
+    {
+        case SysClkPartLoad_EMC:
+            return pretty ? "EMC" : "emc";
+        case SysClkPartLoad_EMCCpu:
+            return pretty ? "EMC (CPU)" : "emc_cpu";
+        case HocClkPartLoad_GPU:
+            return pretty ? "GPU" : "gpu";
+        case HocClkPartLoad_CPU:
+            return pretty ? "CPU" : "cpu";
+        default:
+            return NULL;
+    }
+}
+
 static inline const char* sysclkFormatProfile(SysClkProfile profile, bool pretty)
 {
     switch(profile)
@@ -50,6 +50,64 @@ Result sysclkIpcSetConfigValues(SysClkConfigValueList* configValues);
 Result sysclkIpcGetFreqList(SysClkModule module, u32* list, u32 maxCount, u32* outCount);
 Result sysclkIpcSetReverseNXRTMode(ReverseNXMode mode);
 Result hocClkIpcUpdateEmcRegs();
+Result hocClkIpcGetLearnedProfiles(u64 tid, HocClkLearnedProfileList* out_learned);
+Result hocClkIpcGetEmcProfile(u64 tid, HocClkEmcProfile* out_profile);
+
+// Context change subscription: out_event gets signalled once any subscribed
+// field changed, hocClkIpcGetContextChanges then merges the changed fields
+// into inout_context and rearms the event
+Result hocClkIpcSubscribeContext(const HocClkContextSubscription* sub, u32* out_id, Handle* out_event);
+Result hocClkIpcGetContextChanges(u32 id, SysClkContext* inout_context, u32* out_changed);
+Result hocClkIpcUnsubscribeContext(u32 id, Handle event);
+bool hocClkIpcWaitContextChanged(Handle event, u64 timeout_ns);
+
+// Merges the fields changed since generation since (0 for all of them) into
+// inout_context, out_changed says which ones. Pass out_generation back next time
+Result hocClkIpcGetContextDelta(u32 since, SysClkContext* inout_context, u32* out_generation, u32* out_changed);
+
+// Applies up to HOCCLK_BATCH_MAX_OPS changes at once, with a single config
+// write and a single clock update. Nothing is applied if any op is invalid,
+// the first failing op's status is returned and out_result (optional) has all
+Result hocClkIpcApplyBatch(const HocClkBatchOp* ops, u32 count, HocClkBatchResult* out_result);
+
+// Tick phase latencies, fails with SysClkError_TickStatsDisabled unless the
+// sysmodule was built with TICK_STATS=1
+Result hocClkIpcGetTickStats(HocClkTickStats* out_stats);
+
+// Heap use and high-water mark, out of the sysmodule's fixed inner heap
+Result hocClkIpcGetHeapStats(HocClkHeapStats* out_stats);
+
+// Handheld battery draw of an operating point (hz in SysClkModule order), from
+// the sysmodule's power model. Fails with SysClkError_NoPowerEstimate until the
+// model has seen enough of the console
+Result hocClkIpcEstimatePowerMw(const u32* hz, s32* out_mw);
+
+// Cheapest known operating point running every module at least at minHz (0 = any)
+Result hocClkIpcFindCheapestOperatingPoint(const u32* minHz, HocClkOperatingPoint* out_point);
+
+static inline HocClkBatchOp hocClkBatchConfigValue(SysClkConfigValue kval, u64 value)
+{
+    HocClkBatchOp op = { HocClkBatchOp_ConfigValue, kval, 0, value };
+    return op;
+}
+
+static inline HocClkBatchOp hocClkBatchOverride(SysClkModule module, u32 hz)
+{
+    HocClkBatchOp op = { HocClkBatchOp_Override, module, 0, hz };
+    return op;
+}
+
+static inline HocClkBatchOp hocClkBatchProfile(u64 tid, SysClkProfile profile, SysClkModule module, u32 mhz)
+{
+    HocClkBatchOp op = { HocClkBatchOp_Profile, HOCCLK_BATCH_PROFILE_KEY(profile, module), tid, mhz };
+    return op;
+}
+
+static inline HocClkBatchOp hocClkBatchEnabled(bool enabled)
+{
+    HocClkBatchOp op = { HocClkBatchOp_Enabled, 0, 0, enabled };
+    return op;
+}
 
 static inline Result sysclkIpcRemoveOverride(SysClkModule module)
 {
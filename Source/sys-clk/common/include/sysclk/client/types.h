@@ -34,13 +34,16 @@
 
 #else
 
+#include <stdint.h>
+
 #define R_FAILED(res) ((res) != 0)
 #define R_SUCCEEDED(res) ((res) == 0)
 
-typedef std::uint32_t Result;
-typedef std::uint32_t u32;
-typedef std::int32_t s32;
-typedef std::uint64_t u64;
-typedef std::uint8_t u8;
+typedef uint32_t Result;
+typedef uint32_t Handle;
+typedef uint32_t u32;
+typedef int32_t s32;
+typedef uint64_t u64;
+typedef uint8_t u8;
 
 #endif
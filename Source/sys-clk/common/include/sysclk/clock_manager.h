@@ -28,6 +28,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <string.h>
 #include "board.h"
 
 typedef struct
@@ -42,9 +43,264 @@ typedef struct
     int32_t power[SysClkPowerSensor_EnumMax];
     uint32_t partLoad[SysClkPartLoad_EnumMax];
     uint32_t voltages[HocClkVoltage_EnumMax];
+    uint32_t cpuCoreLoad[HOCCLK_CPU_CORE_COUNT];
 //  uint32_t perfConfId;
 } SysClkContext;
 
+typedef enum
+{
+    HocClkContextField_Enabled = 0,
+    HocClkContextField_ApplicationId,
+    HocClkContextField_Profile,
+    HocClkContextField_Freqs,
+    HocClkContextField_RealFreqs,
+    HocClkContextField_OverrideFreqs,
+    HocClkContextField_Temps,
+    HocClkContextField_Power,
+    HocClkContextField_PartLoad,
+    HocClkContextField_Voltages,
+    HocClkContextField_CpuCoreLoad,
+    HocClkContextField_EnumMax,
+} HocClkContextField;
+
+#define HOCCLK_CONTEXT_FIELD(f) (1U << HocClkContextField_##f)
+#define HOCCLK_CONTEXT_FIELD_ALL ((1U << HocClkContextField_EnumMax) - 1)
+
+// What a context subscriber wants to hear about. A sensor field only
+// counts as changed once it moved at least its threshold away from the
+// value last delivered, 0 reports every change.
+typedef struct
+{
+    uint32_t fields;            // HOCCLK_CONTEXT_FIELD mask
+    uint32_t realFreqHz;
+    uint32_t tempMilliC;
+    uint32_t powerMw;
+    uint32_t loadPermille;      // partLoad and cpuCoreLoad
+    uint32_t voltageUv;
+} HocClkContextSubscription;
+
+typedef struct
+{
+    uint32_t changed;           // HOCCLK_CONTEXT_FIELD mask, only these are valid in context
+    SysClkContext context;
+} HocClkContextChanges;
+
+static inline bool sysclkContextMovedU32(const uint32_t* from, const uint32_t* to, unsigned int count, uint32_t threshold)
+{
+    for(unsigned int i = 0; i < count; i++)
+    {
+        uint32_t delta = to[i] > from[i] ? to[i] - from[i] : from[i] - to[i];
+        if(delta && delta >= threshold)
+            return true;
+    }
+    return false;
+}
+
+static inline bool sysclkContextMovedS32(const int32_t* from, const int32_t* to, unsigned int count, uint32_t threshold)
+{
+    for(unsigned int i = 0; i < count; i++)
+    {
+        int64_t delta = (int64_t)to[i] - from[i];
+        if(delta && (delta < 0 ? -delta : delta) >= threshold)
+            return true;
+    }
+    return false;
+}
+
+#define SYSCLK_CONTEXT_COUNT(ctx, field) (sizeof((ctx)->field) / sizeof((ctx)->field[0]))
+
+// Fields of sub->fields that differ between from and to
+static inline uint32_t sysclkContextChangedFields(const SysClkContext* from, const SysClkContext* to, const HocClkContextSubscription* sub)
+{
+    uint32_t changed = 0;
+
+    if(from->enabled != to->enabled)
+        changed |= HOCCLK_CONTEXT_FIELD(Enabled);
+    if(from->applicationId != to->applicationId)
+        changed |= HOCCLK_CONTEXT_FIELD(ApplicationId);
+    if(from->profile != to->profile)
+        changed |= HOCCLK_CONTEXT_FIELD(Profile);
+    if(memcmp(from->freqs, to->freqs, sizeof(from->freqs)))
+        changed |= HOCCLK_CONTEXT_FIELD(Freqs);
+    if(memcmp(from->overrideFreqs, to->overrideFreqs, sizeof(from->overrideFreqs)))
+        changed |= HOCCLK_CONTEXT_FIELD(OverrideFreqs);
+    if(sysclkContextMovedU32(from->realFreqs, to->realFreqs, SYSCLK_CONTEXT_COUNT(from, realFreqs), sub->realFreqHz))
+        changed |= HOCCLK_CONTEXT_FIELD(RealFreqs);
+    if(sysclkContextMovedU32(from->temps, to->temps, SYSCLK_CONTEXT_COUNT(from, temps), sub->tempMilliC))
+        changed |= HOCCLK_CONTEXT_FIELD(Temps);
+    if(sysclkContextMovedS32(from->power, to->power, SYSCLK_CONTEXT_COUNT(from, power), sub->powerMw))
+        changed |= HOCCLK_CONTEXT_FIELD(Power);
+    if(sysclkContextMovedU32(from->partLoad, to->partLoad, SYSCLK_CONTEXT_COUNT(from, partLoad), sub->loadPermille))
+        changed |= HOCCLK_CONTEXT_FIELD(PartLoad);
+    if(sysclkContextMovedU32(from->voltages, to->voltages, SYSCLK_CONTEXT_COUNT(from, voltages), sub->voltageUv))
+        changed |= HOCCLK_CONTEXT_FIELD(Voltages);
+    if(sysclkContextMovedU32(from->cpuCoreLoad, to->cpuCoreLoad, SYSCLK_CONTEXT_COUNT(from, cpuCoreLoad), sub->loadPermille))
+        changed |= HOCCLK_CONTEXT_FIELD(CpuCoreLoad);
+
+    return changed & sub->fields;
+}
+
+static inline void sysclkContextCopyFields(SysClkContext* dst, const SysClkContext* src, uint32_t fields)
+{
+    if(fields & HOCCLK_CONTEXT_FIELD(Enabled))
+        dst->enabled = src->enabled;
+    if(fields & HOCCLK_CONTEXT_FIELD(ApplicationId))
+        dst->applicationId = src->applicationId;
+    if(fields & HOCCLK_CONTEXT_FIELD(Profile))
+        dst->profile = src->profile;
+    if(fields & HOCCLK_CONTEXT_FIELD(Freqs))
+        memcpy(dst->freqs, src->freqs, sizeof(dst->freqs));
+    if(fields & HOCCLK_CONTEXT_FIELD(RealFreqs))
+        memcpy(dst->realFreqs, src->realFreqs, sizeof(dst->realFreqs));
+    if(fields & HOCCLK_CONTEXT_FIELD(OverrideFreqs))
+        memcpy(dst->overrideFreqs, src->overrideFreqs, sizeof(dst->overrideFreqs));
+    if(fields & HOCCLK_CONTEXT_FIELD(Temps))
+        memcpy(dst->temps, src->temps, sizeof(dst->temps));
+    if(fields & HOCCLK_CONTEXT_FIELD(Power))
+        memcpy(dst->power, src->power, sizeof(dst->power));
+    if(fields & HOCCLK_CONTEXT_FIELD(PartLoad))
+        memcpy(dst->partLoad, src->partLoad, sizeof(dst->partLoad));
+    if(fields & HOCCLK_CONTEXT_FIELD(Voltages))
+        memcpy(dst->voltages, src->voltages, sizeof(dst->voltages));
+    if(fields & HOCCLK_CONTEXT_FIELD(CpuCoreLoad))
+        memcpy(dst->cpuCoreLoad, src->cpuCoreLoad, sizeof(dst->cpuCoreLoad));
+}
+
+// Every published context that differs from the previous one gets the next
+// generation, and each field remembers the generation it last changed in
+typedef struct
+{
+    uint32_t generation;
+    uint32_t fieldGeneration[HocClkContextField_EnumMax];
+} HocClkContextGenerations;
+
+// Fields changed since a generation, packed back to back in field order
+typedef struct
+{
+    uint32_t generation;        // pass back as since next time
+    uint16_t fields;            // HOCCLK_CONTEXT_FIELD mask of what data holds
+    uint16_t size;              // bytes used in data
+    uint8_t data[sizeof(SysClkContext)];
+} HocClkContextDelta;
+
+#define HOCCLK_CONTEXT_DELTA_HEADER_SIZE offsetof(HocClkContextDelta, data)
+
+#define HOCCLK_CONTEXT_MEMBER(member) \
+    *out_size = sizeof(((SysClkContext*)0)->member); \
+    return offsetof(SysClkContext, member)
+
+static inline size_t hocClkContextFieldOffset(HocClkContextField field, size_t* out_size)
+{
+    switch(field)
+    {
+        case HocClkContextField_Enabled:       HOCCLK_CONTEXT_MEMBER(enabled);
+        case HocClkContextField_ApplicationId: HOCCLK_CONTEXT_MEMBER(applicationId);
+        case HocClkContextField_Profile:       HOCCLK_CONTEXT_MEMBER(profile);
+        case HocClkContextField_Freqs:         HOCCLK_CONTEXT_MEMBER(freqs);
+        case HocClkContextField_RealFreqs:     HOCCLK_CONTEXT_MEMBER(realFreqs);
+        case HocClkContextField_OverrideFreqs: HOCCLK_CONTEXT_MEMBER(overrideFreqs);
+        case HocClkContextField_Temps:         HOCCLK_CONTEXT_MEMBER(temps);
+        case HocClkContextField_Power:         HOCCLK_CONTEXT_MEMBER(power);
+        case HocClkContextField_PartLoad:      HOCCLK_CONTEXT_MEMBER(partLoad);
+        case HocClkContextField_Voltages:      HOCCLK_CONTEXT_MEMBER(voltages);
+        case HocClkContextField_CpuCoreLoad:   HOCCLK_CONTEXT_MEMBER(cpuCoreLoad);
+        default:
+            *out_size = 0;
+            return 0;
+    }
+}
+
+#undef HOCCLK_CONTEXT_MEMBER
+
+static inline void hocClkContextGenerationsInit(HocClkContextGenerations* gens)
+{
+    gens->generation = 1;
+    for(unsigned int i = 0; i < HocClkContextField_EnumMax; i++)
+        gens->fieldGeneration[i] = 1;
+}
+
+static inline void hocClkContextBump(HocClkContextGenerations* gens, uint32_t changed)
+{
+    if(!changed)
+        return;
+
+    gens->generation++;
+    for(unsigned int i = 0; i < HocClkContextField_EnumMax; i++)
+    {
+        if(changed & (1U << i))
+            gens->fieldGeneration[i] = gens->generation;
+    }
+}
+
+static inline uint32_t hocClkContextFieldsSince(const HocClkContextGenerations* gens, uint32_t since)
+{
+    // 0 asks for everything, a generation from the future means the sysmodule restarted
+    if(!since || since > gens->generation)
+        return HOCCLK_CONTEXT_FIELD_ALL;
+
+    uint32_t fields = 0;
+    for(unsigned int i = 0; i < HocClkContextField_EnumMax; i++)
+    {
+        if(gens->fieldGeneration[i] > since)
+            fields |= 1U << i;
+    }
+    return fields;
+}
+
+// Returns the bytes to send, header included
+static inline size_t hocClkEncodeContextDelta(const SysClkContext* ctx, uint32_t fields, uint32_t generation, HocClkContextDelta* out)
+{
+    uint16_t size = 0;
+
+    for(unsigned int i = 0; i < HocClkContextField_EnumMax; i++)
+    {
+        size_t fieldSize;
+        size_t offset = hocClkContextFieldOffset((HocClkContextField)i, &fieldSize);
+        if(fields & (1U << i))
+        {
+            memcpy(&out->data[size], (const uint8_t*)ctx + offset, fieldSize);
+            size += fieldSize;
+        }
+    }
+
+    out->generation = generation;
+    out->fields = fields & HOCCLK_CONTEXT_FIELD_ALL;
+    out->size = size;
+    return HOCCLK_CONTEXT_DELTA_HEADER_SIZE + size;
+}
+
+// Merges the delta into inout, false if received (header included) doesn't hold a valid one
+static inline bool hocClkDecodeContextDelta(const HocClkContextDelta* delta, size_t received, SysClkContext* inout)
+{
+    if(received < HOCCLK_CONTEXT_DELTA_HEADER_SIZE || (delta->fields & ~HOCCLK_CONTEXT_FIELD_ALL) ||
+       delta->size > sizeof(delta->data) || delta->size > received - HOCCLK_CONTEXT_DELTA_HEADER_SIZE)
+        return false;
+
+    size_t expected = 0;
+    for(unsigned int i = 0; i < HocClkContextField_EnumMax; i++)
+    {
+        size_t fieldSize;
+        hocClkContextFieldOffset((HocClkContextField)i, &fieldSize);
+        if(delta->fields & (1U << i))
+            expected += fieldSize;
+    }
+    if(expected != delta->size)
+        return false;
+
+    size_t pos = 0;
+    for(unsigned int i = 0; i < HocClkContextField_EnumMax; i++)
+    {
+        size_t fieldSize;
+        size_t offset = hocClkContextFieldOffset((HocClkContextField)i, &fieldSize);
+        if(delta->fields & (1U << i))
+        {
+            memcpy((uint8_t*)inout + offset, &delta->data[pos], fieldSize);
+            pos += fieldSize;
+        }
+    }
+    return true;
+}
+
 typedef struct
 {
     union {
@@ -53,4 +309,134 @@ typedef struct
     };
 } SysClkTitleProfileList;
 
+typedef struct
+{
+    SysClkTitleProfileList profiles;    // 0 MHz where there is nothing to propose yet
+    uint32_t samples[SysClkProfile_EnumMax];
+} HocClkLearnedProfileList;
+
+#define HOCCLK_EMC_PROFILE_BUCKETS 20   // 5% each
+
+typedef struct
+{
+    uint64_t applicationId;
+    uint32_t samples;
+    uint32_t intervalUs;
+    uint32_t histogram[HOCCLK_EMC_PROFILE_BUCKETS];     // EMC utilisation, every client
+    uint32_t cpuHistogram[HOCCLK_EMC_PROFILE_BUCKETS];  // the CPU's part of it
+    uint32_t meanPermille;
+    uint32_t cpuMeanPermille;
+    uint32_t peakPermille;
+    uint32_t saturatedSamples;  // at or over HOCCLK_EMC_PROFILE_SATURATED
+    uint32_t bursts;            // runs of saturated samples
+    uint32_t longestBurstMs;
+    uint32_t meanMemMHz;
+} HocClkEmcProfile;
+
+#define HOCCLK_EMC_PROFILE_SATURATED 900
+
+typedef enum
+{
+    HocClkTickPhase_Total = 0,
+    HocClkTickPhase_Apm,            // performance configuration and operation mode
+    HocClkTickPhase_Sd1Voltage,     // EMC DVFS, SD1 over I2C
+    HocClkTickPhase_Limits,         // TDP, board limit and thermal throttle
+    HocClkTickPhase_Context,        // enabled, title, profile, clocks and overrides
+    HocClkTickPhase_Sensors,        // temperatures, power, loads and voltages
+    HocClkTickPhase_RealFreqs,      // PTO measurements
+    HocClkTickPhase_Models,         // CSV, power model and profile learner
+    HocClkTickPhase_ConfigRefresh,
+    HocClkTickPhase_SetHz,
+    HocClkTickPhase_EnumMax,
+} HocClkTickPhase;
+
+// Bucket i holds [2^i, 2^(i+1)) us, the first one starts at 0 and the last one is open
+#define HOCCLK_TICK_STATS_BUCKETS 18
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint32_t histogram[HOCCLK_TICK_STATS_BUCKETS];
+} HocClkTickPhaseStats;
+
+typedef struct
+{
+    HocClkTickPhaseStats phases[HocClkTickPhase_EnumMax];
+} HocClkTickStats;
+
+// operator new and delete in the sysmodule, C allocations (stdio) aside
+typedef struct
+{
+    uint32_t heapSize;          // the whole inner heap
+    uint32_t usedBytes;
+    uint32_t peakBytes;         // high-water mark of usedBytes since boot
+    uint32_t allocCount;        // since boot
+    uint32_t freeCount;
+} HocClkHeapStats;
+
+static inline const char* hocClkFormatTickPhase(HocClkTickPhase phase, bool pretty)
+{
+    switch(phase)
+    {
+        case HocClkTickPhase_Total:
+            return pretty ? "Total" : "total";
+        case HocClkTickPhase_Apm:
+            return pretty ? "APM" : "apm";
+        case HocClkTickPhase_Sd1Voltage:
+            return pretty ? "SD1 Voltage" : "sd1";
+        case HocClkTickPhase_Limits:
+            return pretty ? "Limits" : "limits";
+        case HocClkTickPhase_Context:
+            return pretty ? "Context" : "context";
+        case HocClkTickPhase_Sensors:
+            return pretty ? "Sensors" : "sensors";
+        case HocClkTickPhase_RealFreqs:
+            return pretty ? "Real Freqs" : "real_freqs";
+        case HocClkTickPhase_Models:
+            return pretty ? "Models" : "models";
+        case HocClkTickPhase_ConfigRefresh:
+            return pretty ? "Config Refresh" : "config";
+        case HocClkTickPhase_SetHz:
+            return pretty ? "Set Clocks" : "set_hz";
+        default:
+            return NULL;
+    }
+}
+
+static inline uint32_t hocClkTickStatsBucket(uint32_t us)
+{
+    uint32_t bucket = 0;
+    while(us > 1 && bucket < HOCCLK_TICK_STATS_BUCKETS - 1)
+    {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+// Upper edge of the bucket holding the percentile, capped by the max seen
+static inline uint32_t hocClkTickStatsPercentileUs(const HocClkTickPhaseStats* stats, uint32_t percent)
+{
+    uint64_t total = 0;
+    for(uint32_t i = 0; i < HOCCLK_TICK_STATS_BUCKETS; i++)
+        total += stats->histogram[i];
+
+    if(!total)
+        return 0;
+
+    uint64_t seen = 0;
+    uint32_t bucket = 0;
+    for(; bucket < HOCCLK_TICK_STATS_BUCKETS - 1; bucket++)
+    {
+        seen += stats->histogram[bucket];
+        if(seen * 100 >= total * percent)
+            break;
+    }
+
+    uint32_t edge = (2U << bucket) - 1;
+    return edge < stats->maxUs ? edge : stats->maxUs;
+}
+
 #define SYSCLK_FREQ_LIST_MAX 32
\ No newline at end of file
@@ -29,6 +29,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 typedef enum {
     SysClkConfigValue_PollingIntervalMs = 0,
@@ -66,6 +67,28 @@ typedef enum {
     HocClkConfigValue_EMCVdd2VoltageUV,
     HocClkConfigValue_EMCVdd2VoltageUVStockErista,
     HocClkConfigValue_EMCVdd2VoltageUVStockMariko,
+
+    HocClkConfigValue_ProfileLearning,
+    HocClkConfigValue_ProfileLearningHeadroom,
+
+    HocClkConfigValue_LoadBurst,
+    HocClkConfigValue_LoadBurstMaxMs,
+    HocClkConfigValue_LoadBurstCpuMHz,
+    HocClkConfigValue_LoadBurstMemMHz,
+
+    HocClkConfigValue_CpuLoadWindowMs,
+
+    HocClkConfigValue_GpuLoadSmoothing,
+    HocClkConfigValue_GpuLoadSmoothMs,
+    HocClkConfigValue_GpuLoadIntervalMs,
+
+    HocClkConfigValue_EmcProfiler,
+    HocClkConfigValue_EmcProfilerIntervalMs,
+
+    HocClkConfigValue_PowerBudgetCpuMemCaps,
+    HocClkConfigValue_PowerBudgetBattery,
+
+    HocClkConfigValue_TickStatsLogIntervalMs,
     SysClkConfigValue_EnumMax,
 } SysClkConfigValue;
 
@@ -142,6 +165,36 @@ static inline const char* sysclkFormatConfigValue(SysClkConfigValue val, bool pr
             return pretty ? "Stock EMC Vdd2 Voltage" : "emc_vdd2_voltage_uv_s_e";
         case HocClkConfigValue_EMCVdd2VoltageUVStockMariko:
             return pretty ? "Stock EMC Vdd2 Voltage" : "emc_vdd2_voltage_uv_s_m";
+        case HocClkConfigValue_ProfileLearning:
+            return pretty ? "Profile Learning" : "profile_learning";
+        case HocClkConfigValue_ProfileLearningHeadroom:
+            return pretty ? "Learning Load Target" : "profile_learning_headroom";
+        case HocClkConfigValue_LoadBurst:
+            return pretty ? "Load Screen Burst" : "load_burst";
+        case HocClkConfigValue_LoadBurstMaxMs:
+            return pretty ? "Max Burst Length (ms)" : "load_burst_max_ms";
+        case HocClkConfigValue_LoadBurstCpuMHz:
+            return pretty ? "Burst CPU Clock (MHz)" : "load_burst_cpu_mhz";
+        case HocClkConfigValue_LoadBurstMemMHz:
+            return pretty ? "Burst MEM Clock (MHz)" : "load_burst_mem_mhz";
+        case HocClkConfigValue_CpuLoadWindowMs:
+            return pretty ? "CPU Load Window (ms)" : "cpu_load_window_ms";
+        case HocClkConfigValue_GpuLoadSmoothing:
+            return pretty ? "GPU Load Windowed Mean" : "gpu_load_windowed";
+        case HocClkConfigValue_GpuLoadSmoothMs:
+            return pretty ? "GPU Load Smoothing (ms)" : "gpu_load_smooth_ms";
+        case HocClkConfigValue_GpuLoadIntervalMs:
+            return pretty ? "GPU Load Min Interval (ms)" : "gpu_load_interval_ms";
+        case HocClkConfigValue_EmcProfiler:
+            return pretty ? "EMC Bandwidth Profiler" : "emc_profiler";
+        case HocClkConfigValue_EmcProfilerIntervalMs:
+            return pretty ? "EMC Profiler Interval (ms)" : "emc_profiler_interval_ms";
+        case HocClkConfigValue_PowerBudgetCpuMemCaps:
+            return pretty ? "Power Budget CPU/MEM Caps" : "power_budget_cpu_mem_caps";
+        case HocClkConfigValue_PowerBudgetBattery:
+            return pretty ? "Battery-Aware Power Budget" : "power_budget_battery";
+        case HocClkConfigValue_TickStatsLogIntervalMs:
+            return pretty ? "Tick timings logging interval (ms)" : "tick_stats_log_interval_ms";
         default:
             return pretty ? "Null" : "null";
     }
@@ -157,6 +210,7 @@ static inline uint64_t sysclkDefaultConfigValue(SysClkConfigValue val)
         case SysClkConfigValue_FreqLogIntervalMs:
         case SysClkConfigValue_PowerLogIntervalMs:
         case SysClkConfigValue_CsvWriteIntervalMs:
+        case HocClkConfigValue_TickStatsLogIntervalMs:
         case HocClkConfigValue_UncappedClocks:
         case HocClkConfigValue_OverwriteBoostMode:
             return 0ULL;
@@ -195,6 +249,23 @@ static inline uint64_t sysclkDefaultConfigValue(SysClkConfigValue val)
             return 1125000ULL;
         case HocClkConfigValue_EMCVdd2VoltageUVStockMariko:
             return 1100000ULL;
+        case HocClkConfigValue_ProfileLearningHeadroom:
+            return 80ULL;
+        case HocClkConfigValue_LoadBurstMaxMs:
+            return 15000ULL;
+        // Stock boost mode clocks
+        case HocClkConfigValue_LoadBurstCpuMHz:
+            return 1785ULL;
+        case HocClkConfigValue_LoadBurstMemMHz:
+            return 1600ULL;
+        case HocClkConfigValue_CpuLoadWindowMs:
+            return 1000ULL;
+        case HocClkConfigValue_GpuLoadSmoothMs:
+            return 500ULL;
+        case HocClkConfigValue_GpuLoadIntervalMs:
+            return 100ULL;
+        case HocClkConfigValue_EmcProfilerIntervalMs:
+            return 20ULL;
         default:
             return 0ULL;
     }
@@ -215,16 +286,26 @@ static inline uint64_t sysclkValidConfigValue(SysClkConfigValue val, uint64_t in
         case HocClkConfigValue_ThermalThrottleThreshold:
         case HocClkConfigValue_HandheldTDPLimit:
         case HocClkConfigValue_LiteTDPLimit:
+        case HocClkConfigValue_LoadBurstMaxMs:
+        case HocClkConfigValue_LoadBurstCpuMHz:
+        case HocClkConfigValue_LoadBurstMemMHz:
+        case HocClkConfigValue_CpuLoadWindowMs:
+        case HocClkConfigValue_EmcProfilerIntervalMs:
         case SysClkConfigValue_PollingIntervalMs:
             return input > 0;
         case SysClkConfigValue_TempLogIntervalMs:
         case SysClkConfigValue_FreqLogIntervalMs:
         case SysClkConfigValue_PowerLogIntervalMs:
         case SysClkConfigValue_CsvWriteIntervalMs:
+        case HocClkConfigValue_TickStatsLogIntervalMs:
         case HocClkConfigValue_EMCVdd2VoltageUV:
         case HocClkConfigValue_EMCVdd2VoltageUVStockErista:
         case HocClkConfigValue_EMCVdd2VoltageUVStockMariko:
+        case HocClkConfigValue_GpuLoadSmoothMs:
+        case HocClkConfigValue_GpuLoadIntervalMs:
             return input >= 0;
+        case HocClkConfigValue_ProfileLearningHeadroom:
+            return input > 0 && input <= 100;
         case HocClkConfigValue_UncappedClocks:
         case HocClkConfigValue_OverwriteBoostMode:
         case HocClkConfigValue_ThermalThrottle:
@@ -233,6 +314,12 @@ static inline uint64_t sysclkValidConfigValue(SysClkConfigValue val, uint64_t in
         case HocClkConfigValue_HandheldTDP:
         case HocClkConfigValue_EnforceBoardLimit:
         case HocClkConfigValue_EMCDVFS:
+        case HocClkConfigValue_ProfileLearning:
+        case HocClkConfigValue_LoadBurst:
+        case HocClkConfigValue_GpuLoadSmoothing:
+        case HocClkConfigValue_EmcProfiler:
+        case HocClkConfigValue_PowerBudgetCpuMemCaps:
+        case HocClkConfigValue_PowerBudgetBattery:
             return (input & 0x1) == input;
         default:
             return false;
@@ -36,4 +36,11 @@ typedef enum
     SysClkError_ConfigNotLoaded = 1,
     SysClkError_ConfigSaveFailed = 2,
     HocClkError_SocThermFail = 3,
+    SysClkError_NoSuchSubscription = 4,
+    SysClkError_SubscriptionsFull = 5,
+    SysClkError_InvalidBatchOp = 6,
+    SysClkError_BatchAborted = 7,
+    SysClkError_TickStatsDisabled = 8,
+    SysClkError_BatchQueueFull = 9,
+    SysClkError_NoPowerEstimate = 10,
 } SysClkError;
@@ -30,8 +30,10 @@
 #include <stdint.h>
 #include "board.h"
 #include "clock_manager.h"
+#include "config.h"
+#include "errors.h"
 
-#define SYSCLK_IPC_API_VERSION 4
+#define SYSCLK_IPC_API_VERSION 5
 #define SYSCLK_IPC_SERVICE_NAME "horizon:oc"
 
 enum SysClkIpcCmd
@@ -50,6 +52,17 @@ enum SysClkIpcCmd
     SysClkIpcCmd_GetFreqList = 11,
     SysClkIpcCmd_SetReverseNXRTMode = 12,
     HocClkIpcCmd_UpdateEMCRegs = 13,
+    HocClkIpcCmd_GetLearnedProfiles = 14,
+    HocClkIpcCmd_GetEmcProfile = 15,
+    HocClkIpcCmd_SubscribeContext = 16,
+    HocClkIpcCmd_GetContextChanges = 17,
+    HocClkIpcCmd_UnsubscribeContext = 18,
+    HocClkIpcCmd_ApplyBatch = 19,
+    HocClkIpcCmd_GetContextDelta = 20,
+    HocClkIpcCmd_GetTickStats = 21,
+    HocClkIpcCmd_GetHeapStats = 22,
+    HocClkIpcCmd_EstimatePower = 23,
+    HocClkIpcCmd_FindCheapestOperatingPoint = 24,
 };
 
 
@@ -69,4 +82,90 @@ typedef struct
 {
     SysClkModule module;
     uint32_t maxCount;
-} SysClkIpc_GetFreqList_Args;
\ No newline at end of file
+} SysClkIpc_GetFreqList_Args;
+
+// Clocks in SysClkModule order, 0 in minHz leaves the module free
+typedef struct
+{
+    uint32_t hz[SysClkModule_EnumMax];
+} HocClkIpc_EstimatePower_Args;
+
+typedef struct
+{
+    uint32_t minHz[SysClkModule_EnumMax];
+} HocClkIpc_FindCheapest_Args;
+
+typedef struct
+{
+    uint32_t hz[SysClkModule_EnumMax];
+    int32_t mw;
+} HocClkOperatingPoint;
+
+#define HOCCLK_BATCH_MAX_OPS 32
+
+typedef enum
+{
+    HocClkBatchOp_ConfigValue = 0, // key: SysClkConfigValue
+    HocClkBatchOp_Override,        // key: SysClkModule, value: Hz, 0 removes it
+    HocClkBatchOp_Profile,         // key: HOCCLK_BATCH_PROFILE_KEY, value: MHz, 0 removes it
+    HocClkBatchOp_Enabled,         // value: 0 or 1
+    HocClkBatchOp_EnumMax,
+} HocClkBatchOpType;
+
+#define HOCCLK_BATCH_PROFILE_KEY(profile, module) ((uint32_t)(profile) * SysClkModule_EnumMax + (uint32_t)(module))
+#define HOCCLK_BATCH_PROFILE(key) ((SysClkProfile)((key) / SysClkModule_EnumMax))
+#define HOCCLK_BATCH_MODULE(key) ((SysClkModule)((key) % SysClkModule_EnumMax))
+
+typedef struct
+{
+    uint32_t type;
+    uint32_t key;
+    uint64_t tid; // HocClkBatchOp_Profile only
+    uint64_t value;
+} HocClkBatchOp;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t status[HOCCLK_BATCH_MAX_OPS]; // Result of each op, 0 once applied
+} HocClkBatchResult;
+
+static inline bool hocClkValidBatchOp(const HocClkBatchOp* op)
+{
+    switch(op->type)
+    {
+        case HocClkBatchOp_ConfigValue:
+            return SYSCLK_ENUM_VALID(SysClkConfigValue, op->key) && sysclkValidConfigValue((SysClkConfigValue)op->key, op->value);
+        case HocClkBatchOp_Override:
+            return SYSCLK_ENUM_VALID(SysClkModule, op->key) && op->value <= UINT32_MAX;
+        case HocClkBatchOp_Profile:
+            return op->tid && op->key < SysClkProfile_EnumMax * SysClkModule_EnumMax && op->value <= UINT32_MAX;
+        case HocClkBatchOp_Enabled:
+            return op->value <= 1;
+        default:
+            return false;
+    }
+}
+
+// A batch is applied whole or not at all: one bad op rejects every other one
+static inline bool hocClkCheckBatch(const HocClkBatchOp* ops, uint32_t count, HocClkBatchResult* out_result)
+{
+    bool valid = true;
+
+    out_result->count = count;
+    for(uint32_t i = 0; i < count; i++)
+    {
+        out_result->status[i] = hocClkValidBatchOp(&ops[i]) ? 0 : SYSCLK_ERROR(InvalidBatchOp);
+        valid &= !out_result->status[i];
+    }
+
+    for(uint32_t i = 0; !valid && i < count; i++)
+    {
+        if(!out_result->status[i])
+        {
+            out_result->status[i] = SYSCLK_ERROR(BatchAborted);
+        }
+    }
+
+    return valid;
+}
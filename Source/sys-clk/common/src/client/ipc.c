@@ -124,12 +124,18 @@ Result sysclkIpcSetProfiles(u64 tid, SysClkTitleProfileList* profiles)
 
 Result sysclkIpcGetConfigValues(SysClkConfigValueList* out_configValues)
 {
-    return serviceDispatchOut(&g_sysclkSrv, SysClkIpcCmd_GetConfigValues, *out_configValues);
+    return serviceDispatch(&g_sysclkSrv, SysClkIpcCmd_GetConfigValues,
+        .buffer_attrs = { SfBufferAttr_HipcMapAlias | SfBufferAttr_Out },
+        .buffers = {{out_configValues, sizeof(SysClkConfigValueList)}},
+    );
 }
 
 Result sysclkIpcSetConfigValues(SysClkConfigValueList* configValues)
 {
-    return serviceDispatchIn(&g_sysclkSrv, SysClkIpcCmd_SetConfigValues, *configValues);
+    return serviceDispatch(&g_sysclkSrv, SysClkIpcCmd_SetConfigValues,
+        .buffer_attrs = { SfBufferAttr_HipcMapAlias | SfBufferAttr_In },
+        .buffers = {{configValues, sizeof(SysClkConfigValueList)}},
+    );
 }
 
 Result sysclkIpcGetFreqList(SysClkModule module, u32* list, u32 maxCount, u32* outCount)
@@ -154,3 +160,121 @@ Result hocClkIpcUpdateEmcRegs()
     int nil = 0;
     return serviceDispatchIn(&g_sysclkSrv, SysClkIpcCmd_SetReverseNXRTMode, nil);
 }
+
+Result hocClkIpcGetLearnedProfiles(u64 tid, HocClkLearnedProfileList* out_learned)
+{
+    return serviceDispatchInOut(&g_sysclkSrv, HocClkIpcCmd_GetLearnedProfiles, tid, *out_learned);
+}
+
+Result hocClkIpcGetEmcProfile(u64 tid, HocClkEmcProfile* out_profile)
+{
+    return serviceDispatchInOut(&g_sysclkSrv, HocClkIpcCmd_GetEmcProfile, tid, *out_profile);
+}
+
+Result hocClkIpcSubscribeContext(const HocClkContextSubscription* sub, u32* out_id, Handle* out_event)
+{
+    return serviceDispatchInOut(&g_sysclkSrv, HocClkIpcCmd_SubscribeContext, *sub, *out_id,
+        .out_handle_attrs = { SfOutHandleAttr_HipcCopy },
+        .out_handles = out_event,
+    );
+}
+
+Result hocClkIpcGetContextChanges(u32 id, SysClkContext* inout_context, u32* out_changed)
+{
+    HocClkContextChanges changes;
+    Result rc = serviceDispatchInOut(&g_sysclkSrv, HocClkIpcCmd_GetContextChanges, id, changes);
+    if (R_SUCCEEDED(rc))
+    {
+        sysclkContextCopyFields(inout_context, &changes.context, changes.changed);
+        *out_changed = changes.changed;
+    }
+    return rc;
+}
+
+Result hocClkIpcUnsubscribeContext(u32 id, Handle event)
+{
+    Result rc = serviceDispatchIn(&g_sysclkSrv, HocClkIpcCmd_UnsubscribeContext, id);
+    svcCloseHandle(event);
+    return rc;
+}
+
+bool hocClkIpcWaitContextChanged(Handle event, u64 timeout_ns)
+{
+    return R_SUCCEEDED(svcWaitSynchronizationSingle(event, timeout_ns));
+}
+
+Result hocClkIpcGetContextDelta(u32 since, SysClkContext* inout_context, u32* out_generation, u32* out_changed)
+{
+    HocClkContextDelta delta;
+    Result rc = serviceDispatchInOut(&g_sysclkSrv, HocClkIpcCmd_GetContextDelta, since, delta);
+    if(R_FAILED(rc))
+    {
+        return rc;
+    }
+
+    if(!hocClkDecodeContextDelta(&delta, sizeof(delta), inout_context))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    *out_generation = delta.generation;
+    *out_changed = delta.fields;
+    return 0;
+}
+
+Result hocClkIpcApplyBatch(const HocClkBatchOp* ops, u32 count, HocClkBatchResult* out_result)
+{
+    HocClkBatchResult result;
+    Result rc = serviceDispatchOut(&g_sysclkSrv, HocClkIpcCmd_ApplyBatch, result,
+        .buffer_attrs = { SfBufferAttr_HipcMapAlias | SfBufferAttr_In },
+        .buffers = {{ops, count * sizeof(HocClkBatchOp)}},
+    );
+
+    if(R_FAILED(rc))
+    {
+        return rc;
+    }
+
+    if(out_result)
+    {
+        memcpy(out_result, &result, sizeof(HocClkBatchResult));
+    }
+
+    // The op that was rejected, not the ones aborted with it
+    for(u32 i = 0; i < result.count && i < HOCCLK_BATCH_MAX_OPS; i++)
+    {
+        if(result.status[i] && result.status[i] != SYSCLK_ERROR(BatchAborted))
+        {
+            return result.status[i];
+        }
+    }
+
+    return 0;
+}
+
+Result hocClkIpcGetTickStats(HocClkTickStats* out_stats)
+{
+    return serviceDispatch(&g_sysclkSrv, HocClkIpcCmd_GetTickStats,
+        .buffer_attrs = { SfBufferAttr_HipcMapAlias | SfBufferAttr_Out },
+        .buffers = {{out_stats, sizeof(HocClkTickStats)}},
+    );
+}
+
+Result hocClkIpcGetHeapStats(HocClkHeapStats* out_stats)
+{
+    return serviceDispatchOut(&g_sysclkSrv, HocClkIpcCmd_GetHeapStats, *out_stats);
+}
+
+Result hocClkIpcEstimatePowerMw(const u32* hz, s32* out_mw)
+{
+    HocClkIpc_EstimatePower_Args args;
+    memcpy(args.hz, hz, sizeof(args.hz));
+    return serviceDispatchInOut(&g_sysclkSrv, HocClkIpcCmd_EstimatePower, args, *out_mw);
+}
+
+Result hocClkIpcFindCheapestOperatingPoint(const u32* minHz, HocClkOperatingPoint* out_point)
+{
+    HocClkIpc_FindCheapest_Args args;
+    memcpy(args.minHz, minHz, sizeof(args.minHz));
+    return serviceDispatchInOut(&g_sysclkSrv, HocClkIpcCmd_FindCheapestOperatingPoint, args, *out_point);
+}
@@ -22,7 +22,7 @@
 
 #include "ipc.h"
 
-#if defined(__SWITCH__) && defined(__cplusplus)
+#ifdef __cplusplus
 #include "cpp_util.hpp"
 extern "C" {
 #endif
@@ -30,6 +30,6 @@ extern "C" {
 #include <sysclk.h>
 #include <sysclk/client/ipc.h>
 
-#if defined(__SWITCH__) && defined(__cplusplus)
+#ifdef __cplusplus
 }
 #endif
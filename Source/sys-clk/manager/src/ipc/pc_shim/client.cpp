@@ -183,8 +183,123 @@ Result sysclkIpcGetFreqList(SysClkModule module, u32* list, u32 maxCount, u32* o
     return 0;
 }
 
+Result hocClkIpcGetLearnedProfiles(u64 tid, HocClkLearnedProfileList* out_learned)
+{
+    // Nothing is ever learned by the shim
+    memset(out_learned, 0, sizeof(HocClkLearnedProfileList));
+    return 0;
+}
+
+Result hocClkIpcGetEmcProfile(u64 tid, HocClkEmcProfile* out_profile)
+{
+    // No actmon on the shim, the profile stays empty
+    memset(out_profile, 0, sizeof(HocClkEmcProfile));
+    out_profile->applicationId = tid;
+    return 0;
+}
+
+Result hocClkIpcSubscribeContext(const HocClkContextSubscription* sub, u32* out_id, Handle* out_event)
+{
+    // The subscription id doubles as the event handle
+    *out_id = g_server->SubscribeContext(sub);
+    *out_event = *out_id;
+    return 0;
+}
+
+Result hocClkIpcGetContextChanges(u32 id, SysClkContext* inout_context, u32* out_changed)
+{
+    HocClkContextChanges changes;
+    if(!g_server->GetContextChanges(id, &changes))
+    {
+        return SYSCLK_ERROR(NoSuchSubscription);
+    }
+
+    sysclkContextCopyFields(inout_context, &changes.context, changes.changed);
+    *out_changed = changes.changed;
+    return 0;
+}
+
+Result hocClkIpcUnsubscribeContext(u32 id, Handle event)
+{
+    return g_server->UnsubscribeContext(id) ? 0 : SYSCLK_ERROR(NoSuchSubscription);
+}
+
+bool hocClkIpcWaitContextChanged(Handle event, u64 timeout_ns)
+{
+    return g_server->WaitContextChanged(event, timeout_ns);
+}
+
+Result hocClkIpcGetContextDelta(u32 since, SysClkContext* inout_context, u32* out_generation, u32* out_changed)
+{
+    // Through the wire format, so the shim exercises the decoder too
+    HocClkContextDelta delta;
+    size_t size = g_server->GetContextDelta(since, &delta);
+    if(!hocClkDecodeContextDelta(&delta, size, inout_context))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    *out_generation = delta.generation;
+    *out_changed = delta.fields;
+    return 0;
+}
+
+Result hocClkIpcApplyBatch(const HocClkBatchOp* ops, u32 count, HocClkBatchResult* out_result)
+{
+    if(!count || count > HOCCLK_BATCH_MAX_OPS)
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    HocClkBatchResult result;
+    g_server->ApplyBatch(ops, count, &result);
+
+    if(out_result)
+    {
+        memcpy(out_result, &result, sizeof(HocClkBatchResult));
+    }
+
+    for(u32 i = 0; i < count; i++)
+    {
+        if(result.status[i] && result.status[i] != SYSCLK_ERROR(BatchAborted))
+        {
+            return result.status[i];
+        }
+    }
+
+    return 0;
+}
+
+Result hocClkIpcGetTickStats(HocClkTickStats* out_stats)
+{
+    // No tick loop to time on the shim
+    return SYSCLK_ERROR(TickStatsDisabled);
+}
+
+Result hocClkIpcGetHeapStats(HocClkHeapStats* out_stats)
+{
+    // The shim lives on the host heap, nothing to report
+    memset(out_stats, 0, sizeof(HocClkHeapStats));
+    return 0;
+}
+
+Result hocClkIpcEstimatePowerMw(const u32* hz, s32* out_mw)
+{
+    // No battery to learn from on the shim
+    return SYSCLK_ERROR(NoPowerEstimate);
+}
+
+Result hocClkIpcFindCheapestOperatingPoint(const u32* minHz, HocClkOperatingPoint* out_point)
+{
+    return SYSCLK_ERROR(NoPowerEstimate);
+}
+
 SysClkShimServer::SysClkShimServer()
 {
+    memset(&this->context, 0, sizeof(this->context));
+    memset(&this->publishedContext, 0, sizeof(this->publishedContext));
+    hocClkContextGenerationsInit(&this->generations);
+    this->nextSubscriptionId = 1;
     this->store = std::map<std::tuple<u64, SysClkModule, SysClkProfile>, u32>();
     this->SetContextApplicationId(0);
     this->SetContextHz(SysClkModule_CPU, 0);
@@ -210,6 +325,8 @@ SysClkShimServer::SysClkShimServer()
 void SysClkShimServer::SetContextApplicationId(u64 tid)
 {
     this->context.applicationId = tid;
+
+    this->NotifySubscribers();
 }
 
 void SysClkShimServer::SetContextHz(SysClkModule module, u32 hz)
@@ -218,6 +335,8 @@ void SysClkShimServer::SetContextHz(SysClkModule module, u32 hz)
     {
         this->context.freqs[module] = hz;
     }
+
+    this->NotifySubscribers();
 }
 
 void SysClkShimServer::SetContextRealHz(SysClkModule module, u32 hz)
@@ -226,6 +345,8 @@ void SysClkShimServer::SetContextRealHz(SysClkModule module, u32 hz)
     {
         this->context.realFreqs[module] = hz;
     }
+
+    this->NotifySubscribers();
 }
 
 void SysClkShimServer::SetContextTemp(SysClkThermalSensor sensor, u32 temp)
@@ -234,6 +355,8 @@ void SysClkShimServer::SetContextTemp(SysClkThermalSensor sensor, u32 temp)
     {
         this->context.temps[sensor] = temp;
     }
+
+    this->NotifySubscribers();
 }
 
 void SysClkShimServer::CopyContext(SysClkContext* out_context)
@@ -247,11 +370,15 @@ void SysClkShimServer::SetContextProfile(SysClkProfile profile)
     {
         this->context.profile = profile;
     }
+
+    this->NotifySubscribers();
 }
 
 void SysClkShimServer::SetContextEnabled(bool enabled)
 {
     this->context.enabled = enabled;
+
+    this->NotifySubscribers();
 }
 
 void SysClkShimServer::SetProfile(uint64_t applicationId, SysClkModule module, SysClkProfile profile, u32 mhz)
@@ -325,6 +452,8 @@ void SysClkShimServer::SetContextOverride(SysClkModule module, u32 hz)
     {
         this->context.overrideFreqs[module] = hz;
     }
+
+    this->NotifySubscribers();
 }
 
 u64 SysClkShimServer::GetConfigValue(SysClkConfigValue kval)
@@ -384,7 +513,7 @@ void SysClkShimServer::GetFreqList(SysClkModule module, u32* list, u32 maxCount,
     {
         std::vector<u32>::iterator iter = this->freqs[module].begin();
 
-        while(iter < this->freqs[module].end() && *outCount < maxCount)
+        while(iter < this->freqs[module].end() && count < maxCount)
         {
             *list = *iter;
             list++;
@@ -397,4 +526,107 @@ void SysClkShimServer::GetFreqList(SysClkModule module, u32* list, u32 maxCount,
     {
         *outCount = count;
     }
-}
\ No newline at end of file
+}
+
+u32 SysClkShimServer::SubscribeContext(const HocClkContextSubscription* sub)
+{
+    std::scoped_lock lock{this->subscriptionMutex};
+    u32 id = this->nextSubscriptionId++;
+    this->subscriptions[id] = { *sub, this->context, 0 };
+    return id;
+}
+
+bool SysClkShimServer::UnsubscribeContext(u32 id)
+{
+    std::scoped_lock lock{this->subscriptionMutex};
+    return this->subscriptions.erase(id) > 0;
+}
+
+bool SysClkShimServer::GetContextChanges(u32 id, HocClkContextChanges* out_changes)
+{
+    std::scoped_lock lock{this->subscriptionMutex};
+    std::map<u32, Subscription>::iterator it = this->subscriptions.find(id);
+    if(it == this->subscriptions.end())
+    {
+        return false;
+    }
+
+    Subscription& subscription = it->second;
+    memset(out_changes, 0, sizeof(HocClkContextChanges));
+    out_changes->changed = subscription.pending | sysclkContextChangedFields(&subscription.sent, &this->context, &subscription.sub);
+    sysclkContextCopyFields(&out_changes->context, &this->context, out_changes->changed);
+    sysclkContextCopyFields(&subscription.sent, &this->context, out_changes->changed);
+    subscription.pending = 0;
+    return true;
+}
+
+bool SysClkShimServer::WaitContextChanged(u32 id, u64 timeout_ns)
+{
+    std::unique_lock lock{this->subscriptionMutex};
+    return this->subscriptionCond.wait_for(lock, std::chrono::nanoseconds(timeout_ns), [this, id]
+    {
+        std::map<u32, Subscription>::iterator it = this->subscriptions.find(id);
+        return it != this->subscriptions.end() && it->second.pending;
+    });
+}
+
+size_t SysClkShimServer::GetContextDelta(u32 since, HocClkContextDelta* out_delta)
+{
+    std::scoped_lock lock{this->subscriptionMutex};
+    u32 fields = hocClkContextFieldsSince(&this->generations, since);
+    return hocClkEncodeContextDelta(&this->publishedContext, fields, this->generations.generation, out_delta);
+}
+
+void SysClkShimServer::NotifySubscribers()
+{
+    std::scoped_lock lock{this->subscriptionMutex};
+    bool signal = false;
+
+    static const HocClkContextSubscription exact = {HOCCLK_CONTEXT_FIELD_ALL, 0, 0, 0, 0, 0};
+    hocClkContextBump(&this->generations, sysclkContextChangedFields(&this->publishedContext, &this->context, &exact));
+    this->publishedContext = this->context;
+
+    for(auto& [id, subscription] : this->subscriptions)
+    {
+        u32 changed = sysclkContextChangedFields(&subscription.sent, &this->context, &subscription.sub);
+        signal |= changed && !subscription.pending;
+        subscription.pending |= changed;
+    }
+
+    if(signal)
+    {
+        this->subscriptionCond.notify_all();
+    }
+}
+
+bool SysClkShimServer::ApplyBatch(const HocClkBatchOp* ops, u32 count, HocClkBatchResult* out_result)
+{
+    if(!hocClkCheckBatch(ops, count, out_result))
+    {
+        return false;
+    }
+
+    // Straight to the fields, subscribers hear about the batch once
+    for(u32 i = 0; i < count; i++)
+    {
+        const HocClkBatchOp* op = &ops[i];
+        switch(op->type)
+        {
+            case HocClkBatchOp_ConfigValue:
+                this->configValues[op->key] = op->value;
+                break;
+            case HocClkBatchOp_Override:
+                this->context.overrideFreqs[op->key] = op->value;
+                break;
+            case HocClkBatchOp_Profile:
+                this->SetProfile(op->tid, HOCCLK_BATCH_MODULE(op->key), HOCCLK_BATCH_PROFILE(op->key), op->value);
+                break;
+            case HocClkBatchOp_Enabled:
+                this->context.enabled = op->value;
+                break;
+        }
+    }
+
+    this->NotifySubscribers();
+    return true;
+}
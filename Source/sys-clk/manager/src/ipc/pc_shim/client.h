@@ -23,6 +23,8 @@
 #include <map>
 #include <vector>
 #include <numeric>
+#include <mutex>
+#include <condition_variable>
 #include "../client.h"
 
 class SysClkShimServer
@@ -48,10 +50,31 @@ class SysClkShimServer
         void SetConfigValues(SysClkConfigValueList* configValues);
         void AddFreq(SysClkModule module, u32 hz);
         void GetFreqList(SysClkModule module, u32* list, u32 maxCount, u32* outCount);
+        u32 SubscribeContext(const HocClkContextSubscription* sub);
+        bool UnsubscribeContext(u32 id);
+        bool GetContextChanges(u32 id, HocClkContextChanges* out_changes);
+        bool WaitContextChanged(u32 id, u64 timeout_ns);
+        size_t GetContextDelta(u32 since, HocClkContextDelta* out_delta);
+        bool ApplyBatch(const HocClkBatchOp* ops, u32 count, HocClkBatchResult* out_result);
 
     protected:
+        struct Subscription
+        {
+            HocClkContextSubscription sub;
+            SysClkContext sent;
+            u32 pending;
+        };
+
+        void NotifySubscribers();
+
         SysClkContext context;
+        SysClkContext publishedContext;
+        HocClkContextGenerations generations;
         std::vector<u32> freqs[SysClkModule_EnumMax];
         std::map<std::tuple<u64, SysClkModule, SysClkProfile>, u32> store;
         u64 configValues[SysClkConfigValue_EnumMax];
+        std::map<u32, Subscription> subscriptions;
+        u32 nextSubscriptionId;
+        std::mutex subscriptionMutex;
+        std::condition_variable subscriptionCond;
 };
@@ -29,6 +29,12 @@ RefreshTask::RefreshTask() : RepeatingTask(REFRESH_INTERVAL)
 
 }
 
+RefreshTask::~RefreshTask()
+{
+    if (this->subscriptionId)
+        hocClkIpcUnsubscribeContext(this->subscriptionId, this->subscriptionEvent);
+}
+
 void RefreshTask::onStart()
 {
     Result rc = sysclkIpcGetCurrentContext(&this->oldContext);
@@ -36,51 +42,98 @@ void RefreshTask::onStart()
     {
         brls::Logger::error("Unable to get context");
         errorResult("sysclkIpcGetCurrentContext", rc);
+        return;
+    }
+
+    // Only wake up for what the listeners below care about, polling stays as a fallback
+    HocClkContextSubscription sub = {};
+    sub.fields = HOCCLK_CONTEXT_FIELD(Freqs) | HOCCLK_CONTEXT_FIELD(RealFreqs) | HOCCLK_CONTEXT_FIELD(ApplicationId) |
+                 HOCCLK_CONTEXT_FIELD(Profile) | HOCCLK_CONTEXT_FIELD(Temps);
+    if (R_FAILED(hocClkIpcSubscribeContext(&sub, &this->subscriptionId, &this->subscriptionEvent)))
+    {
+        brls::Logger::info("Context subscription unavailable, polling");
+        this->subscriptionId = 0;
     }
 }
 
+Result RefreshTask::fetchContext(SysClkContext* context, u32* changed)
+{
+    *context = this->oldContext;
+
+    if (this->subscriptionId)
+    {
+        if (R_SUCCEEDED(hocClkIpcGetContextChanges(this->subscriptionId, context, changed)))
+            return 0;
+
+        hocClkIpcUnsubscribeContext(this->subscriptionId, this->subscriptionEvent);
+        this->subscriptionId = 0;
+    }
+
+    // Polling still only moves what changed since the last call
+    if (R_SUCCEEDED(hocClkIpcGetContextDelta(this->contextGeneration, context, &this->contextGeneration, changed)))
+        return 0;
+
+    *changed = HOCCLK_CONTEXT_FIELD_ALL;
+    return sysclkIpcGetCurrentContext(context);
+}
+
 void RefreshTask::run(retro_time_t currentTime)
 {
     RepeatingTask::run(currentTime);
 
+    // Nothing to do until the sysmodule signals a change
+    if (this->subscriptionId && !hocClkIpcWaitContextChanged(this->subscriptionEvent, 0))
+        return;
+
     // Get new context
     SysClkContext context;
-    if (R_SUCCEEDED(sysclkIpcGetCurrentContext(&context)))
+    u32 changed;
+    if (R_SUCCEEDED(this->fetchContext(&context, &changed)))
     {
-        // CPU Freq
-        if (context.freqs[SysClkModule_CPU] != this->oldContext.freqs[SysClkModule_CPU])
-            this->freqUpdateEvent.fire(SysClkModule_CPU, context.freqs[SysClkModule_CPU]);
+        // Nothing moved, nothing to compare or redraw
+        if (!changed)
+            return;
 
-        // GPU Freq
-        if (context.freqs[SysClkModule_GPU] != this->oldContext.freqs[SysClkModule_GPU])
-            this->freqUpdateEvent.fire(SysClkModule_GPU, context.freqs[SysClkModule_GPU]);
+        if (changed & HOCCLK_CONTEXT_FIELD(Freqs))
+        {
+            // CPU Freq
+            if (context.freqs[SysClkModule_CPU] != this->oldContext.freqs[SysClkModule_CPU])
+                this->freqUpdateEvent.fire(SysClkModule_CPU, context.freqs[SysClkModule_CPU]);
 
-        // MEM Freq
-        if (context.freqs[SysClkModule_MEM] != this->oldContext.freqs[SysClkModule_MEM])
-            this->freqUpdateEvent.fire(SysClkModule_MEM, context.freqs[SysClkModule_MEM]);
+            // GPU Freq
+            if (context.freqs[SysClkModule_GPU] != this->oldContext.freqs[SysClkModule_GPU])
+                this->freqUpdateEvent.fire(SysClkModule_GPU, context.freqs[SysClkModule_GPU]);
 
-        // Real CPU Freq
-        if (context.realFreqs[SysClkModule_CPU] != this->oldContext.realFreqs[SysClkModule_CPU])
-            this->realFreqUpdateEvent.fire(SysClkModule_CPU, context.realFreqs[SysClkModule_CPU]);
+            // MEM Freq
+            if (context.freqs[SysClkModule_MEM] != this->oldContext.freqs[SysClkModule_MEM])
+                this->freqUpdateEvent.fire(SysClkModule_MEM, context.freqs[SysClkModule_MEM]);
+        }
 
-        // Real GPU Freq
-        if (context.realFreqs[SysClkModule_GPU] != this->oldContext.realFreqs[SysClkModule_GPU])
-            this->realFreqUpdateEvent.fire(SysClkModule_GPU, context.realFreqs[SysClkModule_GPU]);
+        if (changed & HOCCLK_CONTEXT_FIELD(RealFreqs))
+        {
+            // Real CPU Freq
+            if (context.realFreqs[SysClkModule_CPU] != this->oldContext.realFreqs[SysClkModule_CPU])
+                this->realFreqUpdateEvent.fire(SysClkModule_CPU, context.realFreqs[SysClkModule_CPU]);
 
-        // Real MEM Freq
-        if (context.realFreqs[SysClkModule_MEM] != this->oldContext.realFreqs[SysClkModule_MEM])
-            this->realFreqUpdateEvent.fire(SysClkModule_MEM, context.realFreqs[SysClkModule_MEM]);
+            // Real GPU Freq
+            if (context.realFreqs[SysClkModule_GPU] != this->oldContext.realFreqs[SysClkModule_GPU])
+                this->realFreqUpdateEvent.fire(SysClkModule_GPU, context.realFreqs[SysClkModule_GPU]);
+
+            // Real MEM Freq
+            if (context.realFreqs[SysClkModule_MEM] != this->oldContext.realFreqs[SysClkModule_MEM])
+                this->realFreqUpdateEvent.fire(SysClkModule_MEM, context.realFreqs[SysClkModule_MEM]);
+        }
 
         // Application ID
-        if (context.applicationId != this->oldContext.applicationId)
+        if ((changed & HOCCLK_CONTEXT_FIELD(ApplicationId)) && context.applicationId != this->oldContext.applicationId)
             this->appIdUpdateEvent.fire(context.applicationId);
 
         // Profile
-        if (context.profile != this->oldContext.profile)
+        if ((changed & HOCCLK_CONTEXT_FIELD(Profile)) && context.profile != this->oldContext.profile)
             this->profileUpdateEvent.fire(context.profile);
 
         // Only notify temp changes every other tick
-        if (this->shouldNotifyTempChange)
+        if (this->shouldNotifyTempChange && (changed & HOCCLK_CONTEXT_FIELD(Temps)))
         {
             // PCB Temp
             if (context.temps[SysClkThermalSensor_PCB] != this->oldContext.temps[SysClkThermalSensor_PCB])
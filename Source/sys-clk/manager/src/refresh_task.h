@@ -44,9 +44,15 @@ class RefreshTask : public brls::RepeatingTask
 
         bool shouldNotifyTempChange = true;
 
+        u32 subscriptionId = 0;
+        Handle subscriptionEvent = 0;
+        u32 contextGeneration = 0;
+
+        Result fetchContext(SysClkContext* context, u32* changed);
+
     public:
         RefreshTask();
-        ~RefreshTask() {}
+        ~RefreshTask();
 
         void onStart() override;
         void run(retro_time_t currentTime) override;
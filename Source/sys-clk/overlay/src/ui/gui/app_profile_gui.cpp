@@ -27,6 +27,8 @@
 
 #include "app_profile_gui.h"
 
+#include <cstring>
+
 #include "../format.h"
 #include "fatal_gui.h"
 
@@ -34,6 +36,7 @@ AppProfileGui::AppProfileGui(std::uint64_t applicationId, SysClkTitleProfileList
 {
     this->applicationId = applicationId;
     this->profileList = profileList;
+    memset(this->moduleItems, 0, sizeof(this->moduleItems));
 }
 
 AppProfileGui::~AppProfileGui()
@@ -41,6 +44,42 @@ AppProfileGui::~AppProfileGui()
     delete this->profileList;
 }
 
+void AppProfileGui::applyLearnedProfile()
+{
+    HocClkLearnedProfileList learned;
+    Result rc = hocClkIpcGetLearnedProfiles(this->applicationId, &learned);
+    if(R_FAILED(rc))
+    {
+        FatalGui::openWithResultCode("hocClkIpcGetLearnedProfiles", rc);
+        return;
+    }
+
+    // Only touch what has been learned, the rest of the profile stays as set
+    for(unsigned int profile = 0; profile < SysClkProfile_EnumMax; profile++)
+    {
+        for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            std::uint32_t mhz = learned.profiles.mhzMap[profile][module];
+            if(!mhz)
+            {
+                continue;
+            }
+
+            this->profileList->mhzMap[profile][module] = mhz;
+            if(this->moduleItems[profile][module])
+            {
+                this->moduleItems[profile][module]->setValue(formatListFreqMHz(mhz));
+            }
+        }
+    }
+
+    rc = sysclkIpcSetProfiles(this->applicationId, this->profileList);
+    if(R_FAILED(rc))
+    {
+        FatalGui::openWithResultCode("sysclkIpcSetProfiles", rc);
+    }
+}
+
 void AppProfileGui::openFreqChoiceGui(tsl::elm::ListItem* listItem, SysClkProfile profile, SysClkModule module)
 {
     std::uint32_t hzList[SYSCLK_FREQ_LIST_MAX];
@@ -95,6 +134,7 @@ void AppProfileGui::addModuleListItem(SysClkProfile profile, SysClkModule module
         return false;
     });
     this->listElement->addItem(listItem);
+    this->moduleItems[profile][module] = listItem;
 }
 
 void AppProfileGui::addProfileUI(SysClkProfile profile)
@@ -107,6 +147,20 @@ void AppProfileGui::addProfileUI(SysClkProfile profile)
 
 void AppProfileGui::listUI()
 {
+    if(this->applicationId != SYSCLK_GLOBAL_PROFILE_TID)
+    {
+        tsl::elm::ListItem* learnedItem = new tsl::elm::ListItem("Apply learned profile");
+        learnedItem->setClickListener([this](u64 keys) {
+            if((keys & HidNpadButton_A) == HidNpadButton_A)
+            {
+                this->applyLearnedProfile();
+                return true;
+            }
+            return false;
+        });
+        this->listElement->addItem(learnedItem);
+    }
+
     this->addProfileUI(SysClkProfile_Docked);
     this->addProfileUI(SysClkProfile_Handheld);
     this->addProfileUI(SysClkProfile_HandheldCharging);
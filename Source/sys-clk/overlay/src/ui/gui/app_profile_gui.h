@@ -37,7 +37,9 @@ class AppProfileGui : public BaseMenuGui
     protected:
         std::uint64_t applicationId;
         SysClkTitleProfileList* profileList;
+        tsl::elm::ListItem* moduleItems[SysClkProfile_EnumMax][SysClkModule_EnumMax];
 
+        void applyLearnedProfile();
         void openFreqChoiceGui(tsl::elm::ListItem* listItem, SysClkProfile profile, SysClkModule module);
         void addModuleListItem(SysClkProfile profile, SysClkModule module);
         void addProfileUI(SysClkProfile profile);
@@ -35,6 +35,10 @@ BaseMenuGui::BaseMenuGui() : tempColors{tsl::Color(0), tsl::Color(0), tsl::Color
     tsl::initializeThemeVars();
     this->context = nullptr;
     this->lastContextUpdate = 0;
+    this->subscriptionId = 0;
+    this->subscriptionEvent = INVALID_HANDLE;
+    this->subscriptionRefused = false;
+    this->contextGeneration = 0;
     this->listElement = nullptr;
     
     // Initialize all voltages to zero once
@@ -48,7 +52,47 @@ BaseMenuGui::BaseMenuGui() : tempColors{tsl::Color(0), tsl::Color(0), tsl::Color
 }
 
 BaseMenuGui::~BaseMenuGui() {
-    delete this->context; // delete handles nullptr automatically
+    if (this->subscriptionId) {
+        hocClkIpcUnsubscribeContext(this->subscriptionId, this->subscriptionEvent);
+    }
+}
+
+// Full context once, then only the fields the sysmodule reports as changed
+Result BaseMenuGui::fetchContext(u32* changed) {
+    if (this->subscriptionId) [[likely]] {
+        if (R_SUCCEEDED(hocClkIpcGetContextChanges(this->subscriptionId, this->context, changed))) [[likely]] {
+            return 0;
+        }
+
+        // Dropped by the sysmodule (we sat hidden for too long), start over
+        hocClkIpcUnsubscribeContext(this->subscriptionId, this->subscriptionEvent);
+        this->subscriptionId = 0;
+        this->contextGeneration = 0;
+    }
+
+    // Generation 0 gets every field, later calls what moved since
+    Result rc = hocClkIpcGetContextDelta(this->contextGeneration, this->context, &this->contextGeneration, changed);
+    if (R_FAILED(rc)) {
+        *changed = HOCCLK_CONTEXT_FIELD_ALL;
+        rc = sysclkIpcGetCurrentContext(this->context);
+    }
+
+    if (R_SUCCEEDED(rc) && !this->subscriptionId && !this->subscriptionRefused) {
+        // Roughly what the header can show, power and temps jitter below that
+        HocClkContextSubscription sub = {};
+        sub.fields = HOCCLK_CONTEXT_FIELD_ALL;
+        sub.realFreqHz = 100000;
+        sub.tempMilliC = 100;
+        sub.powerMw = 50;
+        sub.loadPermille = 10;
+        sub.voltageUv = 1000;
+        // Older sysmodules don't know the command, keep polling then
+        this->subscriptionRefused = R_FAILED(hocClkIpcSubscribeContext(&sub, &this->subscriptionId, &this->subscriptionEvent));
+        if (this->subscriptionRefused) {
+            this->subscriptionId = 0;
+        }
+    }
+    return rc;
 }
 
 // Fast preDraw - just renders pre-computed strings
@@ -156,20 +200,25 @@ void BaseMenuGui::preDraw(tsl::gfx::Renderer* renderer) {
     renderer->drawString(displayStrings[16], false, dataPositions[4], y, SMALL_TEXT_SIZE, tsl::infoTextColor);  // Power avg
 }
 
-// Optimized refresh - now does all the string formatting once per second
+// Optimized refresh - string formatting only when the context changed,
+// at most every 250 ms when subscribed, once per second when polling
 void BaseMenuGui::refresh()
 {
     const u64 ticks = armGetSystemTick();
-    // Use cached comparison - 1 billion nanoseconds
-    if (armTicksToNs(ticks - this->lastContextUpdate) <= 1000000000UL) [[likely]] {
+    const u64 minIntervalNs = this->subscriptionId ? 250000000UL : 1000000000UL;
+    if (armTicksToNs(ticks - this->lastContextUpdate) <= minIntervalNs) [[likely]] {
         return; // Early exit for most calls
     }
+
+    // No IPC at all while nothing moved
+    if (this->subscriptionId && !hocClkIpcWaitContextChanged(this->subscriptionEvent, 0)) [[likely]] {
+        return;
+    }
     
     this->lastContextUpdate = ticks;
     
-    // Lazy context allocation
     if (!this->context) [[unlikely]] {
-        this->context = new SysClkContext;
+        this->context = &this->contextStorage;
     }
 
     // === ULTRA-FAST VOLTAGE READING ===
@@ -184,11 +233,6 @@ void BaseMenuGui::refresh()
     
     // Voltage array for direct indexing
     u32* voltages[] = {&cpuVoltageUv, &gpuVoltageUv, &emcVoltageUv, &socVoltageUv, &vddVoltageUv};
-    *cpuVoltageUv = this->context->voltages[HocClkVoltage_CPU];
-    *gpuVoltageUv = this->context->voltages[HocClkVoltage_GPU];
-    *emcVoltageUv = this->context->voltages[HocClkVoltage_EMCVDD2];
-    *socVoltageUv = this->context->voltages[HocClkVoltage_SOC];
-    *vddVoltageUv = this->context->voltages[HocClkVoltage_EMCVDDQ_MarikoOnly];
 
     // Single regulator init/exit cycle
     // if (R_SUCCEEDED(rgltrInitialize())) [[likely]] {
@@ -231,76 +275,92 @@ void BaseMenuGui::refresh()
     // }
 
     // === SYSCLK CONTEXT UPDATE ===
-    const Result rc = sysclkIpcGetCurrentContext(this->context);
+    u32 changed;
+    const Result rc = this->fetchContext(&changed);
     if (R_FAILED(rc)) [[unlikely]] {
         FatalGui::openWithResultCode("sysclkIpcGetCurrentContext", rc);
         return;
     }
-    
-    // === FORMAT ALL DISPLAY STRINGS (once per second) ===
-    // App ID (hex conversion)
-    sprintf(displayStrings[0], "%016lX", context->applicationId);
-    
-    // Profile
-    strcpy(displayStrings[1], sysclkFormatProfile(context->profile, true));
-    
-    // Current frequencies
-    u32 hz = context->freqs[0]; // CPU
-    sprintf(displayStrings[2], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
-    
-    hz = context->freqs[1]; // GPU
-    sprintf(displayStrings[3], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
-    
-    hz = context->freqs[2]; // MEM
-    sprintf(displayStrings[4], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
-    
-    // Real frequencies
-    hz = context->realFreqs[0]; // CPU
-    sprintf(displayStrings[5], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
-    
-    hz = context->realFreqs[1]; // GPU
-    sprintf(displayStrings[6], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
-    
-    hz = context->realFreqs[2]; // MEM
-    sprintf(displayStrings[7], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
-    
-    // Voltages
-    sprintf(displayStrings[8], "%.1f mV", cpuVoltageUv / 1000.0);
-    sprintf(displayStrings[9], "%.1f mV", gpuVoltageUv / 1000.0);
 
-    // Memory voltage (handle VDD case)
-    if (emcVoltageUv && vddVoltageUv) {
-        //sprintf(displayStrings[10], "%u%u mV", vddVoltageUv / 1000U, emcVoltageUv / 1000U);
-        //sprintf(displayStrings[10], "%u%.1f mV", vddVoltageUv / 1000U, emcVoltageUv / 1000.0f);
-        sprintf(displayStrings[10], "%u.%u%u mV", vddVoltageUv / 1000U, (vddVoltageUv % 1000U) / 100U, emcVoltageUv / 1000U);
-    } else if (vddVoltageUv) {
-        //sprintf(displayStrings[10], "%u mV", vddVoltageUv / 1000U);
-        sprintf(displayStrings[10], "%u.%u mV", vddVoltageUv / 1000U, (vddVoltageUv % 1000U) / 100U);
-    } else if (emcVoltageUv) {
-        sprintf(displayStrings[10], "%u mV", emcVoltageUv / 1000U);
+    // === FORMAT DISPLAY STRINGS (only those whose fields moved) ===
+    if (changed & HOCCLK_CONTEXT_FIELD(ApplicationId)) {
+        // App ID (hex conversion)
+        sprintf(displayStrings[0], "%016lX", context->applicationId);
     }
-    
-    // Temperatures and pre-compute colors
-    u32 millis = context->temps[0]; // SOC
-    sprintf(displayStrings[11], "%u.%u °C", millis / 1000U, (millis % 1000U) / 100U);
-    tempColors[0] = tsl::GradientColor(millis * 0.001f);
-    
-    millis = context->temps[1]; // PCB
-    sprintf(displayStrings[12], "%u.%u °C", millis / 1000U, (millis % 1000U) / 100U);
-    tempColors[1] = tsl::GradientColor(millis * 0.001f);
-    
-    millis = context->temps[2]; // Skin
-    sprintf(displayStrings[13], "%u.%u °C", millis / 1000U, (millis % 1000U) / 100U);
-    tempColors[2] = tsl::GradientColor(millis * 0.001f);
-    
-    // SOC voltage (if available)
-    if (socVoltageUv) {
-        sprintf(displayStrings[14], "%u mV", socVoltageUv / 1000U);
+
+    if (changed & HOCCLK_CONTEXT_FIELD(Profile)) {
+        strcpy(displayStrings[1], sysclkFormatProfile(context->profile, true));
+    }
+
+    if (changed & HOCCLK_CONTEXT_FIELD(Freqs)) {
+        u32 hz = context->freqs[0]; // CPU
+        sprintf(displayStrings[2], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
+
+        hz = context->freqs[1]; // GPU
+        sprintf(displayStrings[3], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
+
+        hz = context->freqs[2]; // MEM
+        sprintf(displayStrings[4], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
+    }
+
+    if (changed & HOCCLK_CONTEXT_FIELD(RealFreqs)) {
+        u32 hz = context->realFreqs[0]; // CPU
+        sprintf(displayStrings[5], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
+
+        hz = context->realFreqs[1]; // GPU
+        sprintf(displayStrings[6], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
+
+        hz = context->realFreqs[2]; // MEM
+        sprintf(displayStrings[7], "%u.%u MHz", hz / 1000000U, (hz / 100000U) % 10U);
+    }
+
+    if (changed & HOCCLK_CONTEXT_FIELD(Voltages)) {
+        cpuVoltageUv = this->context->voltages[HocClkVoltage_CPU];
+        gpuVoltageUv = this->context->voltages[HocClkVoltage_GPU];
+        emcVoltageUv = this->context->voltages[HocClkVoltage_EMCVDD2];
+        socVoltageUv = this->context->voltages[HocClkVoltage_SOC];
+        vddVoltageUv = this->context->voltages[HocClkVoltage_EMCVDDQ_MarikoOnly];
+
+        sprintf(displayStrings[8], "%.1f mV", cpuVoltageUv / 1000.0);
+        sprintf(displayStrings[9], "%.1f mV", gpuVoltageUv / 1000.0);
+
+        // Memory voltage (handle VDD case)
+        if (emcVoltageUv && vddVoltageUv) {
+            //sprintf(displayStrings[10], "%u%u mV", vddVoltageUv / 1000U, emcVoltageUv / 1000U);
+            //sprintf(displayStrings[10], "%u%.1f mV", vddVoltageUv / 1000U, emcVoltageUv / 1000.0f);
+            sprintf(displayStrings[10], "%u.%u%u mV", vddVoltageUv / 1000U, (vddVoltageUv % 1000U) / 100U, emcVoltageUv / 1000U);
+        } else if (vddVoltageUv) {
+            //sprintf(displayStrings[10], "%u mV", vddVoltageUv / 1000U);
+            sprintf(displayStrings[10], "%u.%u mV", vddVoltageUv / 1000U, (vddVoltageUv % 1000U) / 100U);
+        } else if (emcVoltageUv) {
+            sprintf(displayStrings[10], "%u mV", emcVoltageUv / 1000U);
+        }
+
+        // SOC voltage (if available)
+        if (socVoltageUv) {
+            sprintf(displayStrings[14], "%u mV", socVoltageUv / 1000U);
+        }
+    }
+
+    if (changed & HOCCLK_CONTEXT_FIELD(Temps)) {
+        // Temperatures and pre-compute colors
+        u32 millis = context->temps[0]; // SOC
+        sprintf(displayStrings[11], "%u.%u °C", millis / 1000U, (millis % 1000U) / 100U);
+        tempColors[0] = tsl::GradientColor(millis * 0.001f);
+
+        millis = context->temps[1]; // PCB
+        sprintf(displayStrings[12], "%u.%u °C", millis / 1000U, (millis % 1000U) / 100U);
+        tempColors[1] = tsl::GradientColor(millis * 0.001f);
+
+        millis = context->temps[2]; // Skin
+        sprintf(displayStrings[13], "%u.%u °C", millis / 1000U, (millis % 1000U) / 100U);
+        tempColors[2] = tsl::GradientColor(millis * 0.001f);
+    }
+
+    if (changed & HOCCLK_CONTEXT_FIELD(Power)) {
+        sprintf(displayStrings[15], "%d mW", context->power[0]); // Now
+        sprintf(displayStrings[16], "%d mW", context->power[1]); // Avg
     }
-    
-    // Power
-    sprintf(displayStrings[15], "%d mW", context->power[0]); // Now
-    sprintf(displayStrings[16], "%d mW", context->power[1]); // Avg
 }
 
 tsl::elm::Element* BaseMenuGui::baseUI()
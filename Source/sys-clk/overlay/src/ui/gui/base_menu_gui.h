@@ -34,8 +34,13 @@
 class BaseMenuGui : public BaseGui
 {
     protected:
-        SysClkContext* context;
+        SysClkContext* context;         // null until the first fetch, then contextStorage
+        SysClkContext contextStorage;
         std::uint64_t lastContextUpdate;
+        std::uint32_t subscriptionId;
+        Handle subscriptionEvent;
+        bool subscriptionRefused;
+        std::uint32_t contextGeneration;
         std::uint32_t cpuVoltageUv;
         std::uint32_t gpuVoltageUv;
         std::uint32_t emcVoltageUv;
@@ -71,6 +76,7 @@ class BaseMenuGui : public BaseGui
         virtual void listUI() = 0;
 
     private:
+        Result fetchContext(u32* changed);
         char displayStrings[17][32];  // Pre-formatted display strings
         tsl::Color tempColors[3];     // Pre-computed temperature colors
 };
@@ -30,25 +30,36 @@
 MiscGui::MiscGui()
 {
     this->configList = new SysClkConfigValueList {};
+    this->tickStats = nullptr;
 }
 
 MiscGui::~MiscGui()
 {
     delete this->configList;
+    delete this->tickStats;
     this->configToggles.clear();
     this->configTrackbars.clear();
     this->configButtons.clear();
     this->configRanges.clear();
 }
 
+Result MiscGui::applyConfigValue(SysClkConfigValue configVal, uint64_t value)
+{
+    // Only the value that changed, not the whole list
+    HocClkBatchOp op = hocClkBatchConfigValue(configVal, value);
+    Result rc = hocClkIpcApplyBatch(&op, 1, nullptr);
+    if (R_SUCCEEDED(rc))
+        this->configList->values[configVal] = value;
+    return rc;
+}
+
 void MiscGui::addConfigToggle(SysClkConfigValue configVal, const char* altName) {
     const char* configName = altName ? altName : sysclkFormatConfigValue(configVal, true);
     tsl::elm::ToggleListItem* toggle = new tsl::elm::ToggleListItem(configName, this->configList->values[configVal]);
     toggle->setStateChangedListener([this, configVal](bool state) {
-        this->configList->values[configVal] = uint64_t(state);
-        Result rc = sysclkIpcSetConfigValues(this->configList);
+        Result rc = this->applyConfigValue(configVal, uint64_t(state));
         if (R_FAILED(rc))
-            FatalGui::openWithResultCode("sysclkIpcSetConfigValues", rc);
+            FatalGui::openWithResultCode("hocClkIpcApplyBatch", rc);
         this->lastContextUpdate = armGetSystemTick();
     });
     this->listElement->addItem(toggle);
@@ -97,10 +108,9 @@ void MiscGui::addConfigButton(SysClkConfigValue configVal,
                     range,
                     categoryName,
                     [this, configVal](std::uint32_t value) {
-                        this->configList->values[configVal] = value;
-                        Result rc = sysclkIpcSetConfigValues(this->configList);
+                        Result rc = this->applyConfigValue(configVal, value);
                         if (R_FAILED(rc)) {
-                            FatalGui::openWithResultCode("sysclkIpcSetConfigValues", rc);
+                            FatalGui::openWithResultCode("hocClkIpcApplyBatch", rc);
                             return false;
                         }
                         this->lastContextUpdate = armGetSystemTick();
@@ -117,10 +127,9 @@ void MiscGui::addConfigButton(SysClkConfigValue configVal,
                     range,
                     categoryName,
                     [this, configVal](std::uint32_t value) {
-                        this->configList->values[configVal] = value;
-                        Result rc = sysclkIpcSetConfigValues(this->configList);
+                        Result rc = this->applyConfigValue(configVal, value);
                         if (R_FAILED(rc)) {
-                            FatalGui::openWithResultCode("sysclkIpcSetConfigValues", rc);
+                            FatalGui::openWithResultCode("hocClkIpcApplyBatch", rc);
                             return false;
                         }
                         this->lastContextUpdate = armGetSystemTick();
@@ -179,11 +188,10 @@ void MiscGui::addFreqButton(SysClkConfigValue configVal,
                 [this, configVal](std::uint32_t hz)
                 {
                     uint64_t mhz = hz / 1'000'000;
-                    this->configList->values[configVal] = mhz;
 
-                    Result rc = sysclkIpcSetConfigValues(this->configList);
+                    Result rc = this->applyConfigValue(configVal, mhz);
                     if (R_FAILED(rc)) {
-                        FatalGui::openWithResultCode("sysclkIpcSetConfigValues", rc);
+                        FatalGui::openWithResultCode("hocClkIpcApplyBatch", rc);
                         return false;
                     }
 
@@ -214,6 +222,8 @@ void MiscGui::listUI()
 {
     this->listElement->addItem(new tsl::elm::CategoryHeader("Settings"));
     addConfigToggle(HocClkConfigValue_UncappedClocks, nullptr);
+    addConfigToggle(HocClkConfigValue_PowerBudgetCpuMemCaps, nullptr);
+    addConfigToggle(HocClkConfigValue_PowerBudgetBattery, nullptr);
     addConfigToggle(HocClkConfigValue_OverwriteBoostMode, nullptr);
 
     // this->listElement->addItem(new tsl::elm::CategoryHeader("Experimental"));
@@ -254,6 +264,26 @@ void MiscGui::listUI()
         "Temp",
         &throttleThresholds
     );
+
+    addConfigToggle(HocClkConfigValue_LoadBurst, nullptr);
+    addConfigButton(
+        HocClkConfigValue_LoadBurstMaxMs,
+        "Max Burst Length",
+        ValueRange(5000, 60000, 5000, "s", 1000),
+        "Time",
+        nullptr
+    );
+
+    addConfigToggle(HocClkConfigValue_EmcProfiler, nullptr);
+
+    addConfigToggle(HocClkConfigValue_ProfileLearning, nullptr);
+    addConfigButton(
+        HocClkConfigValue_ProfileLearningHeadroom,
+        "Learning Load Target",
+        ValueRange(50, 95, 5, "%", 1),
+        "Load",
+        nullptr
+    );
     std::map<uint32_t, std::string> cpu_freq_label_m = {
         {612000000, "Sleep Mode"},
         {1020000000, "Stock"},
@@ -393,7 +423,39 @@ void MiscGui::listUI()
     });
     this->listElement->addItem(applyBtn);
 
+    addTickStats();
+}
 
+void MiscGui::addTickStats() {
+    HocClkTickStats* stats = new HocClkTickStats {};
+    if (R_FAILED(hocClkIpcGetTickStats(stats))) {
+        // Release sysmodule, nothing to show
+        delete stats;
+        return;
+    }
+
+    this->tickStats = stats;
+    this->listElement->addItem(new tsl::elm::CategoryHeader("Tick Timings (p99 / max)"));
+    for (int phase = 0; phase < HocClkTickPhase_EnumMax; phase++) {
+        this->tickStatItems[phase] = new tsl::elm::ListItem(hocClkFormatTickPhase((HocClkTickPhase)phase, true));
+        this->listElement->addItem(this->tickStatItems[phase]);
+    }
+    updateTickStats();
+}
+
+void MiscGui::updateTickStats() {
+    if (!this->tickStats || R_FAILED(hocClkIpcGetTickStats(this->tickStats)))
+        return;
+
+    for (int phase = 0; phase < HocClkTickPhase_EnumMax; phase++) {
+        const HocClkTickPhaseStats* stats = &this->tickStats->phases[phase];
+        char valueText[32];
+        if (stats->count)
+            snprintf(valueText, sizeof(valueText), "%u / %u us", hocClkTickStatsPercentileUs(stats, 99), stats->maxUs);
+        else
+            snprintf(valueText, sizeof(valueText), "-");
+        this->tickStatItems[phase]->setValue(valueText);
+    }
 }
 
 void MiscGui::refresh() {
@@ -423,5 +485,7 @@ void MiscGui::refresh() {
             }
             button->setValue(valueText);
         }
+
+        updateTickStats();
     }
 }
\ No newline at end of file
@@ -22,6 +22,7 @@ protected:
     std::map<SysClkConfigValue, tsl::elm::ToggleListItem*> configToggles;
     std::map<SysClkConfigValue, std::tuple<tsl::elm::TrackBar*, tsl::elm::ListItem*, std::vector<uint64_t>>> configTrackbars;
     
+    Result applyConfigValue(SysClkConfigValue configVal, uint64_t value);
     void addConfigToggle(SysClkConfigValue configVal, const char* altName);
     void addConfigButton(SysClkConfigValue configVal, 
         const char* altName, 
@@ -34,7 +35,11 @@ protected:
                             SysClkModule module,
                             const std::map<uint32_t, std::string>& labels = {});
     void updateConfigToggles();
+    void addTickStats();
+    void updateTickStats();
     
     tsl::elm::ToggleListItem* enabledToggle;
+    HocClkTickStats* tickStats;     // null unless the sysmodule has tick stats built in
+    tsl::elm::ListItem* tickStatItems[HocClkTickPhase_EnumMax];
     u8 frameCounter = 60;
 };
\ No newline at end of file
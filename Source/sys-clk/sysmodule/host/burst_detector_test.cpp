@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "burst_detector.h"
+#include "context_trace.hpp"
+#include <string>
+
+namespace {
+
+    const std::uint64_t PollNs = 300000000ULL;
+    const std::uint64_t MaxNs = 15000000000ULL;
+
+    struct Phase {
+        double seconds;
+        std::uint32_t emc, emcCpu;  // permille, +-10% noise
+        int label;
+    };
+
+    // Same columns and order as FileUtils::WriteContextToCsv, plus the annotation
+    std::string MakeTrace(const Phase* phases, int count, std::uint32_t seed) {
+        std::string text = "timestamp,profile,app_tid,cpu_hz,gpu_hz,mem_hz,soc_milliC,pcb_milliC,skin_milliC,"
+                           "cpu_real_hz,gpu_real_hz,mem_real_hz,now_mw,avg_mw,emc_load,emc_cpu_load,gpu_load,load_phase\n";
+        std::uint64_t ms = 1700000000000ULL;
+        char line[256];
+
+        for (int p = 0; p < count; p++) {
+            for (double t = 0; t < phases[p].seconds; t += PollNs / 1e9) {
+                std::uint32_t emc = phases[p].emc * (900 + HostTestRand(&seed) % 201) / 1000;
+                std::uint32_t emcCpu = phases[p].emcCpu * (900 + HostTestRand(&seed) % 201) / 1000;
+                snprintf(line, sizeof(line), "%lu,handheld,0100000000010000,1020000000,460800000,1600000000,52000,41000,38000,"
+                         "1020000000,460800000,1600000000,-6100,-6000,%u,%u,0,%d\n",
+                         (unsigned long)ms, emc, emcCpu, phases[p].label);
+                text += line;
+                ms += PollNs / 1000000;
+            }
+        }
+        return text;
+    }
+
+    BurstSample Sample(std::uint64_t ns, std::uint32_t emc, std::uint32_t emcCpu) {
+        BurstSample sample = {};
+        sample.ns = ns;
+        sample.emcLoad = emc;
+        sample.emcCpuLoad = emcCpu;
+        return sample;
+    }
+
+}
+
+void Test_BurstDetectorTrace() {
+    const Phase phases[] = {
+        { 20, 150,  80, 0 },    // menu
+        {  6, 720, 380, 1 },    // load screen
+        { 60, 650, 110, 0 },    // GPU bound gameplay, busy EMC but little of it CPU
+        { 30, 700, 400, 1 },    // long load, cut by the max length
+        { 20, 600, 120, 0 },
+        {  4, 800, 450, 1 },
+        { 10, 150,  80, 0 },
+    };
+
+    std::vector<ContextTraceRow> rows;
+    assert(ContextTraceParse(MakeTrace(phases, sizeof(phases) / sizeof(phases[0]), 1), &rows));
+    assert(rows.size() > 400);
+    assert(rows[0].hasLoad && rows[0].loadPhase == 0 && rows[0].temps[SysClkThermalSensor_SOC] == 52000);
+
+    BurstEvalResult result;
+    ContextTraceEvalBurst(rows, MaxNs, 70000, &result, true);
+
+    LOGGING("%u bursts, %u/%u phases, %.2f s mean latency, tp %u fp %u fn %u",
+            result.bursts, result.detectedPhases, result.labelledPhases,
+            result.latencyNs / 1e9 / (result.detectedPhases ? result.detectedPhases : 1),
+            result.truePositive, result.falsePositive, result.falseNegative);
+
+    assert(result.labelledPhases == 3);
+    assert(result.detectedPhases == 3);
+    assert(result.bursts == 3);
+    assert(result.falseNegative >= (30000000000ULL - MaxNs) / PollNs);
+    assert(result.latencyNs / result.detectedPhases <= 1000000000ULL);
+
+    // Only the exit hold of the two bursts that ended on their own runs past a phase
+    std::uint32_t exitSamples = BURST_DETECTOR_EXIT_NS / PollNs + 1;
+    assert(result.falsePositive <= 2 * exitSamples);
+
+    // The long load got MaxNs, not 30 s
+    assert(result.burstNs <= MaxNs + 2 * (6000000000ULL + BURST_DETECTOR_EXIT_NS));
+
+    // A trace without the load columns never bursts
+    std::vector<ContextTraceRow> old;
+    assert(ContextTraceParse("timestamp,profile,app_tid,cpu_hz\n1000,handheld,0,1020000000\n2000,handheld,0,1020000000\n", &old));
+    assert(old.size() == 2 && !old[0].hasLoad && old[0].loadPhase == -1);
+    ContextTraceEvalBurst(old, MaxNs, 70000, &result, false);
+    assert(result.bursts == 0);
+}
+
+void Test_BurstDetectorGuards() {
+    BurstDetector detector;
+    std::uint64_t ns = 0;
+
+    // Boost starts at once and holds the burst even with idle loads
+    BurstSample sample = Sample(ns, 100, 50);
+    sample.boostMode = true;
+    assert(detector.Update(&sample, MaxNs));
+    for (int i = 0; i < 10; i++) {
+        sample.ns = ns += PollNs;
+        assert(detector.Update(&sample, MaxNs));
+    }
+
+    // Guard ends it, then the cooldown holds off a new one
+    sample.guarded = true;
+    sample.ns = ns += PollNs;
+    assert(!detector.Update(&sample, MaxNs));
+    assert(detector.GetBurstCount() == 1);
+
+    std::uint64_t cooldownEndNs = ns + BURST_DETECTOR_COOLDOWN_NS;
+    sample = Sample(ns, 800, 400);
+    while (ns < cooldownEndNs + 10 * PollNs) {
+        sample.ns = ns += PollNs;
+        assert(!detector.Update(&sample, MaxNs));
+    }
+
+    // Still the same load phase, it has to drop before another burst
+    sample = Sample(ns += PollNs, 100, 50);
+    assert(!detector.Update(&sample, MaxNs));
+
+    // Then a new load phase needs the enter hold before bursting
+    sample = Sample(ns, 800, 400);
+    std::uint64_t startNs = 0;
+    for (int i = 0; i < 10 && !startNs; i++) {
+        sample.ns = ns += PollNs;
+        if (detector.Update(&sample, MaxNs))
+            startNs = ns;
+    }
+    assert(startNs);
+    assert(detector.GetBurstCount() == 2);
+
+    // Bounded by maxNs however long the load lasts
+    while (detector.Update(&sample, 2000000000ULL))
+        sample.ns = ns += PollNs;
+    assert(ns - startNs >= 2000000000ULL && ns - startNs < 2000000000ULL + PollNs);
+
+    detector.Reset();
+    assert(!detector.Active() && detector.GetBurstCount() == 0);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "config_write_queue.h"
+
+namespace {
+
+    const std::uint64_t Ms = 1000000ULL;
+
+}
+
+void Test_ConfigWriteQueueCoalesce() {
+    ConfigWriteQueue queue;
+    ConfigWriteBatch batch;
+
+    assert(!queue.Pending() && queue.WaitNs(0) == UINT64_MAX);
+    assert(!queue.TakeAll(&batch));
+
+    // Overlay toggles 100 ms apart, and the same title saved three times
+    queue.MarkValues(1000 * Ms);
+    queue.MarkProfiles(0x0100000000010000ULL, 1100 * Ms);
+    queue.MarkValues(1200 * Ms);
+    queue.MarkProfiles(0x0100000000010000ULL, 1300 * Ms);
+    queue.MarkProfiles(0x0100000000020000ULL, 1300 * Ms);
+    queue.MarkProfiles(0x0100000000010000ULL, 1400 * Ms);
+
+    assert(queue.WaitNs(1400 * Ms) == CONFIG_WRITE_QUIET_NS);
+    assert(!queue.Take(1500 * Ms, &batch));
+    assert(queue.Take(1400 * Ms + CONFIG_WRITE_QUIET_NS, &batch));
+    assert(batch.values && batch.tidCount == 2);
+    assert(batch.tids[0] == 0x0100000000010000ULL && batch.tids[1] == 0x0100000000020000ULL);
+    assert(!queue.Pending());
+
+    // Changes that never settle still get written
+    std::uint64_t ns = 10000 * Ms;
+    std::uint64_t first = ns;
+    while (!queue.Take(ns, &batch)) {
+        queue.MarkValues(ns);
+        ns += 100 * Ms;
+    }
+    LOGGING("written after %lu ms of constant changes", (unsigned long)((ns - first) / Ms));
+    assert(ns - first >= CONFIG_WRITE_MAX_DELAY_NS && ns - first <= CONFIG_WRITE_MAX_DELAY_NS + 100 * Ms);
+}
+
+void Test_ConfigWriteQueueRequeue() {
+    ConfigWriteQueue queue;
+    ConfigWriteBatch batch;
+
+    for (std::uint64_t tid = 1; tid <= CONFIG_WRITE_QUEUE_TIDS; tid++)
+        assert(queue.MarkProfiles(tid, 0));
+    assert(queue.MarkProfiles(1, 0));
+    assert(!queue.MarkProfiles(CONFIG_WRITE_QUEUE_TIDS + 1, 0));
+
+    // Flushing ignores the delay
+    assert(queue.TakeAll(&batch) && !batch.values && batch.tidCount == CONFIG_WRITE_QUEUE_TIDS);
+
+    // A failed write comes back behind what was marked meanwhile
+    queue.MarkValues(5 * Ms);
+    queue.MarkProfiles(100, 5 * Ms);
+    queue.Requeue(&batch, 10 * Ms);
+    assert(queue.WaitNs(10 * Ms) == CONFIG_WRITE_QUIET_NS);
+
+    ConfigWriteBatch retry;
+    assert(queue.TakeAll(&retry));
+    assert(retry.values && retry.tidCount == CONFIG_WRITE_QUEUE_TIDS);
+    assert(retry.tids[0] == 100 && retry.tids[1] == 1);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include <sysclk.h>
+
+namespace {
+
+    void FillContext(SysClkContext* ctx, std::uint32_t seed) {
+        std::uint8_t* bytes = (std::uint8_t*)ctx;
+        for (size_t i = 0; i < sizeof(*ctx); i++)
+            bytes[i] = HostTestRand(&seed);
+        ctx->enabled = 1;
+        ctx->profile = SysClkProfile_Docked;
+    }
+
+}
+
+void Test_ContextDeltaRoundTrip() {
+    SysClkContext server, client;
+    FillContext(&server, 1);
+    memset(&client, 0, sizeof(client));
+
+    // Fits the IPC response of the sysmodule's server
+    assert(sizeof(HocClkContextDelta) <= 0x100 - 0x10 - 16);
+
+    HocClkContextDelta delta;
+    size_t size = hocClkEncodeContextDelta(&server, HOCCLK_CONTEXT_FIELD_ALL, 7, &delta);
+    LOGGING("full delta %zu bytes, context %zu bytes", size, sizeof(SysClkContext));
+    assert(delta.generation == 7 && delta.fields == HOCCLK_CONTEXT_FIELD_ALL);
+    assert(hocClkDecodeContextDelta(&delta, size, &client));
+    // Padding doesn't travel, compare field by field
+    const HocClkContextSubscription exact = { HOCCLK_CONTEXT_FIELD_ALL, 0, 0, 0, 0, 0 };
+    assert(!sysclkContextChangedFields(&client, &server, &exact));
+
+    // Two fields: only their bytes travel, the rest of the client copy stays
+    SysClkContext before = client;
+    server.temps[SysClkThermalSensor_SOC] += 500;
+    server.applicationId = 0x0100000000010000ULL;
+    std::uint32_t fields = HOCCLK_CONTEXT_FIELD(Temps) | HOCCLK_CONTEXT_FIELD(ApplicationId);
+    size = hocClkEncodeContextDelta(&server, fields, 8, &delta);
+    assert(size == HOCCLK_CONTEXT_DELTA_HEADER_SIZE + sizeof(server.temps) + sizeof(server.applicationId));
+    assert(hocClkDecodeContextDelta(&delta, size, &client));
+    assert(client.applicationId == server.applicationId);
+    assert(client.temps[SysClkThermalSensor_SOC] == server.temps[SysClkThermalSensor_SOC]);
+    assert(!memcmp(client.freqs, before.freqs, sizeof(client.freqs)) && client.enabled == before.enabled);
+
+    // Nothing moved: header only
+    size = hocClkEncodeContextDelta(&server, 0, 8, &delta);
+    assert(size == HOCCLK_CONTEXT_DELTA_HEADER_SIZE && hocClkDecodeContextDelta(&delta, size, &client));
+}
+
+void Test_ContextDeltaMalformed() {
+    SysClkContext ctx;
+    FillContext(&ctx, 2);
+
+    HocClkContextDelta delta;
+    size_t size = hocClkEncodeContextDelta(&ctx, HOCCLK_CONTEXT_FIELD(Freqs) | HOCCLK_CONTEXT_FIELD(Power), 3, &delta);
+    SysClkContext out = ctx;
+
+    assert(!hocClkDecodeContextDelta(&delta, size - 1, &out));
+    assert(!hocClkDecodeContextDelta(&delta, HOCCLK_CONTEXT_DELTA_HEADER_SIZE - 1, &out));
+
+    HocClkContextDelta bad = delta;
+    bad.size -= 4;
+    assert(!hocClkDecodeContextDelta(&bad, size, &out));
+
+    bad = delta;
+    bad.fields |= 1U << HocClkContextField_EnumMax;
+    assert(!hocClkDecodeContextDelta(&bad, size, &out));
+
+    bad = delta;
+    bad.fields = HOCCLK_CONTEXT_FIELD(Freqs);
+    assert(!hocClkDecodeContextDelta(&bad, size, &out));
+
+    // Rejected deltas leave the context alone
+    assert(!memcmp(&out, &ctx, sizeof(ctx)));
+}
+
+void Test_ContextDeltaGenerations() {
+    HocClkContextGenerations gens;
+    hocClkContextGenerationsInit(&gens);
+
+    assert(hocClkContextFieldsSince(&gens, 0) == HOCCLK_CONTEXT_FIELD_ALL);
+    std::uint32_t seen = gens.generation;
+    assert(hocClkContextFieldsSince(&gens, seen) == 0);
+
+    // An unchanged publish doesn't move the generation
+    hocClkContextBump(&gens, 0);
+    assert(gens.generation == seen);
+
+    hocClkContextBump(&gens, HOCCLK_CONTEXT_FIELD(Temps));
+    hocClkContextBump(&gens, HOCCLK_CONTEXT_FIELD(Power));
+    assert(hocClkContextFieldsSince(&gens, seen) == (HOCCLK_CONTEXT_FIELD(Temps) | HOCCLK_CONTEXT_FIELD(Power)));
+    assert(hocClkContextFieldsSince(&gens, seen + 1) == HOCCLK_CONTEXT_FIELD(Power));
+    assert(hocClkContextFieldsSince(&gens, gens.generation) == 0);
+
+    // A client that outlived the sysmodule gets everything again
+    assert(hocClkContextFieldsSince(&gens, gens.generation + 10) == HOCCLK_CONTEXT_FIELD_ALL);
+}
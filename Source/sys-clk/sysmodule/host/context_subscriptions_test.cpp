@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "context_subscriptions.h"
+
+namespace {
+
+    SysClkContext BaseContext() {
+        SysClkContext context;
+        memset(&context, 0, sizeof(context));
+        context.enabled = 1;
+        context.applicationId = 0x0100000000010000ULL;
+        context.freqs[SysClkModule_CPU] = 1020000000;
+        context.realFreqs[SysClkModule_CPU] = 1020000000;
+        context.temps[SysClkThermalSensor_SOC] = 45000;
+        context.power[SysClkPowerSensor_Now] = -4000;
+        return context;
+    }
+
+}
+
+void Test_ContextChangedFields() {
+    SysClkContext from = BaseContext(), to = BaseContext();
+    HocClkContextSubscription sub = {};
+    sub.fields = HOCCLK_CONTEXT_FIELD_ALL;
+    sub.tempMilliC = 1000;
+    sub.powerMw = 500;
+
+    assert(sysclkContextChangedFields(&from, &to, &sub) == 0);
+
+    to.temps[SysClkThermalSensor_SOC] = 45900;
+    to.power[SysClkPowerSensor_Now] = -3600;
+    assert(sysclkContextChangedFields(&from, &to, &sub) == 0);
+
+    to.temps[SysClkThermalSensor_SOC] = 44000;
+    to.power[SysClkPowerSensor_Now] = -4500;
+    to.realFreqs[SysClkModule_CPU] = 1019000000;
+    assert(sysclkContextChangedFields(&from, &to, &sub) ==
+           (HOCCLK_CONTEXT_FIELD(Temps) | HOCCLK_CONTEXT_FIELD(Power) | HOCCLK_CONTEXT_FIELD(RealFreqs)));
+
+    // Unsubscribed fields never show
+    sub.fields = HOCCLK_CONTEXT_FIELD(Freqs) | HOCCLK_CONTEXT_FIELD(Profile);
+    assert(sysclkContextChangedFields(&from, &to, &sub) == 0);
+    to.profile = SysClkProfile_Docked;
+    assert(sysclkContextChangedFields(&from, &to, &sub) == HOCCLK_CONTEXT_FIELD(Profile));
+
+    SysClkContext merged = from;
+    sysclkContextCopyFields(&merged, &to, HOCCLK_CONTEXT_FIELD(Profile) | HOCCLK_CONTEXT_FIELD(Temps));
+    assert(merged.profile == SysClkProfile_Docked && merged.temps[SysClkThermalSensor_SOC] == 44000);
+    assert(merged.power[SysClkPowerSensor_Now] == -4000 && merged.realFreqs[SysClkModule_CPU] == 1020000000);
+}
+
+void Test_ContextSubscriptionsSignal() {
+    ContextSubscriptions subs;
+    SysClkContext context = BaseContext();
+    HocClkContextSubscription sub = {};
+    sub.fields = HOCCLK_CONTEXT_FIELD(Freqs) | HOCCLK_CONTEXT_FIELD(Temps);
+    sub.tempMilliC = 1000;
+
+    std::uint32_t id;
+    unsigned int slot;
+    assert(subs.Add(&sub, &context, 0, &id, &slot));
+    assert(subs.Update(&context, 1) == 0);
+
+    // Small steps add up against what the client was last given
+    context.temps[SysClkThermalSensor_SOC] += 600;
+    assert(subs.Update(&context, 2) == 0);
+    context.temps[SysClkThermalSensor_SOC] += 600;
+    assert(subs.Update(&context, 3) == (1U << slot));
+
+    // Signalled once until collected
+    context.freqs[SysClkModule_CPU] = 1224000000;
+    assert(subs.Update(&context, 4) == 0);
+
+    HocClkContextChanges changes;
+    assert(subs.Collect(id, &context, &changes));
+    assert(changes.changed == (HOCCLK_CONTEXT_FIELD(Freqs) | HOCCLK_CONTEXT_FIELD(Temps)));
+    assert(changes.context.freqs[SysClkModule_CPU] == 1224000000);
+    assert(changes.context.temps[SysClkThermalSensor_SOC] == 46200);
+    assert(changes.context.applicationId == 0);
+
+    assert(subs.Update(&context, 5) == 0);
+    assert(subs.Collect(id, &context, &changes) && changes.changed == 0);
+
+    assert(subs.Remove(id, &slot));
+    assert(!subs.Collect(id, &context, &changes));
+    assert(!subs.Remove(id, &slot));
+}
+
+void Test_ContextSubscriptionsSlots() {
+    ContextSubscriptions subs;
+    SysClkContext context = BaseContext();
+    HocClkContextSubscription sub = {};
+    sub.fields = HOCCLK_CONTEXT_FIELD_ALL;
+
+    std::uint32_t ids[CONTEXT_SUBSCRIPTION_SLOTS], id;
+    unsigned int slot;
+    for (int i = 0; i < CONTEXT_SUBSCRIPTION_SLOTS; i++)
+        assert(subs.Add(&sub, &context, 0, &ids[i], &slot));
+    assert(!subs.Add(&sub, &context, 0, &id, &slot));
+
+    // Everyone has something pending, only one keeps collecting
+    context.profile = SysClkProfile_Docked;
+    assert(subs.Update(&context, 1000) == (1U << CONTEXT_SUBSCRIPTION_SLOTS) - 1);
+    HocClkContextChanges changes;
+    assert(subs.Collect(ids[0], &context, &changes));
+    assert(!subs.Add(&sub, &context, 1000 + CONTEXT_SUBSCRIPTION_STALE_NS / 2, &id, &slot));
+
+    // An abandoned slot is taken over and its old id refused
+    assert(subs.Add(&sub, &context, 1000 + CONTEXT_SUBSCRIPTION_STALE_NS, &id, &slot));
+    assert(slot == 1 && id != ids[1]);
+    assert(!subs.Collect(ids[1], &context, &changes));
+    assert(subs.Collect(id, &context, &changes) && changes.changed == 0);
+    assert(subs.Collect(ids[0], &context, &changes));
+}
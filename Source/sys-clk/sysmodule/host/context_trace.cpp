@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "context_trace.hpp"
+#include "cpu_sampler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+    std::vector<std::string> Split(const std::string& line) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ','))
+            fields.push_back(field);
+        return fields;
+    }
+
+    int Find(const std::vector<std::string>& header, const std::string& name) {
+        for (size_t i = 0; i < header.size(); i++) {
+            if (header[i] == name)
+                return i;
+        }
+        return -1;
+    }
+
+    template <typename T>
+    void Read(const std::vector<std::string>& fields, int column, T* out) {
+        if (column >= 0 && column < (int)fields.size())
+            *out = (T)strtoll(fields[column].c_str(), nullptr, 10);
+    }
+
+}
+
+bool ContextTraceParse(const std::string& text, std::vector<ContextTraceRow>* rows) {
+    std::stringstream stream(text);
+    std::string line;
+
+    if (!std::getline(stream, line))
+        return false;
+
+    std::vector<std::string> header = Split(line);
+    int timestamp = Find(header, "timestamp");
+    if (timestamp < 0)
+        return false;
+
+    int hz[SysClkModule_EnumMax], realHz[SysClkModule_EnumMax];
+    for (int m = 0; m < SysClkModule_EnumMax; m++) {
+        hz[m] = Find(header, std::string(sysclkFormatModule((SysClkModule)m, false)) + "_hz");
+        realHz[m] = Find(header, std::string(sysclkFormatModule((SysClkModule)m, false)) + "_real_hz");
+    }
+    int temps[SysClkThermalSensor_EnumMax];
+    for (int s = 0; s < SysClkThermalSensor_EnumMax; s++)
+        temps[s] = Find(header, std::string(sysclkFormatThermalSensor((SysClkThermalSensor)s, false)) + "_milliC");
+    int power[SysClkPowerSensor_EnumMax];
+    for (int s = 0; s < SysClkPowerSensor_EnumMax; s++)
+        power[s] = Find(header, std::string(sysclkFormatPowerSensor((SysClkPowerSensor)s, false)) + "_mw");
+    int load[SysClkPartLoad_EnumMax];
+    for (int l = 0; l < SysClkPartLoad_EnumMax; l++)
+        load[l] = Find(header, std::string(sysclkFormatPartLoad((SysClkPartLoad)l, false)) + "_load");
+    int coreLoad[HOCCLK_CPU_CORE_COUNT];
+    for (int c = 0; c < HOCCLK_CPU_CORE_COUNT; c++)
+        coreLoad[c] = Find(header, "cpu" + std::to_string(c) + "_load");
+    int loadPhase = Find(header, "load_phase");
+
+    while (std::getline(stream, line)) {
+        if (line.empty())
+            continue;
+
+        std::vector<std::string> fields = Split(line);
+        ContextTraceRow row = {};
+        std::uint64_t ms = 0;
+        Read(fields, timestamp, &ms);
+        row.ns = ms * 1000000ULL;
+
+        for (int m = 0; m < SysClkModule_EnumMax; m++) {
+            Read(fields, hz[m], &row.hz[m]);
+            Read(fields, realHz[m], &row.realHz[m]);
+        }
+        for (int s = 0; s < SysClkThermalSensor_EnumMax; s++)
+            Read(fields, temps[s], &row.temps[s]);
+        for (int s = 0; s < SysClkPowerSensor_EnumMax; s++)
+            Read(fields, power[s], &row.power[s]);
+        for (int l = 0; l < SysClkPartLoad_EnumMax; l++)
+            Read(fields, load[l], &row.load[l]);
+        for (int c = 0; c < HOCCLK_CPU_CORE_COUNT; c++)
+            Read(fields, coreLoad[c], &row.coreLoad[c]);
+        row.hasLoad = load[SysClkPartLoad_EMC] >= 0 && load[SysClkPartLoad_EMCCpu] >= 0;
+        row.hasCoreLoad = coreLoad[0] >= 0;
+        row.loadPhase = -1;
+        Read(fields, loadPhase, &row.loadPhase);
+
+        rows->push_back(row);
+    }
+
+    return true;
+}
+
+bool ContextTraceLoad(const char* path, std::vector<ContextTraceRow>* rows) {
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::stringstream text;
+    text << file.rdbuf();
+    return ContextTraceParse(text.str(), rows);
+}
+
+void ContextTraceEvalBurst(const std::vector<ContextTraceRow>& rows, std::uint64_t maxNs, std::uint32_t thermalLimitMilli,
+                           BurstEvalResult* result, bool verbose) {
+    BurstDetector detector;
+    memset(result, 0, sizeof(*result));
+
+    if (rows.empty())
+        return;
+
+    std::uint64_t firstNs = rows.front().ns;
+    result->traceNs = rows.back().ns - firstNs;
+
+    bool inPhase = false, phaseDetected = false;
+    std::uint64_t phaseStartNs = 0;
+
+    for (const ContextTraceRow& row : rows) {
+        BurstSample sample = {};
+        sample.ns = row.ns;
+        sample.emcLoad = row.load[SysClkPartLoad_EMC];
+        sample.emcCpuLoad = row.load[SysClkPartLoad_EMCCpu];
+        sample.hasCpuLoad = row.hasCoreLoad;
+        for (int c = 0; c < CPU_SAMPLER_APPLICATION_CORES; c++)
+            sample.cpuLoad = std::max(sample.cpuLoad, row.coreLoad[c]);
+        sample.guarded = row.temps[SysClkThermalSensor_SOC] + 5000 >= thermalLimitMilli;
+
+        bool wasActive = detector.Active();
+        bool active = row.hasLoad && detector.Update(&sample, maxNs);
+
+        if (active && !wasActive && verbose)
+            printf("    burst at %7.1f s\n", (row.ns - firstNs) / 1e9);
+        if (!active && wasActive && verbose)
+            printf("    ended at %7.1f s after %.1f s\n", (row.ns - firstNs) / 1e9, detector.GetLastBurstNs() / 1e9);
+
+        if (row.loadPhase > 0 && !inPhase) {
+            inPhase = true;
+            phaseDetected = false;
+            phaseStartNs = row.ns;
+            result->labelledPhases++;
+        } else if (row.loadPhase == 0) {
+            inPhase = false;
+        }
+
+        if (inPhase && active && !phaseDetected) {
+            phaseDetected = true;
+            result->detectedPhases++;
+            result->latencyNs += row.ns - phaseStartNs;
+        }
+
+        if (row.loadPhase >= 0) {
+            if (active && row.loadPhase > 0)
+                result->truePositive++;
+            else if (active)
+                result->falsePositive++;
+            else if (row.loadPhase > 0)
+                result->falseNegative++;
+        }
+    }
+
+    result->bursts = detector.GetBurstCount();
+    result->burstNs = detector.GetTotalBurstNs();
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sysclk.h>
+#include "burst_detector.h"
+
+// One row of the sysmodule's context.csv
+typedef struct ContextTraceRow {
+    std::uint64_t ns;
+    std::uint32_t hz[SysClkModule_EnumMax];
+    std::uint32_t realHz[SysClkModule_EnumMax];
+    std::uint32_t temps[SysClkThermalSensor_EnumMax];
+    std::int32_t  power[SysClkPowerSensor_EnumMax];
+    std::uint32_t load[SysClkPartLoad_EnumMax];
+    std::uint32_t coreLoad[HOCCLK_CPU_CORE_COUNT];
+    bool          hasLoad;      // traces recorded before the load columns have none
+    bool          hasCoreLoad;
+    int           loadPhase;    // optional hand annotation, -1 if the column is missing
+} ContextTraceRow;
+
+// Columns are matched by header name, unknown ones are skipped
+bool ContextTraceParse(const std::string& text, std::vector<ContextTraceRow>* rows);
+bool ContextTraceLoad(const char* path, std::vector<ContextTraceRow>* rows);
+
+typedef struct BurstEvalResult {
+    std::uint32_t bursts;
+    std::uint64_t burstNs;
+    std::uint64_t traceNs;
+    std::uint32_t labelledPhases;   // annotated load phases
+    std::uint32_t detectedPhases;   // ... with a burst somewhere inside
+    std::uint64_t latencyNs;        // summed phase start to burst start
+    std::uint32_t truePositive;     // samples, burst and annotated
+    std::uint32_t falsePositive;
+    std::uint32_t falseNegative;
+} BurstEvalResult;
+
+// Replays a trace through BurstDetector, guarded over thermalLimitMilli - 5 C like the sysmodule
+void ContextTraceEvalBurst(const std::vector<ContextTraceRow>& rows, std::uint64_t maxNs, std::uint32_t thermalLimitMilli,
+                           BurstEvalResult* result, bool verbose);
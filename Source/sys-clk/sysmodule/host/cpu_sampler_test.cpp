@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "cpu_sampler.h"
+
+namespace {
+
+    const std::uint64_t TicksPerSecond = 19200000ULL;
+    const std::uint64_t PollTicks = TicksPerSecond * 300 / 1000;
+
+    // Synthetic kernel counters, cores busy at the given permille
+    struct Counters {
+        std::uint64_t tick = TicksPerSecond * 100;
+        std::uint64_t idle[HOCCLK_CPU_CORE_COUNT] = {};
+
+        void Advance(const std::uint32_t* busy) {
+            tick += PollTicks;
+            for (int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+                idle[core] += PollTicks * (1000 - busy[core]) / 1000;
+        }
+    };
+
+}
+
+void Test_CpuSamplerLoad() {
+    CpuSampler sampler;
+    Counters counters;
+    std::uint32_t load[HOCCLK_CPU_CORE_COUNT], application;
+
+    sampler.AddSample(counters.tick, counters.idle);
+    assert(!sampler.GetLoad(TicksPerSecond, load, &application));
+
+    const std::uint32_t busy[] = { 250, 500, 750, 1000 };
+    for (int i = 0; i < 10; i++) {
+        counters.Advance(busy);
+        sampler.AddSample(counters.tick, counters.idle);
+    }
+
+    assert(sampler.GetLoad(TicksPerSecond, load, &application));
+    for (int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++) {
+        LOGGING("core %d: %u", core, load[core]);
+        assert(load[core] == busy[core]);
+    }
+    assert(application == 500);
+
+    // A window shorter than the polling interval still covers one interval
+    assert(sampler.GetLoad(1, load, &application) && load[0] == 250);
+
+    // Idle ticks can't exceed the elapsed time, but don't underflow if they do
+    counters.tick += PollTicks;
+    counters.idle[0] += PollTicks * 2;
+    sampler.AddSample(counters.tick, counters.idle);
+    assert(sampler.GetLoad(1, load, &application) && load[0] == 0);
+}
+
+void Test_CpuSamplerWindow() {
+    CpuSampler sampler;
+    Counters counters;
+    std::uint32_t load[HOCCLK_CPU_CORE_COUNT], application;
+
+    const std::uint32_t idle[] = { 0, 0, 0, 0 };
+    const std::uint32_t full[] = { 1000, 1000, 1000, 1000 };
+
+    sampler.AddSample(counters.tick, counters.idle);
+    for (int i = 0; i < 20; i++) {
+        counters.Advance(idle);
+        sampler.AddSample(counters.tick, counters.idle);
+    }
+
+    // Two of ten 300 ms intervals busy: the 3 s window sees 20%, the 600 ms one 100%
+    for (int i = 0; i < 2; i++) {
+        counters.Advance(full);
+        sampler.AddSample(counters.tick, counters.idle);
+    }
+    assert(sampler.GetLoad(TicksPerSecond * 3, load, &application) && load[1] == 200);
+    assert(sampler.GetLoad(TicksPerSecond * 600 / 1000, load, &application) && load[1] == 1000);
+
+    // Windows past the history fall back to the oldest snapshot kept
+    for (int i = 0; i < CPU_SAMPLER_HISTORY; i++) {
+        counters.Advance(i % 2 ? full : idle);
+        sampler.AddSample(counters.tick, counters.idle);
+    }
+    assert(sampler.GetLoad(TicksPerSecond * 3600, load, &application));
+    LOGGING("history window: %u", load[2]);
+    assert(load[2] >= 480 && load[2] <= 520);
+
+    // Counters going backwards (a reboot of the trace, a wrap) drop the history
+    counters.idle[3] = 0;
+    sampler.AddSample(counters.tick + PollTicks, counters.idle);
+    assert(!sampler.GetLoad(TicksPerSecond, load, &application));
+}
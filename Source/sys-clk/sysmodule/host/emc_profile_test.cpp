@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "emc_profile.h"
+
+namespace {
+
+    const std::uint64_t Period = 20000000ULL; // one actmon period
+    const std::uint32_t MemHz = 1600000000;
+
+}
+
+void Test_EmcProfileHistogram() {
+    EmcProfileTable table;
+    HocClkEmcProfile profile;
+    const std::uint64_t tid = 0x0100000000010000ULL;
+
+    assert(!table.Get(tid, 20000, &profile));
+    assert(profile.applicationId == tid && profile.samples == 0);
+
+    // 3 s of light traffic, then two saturated stretches of 200 ms and 600 ms
+    std::uint64_t ns = 0;
+    for (int i = 0; i < 150; i++, ns += Period)
+        table.AddSample(tid, ns, 300, 100, MemHz);
+    for (int i = 0; i < 10; i++, ns += Period)
+        table.AddSample(tid, ns, 950, 400, MemHz);
+    for (int i = 0; i < 50; i++, ns += Period)
+        table.AddSample(tid, ns, 300, 100, MemHz);
+    for (int i = 0; i < 30; i++, ns += Period)
+        table.AddSample(tid, ns, 1200, 1100, MemHz);
+    table.AddSample(tid, ns, 300, 100, MemHz);
+
+    assert(table.Get(tid, 20000, &profile));
+    LOGGING("%u samples, mean %u, cpu mean %u, peak %u, %u saturated in %u bursts, longest %u ms",
+            profile.samples, profile.meanPermille, profile.cpuMeanPermille, profile.peakPermille,
+            profile.saturatedSamples, profile.bursts, profile.longestBurstMs);
+
+    assert(profile.samples == 241 && profile.intervalUs == 20000);
+    assert(profile.histogram[6] == 201);
+    assert(profile.histogram[19] == 40);
+    assert(profile.cpuHistogram[2] == 201 && profile.cpuHistogram[8] == 10 && profile.cpuHistogram[19] == 30);
+    assert(profile.peakPermille == 1000);
+    assert(profile.saturatedSamples == 40 && profile.bursts == 2);
+    assert(profile.longestBurstMs == 600);
+    assert(profile.meanPermille == (201 * 300 + 10 * 950 + 30 * 1000) / 241);
+    assert(profile.meanMemMHz == 1600);
+}
+
+void Test_EmcProfileTitles() {
+    EmcProfileTable table;
+    HocClkEmcProfile profile;
+
+    // A burst still going is reported as it stands, a title switch ends it
+    table.AddSample(1, 0, 950, 0, MemHz);
+    table.AddSample(1, Period, 950, 0, MemHz);
+    table.AddSample(1, 2 * Period, 950, 0, MemHz);
+    assert(table.Get(1, 20000, &profile) && profile.bursts == 1 && profile.longestBurstMs == 40);
+
+    table.AddSample(2, 3 * Period, 950, 0, MemHz);
+    assert(table.Get(2, 20000, &profile) && profile.bursts == 1 && profile.longestBurstMs == 0);
+    assert(table.Get(1, 20000, &profile) && profile.longestBurstMs == 40);
+    table.AddSample(2, 4 * Period, 100, 0, MemHz);
+    assert(table.Get(2, 20000, &profile) && profile.longestBurstMs == 20);
+
+    // Slots are recycled least recently used first
+    for (std::uint64_t tid = 3; tid < 3 + EMC_PROFILE_SLOTS - 2; tid++)
+        table.AddSample(tid, 5 * Period, 100, 0, MemHz);
+    assert(table.Get(1, 20000, &profile) && table.Get(2, 20000, &profile));
+    table.AddSample(100, 6 * Period, 100, 0, MemHz);
+    assert(!table.Get(1, 20000, &profile) && table.Get(2, 20000, &profile));
+
+    table.Forget(2);
+    assert(!table.Get(2, 20000, &profile));
+    table.Reset();
+    assert(!table.Get(100, 20000, &profile));
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+
+int main(int argc, char** argv) {
+    UnitTest tests[] = {
+        { "Power model: fit recovers the rail coefficients", Test_PowerModelFit },
+        { "Power model: cheapest operating point",          Test_PowerModelCheapest },
+        { "Power model: save and load",                     Test_PowerModelPersist },
+        { "Profile learner: proposal from the load history", Test_ProfileLearnerPropose },
+        { "Profile learner: saturation and slot recycling",  Test_ProfileLearnerSlots },
+        { "Profile learner: save and load",                  Test_ProfileLearnerPersist },
+        { "Burst detector: load phases in a context trace",  Test_BurstDetectorTrace },
+        { "Burst detector: boost, guard, cooldown and limit", Test_BurstDetectorGuards },
+        { "CPU sampler: per core load from idle ticks",      Test_CpuSamplerLoad },
+        { "CPU sampler: windows over the history",           Test_CpuSamplerWindow },
+        { "Load smoother: time weighted EMA",                Test_LoadSmootherEma },
+        { "Load smoother: windowed mean",                    Test_LoadSmootherWindow },
+        { "Load smoother: read rate cap",                    Test_LoadSmootherRateLimit },
+        { "EMC profile: histograms and saturation bursts",   Test_EmcProfileHistogram },
+        { "EMC profile: title switches and slot recycling",  Test_EmcProfileTitles },
+        { "Context subscriptions: field diff and thresholds", Test_ContextChangedFields },
+        { "Context subscriptions: signal and collect",       Test_ContextSubscriptionsSignal },
+        { "Context subscriptions: slots and stale clients",  Test_ContextSubscriptionsSlots },
+        { "Config write queue: coalescing and delays",       Test_ConfigWriteQueueCoalesce },
+        { "Config write queue: overflow, flush and retry",   Test_ConfigWriteQueueRequeue },
+        { "Profile table: sorted titles and counts",         Test_ProfileTableSet },
+        { "Profile table: full table",                       Test_ProfileTableFull },
+        { "Notification queue: flapping limits",             Test_NotificationQueueCoalesce },
+        { "Notification queue: slots and long texts",        Test_NotificationQueueSlots },
+        { "Power budget: charger contract and battery",      Test_PowerBudgetContract },
+        { "Power budget: fuel gauge feedback",               Test_PowerBudgetFeedback },
+        { "IPC batch: validated as a whole",                 Test_IpcBatchCheck },
+        { "Context delta: encode and decode",                Test_ContextDeltaRoundTrip },
+        { "Context delta: malformed replies",                Test_ContextDeltaMalformed },
+        { "Context delta: generations",                      Test_ContextDeltaGenerations },
+        { "Tick stats: buckets and percentiles",             Test_TickStatsBuckets },
+        { "Tick stats: phases of a tick",                    Test_TickStatsPhases },
+    };
+
+    for (auto& test : tests) {
+        if (argc > 1 && !strstr(test.description, argv[1]))
+            continue;
+        test.Test();
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#undef NDEBUG
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define LOGGING(fmt, ...)  { printf("    " fmt "\n", ##__VA_ARGS__); }
+
+typedef struct UnitTest {
+    using Func = void(*)();
+
+    const char* description;
+    Func        fun = nullptr;
+
+    void Test() {
+        printf("%s\n", description);
+        fun();
+    }
+} UnitTest;
+
+// Deterministic noise for synthetic traces
+static inline std::uint32_t HostTestRand(std::uint32_t* seed) {
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    return *seed;
+}
+
+void Test_PowerModelFit();
+void Test_PowerModelCheapest();
+void Test_PowerModelPersist();
+
+void Test_ProfileLearnerPropose();
+void Test_ProfileLearnerSlots();
+void Test_ProfileLearnerPersist();
+
+void Test_BurstDetectorTrace();
+void Test_BurstDetectorGuards();
+
+void Test_CpuSamplerLoad();
+void Test_CpuSamplerWindow();
+
+void Test_LoadSmootherEma();
+void Test_LoadSmootherWindow();
+void Test_LoadSmootherRateLimit();
+
+void Test_EmcProfileHistogram();
+void Test_EmcProfileTitles();
+
+void Test_ContextChangedFields();
+void Test_ContextSubscriptionsSignal();
+void Test_ContextSubscriptionsSlots();
+
+void Test_ConfigWriteQueueCoalesce();
+void Test_ConfigWriteQueueRequeue();
+
+void Test_ProfileTableSet();
+void Test_ProfileTableFull();
+
+void Test_NotificationQueueCoalesce();
+void Test_NotificationQueueSlots();
+
+void Test_PowerBudgetContract();
+void Test_PowerBudgetFeedback();
+
+void Test_IpcBatchCheck();
+
+void Test_ContextDeltaRoundTrip();
+void Test_ContextDeltaMalformed();
+void Test_ContextDeltaGenerations();
+
+void Test_TickStatsBuckets();
+void Test_TickStatsPhases();
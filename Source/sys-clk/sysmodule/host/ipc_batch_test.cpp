@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include <sysclk.h>
+
+void Test_IpcBatchCheck() {
+    HocClkBatchOp ops[] = {
+        { HocClkBatchOp_ConfigValue, SysClkConfigValue_PollingIntervalMs, 0, 300 },
+        { HocClkBatchOp_Override, SysClkModule_GPU, 0, 768000000 },
+        { HocClkBatchOp_Profile, HOCCLK_BATCH_PROFILE_KEY(SysClkProfile_Docked, SysClkModule_MEM), 0x0100000000010000ULL, 1600 },
+        { HocClkBatchOp_Enabled, 0, 0, 1 },
+    };
+    HocClkBatchResult result;
+
+    assert(hocClkCheckBatch(ops, 4, &result));
+    assert(result.count == 4);
+    for (int i = 0; i < 4; i++)
+        assert(result.status[i] == 0);
+
+    assert(HOCCLK_BATCH_PROFILE(ops[2].key) == SysClkProfile_Docked);
+    assert(HOCCLK_BATCH_MODULE(ops[2].key) == SysClkModule_MEM);
+
+    // One bad op and nothing goes through
+    HocClkBatchOp bad[][1] = {
+        {{ HocClkBatchOp_ConfigValue, SysClkConfigValue_EnumMax, 0, 0 }},
+        {{ HocClkBatchOp_Override, SysClkModule_EnumMax, 0, 0 }},
+        {{ HocClkBatchOp_Override, SysClkModule_CPU, 0, 1ULL << 32 }},
+        {{ HocClkBatchOp_Profile, SysClkProfile_EnumMax * SysClkModule_EnumMax, 0x0100000000010000ULL, 1600 }},
+        {{ HocClkBatchOp_Profile, 0, 0, 1600 }},
+        {{ HocClkBatchOp_Enabled, 0, 0, 2 }},
+        {{ HocClkBatchOp_EnumMax, 0, 0, 0 }},
+    };
+    for (auto& op : bad) {
+        ops[1] = op[0];
+        assert(!hocClkCheckBatch(ops, 4, &result));
+        assert(result.status[1] == (std::uint32_t)SYSCLK_ERROR(InvalidBatchOp));
+        assert(result.status[0] == (std::uint32_t)SYSCLK_ERROR(BatchAborted));
+        assert(result.status[3] == (std::uint32_t)SYSCLK_ERROR(BatchAborted));
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "load_smoother.h"
+
+namespace {
+
+    const std::uint64_t Ms = 1000000ULL;
+
+    // Canned NVGPU_GPU_IOCTL_PMU_GET_GPU_LOAD results (permille) as a game moves
+    // from a menu into a GPU bound scene, with the PMU's usual frame to frame jitter
+    const std::uint32_t CannedLoad[] = {
+         80,  95,  60, 110,  70,  90,  85, 100,  75,  90,
+        940, 990, 870, 1000, 960, 910, 980, 930, 1000, 950,
+        970, 900, 990, 940, 1000, 920, 960, 990, 930, 970,
+    };
+    const int CannedCount = sizeof(CannedLoad) / sizeof(CannedLoad[0]);
+
+    // Replays the canned reads every 50 ms through the smoother, counting the ioctls it let through
+    int Replay(LoadSmoother* smoother, std::uint32_t* outLoads) {
+        int reads = 0;
+        for (int i = 0; i < CannedCount; i++) {
+            std::uint64_t ns = 1000 * Ms + i * 50 * Ms;
+            if (smoother->Due(ns)) {
+                smoother->AddSample(ns, CannedLoad[i]);
+                reads++;
+            }
+            outLoads[i] = smoother->Get();
+        }
+        return reads;
+    }
+
+}
+
+void Test_LoadSmootherEma() {
+    LoadSmoother smoother;
+    std::uint32_t loads[CannedCount];
+
+    assert(!smoother.Primed() && smoother.Get() == 0);
+
+    smoother.SetParams(LoadSmoother_Ema, 200 * Ms, 0);
+    assert(Replay(&smoother, loads) == CannedCount);
+
+    // First read taken as is, then the menu level settles around 85
+    assert(loads[0] == 80);
+    assert(loads[9] >= 70 && loads[9] <= 100);
+
+    // 50 ms into the scene with a 200 ms time constant: 1 - e^-0.25 of the step
+    LOGGING("step response: %u %u %u %u", loads[10], loads[11], loads[14], loads[19]);
+    assert(loads[10] > 250 && loads[10] < 300);
+    assert(loads[14] > 650);
+    assert(loads[29] > 900);
+
+    // Jitter is damped: the smoothed range over the scene is narrower than the raw one
+    std::uint32_t lo = 1000, hi = 0;
+    for (int i = 20; i < CannedCount; i++) {
+        lo = loads[i] < lo ? loads[i] : lo;
+        hi = loads[i] > hi ? loads[i] : hi;
+    }
+    assert(hi - lo < 100);
+
+    // The time constant is per time, not per read: twice the spacing, same 200 ms response
+    LoadSmoother sparse;
+    sparse.SetParams(LoadSmoother_Ema, 200 * Ms, 0);
+    sparse.AddSample(0, 0);
+    sparse.AddSample(200 * Ms, 1000);
+    LoadSmoother dense;
+    dense.SetParams(LoadSmoother_Ema, 200 * Ms, 0);
+    dense.AddSample(0, 0);
+    dense.AddSample(100 * Ms, 1000);
+    dense.AddSample(200 * Ms, 1000);
+    assert(sparse.Get() == dense.Get() && sparse.Get() == 632);
+}
+
+void Test_LoadSmootherWindow() {
+    LoadSmoother smoother;
+    std::uint32_t loads[CannedCount];
+
+    smoother.SetParams(LoadSmoother_Window, 250 * Ms, 0);
+    Replay(&smoother, loads);
+
+    // Five reads in 250 ms: the mean of the last five
+    std::uint32_t sum = 0;
+    for (int i = 25; i < 30; i++)
+        sum += CannedLoad[i];
+    assert(loads[29] == (sum + 2) / 5);
+
+    // Halfway through the step
+    assert(loads[12] > 500 && loads[12] < 700);
+
+    // A zero span keeps just the newest read
+    smoother.SetParams(LoadSmoother_Window, 0, 0);
+    smoother.AddSample(3000 * Ms, 123);
+    assert(smoother.Get() == 123);
+
+    // Switching modes starts over
+    smoother.SetParams(LoadSmoother_Ema, 100 * Ms, 0);
+    assert(!smoother.Primed());
+}
+
+void Test_LoadSmootherRateLimit() {
+    LoadSmoother smoother;
+    std::uint32_t loads[CannedCount];
+
+    // 50 ms polling, capped at one ioctl per 200 ms
+    smoother.SetParams(LoadSmoother_Ema, 200 * Ms, 200 * Ms);
+    int reads = Replay(&smoother, loads);
+    LOGGING("%d of %d reads", reads, CannedCount);
+    assert(reads == (CannedCount + 3) / 4);
+
+    // Between reads the value holds
+    assert(loads[1] == loads[0] && loads[3] == loads[0]);
+    assert(loads[29] > 850);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "notification_queue.h"
+
+namespace {
+
+    const std::uint64_t Ms = 1000000ULL;
+    const char* Tdp = "Horizon OC\nTDP has been activated";
+    const char* Thermal = "Horizon OC\nThermal Throttle has started";
+
+}
+
+void Test_NotificationQueueCoalesce() {
+    NotificationQueue queue;
+    NotificationQueueStats stats;
+    char text[NOTIFICATION_TEXT_MAX];
+
+    assert(!queue.Pending() && queue.WaitNs(0) == UINT64_MAX);
+    assert(!queue.Take(0, text));
+
+    // The TDP limit flapping every 300 ms tick for 2 minutes, thermal once in the middle
+    std::uint32_t shown = 0, tdpShown = 0, thermalShown = 0;
+    std::uint64_t lastShownNs = 0;
+    for (std::uint64_t ns = 1000 * Ms; ns < 121000 * Ms; ns += 300 * Ms) {
+        queue.Post(Tdp, ns);
+        if (ns == 1300 * Ms) {
+            queue.Post(Thermal, ns);
+        }
+
+        while (queue.Take(ns, text)) {
+            assert(!shown || ns - lastShownNs >= NOTIFICATION_MIN_INTERVAL_NS);
+            tdpShown += !strcmp(text, Tdp);
+            thermalShown += !strcmp(text, Thermal);
+            lastShownNs = ns;
+            shown++;
+        }
+    }
+
+    queue.GetStats(&stats);
+    LOGGING("%u posted, %u shown, %u coalesced, %u suppressed", stats.posted, stats.sent, stats.coalesced, stats.suppressed);
+    assert(tdpShown == 2 && thermalShown == 1 && stats.sent == 3);
+    assert(stats.posted == stats.sent + stats.coalesced + stats.suppressed && !stats.dropped);
+
+    // Thermal waited for the interval after the first TDP one
+    queue = NotificationQueue();
+    queue.Post(Tdp, 0);
+    queue.Post(Thermal, 100 * Ms);
+    queue.Post(Tdp, 200 * Ms);
+    assert(queue.Take(200 * Ms, text) && !strcmp(text, Tdp));
+    assert(queue.WaitNs(500 * Ms) == NOTIFICATION_MIN_INTERVAL_NS - 300 * Ms);
+    assert(!queue.Take(500 * Ms, text));
+    assert(queue.Take(200 * Ms + NOTIFICATION_MIN_INTERVAL_NS, text) && !strcmp(text, Thermal));
+    assert(!queue.Pending());
+
+    // Shown again once the repeat window is over
+    assert(!queue.Post(Tdp, 200 * Ms + NOTIFICATION_REPEAT_NS - 1));
+    assert(queue.Post(Tdp, 200 * Ms + NOTIFICATION_REPEAT_NS));
+    assert(queue.Take(200 * Ms + NOTIFICATION_REPEAT_NS, text) && !strcmp(text, Tdp));
+}
+
+void Test_NotificationQueueSlots() {
+    NotificationQueue queue;
+    NotificationQueueStats stats;
+    char text[NOTIFICATION_TEXT_MAX];
+    char posted[NOTIFICATION_QUEUE_SLOTS + 1][16];
+
+    // Every slot waiting, the next text has nowhere to go
+    for (int i = 0; i <= NOTIFICATION_QUEUE_SLOTS; i++) {
+        snprintf(posted[i], sizeof(posted[i]), "message %d", i);
+        assert(queue.Post(posted[i], i * Ms) == (i < NOTIFICATION_QUEUE_SLOTS));
+    }
+    queue.GetStats(&stats);
+    assert(stats.dropped == 1);
+
+    // Oldest first, and a shown slot is reused for something new
+    std::uint64_t ns = 0;
+    for (int i = 0; i < NOTIFICATION_QUEUE_SLOTS; i++) {
+        ns += NOTIFICATION_MIN_INTERVAL_NS;
+        assert(queue.Take(ns, text) && !strcmp(text, posted[i]));
+    }
+    assert(queue.Post(posted[NOTIFICATION_QUEUE_SLOTS], ns));
+    ns += NOTIFICATION_MIN_INTERVAL_NS;
+    assert(queue.Take(ns, text) && !strcmp(text, posted[NOTIFICATION_QUEUE_SLOTS]));
+
+    // Message 0's slot was taken, so it can repeat right away, in message 1's slot now
+    assert(queue.Post(posted[0], ns));
+    assert(!queue.Post(posted[2], ns));
+    assert(queue.Post(posted[1], ns));
+
+    // Too long texts are cut, and still recognized as the same
+    char longText[NOTIFICATION_TEXT_MAX * 2];
+    memset(longText, 'x', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+    queue = NotificationQueue();
+    assert(queue.Post(longText, 0));
+    assert(queue.Take(0, text) && strlen(text) == NOTIFICATION_TEXT_MAX - 1);
+    assert(!queue.Post(longText, Ms));
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "power_budget.h"
+
+namespace {
+
+    const std::uint64_t Sec = 1000000000ULL;
+
+    PowerBudgetInputs Inputs(std::int32_t contractMw, std::uint32_t batteryPcm, std::int32_t batteryMw) {
+        PowerBudgetInputs inputs;
+        inputs.contractMw = contractMw;
+        inputs.chargeMw = 7800;
+        inputs.batteryPcm = batteryPcm;
+        inputs.batteryMw = batteryMw;
+        return inputs;
+    }
+
+    // A fresh solver for one set of inputs, as it settles with nothing overdrawn
+    std::uint32_t GpuCap(SysClkSocType socType, std::int32_t contractMw, std::uint32_t batteryPcm, bool batteryAware) {
+        PowerBudget budget;
+        budget.SetBatteryAware(batteryAware);
+        PowerBudgetInputs inputs = Inputs(contractMw, batteryPcm, contractMw ? 1000 : -1000);
+        budget.Update(socType, &inputs, Sec);
+        return budget.GetMaxHz(SysClkModule_GPU);
+    }
+
+}
+
+void Test_PowerBudgetContract() {
+    // The old profile caps: handheld on battery, charging over USB, the official charger
+    assert(GpuCap(SysClkSocType_Erista, 0, 100000, false) == 460800000);
+    assert(GpuCap(SysClkSocType_Mariko, 0, 100000, false) == 614400000);
+    assert(GpuCap(SysClkSocType_MarikoLite, 0, 100000, false) == 537600000);
+    assert(GpuCap(SysClkSocType_Mariko, 5000 * 1500 / 1000, 100000, false) == 768000000);
+    assert(GpuCap(SysClkSocType_Mariko, 39000, 100000, false) == 0);
+
+    // 18 W and 45 W PD chargers no longer look the same
+    assert(GpuCap(SysClkSocType_Mariko, 18000, 100000, false) == 1075200000);
+    assert(GpuCap(SysClkSocType_Mariko, 45000, 100000, false) == 0);
+    assert(GpuCap(SysClkSocType_Erista, 18000, 100000, false) == 921600000);
+
+    // Charging a low battery comes out of the contract, an empty one gives nothing
+    assert(GpuCap(SysClkSocType_Mariko, 18000, 40000, true) == 768000000);
+    assert(GpuCap(SysClkSocType_Mariko, 0, 40000, true) == 460800000);
+    assert(GpuCap(SysClkSocType_Mariko, 0, 10000, true) == 460800000);
+
+    // Unless enabled the charge level doesn't count, never below the old caps
+    assert(GpuCap(SysClkSocType_Mariko, 18000, 40000, false) == 1075200000);
+    assert(GpuCap(SysClkSocType_Mariko, 0, 10000, false) == 614400000);
+    assert(GpuCap(SysClkSocType_Erista, 0, 10000, false) == 460800000);
+    assert(GpuCap(SysClkSocType_MarikoLite, 0, 10000, false) == 537600000);
+
+    PowerBudget budget;
+    budget.SetBatteryAware(true);
+    PowerBudgetInputs inputs = Inputs(0, 10000, -1000);
+    budget.Update(SysClkSocType_Mariko, &inputs, Sec);
+    assert(budget.GetBudgetMw() == 0 && budget.GetMaxHz(SysClkModule_GPU) == 460800000);
+
+    // CPU and MEM only come down once their caps are enabled, and never in the old GPU-only rows
+    assert(budget.GetMaxHz(SysClkModule_CPU) == 0 && budget.GetMaxHz(SysClkModule_MEM) == 0);
+    assert(budget.SetCpuMemCaps(true) && !budget.SetCpuMemCaps(true));
+    assert(budget.GetMaxHz(SysClkModule_CPU) == 1785000000 && budget.GetMaxHz(SysClkModule_MEM) == 1600000000);
+    for (int s = 0; s < SysClkSocType_EnumMax; s++) {
+        const PowerBudgetSoc* rows = PowerBudget::GetSoc((SysClkSocType)s);
+        for (std::uint32_t r = 1; r < rows->rowCount; r++)
+            assert(rows->rows[r].hz[SysClkModule_CPU] == 0 && rows->rows[r].hz[SysClkModule_MEM] == 0);
+    }
+
+    // Headroom scales with the charge between the two marks
+    const PowerBudgetSoc* soc = PowerBudget::GetSoc(SysClkSocType_Mariko);
+    assert(PowerBudget::GetDischargeMw(soc, POWER_BUDGET_DISCHARGE_EMPTY_PCM) == 0);
+    assert(PowerBudget::GetDischargeMw(soc, (POWER_BUDGET_DISCHARGE_EMPTY_PCM + POWER_BUDGET_DISCHARGE_FULL_PCM) / 2) == soc->dischargeMw / 2);
+    assert(PowerBudget::GetDischargeMw(soc, 100000) == soc->dischargeMw);
+
+    // Unknown SoCs stay uncapped
+    PowerBudget unknown;
+    unknown.Update(SysClkSocType_EnumMax, &inputs, Sec);
+    for (int m = 0; m < SysClkModule_EnumMax; m++) {
+        assert(unknown.GetMaxHz((SysClkModule)m) == 0);
+    }
+
+    // Every table starts at 0 mW and goes up
+    for (int s = 0; s < SysClkSocType_EnumMax; s++) {
+        soc = PowerBudget::GetSoc((SysClkSocType)s);
+        assert(soc->rowCount && soc->rows[0].budgetMw == 0);
+        for (std::uint32_t r = 1; r < soc->rowCount; r++)
+            assert(soc->rows[r].budgetMw > soc->rows[r - 1].budgetMw);
+    }
+}
+
+void Test_PowerBudgetFeedback() {
+    PowerBudget budget;
+    assert(budget.SetBatteryAware(true) && !budget.SetBatteryAware(true));
+    PowerBudgetInputs inputs = Inputs(18000, 100000, 1000);
+    std::uint64_t ns = Sec;
+
+    assert(budget.Update(SysClkSocType_Mariko, &inputs, ns));
+    assert(budget.GetMaxHz(SysClkModule_GPU) == 1075200000);
+    assert(!budget.Update(SysClkSocType_Mariko, &inputs, ns + Sec));
+
+    // The battery drains 3 W past its headroom: ignored until the gauge settled, then a row down
+    inputs.batteryMw = -PowerBudget::GetSoc(SysClkSocType_Mariko)->dischargeMw - 3000;
+    ns += POWER_BUDGET_SETTLE_NS / 2;
+    assert(!budget.Update(SysClkSocType_Mariko, &inputs, ns));
+    ns += POWER_BUDGET_SETTLE_NS;
+    assert(budget.Update(SysClkSocType_Mariko, &inputs, ns));
+    assert(budget.GetMaxHz(SysClkModule_GPU) == 768000000);
+    std::int32_t lowered = budget.GetBudgetMw();
+    LOGGING("budget lowered to %d mW", lowered);
+    assert(lowered == 20000 - 3000);
+
+    // Within its headroom at the lower row, the penalty fades and the row above is tried again
+    inputs.batteryMw = -1000;
+    std::uint64_t retryNs = 0;
+    for (std::uint64_t t = ns + Sec; t < ns + 200 * Sec; t += Sec) {
+        if (budget.Update(SysClkSocType_Mariko, &inputs, t)) {
+            retryNs = t;
+            break;
+        }
+    }
+    LOGGING("retried after %lu s", (unsigned long)((retryNs - ns) / Sec));
+    assert(retryNs && budget.GetMaxHz(SysClkModule_GPU) == 1075200000);
+    assert(retryNs - ns >= 10 * Sec);
+
+    // The fuel gauge isn't heard unless enabled, turning it off drops the penalty
+    inputs.batteryMw = -PowerBudget::GetSoc(SysClkSocType_Mariko)->dischargeMw - 3000;
+    ns = retryNs + 2 * POWER_BUDGET_SETTLE_NS;
+    assert(budget.Update(SysClkSocType_Mariko, &inputs, ns));
+    assert(budget.GetMaxHz(SysClkModule_GPU) == 768000000);
+    assert(budget.SetBatteryAware(false));
+    assert(budget.Update(SysClkSocType_Mariko, &inputs, ns + Sec));
+    assert(budget.GetMaxHz(SysClkModule_GPU) == 1075200000);
+    assert(!budget.Update(SysClkSocType_Mariko, &inputs, ns + 2 * POWER_BUDGET_SETTLE_NS));
+
+    // Small budget moves around a row's edge don't step up and down
+    PowerBudget edge;
+    edge.SetBatteryAware(true);
+    inputs = Inputs(0, 100000, -1000);
+    const PowerBudgetSoc* soc = PowerBudget::GetSoc(SysClkSocType_Mariko);
+    inputs.batteryPcm = POWER_BUDGET_DISCHARGE_EMPTY_PCM + (std::uint64_t)(POWER_BUDGET_DISCHARGE_FULL_PCM - POWER_BUDGET_DISCHARGE_EMPTY_PCM) * 6500 / soc->dischargeMw;
+    edge.Update(SysClkSocType_Mariko, &inputs, Sec);
+    assert(edge.GetMaxHz(SysClkModule_GPU) == 460800000);
+    inputs.batteryPcm = 100000;
+    assert(edge.Update(SysClkSocType_Mariko, &inputs, 2 * Sec));
+    inputs.batteryPcm = POWER_BUDGET_DISCHARGE_EMPTY_PCM + (std::uint64_t)(POWER_BUDGET_DISCHARGE_FULL_PCM - POWER_BUDGET_DISCHARGE_EMPTY_PCM) * 6500 / soc->dischargeMw;
+    assert(!edge.Update(SysClkSocType_Mariko, &inputs, 3 * Sec));
+    assert(edge.GetMaxHz(SysClkModule_GPU) == 614400000);
+
+    // A new charger drops what was learned about the old one
+    inputs = Inputs(18000, 100000, -20000);
+    PowerBudget replug;
+    replug.SetBatteryAware(true);
+    replug.Update(SysClkSocType_Mariko, &inputs, Sec);
+    replug.Update(SysClkSocType_Mariko, &inputs, Sec + 2 * POWER_BUDGET_SETTLE_NS);
+    assert(replug.GetMaxHz(SysClkModule_GPU) != 1075200000);
+    inputs = Inputs(39000, 100000, -20000);
+    assert(replug.Update(SysClkSocType_Mariko, &inputs, Sec + 2 * POWER_BUDGET_SETTLE_NS + Sec));
+    assert(replug.GetMaxHz(SysClkModule_GPU) == 0);
+}
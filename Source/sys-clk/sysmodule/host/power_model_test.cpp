@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "power_model.h"
+
+namespace {
+
+    struct OperatingPoint {
+        std::uint32_t hz;
+        std::uint32_t uv;
+    };
+
+    // Roughly a Mariko unit at speedo 1650
+    const OperatingPoint CpuPoints[] = {
+        {  612000000,  620000 }, { 1020000000,  630000 }, { 1428000000,  770000 },
+        { 1785000000,  945000 }, { 1963500000, 1050000 },
+    };
+    const OperatingPoint GpuPoints[] = {
+        {  307200000,  610000 }, {  460800000,  610000 }, {  768000000,  660000 },
+        {  921600000,  720000 }, { 1075200000,  800000 },
+    };
+    const OperatingPoint MemPoints[] = {
+        { 1331200000, 1100000 }, { 1600000000, 1100000 }, { 2133000000, 1175000 },
+    };
+
+    const double BaseMw = 1500., CpuK = 900., GpuK = 2200., MemK = 300.;
+
+    double TrueMw(const std::uint32_t* hz, const std::uint32_t* uv) {
+        const double k[] = { CpuK, GpuK, MemK };
+        double mw = BaseMw;
+        for (int m = 0; m < SysClkModule_EnumMax; m++) {
+            double v = uv[m] / 1e6;
+            mw += k[m] * hz[m] / 1e9 * v * v;
+        }
+        return mw;
+    }
+
+    // Random walk over the operating points with +-5% sensor noise
+    void FeedTrace(PowerModel* model, int samples, std::uint32_t seed) {
+        for (int i = 0; i < samples; i++) {
+            const OperatingPoint& c = CpuPoints[HostTestRand(&seed) % 5];
+            const OperatingPoint& g = GpuPoints[HostTestRand(&seed) % 5];
+            const OperatingPoint& m = MemPoints[HostTestRand(&seed) % 3];
+            std::uint32_t hz[] = { c.hz, g.hz, m.hz };
+            std::uint32_t uv[] = { c.uv, g.uv, m.uv };
+
+            double noise = 1. + ((int)(HostTestRand(&seed) % 1001) - 500) / 10000.;
+            model->AddSample(hz, uv, (std::int32_t)(TrueMw(hz, uv) * noise));
+        }
+    }
+
+}
+
+void Test_PowerModelFit() {
+    PowerModel model;
+
+    std::uint32_t hz[] = { 1785000000, 921600000, 1600000000 };
+    std::uint32_t uv[] = { 945000, 720000, 1100000 };
+    assert(model.EstimateMw(hz) == -1);
+
+    FeedTrace(&model, 4000, 1);
+    assert(model.Ready());
+
+    std::int32_t rails[POWER_MODEL_FEATURES];
+    assert(model.GetRailMw(hz, rails));
+
+    const double expected[] = {
+        BaseMw,
+        CpuK * 1.785 * 0.945 * 0.945,
+        GpuK * 0.9216 * 0.72 * 0.72,
+        MemK * 1.6 * 1.1 * 1.1,
+    };
+    for (int i = 0; i < POWER_MODEL_FEATURES; i++) {
+        LOGGING("rail %d: %d mW (true %.0f mW)", i, rails[i], expected[i]);
+        assert(std::fabs(rails[i] - expected[i]) < 0.1 * expected[i] + 30.);
+    }
+
+    double truth = TrueMw(hz, uv);
+    std::int32_t estimate = model.EstimateMw(hz);
+    LOGGING("estimate %d mW, true %.0f mW", estimate, truth);
+    assert(std::fabs(estimate - truth) < 0.05 * truth);
+
+    // Between two visited GPU points the voltage is interpolated
+    std::uint32_t between[] = { 1785000000, 844800000, 1600000000 };
+    std::uint32_t betweenUv[] = { 945000, 690000, 1100000 };
+    estimate = model.EstimateMw(between);
+    truth = TrueMw(between, betweenUv);
+    LOGGING("unvisited estimate %d mW, true %.0f mW", estimate, truth);
+    assert(std::fabs(estimate - truth) < 0.05 * truth);
+}
+
+void Test_PowerModelCheapest() {
+    PowerModel model;
+    FeedTrace(&model, 4000, 2);
+
+    std::uint32_t minHz[] = { 1000000000, 460800000, 1500000000 };
+    std::uint32_t hz[SysClkModule_EnumMax];
+    std::int32_t mw = 0;
+    assert(model.FindCheapest(minHz, hz, &mw));
+    LOGGING("cheapest %u/%u/%u MHz at %d mW", hz[0] / 1000000, hz[1] / 1000000, hz[2] / 1000000, mw);
+    assert(hz[0] == 1020000000 && hz[1] == 460800000 && hz[2] == 1600000000);
+
+    // Nothing that fast was ever seen
+    std::uint32_t tooFast[] = { 2397000000, 0, 0 };
+    assert(!model.FindCheapest(tooFast, hz, &mw));
+}
+
+void Test_PowerModelPersist() {
+    const char* path = "power_model_test.bin";
+    PowerModel model;
+    model.Reset(0x1234);
+    FeedTrace(&model, 1000, 3);
+    assert(model.IsDirty());
+    assert(model.Save(path));
+    assert(!model.IsDirty());
+
+    std::uint32_t hz[] = { 1428000000, 768000000, 1600000000 };
+
+    PowerModel loaded;
+    assert(loaded.Load(path, 0x1234));
+    assert(loaded.GetSampleCount() == 1000);
+    assert(loaded.EstimateMw(hz) == model.EstimateMw(hz));
+
+    // Another console starts from scratch
+    PowerModel other;
+    assert(!other.Load(path, 0x5678));
+    assert(!other.Ready());
+
+    remove(path);
+    assert(!other.Load(path, 0x5678));
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "profile_learner.h"
+
+namespace {
+
+    const std::uint64_t Tid = 0x0100000000010000ULL;
+
+    const std::uint32_t MemFreqs[] = { 665600000, 800000000, 1065600000, 1331200000, 1600000000 };
+    const std::uint32_t MemFreqCount = sizeof(MemFreqs) / sizeof(MemFreqs[0]);
+
+    // MEM pinned at 1600 MHz with a load spread evenly over 40-60%
+    void FeedTitle(ProfileLearner* learner, std::uint64_t tid, SysClkProfile profile, int samples, std::uint32_t seed) {
+        for (int i = 0; i < samples; i++) {
+            std::uint32_t hz[] = { 1020000000, 460800000, 1600000000 };
+            std::uint32_t load[] = { 0, 0, 400 + HostTestRand(&seed) % 201 };
+            learner->AddSample(tid, profile, hz, load, 1 << SysClkModule_MEM);
+        }
+    }
+
+}
+
+void Test_ProfileLearnerPropose() {
+    ProfileLearner learner;
+
+    FeedTitle(&learner, Tid, SysClkProfile_Handheld, PROFILE_LEARNER_MIN_SAMPLES - 1, 1);
+    assert(learner.ProposeMHz(Tid, SysClkProfile_Handheld, SysClkModule_MEM, 80, MemFreqs, MemFreqCount) == 0);
+
+    FeedTitle(&learner, Tid, SysClkProfile_Handheld, 1000, 2);
+    assert(learner.GetSampleCount(Tid, SysClkProfile_Handheld, SysClkModule_MEM) == PROFILE_LEARNER_MIN_SAMPLES + 999);
+    assert(learner.GetSampleCount(Tid, SysClkProfile_Handheld, SysClkModule_CPU) == 0);
+    assert(learner.GetSampleCount(Tid, SysClkProfile_Docked, SysClkModule_MEM) == 0);
+
+    // p95 demand ~944 MHz, 950 / 0.8 = 1187 MHz
+    std::uint32_t mhz = learner.ProposeMHz(Tid, SysClkProfile_Handheld, SysClkModule_MEM, 80, MemFreqs, MemFreqCount);
+    LOGGING("80%% target: %u MHz", mhz);
+    assert(mhz == 1331);
+
+    // 950 / 0.95 = 1000 MHz
+    mhz = learner.ProposeMHz(Tid, SysClkProfile_Handheld, SysClkModule_MEM, 95, MemFreqs, MemFreqCount);
+    LOGGING("95%% target: %u MHz", mhz);
+    assert(mhz == 1065);
+
+    // Nothing in the table is enough, the top clock is proposed
+    assert(learner.ProposeMHz(Tid, SysClkProfile_Handheld, SysClkModule_MEM, 50, MemFreqs, MemFreqCount) == 1600);
+    assert(learner.ProposeMHz(Tid, SysClkProfile_Docked, SysClkModule_MEM, 80, MemFreqs, MemFreqCount) == 0);
+
+    learner.Forget(Tid);
+    assert(learner.GetSampleCount(Tid, SysClkProfile_Handheld, SysClkModule_MEM) == 0);
+}
+
+void Test_ProfileLearnerSlots() {
+    ProfileLearner learner;
+
+    // Well past the 16 bit counters, the histograms halve instead of wrapping
+    FeedTitle(&learner, Tid, SysClkProfile_Handheld, 200000, 3);
+    assert(learner.ProposeMHz(Tid, SysClkProfile_Handheld, SysClkModule_MEM, 80, MemFreqs, MemFreqCount) == 1331);
+
+    // The title played least recently gives its slot up first
+    for (std::uint64_t i = 1; i < PROFILE_LEARNER_SLOTS; i++) {
+        FeedTitle(&learner, Tid + i, SysClkProfile_Docked, 1, 4);
+    }
+    FeedTitle(&learner, Tid, SysClkProfile_Handheld, 1, 5);
+    FeedTitle(&learner, Tid + PROFILE_LEARNER_SLOTS, SysClkProfile_Docked, 1, 6);
+
+    assert(learner.GetSampleCount(Tid, SysClkProfile_Handheld, SysClkModule_MEM) == 200001);
+    assert(learner.GetSampleCount(Tid + 1, SysClkProfile_Docked, SysClkModule_MEM) == 0);
+    assert(learner.GetSampleCount(Tid + PROFILE_LEARNER_SLOTS, SysClkProfile_Docked, SysClkModule_MEM) == 1);
+
+    // Application id 0 is nothing running
+    FeedTitle(&learner, 0, SysClkProfile_Docked, 1, 7);
+    assert(learner.GetSampleCount(Tid + 2, SysClkProfile_Docked, SysClkModule_MEM) == 1);
+}
+
+void Test_ProfileLearnerPersist() {
+    const char* path = "build/learned_profiles.bin";
+
+    ProfileLearner learner;
+    FeedTitle(&learner, Tid, SysClkProfile_Handheld, 3000, 8);
+    assert(learner.IsDirty());
+    assert(learner.Save(path));
+    assert(!learner.IsDirty());
+
+    ProfileLearner loaded;
+    assert(loaded.Load(path));
+    assert(loaded.GetSampleCount(Tid, SysClkProfile_Handheld, SysClkModule_MEM) == 3000);
+    assert(loaded.ProposeMHz(Tid, SysClkProfile_Handheld, SysClkModule_MEM, 80, MemFreqs, MemFreqCount) ==
+           learner.ProposeMHz(Tid, SysClkProfile_Handheld, SysClkModule_MEM, 80, MemFreqs, MemFreqCount));
+
+    assert(!loaded.Load("build/missing.bin"));
+    assert(loaded.GetSampleCount(Tid, SysClkProfile_Handheld, SysClkModule_MEM) == 0);
+
+    remove(path);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "profile_table.h"
+
+void Test_ProfileTableSet() {
+    ProfileTable table;
+
+    assert(!table.Find(0x0100000000010000ULL, SysClkModule_CPU, SysClkProfile_Docked));
+    assert(table.Set(0x0100000000010000ULL, SysClkModule_GPU, SysClkProfile_Handheld, 0));
+    assert(!table.GetTitleCount());
+
+    // Out of order inserts come back sorted and stay apart per title
+    assert(table.Set(0x0100000000030000ULL, SysClkModule_CPU, SysClkProfile_Docked, 1785));
+    assert(table.Set(0x0100000000010000ULL, SysClkModule_CPU, SysClkProfile_Docked, 1020));
+    assert(table.Set(0x0100000000020000ULL, SysClkModule_MEM, SysClkProfile_Handheld, 1600));
+    assert(table.Set(0x0100000000010000ULL, SysClkModule_GPU, SysClkProfile_Handheld, 460));
+    assert(table.GetTitleCount() == 3);
+    assert(table.Find(0x0100000000010000ULL, SysClkModule_CPU, SysClkProfile_Docked) == 1020);
+    assert(table.Find(0x0100000000010000ULL, SysClkModule_GPU, SysClkProfile_Handheld) == 460);
+    assert(table.Find(0x0100000000020000ULL, SysClkModule_MEM, SysClkProfile_Handheld) == 1600);
+    assert(table.Find(0x0100000000030000ULL, SysClkModule_CPU, SysClkProfile_Docked) == 1785);
+    assert(!table.Find(0x0100000000030000ULL, SysClkModule_CPU, SysClkProfile_Handheld));
+    assert(table.GetCount(0x0100000000010000ULL) == 2);
+
+    // Setting a clock again doesn't count twice, clearing the last one drops the title
+    assert(table.Set(0x0100000000010000ULL, SysClkModule_CPU, SysClkProfile_Docked, 1224));
+    assert(table.GetCount(0x0100000000010000ULL) == 2);
+    assert(table.Set(0x0100000000010000ULL, SysClkModule_CPU, SysClkProfile_Docked, 0));
+    assert(table.Set(0x0100000000010000ULL, SysClkModule_CPU, SysClkProfile_Docked, 0));
+    assert(table.GetCount(0x0100000000010000ULL) == 1);
+    assert(table.Set(0x0100000000010000ULL, SysClkModule_GPU, SysClkProfile_Handheld, 0));
+    assert(!table.GetCount(0x0100000000010000ULL) && table.GetTitleCount() == 2);
+    assert(table.Find(0x0100000000020000ULL, SysClkModule_MEM, SysClkProfile_Handheld) == 1600);
+
+    table.Clear();
+    assert(!table.GetTitleCount() && !table.Find(0x0100000000020000ULL, SysClkModule_MEM, SysClkProfile_Handheld));
+}
+
+void Test_ProfileTableFull() {
+    ProfileTable table;
+
+    for (std::uint64_t i = PROFILE_TABLE_TITLES; i > 0; i--) {
+        assert(table.Set(0x0100000000000000ULL | (i << 16), SysClkModule_CPU, SysClkProfile_Docked, 1000 + i));
+    }
+    assert(table.GetTitleCount() == PROFILE_TABLE_TITLES);
+
+    // No room for a new title, titles already in still take changes
+    std::uint64_t extra = 0x0100000000000000ULL | ((std::uint64_t)(PROFILE_TABLE_TITLES + 1) << 16);
+    assert(!table.Set(extra, SysClkModule_CPU, SysClkProfile_Docked, 1020));
+    assert(table.Set(extra, SysClkModule_CPU, SysClkProfile_Docked, 0));
+    assert(table.Set(0x0100000000010000ULL, SysClkModule_GPU, SysClkProfile_Docked, 768));
+    assert(table.GetCount(0x0100000000010000ULL) == 2);
+
+    for (std::uint64_t i = 1; i <= PROFILE_TABLE_TITLES; i++) {
+        assert(table.Find(0x0100000000000000ULL | (i << 16), SysClkModule_CPU, SysClkProfile_Docked) == 1000 + i);
+    }
+
+    // A freed row makes room again
+    assert(table.Set(0x0100000000020000ULL, SysClkModule_CPU, SysClkProfile_Docked, 0));
+    assert(table.Set(extra, SysClkModule_CPU, SysClkProfile_Docked, 1020));
+    assert(table.Find(extra, SysClkModule_CPU, SysClkProfile_Docked) == 1020);
+    assert(!table.Find(0x0100000000020000ULL, SysClkModule_CPU, SysClkProfile_Docked));
+}
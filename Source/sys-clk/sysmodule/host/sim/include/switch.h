@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Stand-in for the parts of libnx the sysmodule logic uses, so ClockManager,
+// Config and IpcService build for the host against the simulated board.
+// Threads, events and time are provided by sim_os.cpp, the IPC server by
+// sim_ipc.cpp. Only what the host build needs is declared here.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+
+typedef u32 Result;
+typedef u32 Handle;
+
+#define BIT(n) (1U << (n))
+
+#define INVALID_HANDLE ((Handle)0)
+#define CUR_THREAD_HANDLE ((Handle)0xFFFF8000)
+
+#define R_SUCCEEDED(res) ((res) == 0)
+#define R_FAILED(res) ((res) != 0)
+#define R_MODULE(res) ((res) & 0x1FF)
+#define R_DESCRIPTION(res) (((res) >> 9) & 0x1FFF)
+#define MAKERESULT(module, description) ((((module) & 0x1FF)) | ((description) & 0x1FFF) << 9)
+
+#define Module_Kernel 1
+#define KernelError_TimedOut 117
+#define KernelError_Cancelled 118
+#define KernelError_OutOfRange 119
+#define KernelError_ConnectionClosed 123
+#define KERNELRESULT(description) MAKERESULT(Module_Kernel, KernelError_##description)
+
+#define MAX_WAIT_OBJECTS 0x40
+
+// Time, see simClockSetManual
+u64 armGetSystemTick(void);
+u64 armGetSystemTickFreq(void);
+u64 armTicksToNs(u64 tick);
+u64 armNsToTicks(u64 ns);
+
+// Synchronization
+typedef struct
+{
+    void* impl;
+} Mutex;
+
+void mutexInit(Mutex* m);
+void mutexLock(Mutex* m);
+bool mutexTryLock(Mutex* m);
+void mutexUnlock(Mutex* m);
+
+typedef struct
+{
+    void* impl;
+} UEvent;
+
+void ueventCreate(UEvent* e, bool autoclear);
+void ueventClear(UEvent* e);
+void ueventSignal(UEvent* e);
+
+typedef struct
+{
+    Handle revent;
+    Handle wevent;
+    bool autoclear;
+} Event;
+
+Result eventCreate(Event* e, bool autoclear);
+void eventClose(Event* e);
+Result eventFire(Event* e);
+Result eventClear(Event* e);
+
+typedef struct
+{
+    UEvent* uevent;
+    Handle handle;
+} Waiter;
+
+static inline Waiter waiterForUEvent(UEvent* e)
+{
+    Waiter w = { e, INVALID_HANDLE };
+    return w;
+}
+
+static inline Waiter waiterForEvent(Event* e)
+{
+    Waiter w = { NULL, e->revent };
+    return w;
+}
+
+Result waitSingle(Waiter w, u64 timeout);
+
+// Threads, priorities and cores are ignored
+typedef void (*ThreadFunc)(void*);
+
+typedef struct
+{
+    Handle handle;
+    void* impl;
+} Thread;
+
+Result threadCreate(Thread* t, ThreadFunc entry, void* arg, void* stack_mem, size_t stack_sz, int prio, int cpuid);
+Result threadStart(Thread* t);
+Result threadWaitForExit(Thread* t);
+Result threadClose(Thread* t);
+
+void svcSleepThread(s64 nano);
+Result svcGetThreadPriority(s32* priority, Handle handle);
+Result svcCancelSynchronization(Handle thread);
+Result svcReadWriteRegister(u32* out, u64 address, u32 mask, u32 value);
+
+// Services the sysmodule opens at boot, nothing to do on the host
+static inline Result timeInitialize(void) { return 0; }
+static inline void timeExit(void) {}
+static inline Result fsInitialize(void) { return 0; }
+static inline void fsExit(void) {}
+static inline Result fsdevMountSdmc(void) { return 0; }
+static inline Result fsdevUnmountAll(void) { return 0; }
+static inline bool hosversionAtLeast(u8 major, u8 minor, u8 micro) { return true; }
+
+// Applet
+typedef enum
+{
+    AppletOperationMode_Handheld = 0,
+    AppletOperationMode_Console = 1,
+} AppletOperationMode;
+
+typedef enum
+{
+    PsmChargerType_Unconnected = 0,
+    PsmChargerType_EnoughPower = 1,
+    PsmChargerType_LowPower = 2,
+    PsmChargerType_NotSupported = 3,
+} PsmChargerType;
+
+// pcv, only named by board.h
+typedef u32 PcvModule;
+typedef u32 PcvModuleId;
+
+// i2c, only named by nxExt
+typedef struct
+{
+    Handle handle;
+} I2cSession;
+
+// sm and hipc, as much as nxExt/ipc_server.h needs
+typedef struct
+{
+    char name[8];
+} SmServiceName;
+
+typedef struct
+{
+    u32 num_send_statics;
+    u32 num_send_buffers;
+    u32 num_recv_buffers;
+    u32 num_exch_buffers;
+    u32 num_data_words;
+    u32 num_recv_statics;
+    u32 send_pid;
+    u32 num_copy_handles;
+    u32 num_move_handles;
+} HipcMetadata;
+
+typedef struct
+{
+    void* address;
+    size_t size;
+} HipcBufferDescriptor;
+
+typedef struct
+{
+    const HipcBufferDescriptor* send_buffers;
+    const HipcBufferDescriptor* recv_buffers;
+} HipcRequestData;
+
+typedef struct
+{
+    HipcMetadata meta;
+    HipcRequestData data;
+} HipcParsedRequest;
+
+static inline void* hipcGetBufferAddress(const HipcBufferDescriptor* desc)
+{
+    return desc->address;
+}
+
+static inline size_t hipcGetBufferSize(const HipcBufferDescriptor* desc)
+{
+    return desc->size;
+}
+
+#ifdef __cplusplus
+}
+#endif
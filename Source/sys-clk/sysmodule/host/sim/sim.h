@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Host side of the simulator: clock, threads and the IPC client. Everything
+// the sysmodule itself calls goes through the libnx names in include/switch.h.
+
+#pragma once
+
+#include <switch.h>
+#include <nxExt/ipc_server.h>
+#include <cstddef>
+#include <cstdint>
+
+// Manual clock: armGetSystemTick only moves with simClockAdvanceNs and
+// finite waits return after at most SIM_MANUAL_WAIT_NS of real time, so
+// ticks are deterministic and as fast as the host runs them. Otherwise the
+// clock is the host's monotonic one.
+#define SIM_MANUAL_WAIT_NS 1000000ULL
+
+void simClockSetManual(bool manual);
+bool simClockIsManual();
+void simClockAdvanceNs(std::uint64_t ns);
+std::uint64_t simClockNowNs();
+
+// True once per svcCancelSynchronization of the calling thread
+bool simThreadTakeCancel();
+
+typedef struct
+{
+    std::uint64_t cmdId;
+    const void* in;
+    std::size_t inSize;
+    void* out;
+    std::size_t outSize;        // in: capacity, out: bytes the handler returned
+    const void* send;           // send (in) buffer, optional
+    std::size_t sendSize;
+    void* recv;                 // receive (out) buffer, optional
+    std::size_t recvSize;
+    Handle handle;              // copy handle the handler sent back, if any
+} SimIpcRequest;
+
+// Sends a request to the server registered under name and waits until its
+// ipcServerProcess thread handled it
+Result simIpcDispatch(const char* name, SimIpcRequest* req);
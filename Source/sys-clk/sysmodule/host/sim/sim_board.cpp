@@ -0,0 +1,570 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sim_board.h"
+#include "process_management.h"
+#include "errors.h"
+#include "sim.h"
+#include "cpu_sampler.h"
+#include <nxExt/apm_ext.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+#define SIM_STOCK_SD1_UV 1100000
+#define SIM_ACTMON_PERIOD_MS 20
+
+namespace {
+
+    // Rates as pcv lists them, IsAssignableHz filters like on the console
+    const std::uint32_t g_cpuMHz[] = { 204, 306, 408, 510, 612, 714, 816, 918, 1020, 1122, 1224, 1326, 1428, 1581, 1683, 1785, 1887, 1963, 2091, 2193, 2295, 2397 };
+    const std::uint32_t g_gpuKHz[] = { 76800, 153600, 230400, 307200, 384000, 460800, 537600, 614400, 691200, 768000, 844800, 921600, 998400, 1075200, 1152000, 1228800, 1267200 };
+    const std::uint32_t g_memKHz[] = { 204000, 665600, 800000, 1065600, 1331200, 1600000, 1862400, 2133000, 2400000 };
+
+    struct SimBoardState {
+        std::mutex lock;
+        SimBoardModel model;
+        SimBoardCounters counters;
+        std::uint32_t hz[SysClkModule_EnumMax];
+        std::uint32_t sd1Uv;
+        double socMilli;
+        double powerAvgMw;
+        std::uint64_t idleTicks[HOCCLK_CPU_CORE_COUNT];
+
+        // Replay
+        bool replaying;
+        TickTraceRow trace;
+        std::uint32_t traceCpuLoad;
+        double deltaMw;
+        double deltaAvgMw;
+        double deltaSocMilli;
+    };
+
+    SimBoardState& State() {
+        static SimBoardState state;
+        return state;
+    }
+
+    // Linear V/f between the lowest and highest rate of each rail
+    std::uint32_t RailUv(SysClkModule module, std::uint32_t hz) {
+        std::uint32_t lo, hi, minUv, maxUv;
+        switch (module) {
+            case SysClkModule_CPU:
+                lo = 204000000; hi = 2397000000U; minUv = 620000; maxUv = 1120000;
+                break;
+            case SysClkModule_GPU:
+                lo = 76800000; hi = 1267200000; minUv = 610000; maxUv = 1050000;
+                break;
+            default:
+                return State().sd1Uv;
+        }
+        hz = std::clamp(hz, lo, hi);
+        return minUv + (std::uint64_t)(maxUv - minUv) * (hz - lo) / (hi - lo);
+    }
+
+    double BoardMw(const SimBoardState& s, const std::uint32_t* hz) {
+        double mw = s.model.baseMw;
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++) {
+            double v = RailUv((SysClkModule)module, hz[module]) / 1e6;
+            double activity = s.model.idleActivity + (1.0 - s.model.idleActivity) * s.model.load[module] / 1000.0;
+            mw += s.model.mwPerMHzV2[module] * (hz[module] / 1e6) * v * v * activity;
+        }
+        return mw;
+    }
+
+    double BoardMw(const SimBoardState& s) {
+        return BoardMw(s, s.hz);
+    }
+
+    bool Charging(const SimBoardModel& model) {
+        return model.profile != SysClkProfile_Handheld;
+    }
+
+    // What Board::ResetToStock* would set for the model's APM configuration
+    std::uint32_t StockHz(SysClkModule module, const SimBoardModel& model) {
+        const SysClkApmConfiguration* conf = sysclk_g_apm_configurations;
+        while (conf->id && conf->id != model.apmConfiguration)
+            conf++;
+        if (!conf->id) {
+            ERROR_THROW("Unknown apm configuration: %x", model.apmConfiguration);
+        }
+
+        switch (module) {
+            case SysClkModule_CPU:
+                return conf->cpu_hz;
+            case SysClkModule_GPU:
+                return conf->gpu_hz;
+            default:
+                return conf->mem_hz;
+        }
+    }
+
+    void ResetModule(SimBoardState& s, SysClkModule module) {
+        s.hz[module] = StockHz(module, s.model);
+        s.counters.resets[module]++;
+    }
+
+}
+
+SimBoardModel SimBoard::DefaultModel() {
+    SimBoardModel model = {};
+    model.socType = SysClkSocType_Mariko;
+    model.profile = SysClkProfile_Handheld;
+    model.operationMode = AppletOperationMode_Handheld;
+    model.chargerType = PsmChargerType_Unconnected;
+    model.apmConfiguration = 0x92220007;
+    model.applicationId = PROCESS_MANAGEMENT_QLAUNCH_TID;
+    model.deviceId = 0x5EED5EED5EED5EEDULL;
+    model.baseMw = 2000;
+    model.mwPerMHzV2[SysClkModule_CPU] = 1.6;
+    model.mwPerMHzV2[SysClkModule_GPU] = 3.6;
+    model.mwPerMHzV2[SysClkModule_MEM] = 0.5;
+    model.idleActivity = 0.3;
+    model.powerAvgTauMs = 5000;
+    model.batteryChargeMw = 7800;
+    model.batteryPcm = 100000;
+    model.chargeInfo = true;
+    model.ambientMilli = 25000;
+    model.socMilliPerMw = 6.0;
+    model.socTauMs = 20000;
+    model.emcCpuShare = 300;
+    return model;
+}
+
+void SimBoard::Reset(const SimBoardModel* model) {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+
+    s.model = *model;
+    s.counters = {};
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        s.hz[module] = StockHz((SysClkModule)module, *model);
+    s.sd1Uv = SIM_STOCK_SD1_UV;
+    s.socMilli = model->ambientMilli;
+    s.powerAvgMw = BoardMw(s);
+    std::fill(std::begin(s.idleTicks), std::end(s.idleTicks), 0);
+    s.replaying = false;
+    s.deltaMw = s.deltaAvgMw = s.deltaSocMilli = 0;
+}
+
+void SimBoard::SetModel(const SimBoardModel* model) {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    s.model = *model;
+}
+
+SimBoardModel SimBoard::GetModel() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.model;
+}
+
+SimBoardCounters SimBoard::GetCounters() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.counters;
+}
+
+void SimBoard::Advance(std::uint64_t ns) {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+
+    double ms = ns / 1e6;
+
+    if (s.replaying) {
+        // Only the difference to the recording, it has the rest
+        double delta = BoardMw(s) - BoardMw(s, s.trace.hz);
+        s.deltaMw = delta;
+        s.deltaAvgMw = delta + (s.deltaAvgMw - delta) * std::exp(-ms / std::max(1U, s.model.powerAvgTauMs));
+        double target = delta * s.model.socMilliPerMw;
+        s.deltaSocMilli = target + (s.deltaSocMilli - target) * std::exp(-ms / std::max(1U, s.model.socTauMs));
+        return;
+    }
+
+    double mw = BoardMw(s);
+
+    // Exact step response, stable whatever the step
+    double target = s.model.ambientMilli + mw * s.model.socMilliPerMw;
+    s.socMilli = target + (s.socMilli - target) * std::exp(-ms / std::max(1U, s.model.socTauMs));
+    s.powerAvgMw = mw + (s.powerAvgMw - mw) * std::exp(-ms / std::max(1U, s.model.powerAvgTauMs));
+
+    std::uint64_t ticks = armNsToTicks(ns);
+    for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++) {
+        // The last core belongs to the system, mostly idle
+        std::uint32_t busy = core < HOCCLK_CPU_CORE_COUNT - 1 ? s.model.load[SysClkModule_CPU] : 100;
+        s.idleTicks[core] += ticks * (1000 - std::min(busy, 1000U)) / 1000;
+    }
+}
+
+std::int32_t SimBoard::GetBoardMw() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return BoardMw(s);
+}
+
+void SimBoard::SetTraceInputs(const TickTraceRow* row) {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++) {
+        if (!s.replaying || row->hzIn[module] != s.trace.hz[module])
+            s.hz[module] = row->hzIn[module];
+    }
+
+    // Busy share of the application cores since the previous row
+    s.traceCpuLoad = 0;
+    if (s.replaying && row->ns > s.trace.ns) {
+        std::uint64_t ticks = armNsToTicks(row->ns - s.trace.ns);
+        std::uint64_t busy = 0;
+        for (unsigned int core = 0; core < CPU_SAMPLER_APPLICATION_CORES; core++) {
+            std::uint64_t idle = row->cpuIdleTicks[core] - s.trace.cpuIdleTicks[core];
+            busy += ticks - std::min(idle, ticks);
+        }
+        s.traceCpuLoad = busy * 1000 / (ticks * CPU_SAMPLER_APPLICATION_CORES);
+    }
+
+    s.model.profile = row->profile;
+    s.model.operationMode = row->operationMode;
+    s.model.chargerType = row->chargerType;
+    s.model.apmConfiguration = row->apmConfiguration;
+    s.model.chargerMw = row->contractMw;
+    s.model.batteryChargeMw = row->chargeMw;
+    s.model.batteryPcm = row->batteryPcm;
+    s.model.applicationId = row->applicationId;
+    s.model.load[SysClkModule_CPU] = s.traceCpuLoad;
+    s.model.load[SysClkModule_GPU] = row->gpuLoad;
+    s.model.load[SysClkModule_MEM] = row->emcLoad;
+
+    s.trace = *row;
+    s.replaying = true;
+}
+
+std::uint32_t SimBoard::GetStockHz(SysClkModule module) {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return StockHz(module, s.model);
+}
+
+const char* Board::GetModuleName(SysClkModule module, bool pretty) {
+    ASSERT_ENUM_VALID(SysClkModule, module);
+    return sysclkFormatModule(module, pretty);
+}
+
+const char* Board::GetProfileName(SysClkProfile profile, bool pretty) {
+    ASSERT_ENUM_VALID(SysClkProfile, profile);
+    return sysclkFormatProfile(profile, pretty);
+}
+
+const char* Board::GetThermalSensorName(SysClkThermalSensor sensor, bool pretty) {
+    ASSERT_ENUM_VALID(SysClkThermalSensor, sensor);
+    return sysclkFormatThermalSensor(sensor, pretty);
+}
+
+const char* Board::GetPowerSensorName(SysClkPowerSensor sensor, bool pretty) {
+    ASSERT_ENUM_VALID(SysClkPowerSensor, sensor);
+    return sysclkFormatPowerSensor(sensor, pretty);
+}
+
+void Board::Initialize() {
+    SimBoardModel model = SimBoard::DefaultModel();
+    SimBoard::Reset(&model);
+}
+
+void Board::Exit() {
+}
+
+void Board::ResetToStock() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        ResetModule(s, (SysClkModule)module);
+}
+
+void Board::ResetToStockCpu() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    ResetModule(s, SysClkModule_CPU);
+}
+
+void Board::ResetToStockMem() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    ResetModule(s, SysClkModule_MEM);
+}
+
+void Board::ResetToStockGpu() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    ResetModule(s, SysClkModule_GPU);
+}
+
+SysClkProfile Board::GetProfile() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.model.profile;
+}
+
+void Board::SetHz(SysClkModule module, std::uint32_t hz) {
+    ASSERT_ENUM_VALID(SysClkModule, module);
+
+    std::uint32_t list[SYSCLK_FREQ_LIST_MAX];
+    std::uint32_t count = 0;
+    Board::GetFreqList(module, list, SYSCLK_FREQ_LIST_MAX, &count);
+    if (std::find(list, list + count, hz) == list + count) {
+        ERROR_THROW("Not a %s rate: %u", Board::GetModuleName(module, false), hz);
+    }
+
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    s.hz[module] = hz;
+    s.counters.setHz[module]++;
+}
+
+std::uint32_t Board::GetHz(SysClkModule module) {
+    ASSERT_ENUM_VALID(SysClkModule, module);
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.hz[module];
+}
+
+std::uint32_t Board::GetRealHz(SysClkModule module) {
+    return Board::GetHz(module);
+}
+
+void Board::GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount) {
+    ASSERT_ENUM_VALID(SysClkModule, module);
+
+    std::uint32_t count = 0;
+    switch (module) {
+        case SysClkModule_CPU:
+            for (std::uint32_t mhz : g_cpuMHz)
+                if (count < maxCount)
+                    outList[count++] = mhz * 1000000;
+            break;
+        case SysClkModule_GPU:
+            for (std::uint32_t khz : g_gpuKHz)
+                if (count < maxCount)
+                    outList[count++] = khz * 1000;
+            break;
+        default:
+            for (std::uint32_t khz : g_memKHz)
+                if (count < maxCount)
+                    outList[count++] = khz * 1000;
+            break;
+    }
+    *outCount = count;
+}
+
+std::uint32_t Board::GetTemperatureMilli(SysClkThermalSensor sensor) {
+    ASSERT_ENUM_VALID(SysClkThermalSensor, sensor);
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+
+    // PCB and skin follow the SoC at a fraction of its rise
+    if (s.replaying) {
+        double scale = sensor == SysClkThermalSensor_SOC ? 1.0 : sensor == SysClkThermalSensor_PCB ? 0.6 : 0.4;
+        return std::max(0.0, s.trace.temps[sensor] + s.deltaSocMilli * scale);
+    }
+
+    double rise = s.socMilli - s.model.ambientMilli;
+    switch (sensor) {
+        case SysClkThermalSensor_SOC:
+            return std::max(0.0, s.socMilli);
+        case SysClkThermalSensor_PCB:
+            return std::max(0.0, s.model.ambientMilli + rise * 0.6);
+        default:
+            return std::max(0.0, s.model.ambientMilli + rise * 0.4);
+    }
+}
+
+std::int32_t Board::GetPowerMw(SysClkPowerSensor sensor) {
+    ASSERT_ENUM_VALID(SysClkPowerSensor, sensor);
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+
+    if (s.replaying) {
+        double delta = sensor == SysClkPowerSensor_Now ? s.deltaMw : s.deltaAvgMw;
+        return s.trace.power[sensor] - (std::int32_t)delta;
+    }
+
+    // Battery side: negative while discharging
+    double mw = sensor == SysClkPowerSensor_Now ? BoardMw(s) : s.powerAvgMw;
+    return Charging(s.model) ? s.model.chargerMw - (std::int32_t)mw : -(std::int32_t)mw;
+}
+
+std::uint32_t Board::GetPartLoad(SysClkPartLoad load) {
+    ASSERT_ENUM_VALID(SysClkPartLoad, load);
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+
+    if (s.replaying) {
+        switch (load) {
+            case SysClkPartLoad_EMC:
+                return s.trace.emcLoad;
+            case SysClkPartLoad_EMCCpu:
+                return s.trace.emcCpuLoad;
+            case HocClkPartLoad_GPU:
+                return s.trace.gpuLoad;
+            default:
+                return s.traceCpuLoad;
+        }
+    }
+
+    switch (load) {
+        case SysClkPartLoad_EMC:
+            return s.model.load[SysClkModule_MEM];
+        case SysClkPartLoad_EMCCpu:
+            return s.model.load[SysClkModule_MEM] * s.model.emcCpuShare / 1000;
+        case HocClkPartLoad_GPU:
+            return s.model.load[SysClkModule_GPU];
+        default:
+            return s.model.load[SysClkModule_CPU];
+    }
+}
+
+bool Board::GetGpuLoad(std::uint32_t* outLoad) {
+    *outLoad = Board::GetPartLoad(HocClkPartLoad_GPU);
+    return true;
+}
+
+bool Board::GetCpuIdleTicks(std::uint64_t* outTicks) {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    const std::uint64_t* idleTicks = s.replaying ? s.trace.cpuIdleTicks : s.idleTicks;
+    std::copy(idleTicks, idleTicks + HOCCLK_CPU_CORE_COUNT, outTicks);
+    return true;
+}
+
+std::uint32_t Board::GetVoltage(HocClkVoltage voltage) {
+    ASSERT_ENUM_VALID(HocClkVoltage, voltage);
+
+    switch (voltage) {
+        case HocClkVoltage_CPU:
+            return RailUv(SysClkModule_CPU, Board::GetHz(SysClkModule_CPU));
+        case HocClkVoltage_GPU:
+            return RailUv(SysClkModule_GPU, Board::GetHz(SysClkModule_GPU));
+        case HocClkVoltage_EMCVDD2: {
+            SimBoardState& s = State();
+            std::scoped_lock lock{s.lock};
+            return s.sd1Uv;
+        }
+        case HocClkVoltage_EMCVDDQ_MarikoOnly:
+            return Board::GetSocType() == SysClkSocType_Erista ? 0 : 600000;
+        case HocClkVoltage_SOC:
+            return 800000;
+        default:
+            return 0;
+    }
+}
+
+void Board::SetVoltage(HocClkVoltage voltage, std::uint32_t uv) {
+    if (voltage != HocClkVoltage_EMCVDD2) {
+        ASSERT_ENUM_VALID(HocClkVoltage, voltage);
+        return;
+    }
+
+    // Same range and rounding as the SD1 register
+    if (uv < 600000 || uv > 1237500)
+        return;
+
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    s.sd1Uv = 600000 + (uv - 600000 + 12499) / 12500 * 12500;
+    s.counters.sd1Writes++;
+}
+
+std::uint32_t Board::GetPerformanceConfiguration() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.model.apmConfiguration;
+}
+
+bool Board::IsBoostMode() {
+    return apmExtIsBoostMode(Board::GetPerformanceConfiguration());
+}
+
+PsmChargerType Board::GetChargerType() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.model.chargerType;
+}
+
+bool Board::GetChargeStatus(std::int32_t* outContractMw, std::int32_t* outChargeMw, std::uint32_t* outBatteryPcm) {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    if (!s.model.chargeInfo)
+        return false;
+    *outContractMw = Charging(s.model) ? s.model.chargerMw : 0;
+    *outChargeMw = s.model.batteryChargeMw;
+    *outBatteryPcm = s.model.batteryPcm;
+    return true;
+}
+
+AppletOperationMode Board::GetOperationMode() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.model.operationMode;
+}
+
+bool Board::GetEmcLoadRaw(std::uint32_t* outAll, std::uint32_t* outCpu, std::uint32_t* outMemHz) {
+    *outAll = Board::GetPartLoad(SysClkPartLoad_EMC);
+    *outCpu = Board::GetPartLoad(SysClkPartLoad_EMCCpu);
+    *outMemHz = Board::GetHz(SysClkModule_MEM);
+    return true;
+}
+
+std::uint32_t Board::GetActmonPeriodMs() {
+    return SIM_ACTMON_PERIOD_MS;
+}
+
+SysClkSocType Board::GetSocType() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.model.socType;
+}
+
+std::uint64_t Board::GetDeviceId() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.model.deviceId;
+}
+
+void Board::FetchHardwareInfos() {
+}
+
+PcvModule Board::GetPcvModule(SysClkModule sysclkModule) {
+    return sysclkModule;
+}
+
+PcvModuleId Board::GetPcvModuleId(SysClkModule sysclkModule) {
+    return sysclkModule;
+}
+
+void ProcessManagement::Initialize() {
+}
+
+void ProcessManagement::WaitForQLaunch() {
+}
+
+std::uint64_t ProcessManagement::GetCurrentApplicationId() {
+    SimBoardState& s = State();
+    std::scoped_lock lock{s.lock};
+    return s.model.applicationId;
+}
+
+void ProcessManagement::Exit() {
+}
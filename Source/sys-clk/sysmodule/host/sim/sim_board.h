@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Simulated console behind the Board and ProcessManagement interfaces.
+// Clocks land where they are set; power, temperatures, loads and idle ticks
+// come from the models below and move with SimBoard::Advance, or from a
+// recorded tick trace while one is replayed.
+
+#pragma once
+
+#include <cstdint>
+#include <sysclk.h>
+#include "board.h"
+#include "tick_trace.h"
+
+typedef struct
+{
+    SysClkSocType socType;
+    SysClkProfile profile;
+    AppletOperationMode operationMode;
+    PsmChargerType chargerType;
+    std::uint32_t apmConfiguration;     // stock clocks and boost mode, see apm_profile_table.c
+    std::uint64_t applicationId;
+    std::uint64_t deviceId;
+
+    // Power: baseMw + sum of mwPerMHzV2 * MHz * V^2 * (idle + (1 - idle) * load)
+    std::int32_t baseMw;
+    double mwPerMHzV2[SysClkModule_EnumMax];
+    double idleActivity;
+    std::int32_t chargerMw;             // input when charging, the battery gets the rest
+    std::int32_t batteryChargeMw;       // charging at the battery's current limit
+    std::uint32_t batteryPcm;
+    bool chargeInfo;                    // psm answers the charge info, 10.0.0+
+    std::uint32_t powerAvgTauMs;        // fuel gauge averaging
+
+    // Thermal: SoC settles at ambient + power * resistance, first order
+    std::int32_t ambientMilli;
+    double socMilliPerMw;
+    std::uint32_t socTauMs;
+
+    // Load in permille, GPU and EMC as their counters read, CPU as the application cores' busy time
+    std::uint32_t load[SysClkModule_EnumMax];
+    std::uint32_t emcCpuShare;          // permille of the EMC load from the CPU
+} SimBoardModel;
+
+typedef struct
+{
+    std::uint32_t setHz[SysClkModule_EnumMax];
+    std::uint32_t resets[SysClkModule_EnumMax];
+    std::uint32_t sd1Writes;
+} SimBoardCounters;
+
+class SimBoard
+{
+  public:
+    // Handheld Mariko at stock, idle, at ambient temperature
+    static SimBoardModel DefaultModel();
+
+    // Back to stock clocks and ambient temperature
+    static void Reset(const SimBoardModel* model);
+    // Swaps the model, state carries on (docking, a new title, a load change)
+    static void SetModel(const SimBoardModel* model);
+    static SimBoardModel GetModel();
+    static SimBoardCounters GetCounters();
+
+    // Integrates the models over ns of simulated time
+    static void Advance(std::uint64_t ns);
+
+    // Replay: the title, modes, loads and sensors come from row until the
+    // next call. Temperatures and power are the recorded ones plus what the
+    // model says the current clocks draw over the recorded ones, filtered
+    // like the fuel gauge and the SoC. Clocks the recording shows changing
+    // between ticks are changed here too. Ends with Reset.
+    static void SetTraceInputs(const TickTraceRow* row);
+
+    static std::int32_t GetBoardMw();
+    // For the current model's APM configuration
+    static std::uint32_t GetStockHz(SysClkModule module);
+};
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// nxExt's IPC server over an in-process queue: simIpcDispatch hands the
+// request to whichever thread sits in ipcServerProcess for that service, like
+// a client session would, so handlers run on IpcService's own thread.
+
+#include "sim.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+
+namespace {
+
+    struct SimIpcCall {
+        IpcServer* server;
+        SimIpcRequest* req;
+        Result rc;
+        bool done;
+    };
+
+    struct SimIpcQueue {
+        std::mutex lock;
+        std::condition_variable cond;
+        std::deque<SimIpcCall*> calls;
+        IpcServer* servers[8] = {};
+    };
+
+    SimIpcQueue& Queue() {
+        static SimIpcQueue queue;
+        return queue;
+    }
+
+    void HandleCall(SimIpcCall* call, IpcServerRequestHandler handler, void* userdata) {
+        SimIpcRequest* req = call->req;
+        HipcBufferDescriptor send = { (void*)req->send, req->sendSize };
+        HipcBufferDescriptor recv = { req->recv, req->recvSize };
+
+        IpcServerRequest r = {};
+        r.hipc.meta.num_send_buffers = req->send ? 1 : 0;
+        r.hipc.meta.num_recv_buffers = req->recv ? 1 : 0;
+        r.hipc.data.send_buffers = &send;
+        r.hipc.data.recv_buffers = &recv;
+        r.data.cmdId = req->cmdId;
+        r.data.ptr = (void*)req->in;
+        r.data.size = req->inSize;
+
+        // Room for handlers that overrun the response, so they fail here rather than corrupt the stack
+        u8 out[IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE * 4] = {};
+        size_t outSize = 0;
+        req->handle = INVALID_HANDLE;
+        call->rc = handler(userdata, &r, out, &outSize, &req->handle);
+
+        if (outSize > IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE) {
+            call->rc = KERNELRESULT(OutOfRange);
+            outSize = 0;
+        }
+        if (R_SUCCEEDED(call->rc)) {
+            outSize = std::min(outSize, req->outSize);
+            if (outSize)
+                memcpy(req->out, out, outSize);
+            req->outSize = outSize;
+        }
+    }
+
+}
+
+extern "C" {
+
+Result ipcServerInit(IpcServer* server, const char* name, u32 max_sessions) {
+    memset(server, 0, sizeof(*server));
+    // Names longer than the 8 bytes of an sm name are cut, like smEncodeName does
+    memcpy(server->srvName.name, name, strnlen(name, sizeof(server->srvName.name)));
+    server->max = max_sessions;
+
+    SimIpcQueue& queue = Queue();
+    std::scoped_lock lock{queue.lock};
+    for (auto& slot : queue.servers) {
+        if (!slot) {
+            slot = server;
+            return 0;
+        }
+    }
+    return MAKERESULT(21, 2);
+}
+
+Result ipcServerExit(IpcServer* server) {
+    SimIpcQueue& queue = Queue();
+    std::scoped_lock lock{queue.lock};
+    for (auto& slot : queue.servers) {
+        if (slot == server)
+            slot = nullptr;
+    }
+    return 0;
+}
+
+Result ipcServerProcess(IpcServer* server, IpcServerRequestHandler handler, void* userdata) {
+    SimIpcQueue& queue = Queue();
+    std::unique_lock<std::mutex> lock{queue.lock};
+
+    while (true) {
+        if (simThreadTakeCancel())
+            return KERNELRESULT(Cancelled);
+
+        for (auto it = queue.calls.begin(); it != queue.calls.end(); it++) {
+            SimIpcCall* call = *it;
+            if (call->server != server)
+                continue;
+
+            queue.calls.erase(it);
+            lock.unlock();
+            HandleCall(call, handler, userdata);
+            lock.lock();
+            call->done = true;
+            queue.cond.notify_all();
+            return 0;
+        }
+
+        // Cancellation has no way to notify this queue, look again shortly
+        queue.cond.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+}
+
+Result simIpcDispatch(const char* name, SimIpcRequest* req) {
+    SimIpcQueue& queue = Queue();
+    std::unique_lock<std::mutex> lock{queue.lock};
+
+    SimIpcCall call = { nullptr, req, 0, false };
+    for (auto server : queue.servers) {
+        if (server && !strncmp(server->srvName.name, name, sizeof(server->srvName.name)))
+            call.server = server;
+    }
+    if (!call.server)
+        return KERNELRESULT(ConnectionClosed);
+
+    queue.calls.push_back(&call);
+    queue.cond.notify_all();
+    queue.cond.wait(lock, [&call] { return call.done; });
+    return call.rc;
+}
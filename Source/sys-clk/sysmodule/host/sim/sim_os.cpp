@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sim.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+    struct SimSync {
+        std::mutex lock;
+        std::condition_variable cond;
+        bool signaled = false;
+        bool autoclear = false;
+    };
+
+    struct SimThread {
+        Handle handle;
+        ThreadFunc entry;
+        void* arg;
+        std::thread thread;
+        std::atomic_bool cancelled{false};
+    };
+
+    // Function statics, the sysmodule's own globals lock mutexes during static init
+    struct SimHandles {
+        std::mutex lock;
+        Handle next = 0x100;
+        std::map<Handle, SimSync*> events;
+        std::map<Handle, SimThread*> threads;
+    };
+
+    SimHandles& Handles() {
+        static SimHandles handles;
+        return handles;
+    }
+
+    std::atomic_bool g_manualClock{false};
+    std::atomic<std::uint64_t> g_manualNs{0};
+    thread_local SimThread* t_self = nullptr;
+
+    std::uint64_t HostNs() {
+        static const auto start = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Manual clock waits are bounded in real time, unbounded ones stay unbounded
+    std::uint64_t RealWaitNs(std::uint64_t ns) {
+        if (g_manualClock && ns != UINT64_MAX)
+            return std::min<std::uint64_t>(ns, SIM_MANUAL_WAIT_NS);
+        return ns;
+    }
+
+    Result WaitSync(SimSync* sync, std::uint64_t timeout) {
+        std::unique_lock<std::mutex> lock{sync->lock};
+        auto ready = [sync] { return sync->signaled || (t_self && t_self->cancelled); };
+
+        std::uint64_t ns = RealWaitNs(timeout);
+        if (ns == UINT64_MAX) {
+            sync->cond.wait(lock, ready);
+        } else if (!sync->cond.wait_for(lock, std::chrono::nanoseconds(ns), ready)) {
+            return KERNELRESULT(TimedOut);
+        }
+
+        if (t_self && t_self->cancelled.exchange(false))
+            return KERNELRESULT(Cancelled);
+
+        if (sync->autoclear)
+            sync->signaled = false;
+        return 0;
+    }
+
+    void Signal(SimSync* sync) {
+        std::scoped_lock lock{sync->lock};
+        sync->signaled = true;
+        sync->cond.notify_all();
+    }
+
+}
+
+void simClockSetManual(bool manual) {
+    if (manual && !g_manualClock)
+        g_manualNs = HostNs();
+    g_manualClock = manual;
+}
+
+bool simClockIsManual() {
+    return g_manualClock;
+}
+
+void simClockAdvanceNs(std::uint64_t ns) {
+    g_manualNs += ns;
+}
+
+std::uint64_t simClockNowNs() {
+    return g_manualClock ? g_manualNs.load() : HostNs();
+}
+
+bool simThreadTakeCancel() {
+    return t_self && t_self->cancelled.exchange(false);
+}
+
+extern "C" {
+
+// FileUtils sets the clock from the time service, the host's is right already
+void __libnx_init_time(void) {
+}
+
+u64 armGetSystemTickFreq(void) {
+    return 19200000ULL;
+}
+
+u64 armNsToTicks(u64 ns) {
+    return (ns * 12) / 625;
+}
+
+u64 armTicksToNs(u64 tick) {
+    return (tick * 625) / 12;
+}
+
+u64 armGetSystemTick(void) {
+    return armNsToTicks(simClockNowNs());
+}
+
+void mutexInit(Mutex* m) {
+    m->impl = new std::mutex;
+}
+
+void mutexLock(Mutex* m) {
+    static_cast<std::mutex*>(m->impl)->lock();
+}
+
+bool mutexTryLock(Mutex* m) {
+    return static_cast<std::mutex*>(m->impl)->try_lock();
+}
+
+void mutexUnlock(Mutex* m) {
+    static_cast<std::mutex*>(m->impl)->unlock();
+}
+
+void ueventCreate(UEvent* e, bool autoclear) {
+    SimSync* sync = new SimSync;
+    sync->autoclear = autoclear;
+    e->impl = sync;
+}
+
+void ueventClear(UEvent* e) {
+    SimSync* sync = static_cast<SimSync*>(e->impl);
+    std::scoped_lock lock{sync->lock};
+    sync->signaled = false;
+}
+
+void ueventSignal(UEvent* e) {
+    Signal(static_cast<SimSync*>(e->impl));
+}
+
+Result eventCreate(Event* e, bool autoclear) {
+    SimSync* sync = new SimSync;
+    sync->autoclear = autoclear;
+
+    SimHandles& handles = Handles();
+    std::scoped_lock lock{handles.lock};
+    e->revent = handles.next++;
+    e->wevent = e->revent;
+    e->autoclear = autoclear;
+    handles.events[e->revent] = sync;
+    return 0;
+}
+
+void eventClose(Event* e) {
+    SimHandles& handles = Handles();
+    std::scoped_lock lock{handles.lock};
+    auto it = handles.events.find(e->revent);
+    if (it != handles.events.end()) {
+        delete it->second;
+        handles.events.erase(it);
+    }
+    e->revent = INVALID_HANDLE;
+    e->wevent = INVALID_HANDLE;
+}
+
+static SimSync* FindEvent(Handle handle) {
+    SimHandles& handles = Handles();
+    std::scoped_lock lock{handles.lock};
+    auto it = handles.events.find(handle);
+    return it == handles.events.end() ? nullptr : it->second;
+}
+
+Result eventFire(Event* e) {
+    SimSync* sync = FindEvent(e->wevent);
+    if (!sync)
+        return KERNELRESULT(ConnectionClosed);
+    Signal(sync);
+    return 0;
+}
+
+Result eventClear(Event* e) {
+    SimSync* sync = FindEvent(e->revent);
+    if (!sync)
+        return KERNELRESULT(ConnectionClosed);
+    std::scoped_lock lock{sync->lock};
+    sync->signaled = false;
+    return 0;
+}
+
+Result waitSingle(Waiter w, u64 timeout) {
+    SimSync* sync = w.uevent ? static_cast<SimSync*>(w.uevent->impl) : FindEvent(w.handle);
+    if (!sync)
+        return KERNELRESULT(ConnectionClosed);
+    return WaitSync(sync, timeout);
+}
+
+Result threadCreate(Thread* t, ThreadFunc entry, void* arg, void* stack_mem, size_t stack_sz, int prio, int cpuid) {
+    SimThread* thread = new SimThread;
+    thread->entry = entry;
+    thread->arg = arg;
+
+    SimHandles& handles = Handles();
+    std::scoped_lock lock{handles.lock};
+    thread->handle = handles.next++;
+    handles.threads[thread->handle] = thread;
+    t->handle = thread->handle;
+    t->impl = thread;
+    return 0;
+}
+
+Result threadStart(Thread* t) {
+    SimThread* thread = static_cast<SimThread*>(t->impl);
+    thread->thread = std::thread([thread] {
+        t_self = thread;
+        thread->entry(thread->arg);
+    });
+    return 0;
+}
+
+Result threadWaitForExit(Thread* t) {
+    SimThread* thread = static_cast<SimThread*>(t->impl);
+    if (thread && thread->thread.joinable())
+        thread->thread.join();
+    return 0;
+}
+
+Result threadClose(Thread* t) {
+    threadWaitForExit(t);
+
+    SimHandles& handles = Handles();
+    std::scoped_lock lock{handles.lock};
+    handles.threads.erase(t->handle);
+    delete static_cast<SimThread*>(t->impl);
+    t->impl = nullptr;
+    t->handle = INVALID_HANDLE;
+    return 0;
+}
+
+Result svcCancelSynchronization(Handle handle) {
+    SimHandles& handles = Handles();
+    std::scoped_lock lock{handles.lock};
+    auto it = handles.threads.find(handle);
+    if (it == handles.threads.end())
+        return KERNELRESULT(ConnectionClosed);
+    it->second->cancelled = true;
+
+    // Whatever it waits on, wake it up to see the flag
+    for (auto& event : handles.events) {
+        std::scoped_lock syncLock{event.second->lock};
+        event.second->cond.notify_all();
+    }
+    return 0;
+}
+
+void svcSleepThread(s64 nano) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(RealWaitNs(nano)));
+}
+
+Result svcGetThreadPriority(s32* priority, Handle handle) {
+    *priority = 0x2C;
+    return 0;
+}
+
+Result svcReadWriteRegister(u32* out, u64 address, u32 mask, u32 value) {
+    if (out)
+        *out = 0;
+    return 0;
+}
+
+}
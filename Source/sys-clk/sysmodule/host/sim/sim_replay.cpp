@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sim_replay.h"
+#include "sim_sysmodule.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+    std::vector<std::string> Split(const std::string& line) {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ','))
+            fields.push_back(field);
+        return fields;
+    }
+
+    int Find(const std::vector<std::string>& header, const std::string& name) {
+        for (size_t i = 0; i < header.size(); i++) {
+            if (header[i] == name)
+                return i;
+        }
+        return -1;
+    }
+
+    template <typename T>
+    void Read(const std::vector<std::string>& fields, int column, T* out, int base = 10) {
+        if (column >= 0 && column < (int)fields.size())
+            *out = (T)strtoull(fields[column].c_str(), nullptr, base);
+    }
+
+    void ReadProfile(const std::vector<std::string>& fields, int column, SysClkProfile* out) {
+        if (column < 0 || column >= (int)fields.size())
+            return;
+        for (int p = 0; p < SysClkProfile_EnumMax; p++) {
+            if (fields[column] == sysclkFormatProfile((SysClkProfile)p, false))
+                *out = (SysClkProfile)p;
+        }
+    }
+
+    std::string Column(const char* name, const char* suffix) {
+        return std::string(name) + suffix;
+    }
+
+}
+
+bool TickTraceParse(const std::string& text, std::vector<TickTraceRow>* rows) {
+    std::stringstream stream(text);
+    std::string line;
+
+    if (!std::getline(stream, line))
+        return false;
+
+    std::vector<std::string> header = Split(line);
+    int ns = Find(header, "tick_ns");
+    if (ns < 0)
+        return false;
+
+    int tid = Find(header, "app_tid");
+    int socType = Find(header, "soc_type");
+    int profile = Find(header, "profile");
+    int opMode = Find(header, "operation_mode");
+    int chargerType = Find(header, "charger_type");
+    int apmConfiguration = Find(header, "apm_configuration");
+    int contractMw = Find(header, "contract_mw");
+    int chargeMw = Find(header, "charge_mw");
+    int batteryPcm = Find(header, "battery_pcm");
+    int hzIn[SysClkModule_EnumMax], hz[SysClkModule_EnumMax];
+    for (int m = 0; m < SysClkModule_EnumMax; m++) {
+        hzIn[m] = Find(header, Column(sysclkFormatModule((SysClkModule)m, false), "_hz_in"));
+        hz[m] = Find(header, Column(sysclkFormatModule((SysClkModule)m, false), "_hz"));
+    }
+    int temps[SysClkThermalSensor_EnumMax];
+    for (int s = 0; s < SysClkThermalSensor_EnumMax; s++)
+        temps[s] = Find(header, Column(sysclkFormatThermalSensor((SysClkThermalSensor)s, false), "_milliC"));
+    int power[SysClkPowerSensor_EnumMax];
+    for (int s = 0; s < SysClkPowerSensor_EnumMax; s++)
+        power[s] = Find(header, Column(sysclkFormatPowerSensor((SysClkPowerSensor)s, false), "_mw"));
+    int emcLoad = Find(header, "emc_load");
+    int emcCpuLoad = Find(header, "emc_cpu_load");
+    int gpuLoad = Find(header, "gpu_load");
+    int idleTicks[HOCCLK_CPU_CORE_COUNT];
+    for (int c = 0; c < HOCCLK_CPU_CORE_COUNT; c++)
+        idleTicks[c] = Find(header, "cpu" + std::to_string(c) + "_idle_ticks");
+
+    while (std::getline(stream, line)) {
+        if (line.empty())
+            continue;
+
+        std::vector<std::string> fields = Split(line);
+        TickTraceRow row = {};
+        row.socType = SysClkSocType_Mariko;
+        row.profile = SysClkProfile_Handheld;
+        row.batteryPcm = 100000;
+        Read(fields, ns, &row.ns);
+        Read(fields, tid, &row.applicationId, 16);
+        Read(fields, socType, &row.socType);
+        ReadProfile(fields, profile, &row.profile);
+        Read(fields, opMode, &row.operationMode);
+        Read(fields, chargerType, &row.chargerType);
+        Read(fields, apmConfiguration, &row.apmConfiguration, 16);
+        Read(fields, contractMw, &row.contractMw);
+        Read(fields, chargeMw, &row.chargeMw);
+        Read(fields, batteryPcm, &row.batteryPcm);
+        for (int m = 0; m < SysClkModule_EnumMax; m++) {
+            Read(fields, hzIn[m], &row.hzIn[m]);
+            Read(fields, hz[m], &row.hz[m]);
+        }
+        for (int s = 0; s < SysClkThermalSensor_EnumMax; s++)
+            Read(fields, temps[s], &row.temps[s]);
+        for (int s = 0; s < SysClkPowerSensor_EnumMax; s++)
+            Read(fields, power[s], &row.power[s]);
+        Read(fields, emcLoad, &row.emcLoad);
+        Read(fields, emcCpuLoad, &row.emcCpuLoad);
+        Read(fields, gpuLoad, &row.gpuLoad);
+        for (int c = 0; c < HOCCLK_CPU_CORE_COUNT; c++)
+            Read(fields, idleTicks[c], &row.cpuIdleTicks[c]);
+
+        rows->push_back(row);
+    }
+
+    return true;
+}
+
+bool TickTraceLoad(const char* path, std::vector<TickTraceRow>* rows) {
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::stringstream text;
+    text << file.rdbuf();
+    return TickTraceParse(text.str(), rows);
+}
+
+SimReplayLimits SimReplayDefaultLimits() {
+    SimReplayLimits limits;
+    limits.thermalMilli = sysclkDefaultConfigValue(HocClkConfigValue_ThermalThrottleThreshold) * 1000;
+    limits.powerMw = sysclkDefaultConfigValue(HocClkConfigValue_HandheldTDPLimit);
+    return limits;
+}
+
+bool SimReplay(const std::vector<TickTraceRow>& rows, const std::string& policyIni, const SimReplayLimits* limits,
+               SimReplayResult* result, FILE* decisions) {
+    memset(result, 0, sizeof(*result));
+    if (rows.empty())
+        return false;
+
+    // What the console was doing when the recording started
+    const TickTraceRow& first = rows.front();
+    SimBoardModel model = SimBoard::DefaultModel();
+    model.socType = first.socType;
+    model.profile = first.profile;
+    model.operationMode = first.operationMode;
+    model.chargerType = first.chargerType;
+    model.apmConfiguration = first.apmConfiguration;
+    model.applicationId = first.applicationId;
+
+    simClockSetManual(true);
+    SimSysmodule sys(&model, false, policyIni.c_str());
+
+    std::uint8_t enabled = 1;
+    Result rc = sys.Call(SysClkIpcCmd_SetEnabled, &enabled, sizeof(enabled), nullptr, 0);
+    if (R_FAILED(rc))
+        return false;
+
+    if (decisions) {
+        fprintf(decisions, "tick_ns");
+        for (int m = 0; m < SysClkModule_EnumMax; m++)
+            fprintf(decisions, ",%s_hz,%s_recorded_hz", sysclkFormatModule((SysClkModule)m, false), sysclkFormatModule((SysClkModule)m, false));
+        fprintf(decisions, ",soc_milliC,avg_mw,board_mw\n");
+    }
+
+    double hzNs[SysClkModule_EnumMax] = {};
+    std::uint32_t lastHz[SysClkModule_EnumMax] = {};
+    for (size_t i = 0; i < rows.size(); i++) {
+        const TickTraceRow& row = rows[i];
+
+        // Until this row, at the clocks the previous tick left
+        std::uint64_t ns = i ? row.ns - rows[i - 1].ns : 0;
+        if (ns) {
+            result->energyMj += SimBoard::GetBoardMw() * (ns / 1e9);
+            for (int m = 0; m < SysClkModule_EnumMax; m++)
+                hzNs[m] += (double)Board::GetHz((SysClkModule)m) * ns;
+
+            simClockAdvanceNs(ns);
+            SimBoard::Advance(ns);
+        }
+
+        SimBoard::SetTraceInputs(&row);
+        sys.clockMgr->Tick();
+
+        bool diverged = false;
+        for (int m = 0; m < SysClkModule_EnumMax; m++) {
+            std::uint32_t hz = Board::GetHz((SysClkModule)m);
+            if (i && hz != lastHz[m])
+                result->clockChanges[m]++;
+            diverged |= hz != row.hz[m];
+            lastHz[m] = hz;
+        }
+        if (diverged)
+            result->divergedTicks++;
+
+        std::uint32_t socMilli = Board::GetTemperatureMilli(SysClkThermalSensor_SOC);
+        std::int32_t avgMw = Board::GetPowerMw(SysClkPowerSensor_Avg);
+        result->maxSocMilli = std::max(result->maxSocMilli, socMilli);
+        if (socMilli > limits->thermalMilli)
+            result->overThermalNs += ns;
+        if (-avgMw > (std::int32_t)limits->powerMw)
+            result->overPowerNs += ns;
+
+        if (decisions) {
+            fprintf(decisions, "%lu", row.ns);
+            for (int m = 0; m < SysClkModule_EnumMax; m++)
+                fprintf(decisions, ",%u,%u", lastHz[m], row.hz[m]);
+            fprintf(decisions, ",%u,%d,%d\n", socMilli, avgMw, SimBoard::GetBoardMw());
+        }
+
+        result->ticks++;
+        result->ns += ns;
+    }
+
+    for (int m = 0; m < SysClkModule_EnumMax; m++)
+        result->meanMhz[m] = result->ns ? hzNs[m] / result->ns / 1e6 : lastHz[m] / 1000000;
+
+    return true;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Replays tick_trace.csv recordings (see src/tick_trace.h) through
+// ClockManager on the simulated board, to compare clock policies on the
+// same play session.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "tick_trace.h"
+
+// Columns are matched by header name, unknown ones are skipped
+bool TickTraceParse(const std::string& text, std::vector<TickTraceRow>* rows);
+bool TickTraceLoad(const char* path, std::vector<TickTraceRow>* rows);
+
+// Fixed for both sides of a comparison, whatever the policies enforce
+typedef struct SimReplayLimits {
+    std::uint32_t thermalMilli;     // SoC
+    std::uint32_t powerMw;          // fuel gauge average, drawn from the battery
+} SimReplayLimits;
+
+// Config defaults: thermal throttle threshold and handheld TDP limit
+SimReplayLimits SimReplayDefaultLimits();
+
+typedef struct SimReplayResult {
+    std::uint32_t ticks;
+    std::uint64_t ns;
+    double energyMj;                // board model, compare rather than read as absolute
+    std::uint32_t meanMhz[SysClkModule_EnumMax];
+    std::uint32_t clockChanges[SysClkModule_EnumMax];
+    std::uint32_t divergedTicks;    // ticks leaving other clocks than the recording
+    std::uint64_t overThermalNs;
+    std::uint64_t overPowerNs;
+    std::uint32_t maxSocMilli;
+} SimReplayResult;
+
+// Runs rows through a freshly started, enabled sysmodule with policyIni as
+// its config.ini. decisions, if set, gets a CSV line per tick.
+bool SimReplay(const std::vector<TickTraceRow>& rows, const std::string& policyIni, const SimReplayLimits* limits,
+               SimReplayResult* result, FILE* decisions);
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sim_sysmodule.h"
+#include "file_utils.h"
+#include "emc_patcher.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+
+static void MakeConfigDir() {
+    std::string path = FILE_CONFIG_DIR;
+    for (std::size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1)) {
+        mkdir(path.substr(0, pos).c_str(), 0755);
+        if (pos == std::string::npos)
+            break;
+    }
+}
+
+SimSysmodule::SimSysmodule(const SimBoardModel* model, bool keepConfig, const char* configIni) {
+    MakeConfigDir();
+    if (!keepConfig) {
+        remove(FILE_CONFIG_DIR "/config.ini");
+        remove(FILE_POWER_MODEL_PATH);
+        remove(FILE_LEARNED_PROFILES_PATH);
+    }
+
+    if (configIni) {
+        FILE* file = fopen(FILE_CONFIG_DIR "/config.ini", "w");
+        if (!file) {
+            ERROR_THROW("Cannot write " FILE_CONFIG_DIR "/config.ini");
+        }
+        fputs(configIni, file);
+        fclose(file);
+    }
+
+    // log.flag in the config directory turns the log on, as on the SD card
+    FileUtils::Initialize();
+    SimBoard::Reset(model);
+
+    this->clockMgr = new ClockManager();
+    this->ipcSrv = new IpcService(this->clockMgr);
+    EMCpatcher::Initialize(this->clockMgr->GetConfig());
+    this->clockMgr->SetRunning(true);
+    this->ipcSrv->SetRunning(true);
+}
+
+SimSysmodule::~SimSysmodule() {
+    this->ipcSrv->SetRunning(false);
+    delete this->ipcSrv;
+    EMCpatcher::Exit();
+    delete this->clockMgr;
+}
+
+void SimSysmodule::Step(std::uint32_t ms) {
+    std::uint64_t ns = ms * 1000000ULL;
+    if (simClockIsManual())
+        simClockAdvanceNs(ns);
+    SimBoard::Advance(ns);
+    this->clockMgr->Tick();
+}
+
+Result SimSysmodule::Call(std::uint64_t cmdId, const void* in, std::size_t inSize, void* out, std::size_t outSize) {
+    SimIpcRequest req = {};
+    req.cmdId = cmdId;
+    req.in = in;
+    req.inSize = inSize;
+    req.out = out;
+    req.outSize = outSize;
+    return simIpcDispatch(SYSCLK_IPC_SERVICE_NAME, &req);
+}
+
+Result SimSysmodule::ApplyBatch(const HocClkBatchOp* ops, std::uint32_t count, HocClkBatchResult* out_result) {
+    SimIpcRequest req = {};
+    req.cmdId = HocClkIpcCmd_ApplyBatch;
+    req.send = ops;
+    req.sendSize = count * sizeof(*ops);
+    req.out = out_result;
+    req.outSize = sizeof(*out_result);
+    return simIpcDispatch(SYSCLK_IPC_SERVICE_NAME, &req);
+}
+
+Result SimSysmodule::GetConfigValues(SysClkConfigValueList* out_values) {
+    SimIpcRequest req = {};
+    req.cmdId = SysClkIpcCmd_GetConfigValues;
+    req.recv = out_values;
+    req.recvSize = sizeof(*out_values);
+    return simIpcDispatch(SYSCLK_IPC_SERVICE_NAME, &req);
+}
+
+Result SimSysmodule::SetConfigValues(const SysClkConfigValueList* values) {
+    SimIpcRequest req = {};
+    req.cmdId = SysClkIpcCmd_SetConfigValues;
+    req.send = values;
+    req.sendSize = sizeof(*values);
+    return simIpcDispatch(SYSCLK_IPC_SERVICE_NAME, &req);
+}
+
+SysClkContext SimSysmodule::GetContext() {
+    SysClkContext context = {};
+    Result rc = this->Call(SysClkIpcCmd_GetCurrentContext, nullptr, 0, &context, sizeof(context));
+    if (R_FAILED(rc)) {
+        ERROR_RESULT_THROW(rc, "GetCurrentContext");
+    }
+    return context;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The sysmodule as main.cpp runs it, on the simulated board and with IPC
+// going through sim_ipc. Config and learned state live in FILE_CONFIG_DIR.
+
+#pragma once
+
+#include "clock_manager.h"
+#include "ipc_service.h"
+#include "sim.h"
+#include "sim_board.h"
+
+class SimSysmodule
+{
+  public:
+    // Starts from defaults unless keepConfig, with the board reset to model.
+    // configIni, if set, is written as config.ini before the start
+    SimSysmodule(const SimBoardModel* model, bool keepConfig, const char* configIni = nullptr);
+    virtual ~SimSysmodule();
+
+    // Moves the board (and the manual clock) forward, then runs one tick
+    void Step(std::uint32_t ms);
+
+    Result Call(std::uint64_t cmdId, const void* in, std::size_t inSize, void* out, std::size_t outSize);
+    Result ApplyBatch(const HocClkBatchOp* ops, std::uint32_t count, HocClkBatchResult* out_result);
+    Result GetConfigValues(SysClkConfigValueList* out_values);
+    Result SetConfigValues(const SysClkConfigValueList* values);
+    SysClkContext GetContext();
+
+    ClockManager* clockMgr;
+    IpcService* ipcSrv;
+};
@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Regression tests for ClockManager, Config and IpcService running together
+// on the simulated board, on the manual clock.
+
+#include "host_test.hpp"
+#include "sim_sysmodule.h"
+#include "sim_replay.h"
+#include "process_management.h"
+#include "file_utils.h"
+#include "heap_stats.h"
+
+#define SIM_TID 0x0100000000010000ULL
+#define SIM_TICK_MS 300
+
+static HocClkBatchOp ProfileOp(SysClkProfile profile, SysClkModule module, std::uint32_t mhz) {
+    HocClkBatchOp op = {};
+    op.type = HocClkBatchOp_Profile;
+    op.key = HOCCLK_BATCH_PROFILE_KEY(profile, module);
+    op.tid = SIM_TID;
+    op.value = mhz;
+    return op;
+}
+
+static HocClkBatchOp ConfigOp(SysClkConfigValue value, std::uint64_t v) {
+    HocClkBatchOp op = {};
+    op.type = HocClkBatchOp_ConfigValue;
+    op.key = value;
+    op.value = v;
+    return op;
+}
+
+static HocClkBatchOp EnabledOp(bool enabled) {
+    HocClkBatchOp op = {};
+    op.type = HocClkBatchOp_Enabled;
+    op.value = enabled;
+    return op;
+}
+
+static void Apply(SimSysmodule* sys, const HocClkBatchOp* ops, std::uint32_t count) {
+    HocClkBatchResult result = {};
+    assert(R_SUCCEEDED(sys->ApplyBatch(ops, count, &result)));
+    assert(result.count == count);
+}
+
+static SimBoardModel TitleModel() {
+    SimBoardModel model = SimBoard::DefaultModel();
+    model.applicationId = SIM_TID;
+    return model;
+}
+
+void Test_SimProfileClocks() {
+    SimBoardModel model = TitleModel();
+    SimSysmodule sys(&model, false);
+    sys.Step(SIM_TICK_MS);
+
+    HocClkBatchOp ops[] = {
+        ProfileOp(SysClkProfile_Handheld, SysClkModule_CPU, 1785),
+        ProfileOp(SysClkProfile_Handheld, SysClkModule_GPU, 921),
+        ProfileOp(SysClkProfile_Handheld, SysClkModule_MEM, 1862),
+        EnabledOp(true),
+    };
+    Apply(&sys, ops, 4);
+    sys.Step(SIM_TICK_MS);
+
+    // The GPU is held to the handheld cap
+    assert(Board::GetHz(SysClkModule_CPU) == 1785000000);
+    assert(Board::GetHz(SysClkModule_GPU) == 614400000);
+    assert(Board::GetHz(SysClkModule_MEM) == 1862400000);
+
+    // SD1 goes by the RAM clock read at the start of a tick, so it follows one tick later
+    assert(Board::GetVoltage(HocClkVoltage_EMCVDD2) == 1100000);
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetVoltage(HocClkVoltage_EMCVDD2) == 1175000);
+
+    SysClkContext context = sys.GetContext();
+    assert(context.enabled);
+    assert(context.applicationId == SIM_TID);
+    assert(context.freqs[SysClkModule_CPU] == 1785000000);
+    LOGGING("handheld: %d mW, SoC %u mC", SimBoard::GetBoardMw(), context.temps[SysClkThermalSensor_SOC]);
+
+    // Docking resets to stock and nothing is set for docked
+    model.profile = SysClkProfile_Docked;
+    model.operationMode = AppletOperationMode_Console;
+    model.apmConfiguration = 0x00010001;
+    model.chargerMw = 18000;
+    SimBoard::SetModel(&model);
+    SimBoardCounters before = SimBoard::GetCounters();
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_GPU) == SimBoard::GetStockHz(SysClkModule_GPU));
+    assert(Board::GetHz(SysClkModule_GPU) == 768000000);
+    assert(SimBoard::GetCounters().setHz[SysClkModule_GPU] == before.setHz[SysClkModule_GPU]);
+
+    // Overrides win over profiles and are not capped on the CPU
+    SysClkIpc_SetOverride_Args args = { SysClkModule_CPU, 2091000000 };
+    assert(R_SUCCEEDED(sys.Call(SysClkIpcCmd_SetOverride, &args, sizeof(args), nullptr, 0)));
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_CPU) == 2091000000);
+
+    // Back to the title's clocks once undocked and the override is gone
+    args.hz = 0;
+    assert(R_SUCCEEDED(sys.Call(SysClkIpcCmd_SetOverride, &args, sizeof(args), nullptr, 0)));
+    model = TitleModel();
+    SimBoard::SetModel(&model);
+    sys.Step(SIM_TICK_MS);
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_CPU) == 1785000000);
+}
+
+void Test_SimThermalThrottle() {
+    SimBoardModel model = TitleModel();
+    SimSysmodule sys(&model, false);
+    sys.Step(SIM_TICK_MS);
+
+    // TDP off so the thermal limit is the one that trips
+    HocClkBatchOp ops[] = {
+        ConfigOp(HocClkConfigValue_HandheldTDP, 0),
+        ConfigOp(HocClkConfigValue_UncappedClocks, 1),
+        ProfileOp(SysClkProfile_Handheld, SysClkModule_CPU, 1963),
+        ProfileOp(SysClkProfile_Handheld, SysClkModule_GPU, 1267),
+        ProfileOp(SysClkProfile_Handheld, SysClkModule_MEM, 1862),
+        EnabledOp(true),
+    };
+    Apply(&sys, ops, 6);
+
+    for (auto& load : model.load) {
+        load = 1000;
+    }
+    SimBoard::SetModel(&model);
+
+    std::uint32_t limitMilli = sysclkDefaultConfigValue(HocClkConfigValue_ThermalThrottleThreshold) * 1000;
+    std::uint32_t throttled = 0, restored = 0, maxMilli = 0;
+    bool wasThrottled = false;
+    for (int i = 0; i < 1200; i++) {
+        sys.Step(SIM_TICK_MS);
+
+        std::uint32_t milli = Board::GetTemperatureMilli(SysClkThermalSensor_SOC);
+        maxMilli = std::max(maxMilli, milli);
+        bool isThrottled = Board::GetHz(SysClkModule_CPU) == SimBoard::GetStockHz(SysClkModule_CPU);
+        if (isThrottled && !wasThrottled) {
+            throttled++;
+            assert(milli >= limitMilli + 1000);
+        } else if (!isThrottled && wasThrottled) {
+            restored++;
+            assert(milli < limitMilli + 1000);
+            assert(Board::GetHz(SysClkModule_GPU) == 1267200000);
+        }
+        wasThrottled = isThrottled;
+    }
+
+    // No hysteresis: it toggles around the limit (whole degrees), within a tick's worth of heating
+    LOGGING("%u throttles, %u restores, peak %u mC (limit %u mC)", throttled, restored, maxMilli, limitMilli);
+    assert(throttled >= 2 && restored >= 1);
+    assert(maxMilli < limitMilli + 2000);
+}
+
+void Test_SimConfigRestart() {
+    SimBoardModel model = TitleModel();
+    {
+        SimSysmodule sys(&model, false);
+        sys.Step(SIM_TICK_MS);
+
+        HocClkBatchOp ops[] = {
+            ConfigOp(HocClkConfigValue_ThermalThrottleThreshold, 65),
+            ProfileOp(SysClkProfile_Handheld, SysClkModule_CPU, 1683),
+            EnabledOp(true),
+        };
+        Apply(&sys, ops, 3);
+
+        // Rejected whole, the valid op included
+        HocClkBatchOp bad[] = {
+            ProfileOp(SysClkProfile_Handheld, SysClkModule_CPU, 1020),
+            ConfigOp(SysClkConfigValue_PollingIntervalMs, 0),
+        };
+        HocClkBatchResult result = {};
+        assert(R_SUCCEEDED(sys.ApplyBatch(bad, 2, &result)));
+        assert(result.status[0] == SYSCLK_ERROR(BatchAborted));
+        assert(result.status[1] == SYSCLK_ERROR(InvalidBatchOp));
+        sys.Step(SIM_TICK_MS);
+        assert(Board::GetHz(SysClkModule_CPU) == 1683000000);
+    }
+
+    // The writer flushed on the way out, a new boot reads it all back
+    SimSysmodule sys(&model, true);
+    sys.Step(SIM_TICK_MS);
+    assert(sys.clockMgr->GetConfig()->GetConfigValue(HocClkConfigValue_ThermalThrottleThreshold) == 65);
+
+    std::uint64_t tid = SIM_TID;
+    SysClkTitleProfileList profiles = {};
+    assert(R_SUCCEEDED(sys.Call(SysClkIpcCmd_GetProfiles, &tid, sizeof(tid), &profiles, sizeof(profiles))));
+    assert(profiles.mhzMap[SysClkProfile_Handheld][SysClkModule_CPU] == 1683);
+    assert(profiles.mhzMap[SysClkProfile_Handheld][SysClkModule_GPU] == 0);
+
+    // Enabled is not persisted, main.cpp turns it on at boot
+    std::uint8_t enabled = 1;
+    assert(R_SUCCEEDED(sys.Call(SysClkIpcCmd_SetEnabled, &enabled, sizeof(enabled), nullptr, 0)));
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_CPU) == 1683000000);
+}
+
+void Test_SimPowerBudget() {
+    SimBoardModel model = TitleModel();
+    model.profile = SysClkProfile_Docked;
+    model.operationMode = AppletOperationMode_Console;
+    model.apmConfiguration = 0x00010001;
+    model.chargerMw = 18000;
+    SimSysmodule sys(&model, false);
+    sys.Step(SIM_TICK_MS);
+
+    HocClkBatchOp ops[] = {
+        ProfileOp(SysClkProfile_Docked, SysClkModule_GPU, 1267),
+        ProfileOp(SysClkProfile_Handheld, SysClkModule_GPU, 921),
+        ProfileOp(SysClkProfile_Handheld, SysClkModule_MEM, 1862),
+        // The TDP and thermal limits would reset to stock before the budget steps in
+        ConfigOp(HocClkConfigValue_HandheldTDP, 0),
+        ConfigOp(HocClkConfigValue_ThermalThrottle, 0),
+        ConfigOp(HocClkConfigValue_PowerBudgetBattery, 1),
+        EnabledOp(true),
+    };
+    Apply(&sys, ops, 7);
+    sys.Step(SIM_TICK_MS);
+
+    // An 18 W charger in the dock holds the GPU back, the dock's own doesn't
+    assert(Board::GetHz(SysClkModule_GPU) == 1075200000);
+    model.chargerMw = 39000;
+    SimBoard::SetModel(&model);
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_GPU) == 1267200000);
+
+    // Undocked on a battery running low, the memory is held back too once its cap is enabled
+    model = TitleModel();
+    model.batteryPcm = 20000;
+    SimBoard::SetModel(&model);
+    sys.Step(SIM_TICK_MS);
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_GPU) == 460800000);
+    assert(Board::GetHz(SysClkModule_MEM) == 1862400000);
+
+    HocClkBatchOp caps = ConfigOp(HocClkConfigValue_PowerBudgetCpuMemCaps, 1);
+    Apply(&sys, &caps, 1);
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_MEM) == 1600000000);
+
+    model.batteryPcm = 90000;
+    SimBoard::SetModel(&model);
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_GPU) == 614400000);
+    assert(Board::GetHz(SysClkModule_MEM) == 1862400000);
+
+    // Drawing past what the battery may give steps down, not before the fuel gauge caught up
+    model.baseMw = 9000;
+    SimBoard::SetModel(&model);
+    std::uint64_t ticks = 0;
+    while (Board::GetHz(SysClkModule_MEM) != 1600000000 && ticks < 200) {
+        sys.Step(SIM_TICK_MS);
+        ticks++;
+    }
+    LOGGING("stepped down after %lu ms at %d mW", (unsigned long)(ticks * SIM_TICK_MS), SimBoard::GetBoardMw());
+    assert(ticks < 200 && ticks * SIM_TICK_MS * 1000000 >= POWER_BUDGET_SETTLE_NS - SIM_TICK_MS * 1000000ULL);
+    assert(Board::GetHz(SysClkModule_GPU) == 460800000);
+
+    // Without the charge info (before 10.0.0) each profile gets its stock cap back
+    model.chargeInfo = false;
+    SimBoard::SetModel(&model);
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_GPU) == 614400000);
+    assert(Board::GetHz(SysClkModule_MEM) == 1862400000);
+    model.profile = SysClkProfile_Docked;
+    model.operationMode = AppletOperationMode_Console;
+    model.apmConfiguration = 0x00010001;
+    model.chargerMw = 39000;
+    SimBoard::SetModel(&model);
+    sys.Step(SIM_TICK_MS);
+    assert(Board::GetHz(SysClkModule_GPU) == 1267200000);
+}
+
+// The title at full clocks with no limits, what the trace below is recorded with
+#define SIM_REPLAY_POLICY \
+    "[values]\n" \
+    "handheld_tdp=0\n" \
+    "uncapped_clocks=1\n" \
+    "thermal_throttle=0\n" \
+    "[0100000000010000]\n" \
+    "handheld_cpu=1963\n" \
+    "handheld_gpu=1267\n" \
+    "handheld_mem=1862\n"
+
+void Test_SimTraceReplay() {
+    remove(FILE_TICK_TRACE_PATH);
+    fclose(fopen(FILE_TICK_TRACE_FLAG_PATH, "w"));
+
+    SimBoardModel model = TitleModel();
+    {
+        SimSysmodule sys(&model, false, SIM_REPLAY_POLICY);
+        std::uint8_t enabled = 1;
+        assert(R_SUCCEEDED(sys.Call(SysClkIpcCmd_SetEnabled, &enabled, sizeof(enabled), nullptr, 0)));
+
+        // Gameplay, a lighter scene, gameplay again
+        for (int i = 0; i < 600; i++) {
+            std::uint32_t load = i >= 200 && i < 300 ? 400 : 1000;
+            for (auto& l : model.load) {
+                l = load;
+            }
+            SimBoard::SetModel(&model);
+            sys.Step(SIM_TICK_MS);
+        }
+    }
+    remove(FILE_TICK_TRACE_FLAG_PATH);
+
+    std::vector<TickTraceRow> rows;
+    assert(TickTraceLoad(FILE_TICK_TRACE_PATH, &rows));
+    assert(rows.size() == 600);
+    assert(rows[0].applicationId == SIM_TID && rows[0].apmConfiguration == 0x92220007);
+    assert(rows[599].hz[SysClkModule_CPU] == 1963000000);
+    assert(rows[599].ns - rows[0].ns == 599ULL * SIM_TICK_MS * 1000000);
+
+    // Same policy, same decisions
+    SimReplayLimits limits = SimReplayDefaultLimits();
+    SimReplayResult same;
+    assert(SimReplay(rows, SIM_REPLAY_POLICY, &limits, &same, nullptr));
+    assert(same.ticks == 600 && same.divergedTicks == 0);
+    std::uint32_t recordedMaxMilli = 0;
+    for (const TickTraceRow& row : rows) {
+        recordedMaxMilli = std::max(recordedMaxMilli, row.temps[SysClkThermalSensor_SOC]);
+    }
+    assert(same.maxSocMilli == recordedMaxMilli && same.overThermalNs > 0);
+
+    // The recording ran hot, throttling at 70 C then 60 C should trade clocks for heat
+    std::string at70 = SIM_REPLAY_POLICY;
+    at70.replace(at70.find("thermal_throttle=0"), 18, "thermal_throttle=1");
+    std::string at60 = at70;
+    at60.insert(at60.find("[0100"), "thermal_throttle_threshold=60\n");
+    SimReplayResult throttled70, throttled60;
+    assert(SimReplay(rows, at70, &limits, &throttled70, nullptr));
+    assert(SimReplay(rows, at60, &limits, &throttled60, nullptr));
+
+    LOGGING("as recorded: %.0f J, %.1f s over %u mC, peak %u mC", same.energyMj / 1000, same.overThermalNs / 1e9, limits.thermalMilli, same.maxSocMilli);
+    LOGGING("throttle 70: %.0f J, %.1f s over, peak %u mC, CPU %u MHz", throttled70.energyMj / 1000, throttled70.overThermalNs / 1e9, throttled70.maxSocMilli, throttled70.meanMhz[SysClkModule_CPU]);
+    LOGGING("throttle 60: %.0f J, %.1f s over, peak %u mC, CPU %u MHz", throttled60.energyMj / 1000, throttled60.overThermalNs / 1e9, throttled60.maxSocMilli, throttled60.meanMhz[SysClkModule_CPU]);
+    assert(throttled70.divergedTicks > 0 && throttled60.divergedTicks > throttled70.divergedTicks);
+    // At 70 it hovers just over the limit (whole degrees) instead of running away
+    assert(throttled70.maxSocMilli < limits.thermalMilli + 2000 && throttled70.maxSocMilli < same.maxSocMilli);
+    assert(throttled60.overThermalNs == 0 && throttled60.maxSocMilli < throttled70.maxSocMilli);
+    assert(throttled70.energyMj < same.energyMj && throttled60.energyMj < throttled70.energyMj);
+    assert(throttled60.meanMhz[SysClkModule_CPU] < throttled70.meanMhz[SysClkModule_CPU]);
+}
+
+void Test_SimSteadyStateHeap() {
+    SimBoardModel model = TitleModel();
+    SimSysmodule sys(&model, false, SIM_REPLAY_POLICY);
+    std::uint8_t enabled = 1;
+    assert(R_SUCCEEDED(sys.Call(SysClkIpcCmd_SetEnabled, &enabled, sizeof(enabled), nullptr, 0)));
+    sys.Step(SIM_TICK_MS);
+
+    // The first change starts the config writer thread
+    HocClkBatchOp ops[] = {
+        ProfileOp(SysClkProfile_Handheld, SysClkModule_CPU, 1785),
+        ConfigOp(HocClkConfigValue_ThermalThrottleThreshold, 65),
+    };
+    Apply(&sys, ops, 2);
+    for (int i = 0; i < 10; i++) {
+        sys.Step(SIM_TICK_MS);
+    }
+
+    // Ticks, the overlay polling, and settings changes with the reload that follows
+    std::uint32_t allocs = HeapStats::GetAllocCount();
+    for (int i = 0; i < 300; i++) {
+        SysClkContext context;
+        assert(R_SUCCEEDED(sys.Call(SysClkIpcCmd_GetCurrentContext, nullptr, 0, &context, sizeof(context))));
+        if (i % 100 == 50) {
+            ops[0].value = ops[0].value == 1785 ? 1963 : 1785;
+            Apply(&sys, ops, 2);
+        }
+        sys.Step(SIM_TICK_MS);
+    }
+    assert(Board::GetHz(SysClkModule_CPU) == 1963000000);
+    assert(HeapStats::GetAllocCount() == allocs);
+
+    HocClkHeapStats stats = {};
+    assert(R_SUCCEEDED(sys.Call(HocClkIpcCmd_GetHeapStats, nullptr, 0, &stats, sizeof(stats))));
+    LOGGING("%u B in use, peak %u B, %u allocations, %u frees", stats.usedBytes, stats.peakBytes, stats.allocCount, stats.freeCount);
+    assert(stats.usedBytes > 0 && stats.peakBytes >= stats.usedBytes);
+    assert(stats.allocCount == allocs && stats.allocCount > stats.freeCount);
+}
+void Test_SimPowerModelQueries() {
+    SimBoardModel model = TitleModel();
+    SimSysmodule sys(&model, false);
+    sys.Step(SIM_TICK_MS);
+
+    // Nothing learned yet
+    HocClkIpc_EstimatePower_Args estimate = {};
+    estimate.hz[SysClkModule_CPU] = 1020000000;
+    estimate.hz[SysClkModule_GPU] = 307200000;
+    estimate.hz[SysClkModule_MEM] = 1600000000;
+    std::int32_t mw = 0;
+    assert(sys.Call(HocClkIpcCmd_EstimatePower, &estimate, sizeof(estimate), &mw, sizeof(mw)) == SYSCLK_ERROR(NoPowerEstimate));
+
+    HocClkBatchOp op = EnabledOp(true);
+    Apply(&sys, &op, 1);
+    for (int i = 0; i < 50; i++)
+        sys.Step(SIM_TICK_MS);
+
+    // The clocks it ran at on battery, answered over IPC
+    for (int module = 0; module < SysClkModule_EnumMax; module++)
+        estimate.hz[module] = Board::GetHz((SysClkModule)module);
+    assert(R_SUCCEEDED(sys.Call(HocClkIpcCmd_EstimatePower, &estimate, sizeof(estimate), &mw, sizeof(mw))));
+    LOGGING("%u/%u/%u MHz: %d mW", estimate.hz[0] / 1000000, estimate.hz[1] / 1000000, estimate.hz[2] / 1000000, mw);
+    assert(mw > 0);
+
+    HocClkIpc_FindCheapest_Args cheapest = {};
+    HocClkOperatingPoint point = {};
+    assert(R_SUCCEEDED(sys.Call(HocClkIpcCmd_FindCheapestOperatingPoint, &cheapest, sizeof(cheapest), &point, sizeof(point))));
+    assert(point.mw > 0 && point.hz[SysClkModule_CPU]);
+
+    // Faster than anything seen
+    cheapest.minHz[SysClkModule_CPU] = UINT32_MAX;
+    assert(sys.Call(HocClkIpcCmd_FindCheapestOperatingPoint, &cheapest, sizeof(cheapest), &point, sizeof(point)) == SYSCLK_ERROR(NoPowerEstimate));
+}
+
+void Test_SimStagedBatches() {
+    SimBoardModel model = TitleModel();
+    SimSysmodule sys(&model, false);
+    sys.Step(SIM_TICK_MS);
+
+    // Applied by the next tick, not by the IPC thread
+    HocClkBatchOp op = ConfigOp(HocClkConfigValue_ThermalThrottleThreshold, 65);
+    Apply(&sys, &op, 1);
+    assert(sys.clockMgr->GetConfig()->GetConfigValue(HocClkConfigValue_ThermalThrottleThreshold) == 70);
+    sys.Step(SIM_TICK_MS);
+    assert(sys.clockMgr->GetConfig()->GetConfigValue(HocClkConfigValue_ThermalThrottleThreshold) == 65);
+
+    // Batches queue up in order until the tick catches up, then they are turned away
+    HocClkBatchOp ops[HOCCLK_BATCH_MAX_OPS];
+    for (std::uint32_t batch = 0; batch < CONFIG_STAGED_BATCH_OPS / HOCCLK_BATCH_MAX_OPS; batch++) {
+        for (auto& o : ops)
+            o = ConfigOp(HocClkConfigValue_ThermalThrottleThreshold, 50 + batch);
+        Apply(&sys, ops, HOCCLK_BATCH_MAX_OPS);
+    }
+    HocClkBatchResult result = {};
+    assert(R_SUCCEEDED(sys.ApplyBatch(&op, 1, &result)));
+    assert(result.status[0] == SYSCLK_ERROR(BatchQueueFull));
+
+    sys.Step(SIM_TICK_MS);
+    assert(sys.clockMgr->GetConfig()->GetConfigValue(HocClkConfigValue_ThermalThrottleThreshold) == 50 + CONFIG_STAGED_BATCH_OPS / HOCCLK_BATCH_MAX_OPS - 1);
+    Apply(&sys, &op, 1);
+    sys.Step(SIM_TICK_MS);
+    assert(sys.clockMgr->GetConfig()->GetConfigValue(HocClkConfigValue_ThermalThrottleThreshold) == 65);
+}
+
+void Test_SimConfigValues() {
+    SimBoardModel model = TitleModel();
+    SimSysmodule sys(&model, false);
+    sys.Step(SIM_TICK_MS);
+
+    // The whole list no longer fits an inline reply, asking for it that way is refused
+    SysClkConfigValueList values = {};
+    assert(sizeof(values) > IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE);
+    assert(R_FAILED(sys.Call(SysClkIpcCmd_GetConfigValues, nullptr, 0, &values, sizeof(values))));
+
+    assert(R_SUCCEEDED(sys.GetConfigValues(&values)));
+    for (int v = 0; v < SysClkConfigValue_EnumMax; v++) {
+        assert(values.values[v] == sysclkDefaultConfigValue((SysClkConfigValue)v));
+    }
+
+    // The first and the last value make it through and back
+    values.values[SysClkConfigValue_PollingIntervalMs] = 500;
+    values.values[HocClkConfigValue_TickStatsLogIntervalMs] = 1000;
+    assert(R_SUCCEEDED(sys.SetConfigValues(&values)));
+    sys.Step(SIM_TICK_MS);
+
+    SysClkConfigValueList readBack = {};
+    assert(R_SUCCEEDED(sys.GetConfigValues(&readBack)));
+    assert(!memcmp(&readBack, &values, sizeof(values)));
+    assert(sys.clockMgr->GetConfig()->GetConfigValue(HocClkConfigValue_TickStatsLogIntervalMs) == 1000);
+}
+
+int main(int argc, char** argv) {
+    UnitTest tests[] = {
+        { "Sim: title profiles, docking and overrides",      Test_SimProfileClocks },
+        { "Sim: thermal throttle under sustained load",      Test_SimThermalThrottle },
+        { "Sim: settings over IPC survive a restart",        Test_SimConfigRestart },
+        { "Sim: config list round trip over IPC",            Test_SimConfigValues },
+        { "Sim: batches are applied by the tick",            Test_SimStagedBatches },
+        { "Sim: power model queries over IPC",               Test_SimPowerModelQueries },
+        { "Sim: recorded ticks replay under other policies", Test_SimTraceReplay },
+        { "Sim: clock caps from the charger and battery",    Test_SimPowerBudget },
+        { "Sim: no allocations once running",                Test_SimSteadyStateHeap },
+    };
+
+    simClockSetManual(true);
+    for (auto& test : tests) {
+        if (argc > 1 && !strstr(test.description, argv[1]))
+            continue;
+        test.Test();
+    }
+
+    printf("All tests passed\n");
+    return 0;
+}
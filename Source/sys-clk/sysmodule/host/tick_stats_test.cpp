@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "host_test.hpp"
+#include "tick_stats.h"
+
+void Test_TickStatsBuckets() {
+    assert(hocClkTickStatsBucket(0) == 0);
+    assert(hocClkTickStatsBucket(1) == 0);
+    assert(hocClkTickStatsBucket(2) == 1);
+    assert(hocClkTickStatsBucket(3) == 1);
+    assert(hocClkTickStatsBucket(1000) == 9);
+    assert(hocClkTickStatsBucket(UINT32_MAX) == HOCCLK_TICK_STATS_BUCKETS - 1);
+
+    HocClkTickPhaseStats stats = {};
+    assert(hocClkTickStatsPercentileUs(&stats, 99) == 0);
+
+    // 98 fast ticks around 300 us and two slow ones at 40 ms
+    for (int i = 0; i < 98; i++) {
+        stats.histogram[hocClkTickStatsBucket(300)]++;
+    }
+    stats.histogram[hocClkTickStatsBucket(40000)] += 2;
+    stats.maxUs = 40000;
+
+    assert(hocClkTickStatsPercentileUs(&stats, 50) == 511);
+    assert(hocClkTickStatsPercentileUs(&stats, 98) == 511);
+    assert(hocClkTickStatsPercentileUs(&stats, 99) == 40000);
+}
+
+void Test_TickStatsPhases() {
+    TickStats tickStats;
+    HocClkTickStats stats;
+
+    for (int tick = 0; tick < 10; tick++) {
+        tickStats.AddPhase(HocClkTickPhase_Apm, 20000);
+        // Entered twice, counted once
+        tickStats.AddPhase(HocClkTickPhase_Sensors, 100000);
+        tickStats.AddPhase(HocClkTickPhase_Sensors, 50000);
+        if (tick == 9) {
+            tickStats.AddPhase(HocClkTickPhase_SetHz, 3000000);
+        }
+        tickStats.EndTick(tick == 9 ? 3500000 : 400000);
+    }
+
+    tickStats.GetStats(&stats);
+    assert(stats.phases[HocClkTickPhase_Total].count == 10);
+    assert(stats.phases[HocClkTickPhase_Total].lastUs == 3500);
+    assert(stats.phases[HocClkTickPhase_Total].maxUs == 3500);
+    assert(stats.phases[HocClkTickPhase_Apm].count == 10);
+    assert(stats.phases[HocClkTickPhase_Apm].maxUs == 20);
+    assert(stats.phases[HocClkTickPhase_Sensors].count == 10);
+    assert(stats.phases[HocClkTickPhase_Sensors].lastUs == 150);
+    assert(stats.phases[HocClkTickPhase_SetHz].count == 1);
+    assert(stats.phases[HocClkTickPhase_Limits].count == 0);
+
+    // A phase left out of a tick keeps its last value
+    tickStats.EndTick(400000);
+    tickStats.GetStats(&stats);
+    assert(stats.phases[HocClkTickPhase_SetHz].count == 1);
+    assert(stats.phases[HocClkTickPhase_SetHz].lastUs == 3000);
+    LOGGING("total p50 %u us, p99 %u us", hocClkTickStatsPercentileUs(&stats.phases[HocClkTickPhase_Total], 50),
+            hocClkTickStatsPercentileUs(&stats.phases[HocClkTickPhase_Total], 99));
+
+    // Reset starts over
+    tickStats.Reset();
+    for (int i = 0; i < 4; i++) {
+        tickStats.EndTick(1000);
+    }
+    tickStats.GetStats(&stats);
+    assert(stats.phases[HocClkTickPhase_Total].histogram[0] == 4);
+    assert(stats.phases[HocClkTickPhase_Total].lastUs == 1);
+}
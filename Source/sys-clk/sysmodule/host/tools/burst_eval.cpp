@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Replays recorded context.csv traces through the load burst detector.
+// Annotate load screens with a 0/1 load_phase column to get hit rates.
+
+#include "context_trace.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+static void Usage(const char* name) {
+    printf("Usage: %s [-m max_burst_ms] [-t thermal_limit_c] [-q] context.csv...\n", name);
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t maxMs = 15000;
+    std::uint32_t thermalLimit = 70;
+    bool verbose = true;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "m:t:qh")) != -1) {
+        switch (opt) {
+            case 'm': maxMs = strtoull(optarg, nullptr, 10); break;
+            case 't': thermalLimit = strtoul(optarg, nullptr, 10); break;
+            case 'q': verbose = false; break;
+            default:  Usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (optind >= argc) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    for (int i = optind; i < argc; i++) {
+        std::vector<ContextTraceRow> rows;
+        if (!ContextTraceLoad(argv[i], &rows)) {
+            fprintf(stderr, "%s: can't read trace\n", argv[i]);
+            return 1;
+        }
+
+        printf("%s: %zu samples\n", argv[i], rows.size());
+        if (!rows.empty() && !rows[0].hasLoad) {
+            printf("    no load columns, recorded before they were logged\n");
+            continue;
+        }
+
+        BurstEvalResult result;
+        ContextTraceEvalBurst(rows, maxMs * 1000000ULL, thermalLimit * 1000, &result, verbose);
+
+        printf("    %u bursts, %.1f s of %.1f s bursting\n", result.bursts, result.burstNs / 1e9, result.traceNs / 1e9);
+        if (result.labelledPhases) {
+            std::uint32_t positives = result.truePositive + result.falsePositive;
+            std::uint32_t labelled = result.truePositive + result.falseNegative;
+            printf("    %u/%u load phases caught, %.2f s mean latency\n", result.detectedPhases, result.labelledPhases,
+                   result.detectedPhases ? result.latencyNs / 1e9 / result.detectedPhases : 0.);
+            printf("    precision %.2f, recall %.2f (per sample)\n",
+                   positives ? (double)result.truePositive / positives : 0.,
+                   labelled ? (double)result.truePositive / labelled : 0.);
+        }
+    }
+
+    return 0;
+}
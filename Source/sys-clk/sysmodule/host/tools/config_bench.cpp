@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Read latency of the config while settings are being saved, with the SD
+// rewrite done inline under the config lock (as IPC used to) and deferred
+// to a writer thread through ConfigWriteQueue.
+
+#include "config_write_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    std::uint64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    struct Options {
+        std::uint32_t writeMs = 40;   // one ini_putsection on SD
+        std::uint32_t writes = 40;    // overlay changes
+        std::uint32_t gapMs = 50;     // between two changes
+    };
+
+    // Config stand-in: values behind one lock, and a store that takes writeMs
+    struct BenchConfig {
+        std::mutex lock;
+        std::uint64_t values[32] = {};
+        ConfigWriteQueue queue;
+        std::condition_variable wake;
+        bool stop = false;
+        std::uint32_t stored = 0;
+        const Options* options;
+
+        void Store(const std::uint64_t* values) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(this->options->writeMs));
+            this->stored++;
+        }
+
+        void SetInline(std::uint32_t i, std::uint64_t value) {
+            std::scoped_lock guard{this->lock};
+            this->Store(this->values);
+            this->values[i % 32] = value;
+        }
+
+        void SetDeferred(std::uint32_t i, std::uint64_t value) {
+            std::scoped_lock guard{this->lock};
+            this->values[i % 32] = value;
+            this->queue.MarkValues(NowNs());
+            this->wake.notify_one();
+        }
+
+        void Writer() {
+            std::unique_lock guard{this->lock};
+            while (!this->stop || this->queue.Pending()) {
+                ConfigWriteBatch batch;
+                std::uint64_t waitNs = this->queue.WaitNs(NowNs());
+                if (waitNs && !this->stop) {
+                    this->wake.wait_for(guard, std::chrono::nanoseconds(std::min(waitNs, (std::uint64_t)1000000000)));
+                    continue;
+                }
+                if (!this->queue.TakeAll(&batch))
+                    continue;
+
+                std::uint64_t snapshot[32];
+                memcpy(snapshot, this->values, sizeof(snapshot));
+                guard.unlock();
+                this->Store(snapshot);
+                guard.lock();
+            }
+        }
+
+        std::uint64_t Get(std::uint32_t i) {
+            std::scoped_lock guard{this->lock};
+            return this->values[i % 32];
+        }
+    };
+
+    void Run(const char* name, bool deferred, const Options& options) {
+        BenchConfig config;
+        config.options = &options;
+        std::atomic_bool done{false};
+        std::vector<std::uint64_t> latencies;
+
+        std::thread writer;
+        if (deferred)
+            writer = std::thread(&BenchConfig::Writer, &config);
+
+        // The IPC thread answering GetConfigValues as fast as it's asked
+        std::thread reader([&] {
+            std::uint32_t i = 0;
+            while (!done) {
+                std::uint64_t start = NowNs();
+                volatile std::uint64_t value = config.Get(i++);
+                (void)value;
+                latencies.push_back(NowNs() - start);
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+        });
+
+        std::uint64_t start = NowNs();
+        for (std::uint32_t i = 0; i < options.writes; i++) {
+            if (deferred)
+                config.SetDeferred(i, i + 1);
+            else
+                config.SetInline(i, i + 1);
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.gapMs));
+        }
+        std::uint64_t elapsedMs = (NowNs() - start) / 1000000;
+
+        done = true;
+        reader.join();
+        if (deferred) {
+            {
+                std::scoped_lock guard{config.lock};
+                config.stop = true;
+            }
+            config.wake.notify_one();
+            writer.join();
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        auto at = [&](double p) { return latencies[(size_t)(p * (latencies.size() - 1))] / 1000.; };
+        printf("%-9s %6zu reads  p50 %8.1f us  p99 %8.1f us  max %8.1f us  %3u SD writes for %u changes in %lu ms\n",
+               name, latencies.size(), at(.5), at(.99), latencies.back() / 1000., config.stored, options.writes, (unsigned long)elapsedMs);
+    }
+
+    void Usage(const char* name) {
+        printf("Usage: %s [-w write_ms] [-n changes] [-g gap_ms]\n", name);
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "w:n:g:h")) != -1) {
+        switch (opt) {
+            case 'w': options.writeMs = strtoul(optarg, nullptr, 10); break;
+            case 'n': options.writes = strtoul(optarg, nullptr, 10); break;
+            case 'g': options.gapMs = strtoul(optarg, nullptr, 10); break;
+            default:  Usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    printf("%u changes %u ms apart, %u ms per config.ini write\n", options.writes, options.gapMs, options.writeMs);
+    Run("inline", false, options);
+    Run("deferred", true, options);
+    return 0;
+}
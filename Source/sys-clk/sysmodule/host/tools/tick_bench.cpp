@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Cost of a ClockManager tick on the host, against the simulated board:
+// wall time per Tick() and the tick stats phase breakdown. Ticks run back to
+// back on the host clock, the board moves by the polling interval each time.
+
+#include "sim_sysmodule.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    struct Options {
+        std::uint32_t ticks = 20000;
+        std::uint32_t stepMs = 300;        // board time per tick
+        std::uint32_t loadPeriod = 50;     // ticks between load changes
+        bool enabled = true;
+    };
+
+    void Usage(const char* name) {
+        printf("Usage: %s [-n ticks] [-s step_ms] [-l load_period] [-d (disabled)]\n", name);
+    }
+
+    void Run(const Options& options) {
+        SimBoardModel model = SimBoard::DefaultModel();
+        model.applicationId = 0x0100000000010000ULL;
+        SimSysmodule sys(&model, false);
+        sys.Step(options.stepMs);
+
+        // A title profile, so ticks have clocks to apply and keep
+        HocClkBatchOp ops[4] = {};
+        std::uint32_t mhz[SysClkModule_EnumMax] = { 1785, 768, 1862 };
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++) {
+            ops[module].type = HocClkBatchOp_Profile;
+            ops[module].key = HOCCLK_BATCH_PROFILE_KEY(SysClkProfile_Handheld, module);
+            ops[module].tid = model.applicationId;
+            ops[module].value = mhz[module];
+        }
+        ops[3].type = HocClkBatchOp_Enabled;
+        ops[3].value = options.enabled;
+        HocClkBatchResult result;
+        sys.ApplyBatch(ops, 4, &result);
+        sys.Step(options.stepMs);
+
+        std::uint32_t seed = 0x2545F491;
+        std::vector<std::uint64_t> ns;
+        ns.reserve(options.ticks);
+        Clock::time_point start = Clock::now();
+        for (std::uint32_t i = 0; i < options.ticks; i++) {
+            if (options.loadPeriod && i % options.loadPeriod == 0) {
+                for (auto& load : model.load) {
+                    seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+                    load = seed % 1001;
+                }
+                SimBoard::SetModel(&model);
+            }
+
+            Clock::time_point before = Clock::now();
+            sys.Step(options.stepMs);
+            ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count());
+        }
+        double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::sort(ns.begin(), ns.end());
+        auto at = [&](double p) { return ns[(size_t)(p * (ns.size() - 1))] / 1000.; };
+        std::uint64_t total = 0;
+        for (std::uint64_t t : ns) {
+            total += t;
+        }
+        printf("%u ticks  mean %7.1f us  p50 %7.1f us  p99 %7.1f us  max %7.1f us  %.0f ticks/s\n",
+               options.ticks, total / 1000. / ns.size(), at(.5), at(.99), ns.back() / 1000., options.ticks / elapsed);
+
+        HocClkTickStats stats;
+        if (!sys.clockMgr->GetTickStats(&stats)) {
+            return;
+        }
+        for (unsigned int phase = 0; phase < HocClkTickPhase_EnumMax; phase++) {
+            const HocClkTickPhaseStats* p = &stats.phases[phase];
+            if (!p->count) {
+                continue;
+            }
+            printf("  %-14s %7u  p99 <= %6u us  max %6u us\n", hocClkFormatTickPhase((HocClkTickPhase)phase, false),
+                   p->count, hocClkTickStatsPercentileUs(p, 99), p->maxUs);
+        }
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:l:dh")) != -1) {
+        switch (opt) {
+            case 'n': options.ticks = std::max(1UL, strtoul(optarg, nullptr, 10)); break;
+            case 's': options.stepMs = strtoul(optarg, nullptr, 10); break;
+            case 'l': options.loadPeriod = strtoul(optarg, nullptr, 10); break;
+            case 'd': options.enabled = false; break;
+            default:  Usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    Run(options);
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Replays a tick_trace.csv recording through ClockManager under one or two
+// policies (config.ini files) and prints them side by side. Replayed with
+// the config.ini it was recorded with, no tick should be off the recording.
+
+#include "sim_replay.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+    void Usage(const char* name) {
+        printf("Usage: %s -a a.ini [-b b.ini] [-t thermal_limit_c] [-p power_limit_mw] [-o decisions.csv] tick_trace.csv\n", name);
+    }
+
+    bool ReadFile(const char* path, std::string* text) {
+        std::ifstream file(path);
+        if (!file)
+            return false;
+
+        std::stringstream stream;
+        stream << file.rdbuf();
+        *text = stream.str();
+        return true;
+    }
+
+    int g_columns = 1;
+
+    void Print(const std::string& label, double a, double b, const char* format) {
+        printf("  %-24s", label.c_str());
+        printf(format, a);
+        if (g_columns > 1)
+            printf(format, b);
+        printf("\n");
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const char* policyPaths[2] = {};
+    const char* decisionsPath = nullptr;
+    SimReplayLimits limits = SimReplayDefaultLimits();
+
+    int opt;
+    while ((opt = getopt(argc, argv, "a:b:t:p:o:h")) != -1) {
+        switch (opt) {
+            case 'a': policyPaths[0] = optarg; break;
+            case 'b': policyPaths[1] = optarg; break;
+            case 't': limits.thermalMilli = strtoul(optarg, nullptr, 10) * 1000; break;
+            case 'p': limits.powerMw = strtoul(optarg, nullptr, 10); break;
+            case 'o': decisionsPath = optarg; break;
+            default:  Usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (!policyPaths[0] || optind != argc - 1) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<TickTraceRow> rows;
+    if (!TickTraceLoad(argv[optind], &rows) || rows.empty()) {
+        fprintf(stderr, "%s: can't read trace\n", argv[optind]);
+        return 1;
+    }
+
+    SimReplayResult results[2] = {};
+    for (int i = 0; i < 2; i++) {
+        if (!policyPaths[i])
+            continue;
+
+        std::string policy;
+        if (!ReadFile(policyPaths[i], &policy)) {
+            fprintf(stderr, "%s: can't read policy\n", policyPaths[i]);
+            return 1;
+        }
+
+        // Decisions of the first policy only
+        FILE* decisions = nullptr;
+        if (i == 0 && decisionsPath && !(decisions = fopen(decisionsPath, "w"))) {
+            fprintf(stderr, "%s: can't write decisions\n", decisionsPath);
+            return 1;
+        }
+
+        bool ok = SimReplay(rows, policy, &limits, &results[i], decisions);
+        if (decisions)
+            fclose(decisions);
+        if (!ok) {
+            fprintf(stderr, "%s: replay failed\n", policyPaths[i]);
+            return 1;
+        }
+    }
+
+    g_columns = policyPaths[1] ? 2 : 1;
+    const SimReplayResult& ra = results[0];
+    const SimReplayResult& rb = results[1];
+
+    printf("%s: %zu ticks, %.1f s\n", argv[optind], rows.size(), ra.ns / 1e9);
+    printf("  %-24s%14s%14s\n", "", "a", g_columns > 1 ? "b" : "");
+    Print("energy (J)", ra.energyMj / 1000, rb.energyMj / 1000, "%14.1f");
+    for (int m = 0; m < SysClkModule_EnumMax; m++) {
+        std::string name = sysclkFormatModule((SysClkModule)m, true);
+        Print(name + " mean (MHz)", ra.meanMhz[m], rb.meanMhz[m], "%14.0f");
+        Print(name + " changes", ra.clockChanges[m], rb.clockChanges[m], "%14.0f");
+    }
+    Print("max SoC (C)", ra.maxSocMilli / 1000., rb.maxSocMilli / 1000., "%14.1f");
+    Print("over thermal limit (s)", ra.overThermalNs / 1e9, rb.overThermalNs / 1e9, "%14.1f");
+    Print("over power limit (s)", ra.overPowerNs / 1e9, rb.overPowerNs / 1e9, "%14.1f");
+    Print("ticks off the recording", ra.divergedTicks, rb.divergedTicks, "%14.0f");
+
+    return 0;
+}
@@ -67,7 +67,8 @@ typedef struct
     IpcServerRequestData data;
 } IpcServerRequest;
 
-typedef Result (*IpcServerRequestHandler)(void* userdata, const IpcServerRequest* r, u8* out_data, size_t* out_dataSize);
+// out_handle starts as INVALID_HANDLE, anything else is sent back as a copy handle
+typedef Result (*IpcServerRequestHandler)(void* userdata, const IpcServerRequest* r, u8* out_data, size_t* out_dataSize, Handle* out_handle);
 
 Result ipcServerInit(IpcServer* server, const char* name, u32 max_sessions);
 Result ipcServerExit(IpcServer* server);
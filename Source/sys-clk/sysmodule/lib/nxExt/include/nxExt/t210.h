@@ -40,6 +40,10 @@ u32 t210ClkGpuFreq(void);
 u32 t210EmcLoadAll(void);
 u32 t210EmcLoadCpu(void);
 
+// Last actmon period only (no averaging, no refresh), false until actmon runs
+bool t210EmcLoadRaw(u32* out_all, u32* out_cpu, u32* out_mem_freq);
+u32 t210ActmonPeriodMs(void);
+
 #ifdef __cplusplus
 }
 #endif
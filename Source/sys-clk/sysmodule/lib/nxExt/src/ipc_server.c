@@ -116,14 +116,21 @@ static Result _ipcServerParseRequest(IpcServerRequest* r)
     return 0;
 }
 
-static void _ipcServerPrepareResponse(Result rc, void* data, size_t dataSize)
+static void _ipcServerPrepareResponse(Result rc, void* data, size_t dataSize, Handle handle)
 {
     u8* base = armGetTls();
+    bool sendHandle = R_SUCCEEDED(rc) && handle != INVALID_HANDLE;
     HipcRequest hipc = hipcMakeRequestInline(base,
         .type = CmifCommandType_Request,
         .num_data_words = (sizeof(IpcServerRawHeader) + dataSize + 0x10) / 4,
+        .num_copy_handles = sendHandle ? 1 : 0,
     );
 
+    if(sendHandle)
+    {
+        hipc.copy_handles[0] = handle;
+    }
+
     IpcServerRawHeader* rawHeader = cmifGetAlignedDataStart(hipc.data_words, base);
     rawHeader->magic = CMIF_OUT_HEADER_MAGIC;
     rawHeader->result = rc;
@@ -151,6 +158,7 @@ static Result _ipcServerProcessSession(IpcServer* server, IpcServerRequestHandle
     IpcServerRequest r;
     size_t dataSize = 0;
     u8 data[IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE];
+    Handle handle = INVALID_HANDLE;
     bool close = false;
 
     Result rc = svcReplyAndReceive(&unusedIndex, &server->handles[handleIndex], 1, 0, UINT64_MAX);
@@ -165,17 +173,18 @@ static Result _ipcServerProcessSession(IpcServer* server, IpcServerRequestHandle
         {
             case CmifCommandType_Request:
                 _ipcServerPrepareResponse(
-                    handler(userdata, &r, data, &dataSize),
+                    handler(userdata, &r, data, &dataSize, &handle),
                     data,
-                    dataSize
+                    dataSize,
+                    handle
                 );
                 break;
             case CmifCommandType_Close:
-                _ipcServerPrepareResponse(0, NULL, 0);
+                _ipcServerPrepareResponse(0, NULL, 0, INVALID_HANDLE);
                 close = true;
                 break;
             default:
-                _ipcServerPrepareResponse(MAKERESULT(11, 403), NULL, 0);
+                _ipcServerPrepareResponse(MAKERESULT(11, 403), NULL, 0, INVALID_HANDLE);
                 break;
         }
 
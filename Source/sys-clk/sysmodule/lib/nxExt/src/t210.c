@@ -163,6 +163,13 @@ static void _actmon_dev_enable(actmon_dev_t dev, u32 freq, u32 weight)
     regs->ctrl = ACTMON_DEV_CTRL_ENB | ACTMON_DEV_CTRL_ENB_PERIODIC | ACTMON_DEV_CTRL_K_VAL(3); // 8 samples average.
 }
 
+static u32 _actmon_dev_get_count(actmon_dev_t dev)
+{
+    actmon_dev_reg_t *regs = (actmon_dev_reg_t *)(ACTMON_DEV_BASE + (dev * ACTMON_DEV_SIZE));
+
+    return regs->count;
+}
+
 static u32 _actmon_dev_get_count_avg(actmon_dev_t dev)
 {
     actmon_dev_reg_t *regs = (actmon_dev_reg_t *)(ACTMON_DEV_BASE + (dev * ACTMON_DEV_SIZE));
@@ -287,3 +294,24 @@ u32 t210EmcLoadCpu()
     _clock_update_freqs();
     return g_emc_lcpu;
 }
+
+bool t210EmcLoadRaw(u32* out_all, u32* out_cpu, u32* out_mem_freq)
+{
+    // Safe from another thread: only reads actmon and the cached EMC clock, the refresh is left to the getters above
+    u32 mem_freq = g_mem_freq;
+    u32 emc_freq = mem_freq / 1000;
+    if (!g_act_base || !emc_freq || (ACTMON(ACTMON_GLB_STATUS) & (ACTMON_MCALL_MON_ACT | ACTMON_MCCPU_MON_ACT)) != (ACTMON_MCALL_MON_ACT | ACTMON_MCCPU_MON_ACT))
+    {
+        return false;
+    }
+
+    *out_all = (u64)_actmon_dev_get_count(ACTMON_DEV_MC_ALL) * 10 * 100 / (emc_freq * ACTMON_PERIOD_MS);
+    *out_cpu = (u64)_actmon_dev_get_count(ACTMON_DEV_MC_CPU) * 10 * 100 / (emc_freq * ACTMON_PERIOD_MS);
+    *out_mem_freq = mem_freq;
+    return true;
+}
+
+u32 t210ActmonPeriodMs(void)
+{
+    return ACTMON_PERIOD_MS;
+}
@@ -25,21 +25,26 @@
  */
 
 
+#include <algorithm>
 #include <nxExt.h>
 #include "board.h"
 #include "errors.h"
 #include "rgltr.h"
 #include "rgltr_services.h"
 #include "pcv_types.h"
+#include "file_utils.h"
+#include "notification.h"
 
 #define HOSSVC_HAS_CLKRST (hosversionAtLeast(8,0,0))
 #define HOSSVC_HAS_TC (hosversionAtLeast(5,0,0))
+#define HOSSVC_HAS_CHARGE_INFO (hosversionAtLeast(10,0,0))
 #define NVGPU_GPU_IOCTL_PMU_GET_GPU_LOAD 0x80044715
 
-Result nvCheck = 1;
-u32 fd = 0;
+static bool g_nvOpen = false;
+static u32 g_nvGpuFd = 0;
 
 static SysClkSocType g_socType = SysClkSocType_Erista;
+static std::uint64_t g_deviceId = 0;
 
 const char* Board::GetModuleName(SysClkModule module, bool pretty)
 {
@@ -126,10 +131,25 @@ void Board::Initialize()
 
     rc = rgltrInitialize();
     ASSERT_RESULT_OK(rc, "rgltrInitialize");
-    // u32 fd = 0;
-
-    // if (R_SUCCEEDED(nvInitialize())) nvCheck = nvOpen(&fd, "/dev/nvhost-ctrl-gpu");
 
+    // GPU load is optional, keep going without it
+    rc = nvInitialize();
+    if (R_SUCCEEDED(rc))
+    {
+        rc = nvOpen(&g_nvGpuFd, "/dev/nvhost-ctrl-gpu");
+        if (R_SUCCEEDED(rc))
+        {
+            g_nvOpen = true;
+        }
+        else
+        {
+            nvExit();
+        }
+    }
+    if (!g_nvOpen)
+    {
+        FileUtils::LogLine("[brd] GPU load unavailable: [0x%x] %04d-%04d", rc, R_MODULE(rc), R_DESCRIPTION(rc));
+    }
 
     FetchHardwareInfos();
 }
@@ -156,7 +176,13 @@ void Board::Exit()
     max17050Exit();
     tmp451Exit();
     rgltrExit();
-    // nvExit();
+
+    if (g_nvOpen)
+    {
+        nvClose(g_nvGpuFd);
+        nvExit();
+        g_nvOpen = false;
+    }
 }
 
 SysClkProfile Board::GetProfile()
@@ -170,10 +196,7 @@ SysClkProfile Board::GetProfile()
         return SysClkProfile_Docked;
     }
 
-    PsmChargerType chargerType;
-
-    rc = psmGetChargerType(&chargerType);
-    ASSERT_RESULT_OK(rc, "psmGetChargerType");
+    PsmChargerType chargerType = Board::GetChargerType();
 
     if(chargerType == PsmChargerType_EnoughPower)
     {
@@ -481,20 +504,18 @@ std::int32_t Board::GetPowerMw(SysClkPowerSensor sensor)
 
 std::uint32_t Board::GetPartLoad(SysClkPartLoad loadSource)
 {
-    // u32 temp, GPU_Load_u = 0;
+    std::uint32_t load = 0;
 
     switch(loadSource)
     {
-        case HocClkVoltage_CPU:
-            rlgtr
+        case SysClkPartLoad_EMC:
             return t210EmcLoadAll();
         case SysClkPartLoad_EMCCpu:
             return t210EmcLoadCpu();
-        // case HocClkPartLoad_GPU:
-        // 	#define gpu_samples_average 10
-        //     // nvIoctl(fd, NVGPU_GPU_IOCTL_PMU_GET_GPU_LOAD, &temp);
-        //     GPU_Load_u = ((GPU_Load_u * (gpu_samples_average-1)) + temp) / gpu_samples_average;
-        //     return GPU_Load_u / 10;
+        case HocClkPartLoad_GPU:
+            // Raw PMU reading, ClockManager rate limits and smooths it
+            Board::GetGpuLoad(&load);
+            return load;
         default:
             ASSERT_ENUM_VALID(SysClkPartLoad, loadSource);
     }
@@ -502,6 +523,37 @@ std::uint32_t Board::GetPartLoad(SysClkPartLoad loadSource)
     return 0;
 }
 
+bool Board::GetGpuLoad(std::uint32_t* outLoad)
+{
+    if (!g_nvOpen)
+    {
+        return false;
+    }
+
+    u32 load = 0;
+    if (R_FAILED(nvIoctl(g_nvGpuFd, NVGPU_GPU_IOCTL_PMU_GET_GPU_LOAD, &load)))
+    {
+        return false;
+    }
+
+    *outLoad = load;
+    return true;
+}
+
+bool Board::GetCpuIdleTicks(std::uint64_t* outTicks)
+{
+    for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+    {
+        Result rc = svcGetInfo(&outTicks[core], InfoType_IdleTickCount, INVALID_HANDLE, core);
+        if (R_FAILED(rc))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /*
 * Switch Power domains (max77620):
 * Name  | Usage         | uV step | uV min | uV default | uV max  | Init
@@ -594,11 +646,131 @@ std::uint32_t Board::GetVoltage(HocClkVoltage voltage)
     return 0;
 }
 
+void Board::SetVoltage(HocClkVoltage voltage, std::uint32_t uv)
+{
+    // Only SD1 (EMC VDD2) is written directly, over I2C
+    if(voltage != HocClkVoltage_EMCVDD2)
+    {
+        ASSERT_ENUM_VALID(HocClkVoltage, voltage);
+        return;
+    }
+
+    // SD1 parameters
+    const u32 uv_step = 12500;
+    const u32 uv_min = 600000;
+    const u32 uv_max = 1237500;
+    const u8 volt_addr = 0x17;      // MAX77620_REG_SD1
+    const u8 volt_mask = 0x7F;      // MAX77620_SD1_VOLT_MASK
+
+    if (uv < uv_min || uv > uv_max)
+        return;
+
+    u32 mult = (uv + uv_step - 1 - uv_min) / uv_step;
+    mult = mult & volt_mask;
+
+    I2cSession session;
+    Result res = i2cOpenSession(&session, I2cDevice_Max77620Pmic);
+    if (R_FAILED(res)) {
+        return;
+    }
+
+    u8 current_val = 0;
+    res = i2csessionSendAuto(&session, &volt_addr, 1, I2cTransactionOption_Start);
+    if (R_FAILED(res)) {
+        Notifications::Post("I2C write failed. This may be a hardware issue");
+        i2csessionClose(&session);
+        return;
+    }
+
+    res = i2csessionReceiveAuto(&session, &current_val, 1, I2cTransactionOption_Stop);
+    if (R_FAILED(res)) {
+        Notifications::Post("I2C read failed. This may be a hardware issue");
+        i2csessionClose(&session);
+        return;
+    }
+
+    // Mask in the new voltage bits, preserving other bits
+    u8 new_val = (current_val & ~volt_mask) | mult;
+
+    // Write back register with START and STOP conditions
+    u8 write_buf[2] = {volt_addr, new_val};
+    res = i2csessionSendAuto(&session, write_buf, sizeof(write_buf), I2cTransactionOption_All);
+    if (R_FAILED(res)) {
+        Notifications::Post("I2C write failed. This may be a hardware issue");
+        i2csessionClose(&session);
+        return;
+    }
+    i2csessionClose(&session);
+}
+
+std::uint32_t Board::GetPerformanceConfiguration()
+{
+    std::uint32_t confId = 0;
+    Result rc = apmExtGetCurrentPerformanceConfiguration(&confId);
+    ASSERT_RESULT_OK(rc, "apmExtGetCurrentPerformanceConfiguration");
+
+    return confId;
+}
+
+bool Board::IsBoostMode()
+{
+    return apmExtIsBoostMode(Board::GetPerformanceConfiguration());
+}
+
+PsmChargerType Board::GetChargerType()
+{
+    PsmChargerType chargerType;
+    Result rc = psmGetChargerType(&chargerType);
+    ASSERT_RESULT_OK(rc, "psmGetChargerType");
+
+    return chargerType;
+}
+
+bool Board::GetChargeStatus(std::int32_t* outContractMw, std::int32_t* outChargeMw, std::uint32_t* outBatteryPcm)
+{
+    if(!HOSSVC_HAS_CHARGE_INFO)
+    {
+        return false;
+    }
+
+    PsmChargeInfo info;
+    Result rc = serviceDispatchOut(psmGetServiceSession(), Psm_GetBatteryChargeInfoFields, info);
+    if(R_FAILED(rc))
+    {
+        return false;
+    }
+
+    // The sink side is capped below the contract in handheld
+    std::int32_t currentMa = std::min(info.ChargerCurrentLimit, info.InputCurrentLimit);
+    *outContractMw = PsmIsChargerConnected(&info) ? info.ChargerVoltageLimit * currentMa / 1000 : 0;
+    *outChargeMw = info.ChargeCurrentLimit * info.VoltageAvg / 1000;
+    *outBatteryPcm = std::max(info.RawBatteryCharge, 0);
+    return true;
+}
+
+AppletOperationMode Board::GetOperationMode()
+{
+    return appletGetOperationMode();
+}
+
+bool Board::GetEmcLoadRaw(std::uint32_t* outAll, std::uint32_t* outCpu, std::uint32_t* outMemHz)
+{
+    return t210EmcLoadRaw(outAll, outCpu, outMemHz);
+}
+
+std::uint32_t Board::GetActmonPeriodMs()
+{
+    return t210ActmonPeriodMs();
+}
 
 SysClkSocType Board::GetSocType() {
     return g_socType;
 }
 
+std::uint64_t Board::GetDeviceId() {
+    return g_deviceId;
+}
+
 
 void Board::FetchHardwareInfos()
 {
@@ -609,6 +781,12 @@ void Board::FetchHardwareInfos()
     rc = splGetConfig(SplConfigItem_HardwareType, &sku);
     ASSERT_RESULT_OK(rc, "splGetConfig");
 
+    // Only used to tell consoles apart, no need to fail over it
+    if(R_FAILED(splGetConfig(SplConfigItem_DeviceId, &g_deviceId)))
+    {
+        g_deviceId = 0;
+    }
+
     splExit();
 
     switch(sku)
@@ -52,8 +52,22 @@ class Board
     static std::uint32_t GetTemperatureMilli(SysClkThermalSensor sensor);
     static std::int32_t GetPowerMw(SysClkPowerSensor sensor);
     static std::uint32_t GetPartLoad(SysClkPartLoad load);
+    static bool GetGpuLoad(std::uint32_t* outLoad);
+    static bool GetCpuIdleTicks(std::uint64_t* outTicks);
     static std::uint32_t GetVoltage(HocClkVoltage voltage);
+    static void SetVoltage(HocClkVoltage voltage, std::uint32_t uv);
+    static std::uint32_t GetPerformanceConfiguration();
+    static bool IsBoostMode();
+    static PsmChargerType GetChargerType();
+    // Charger contract and battery charging power in mW, charge in pcm (100% = 100000)
+    // False when psm can't tell (before 10.0.0, or failing), outputs untouched
+    static bool GetChargeStatus(std::int32_t* outContractMw, std::int32_t* outChargeMw, std::uint32_t* outBatteryPcm);
+    static AppletOperationMode GetOperationMode();
+    // Last actmon period, see t210EmcLoadRaw
+    static bool GetEmcLoadRaw(std::uint32_t* outAll, std::uint32_t* outCpu, std::uint32_t* outMemHz);
+    static std::uint32_t GetActmonPeriodMs();
     static SysClkSocType GetSocType();
+    static std::uint64_t GetDeviceId();
 
   protected:
     static void FetchHardwareInfos();
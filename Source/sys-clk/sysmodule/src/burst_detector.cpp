@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "burst_detector.h"
+
+BurstDetector::BurstDetector()
+{
+    this->Reset();
+}
+
+void BurstDetector::Reset()
+{
+    this->state = State_Idle;
+    this->pending = false;
+    this->pendingNs = 0;
+    this->startNs = 0;
+    this->lastLoadNs = 0;
+    this->cooldownEndNs = 0;
+    this->burstCount = 0;
+    this->lastBurstNs = 0;
+    this->totalBurstNs = 0;
+}
+
+bool BurstDetector::IsLoadPhase(const BurstSample* sample)
+{
+    return sample->emcLoad >= BURST_DETECTOR_ENTER_EMC &&
+           sample->emcCpuLoad >= BURST_DETECTOR_ENTER_EMC_CPU &&
+           (!sample->hasCpuLoad || sample->cpuLoad >= BURST_DETECTOR_ENTER_CPU);
+}
+
+bool BurstDetector::IsStillLoading(const BurstSample* sample)
+{
+    return sample->boostMode ||
+           (sample->emcLoad >= BURST_DETECTOR_EXIT_EMC &&
+            sample->emcCpuLoad >= BURST_DETECTOR_EXIT_EMC_CPU &&
+            (!sample->hasCpuLoad || sample->cpuLoad >= BURST_DETECTOR_EXIT_CPU));
+}
+
+void BurstDetector::Start(std::uint64_t ns)
+{
+    this->state = State_Burst;
+    this->startNs = ns;
+    this->lastLoadNs = ns;
+    this->pending = false;
+    this->burstCount++;
+}
+
+void BurstDetector::Stop(std::uint64_t ns, bool cooldown)
+{
+    this->lastBurstNs = ns - this->startNs;
+    this->totalBurstNs += this->lastBurstNs;
+    this->state = cooldown ? State_Cooldown : State_Idle;
+    this->cooldownEndNs = ns + BURST_DETECTOR_COOLDOWN_NS;
+    this->pending = false;
+}
+
+bool BurstDetector::Update(const BurstSample* sample, std::uint64_t maxNs)
+{
+    std::uint64_t ns = sample->ns;
+
+    switch (this->state)
+    {
+    case State_Cooldown:
+        // The phase that was cut has to end too, or a long load would just burst again
+        if (ns < this->cooldownEndNs || IsStillLoading(sample))
+        {
+            break;
+        }
+        this->state = State_Idle;
+        // fall through
+    case State_Idle:
+        if (sample->guarded)
+        {
+            this->pending = false;
+        }
+        else if (sample->boostMode)
+        {
+            this->Start(ns);
+        }
+        else if (IsLoadPhase(sample))
+        {
+            if (!this->pending)
+            {
+                this->pending = true;
+                this->pendingNs = ns;
+            }
+            else if (ns - this->pendingNs >= BURST_DETECTOR_ENTER_NS)
+            {
+                this->Start(ns);
+            }
+        }
+        else
+        {
+            this->pending = false;
+        }
+        break;
+    case State_Burst:
+        if (sample->guarded || ns - this->startNs >= maxNs)
+        {
+            this->Stop(ns, true);
+        }
+        else if (IsStillLoading(sample))
+        {
+            this->lastLoadNs = ns;
+        }
+        else if (ns - this->lastLoadNs >= BURST_DETECTOR_EXIT_NS)
+        {
+            this->Stop(ns, false);
+        }
+        break;
+    }
+
+    return this->state == State_Burst;
+}
+
+bool BurstDetector::Active()
+{
+    return this->state == State_Burst;
+}
+
+std::uint32_t BurstDetector::GetBurstCount()
+{
+    return this->burstCount;
+}
+
+std::uint64_t BurstDetector::GetLastBurstNs()
+{
+    return this->lastBurstNs;
+}
+
+std::uint64_t BurstDetector::GetTotalBurstNs()
+{
+    return this->totalBurstNs;
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#define BURST_DETECTOR_ENTER_EMC 600        // permille
+#define BURST_DETECTOR_ENTER_EMC_CPU 250    // permille of the EMC bandwidth used by the CPU
+#define BURST_DETECTOR_ENTER_CPU 700        // permille, when a CPU load is known
+#define BURST_DETECTOR_EXIT_EMC 400
+#define BURST_DETECTOR_EXIT_EMC_CPU 150
+#define BURST_DETECTOR_EXIT_CPU 450
+#define BURST_DETECTOR_ENTER_NS 600000000ULL
+#define BURST_DETECTOR_EXIT_NS 1500000000ULL
+#define BURST_DETECTOR_COOLDOWN_NS 10000000000ULL
+
+typedef struct
+{
+    std::uint64_t ns;
+    std::uint32_t emcLoad;
+    std::uint32_t emcCpuLoad;
+    std::uint32_t cpuLoad;
+    bool hasCpuLoad;
+    bool boostMode;     // APM boost configuration, the system itself says it is loading
+    bool guarded;       // thermal or power headroom is gone
+} BurstSample;
+
+/*
+ * Load phase detector.
+ *
+ * A load screen shows up as the CPU streaming decompressed data through the
+ * EMC: high memory load with a large CPU share, unlike rendering where the
+ * GPU owns the bandwidth. A burst starts once that has held for
+ * BURST_DETECTOR_ENTER_NS (or right away on APM boost), ends once the loads
+ * fall under the lower exit thresholds for BURST_DETECTOR_EXIT_NS, and never
+ * outlives maxNs. A burst cut short by maxNs or by the guard is followed by a
+ * cooldown, and the load phase it was part of has to end before the next.
+ */
+class BurstDetector
+{
+  public:
+    BurstDetector();
+
+    void Reset();
+
+    // Returns whether a burst is running after this sample
+    bool Update(const BurstSample* sample, std::uint64_t maxNs);
+
+    bool Active();
+    std::uint32_t GetBurstCount();
+    std::uint64_t GetLastBurstNs();
+    std::uint64_t GetTotalBurstNs();
+
+  protected:
+    enum State
+    {
+        State_Idle,
+        State_Burst,
+        State_Cooldown,
+    };
+
+    static bool IsLoadPhase(const BurstSample* sample);
+    static bool IsStillLoading(const BurstSample* sample);
+    void Start(std::uint64_t ns);
+    void Stop(std::uint64_t ns, bool cooldown);
+
+    State state;
+    bool pending;
+    std::uint64_t pendingNs;
+    std::uint64_t startNs;
+    std::uint64_t lastLoadNs;
+    std::uint64_t cooldownEndNs;
+    std::uint32_t burstCount;
+    std::uint64_t lastBurstNs;
+    std::uint64_t totalBurstNs;
+};
@@ -34,7 +34,17 @@
 #include "errors.h"
 #include "ipc_service.h"
 
-#define HOSPPC_HAS_BOOST (hosversionAtLeast(7,0,0))
+#define LEARNED_STATE_SAVE_INTERVAL_NS 300000000000ULL
+#define LOAD_BURST_THERMAL_MARGIN_MILLI 5000
+
+// Closes the running tick phase and opens the next one, nothing without tick stats
+#ifdef HOCCLK_TICK_STATS
+#define TICK_PHASE(phase) this->MarkTickPhase(HocClkTickPhase_##phase)
+#define TICK_PHASE_END() this->MarkTickPhase(HocClkTickPhase_EnumMax)
+#else
+#define TICK_PHASE(phase)
+#define TICK_PHASE_END()
+#endif
 
 bool HAS_TDP_BEEN_FIRED = false;
 bool HAS_EBL_BEEN_FIRED = false;
@@ -77,24 +87,79 @@ ClockManager::ClockManager()
         this->context->overrideFreqs[module] = 0;
         this->RefreshFreqTableRow((SysClkModule)module);
     }
+    for (unsigned int loadSource = 0; loadSource < SysClkPartLoad_EnumMax; loadSource++)
+    {
+        this->context->partLoad[loadSource] = 0;
+    }
+    for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+    {
+        this->context->cpuCoreLoad[core] = 0;
+    }
 
     this->running = false;
     this->lastTempLogNs = 0;
     this->lastCsvWriteNs = 0;
+    this->lastPowerModelSaveNs = 0;
+    this->lastProfileLearnerSaveNs = 0;
+    this->burstApplied = false;
+    this->learnerLoadMask = 0;
+    memset(this->subscriberEvents, 0, sizeof(this->subscriberEvents));
+    this->publishedContext = *this->context;
+    hocClkContextGenerationsInit(&this->publishedGenerations);
+    ueventCreate(&this->tickEvent, true);
+#ifdef HOCCLK_TICK_STATS
+    this->tickPhase = HocClkTickPhase_EnumMax;
+    this->tickPhaseStart = 0;
+    this->lastTickStatsLogNs = 0;
+#endif
 
     this->rnxSync = new ReverseNXSync;
+
+    this->powerModel = new PowerModel;
+    if (this->powerModel->Load(FILE_POWER_MODEL_PATH, Board::GetDeviceId()))
+    {
+        FileUtils::LogLine("[mgr] Power model loaded: %u samples", this->powerModel->GetSampleCount());
+    }
+
+    this->profileLearner = new ProfileLearner;
+    if (this->profileLearner->Load(FILE_LEARNED_PROFILES_PATH))
+    {
+        FileUtils::LogLine("[mgr] Learned profiles loaded");
+    }
+
+    this->emcProfiler = new EmcProfiler;
+    this->emcProfiler->SetRunning(true);
 }
 
 ClockManager::~ClockManager()
 {
+    if (this->powerModel->IsDirty())
+    {
+        this->powerModel->Save(FILE_POWER_MODEL_PATH);
+    }
+
+    if (this->profileLearner->IsDirty())
+    {
+        this->profileLearner->Save(FILE_LEARNED_PROFILES_PATH);
+    }
+
+    for (unsigned int slot = 0; slot < CONTEXT_SUBSCRIPTION_SLOTS; slot++)
+    {
+        eventClose(&this->subscriberEvents[slot]);
+    }
+
+    delete this->emcProfiler;
+    delete this->powerModel;
+    delete this->profileLearner;
     delete this->config;
     delete this->context;
 }
 
 SysClkContext ClockManager::GetCurrentContext()
 {
-    std::scoped_lock lock{this->contextMutex};
-    return *this->context;
+    // The last finished tick, readers never wait for the one in progress
+    std::scoped_lock lock{this->publishedMutex};
+    return this->publishedContext;
 }
 
 Config *ClockManager::GetConfig()
@@ -133,36 +198,15 @@ bool ClockManager::IsAssignableHz(SysClkModule module, std::uint32_t hz)
     }
 }
 
-std::uint32_t ClockManager::GetMaxAllowedHz(SysClkModule module, SysClkProfile profile)
+std::uint32_t ClockManager::GetMaxAllowedHz(SysClkModule module)
 {
     if (this->config->GetConfigValue(HocClkConfigValue_UncappedClocks))
     {
         return 4294967294; // Integer limit, uncapped clocks ON
     }
-    else
-    {
-        if (module == SysClkModule_GPU)
-        {
-            if (profile < SysClkProfile_HandheldCharging)
-            {
-                switch(Board::GetSocType()) {
-                    case SysClkSocType_Erista:
-                        return 460800000;
-                    case SysClkSocType_Mariko:
-                        return 614400000;
-                    case SysClkSocType_MarikoLite:
-                        return 537600000;
-                    default:
-                        return 4294967294;
-                }
-            }
-            else if (profile <= SysClkProfile_HandheldChargingUSB)
-            {
-                return 768000000;
-            }
-        }
-    }
-    return 0;
+
+    // By what the charger and the battery can supply, 0 when uncapped
+    return this->powerBudget.GetMaxHz(module);
 }
 
 std::uint32_t ClockManager::GetNearestHz(SysClkModule module, std::uint32_t inHz, std::uint32_t maxHz)
@@ -233,14 +277,143 @@ void ClockManager::RefreshFreqTableRow(SysClkModule module)
 
 void ClockManager::Tick()
 {
-    
-    std::uint32_t mode = 0;
-    AppletOperationMode opMode = appletGetOperationMode();
-    Result rc = apmExtGetCurrentPerformanceConfiguration(&mode);
-    ASSERT_RESULT_OK(rc, "apmExtGetCurrentPerformanceConfiguration");
+    bool traced = FileUtils::IsTickTraceEnabled();
+    if (traced)
+    {
+        this->BeginTickTrace();
+    }
+
+#ifdef HOCCLK_TICK_STATS
+    std::uint64_t start = armGetSystemTick();
+    this->RunTick();
+    TICK_PHASE_END();
+
+    std::uint64_t end = armGetSystemTick();
+    if (traced)
+    {
+        this->EndTickTrace();
+    }
+
+    std::scoped_lock lock{this->tickStatsMutex};
+    this->tickStats.EndTick(armTicksToNs(end - start));
+
+    if (this->ConfigIntervalTimeout(HocClkConfigValue_TickStatsLogIntervalMs, armTicksToNs(end), &this->lastTickStatsLogNs))
+    {
+        HocClkTickStats stats;
+        this->tickStats.GetStats(&stats);
+        for (unsigned int phase = 0; phase < HocClkTickPhase_EnumMax; phase++)
+        {
+            const HocClkTickPhaseStats* phaseStats = &stats.phases[phase];
+            if (phaseStats->count)
+            {
+                FileUtils::LogLine("[mgr] Tick %s: last %u us, p50 %u us, p99 %u us, max %u us (%u runs)",
+                    hocClkFormatTickPhase((HocClkTickPhase)phase, false), phaseStats->lastUs,
+                    hocClkTickStatsPercentileUs(phaseStats, 50), hocClkTickStatsPercentileUs(phaseStats, 99),
+                    phaseStats->maxUs, phaseStats->count);
+            }
+        }
+    }
+#else
+    this->RunTick();
+    if (traced)
+    {
+        this->EndTickTrace();
+    }
+#endif
+}
+
+void ClockManager::BeginTickTrace()
+{
+    TickTraceRow* row = &this->tickTrace;
+    row->ns = armTicksToNs(armGetSystemTick());
+    row->applicationId = ProcessManagement::GetCurrentApplicationId();
+    row->socType = Board::GetSocType();
+    row->profile = Board::GetProfile();
+    row->operationMode = Board::GetOperationMode();
+    row->chargerType = Board::GetChargerType();
+    row->apmConfiguration = Board::GetPerformanceConfiguration();
+    if (!Board::GetChargeStatus(&row->contractMw, &row->chargeMw, &row->batteryPcm))
+    {
+        row->contractMw = 0;
+        row->chargeMw = 0;
+        row->batteryPcm = 0;
+    }
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        row->hzIn[module] = Board::GetHz((SysClkModule)module);
+    }
+
+    for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+    {
+        row->temps[sensor] = Board::GetTemperatureMilli((SysClkThermalSensor)sensor);
+    }
+
+    for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
+    {
+        row->power[sensor] = Board::GetPowerMw((SysClkPowerSensor)sensor);
+    }
+
+    row->emcLoad = Board::GetPartLoad(SysClkPartLoad_EMC);
+    row->emcCpuLoad = Board::GetPartLoad(SysClkPartLoad_EMCCpu);
+    if (!Board::GetGpuLoad(&row->gpuLoad))
+    {
+        row->gpuLoad = 0;
+    }
+
+    if (!Board::GetCpuIdleTicks(row->cpuIdleTicks))
+    {
+        memset(row->cpuIdleTicks, 0, sizeof(row->cpuIdleTicks));
+    }
+}
+
+void ClockManager::EndTickTrace()
+{
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        this->tickTrace.hz[module] = Board::GetHz((SysClkModule)module);
+    }
+
+    FileUtils::WriteTickTrace(&this->tickTrace);
+}
+
+#ifdef HOCCLK_TICK_STATS
+void ClockManager::MarkTickPhase(HocClkTickPhase next)
+{
+    std::uint64_t tick = armGetSystemTick();
+    if (this->tickPhase != HocClkTickPhase_EnumMax)
+    {
+        this->tickStats.AddPhase(this->tickPhase, armTicksToNs(tick - this->tickPhaseStart));
+    }
+
+    this->tickPhase = next;
+    this->tickPhaseStart = tick;
+}
+#endif
+
+bool ClockManager::GetTickStats(HocClkTickStats* out_stats)
+{
+#ifdef HOCCLK_TICK_STATS
+    std::scoped_lock lock{this->tickStatsMutex};
+    this->tickStats.GetStats(out_stats);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ClockManager::RunTick()
+{
+    // Batches staged over IPC since the last tick, applied before any setting is read
+    this->config->ApplyStagedBatches();
+
+    TICK_PHASE(Apm);
+    AppletOperationMode opMode = Board::GetOperationMode();
+    bool boostMode = Board::IsBoostMode();
 
 
     if(this->config->GetConfigValue(HocClkConfigValue_EMCDVFS)) { 
+        TICK_PHASE(Sd1Voltage);
 
         #define DEFAULT_FREQ_MHZ 1600
         #define DEFAULT_FREQ_MHZ_M 1862
@@ -248,22 +421,24 @@ void ClockManager::Tick()
 
         if (Board::GetSocType() == SysClkSocType_Mariko) {
             if(ram_mhz > DEFAULT_FREQ_MHZ)
-                set_sd1_voltage(this->config->GetConfigValue(HocClkConfigValue_EMCVdd2VoltageUV));
+                Board::SetVoltage(HocClkVoltage_EMCVDD2, this->config->GetConfigValue(HocClkConfigValue_EMCVdd2VoltageUV));
             else
-                set_sd1_voltage(this->config->GetConfigValue(HocClkConfigValue_EMCVdd2VoltageUVStockMariko));
+                Board::SetVoltage(HocClkVoltage_EMCVDD2, this->config->GetConfigValue(HocClkConfigValue_EMCVdd2VoltageUVStockMariko));
         } else {
             if(ram_mhz > DEFAULT_FREQ_MHZ)
-                set_sd1_voltage(this->config->GetConfigValue(HocClkConfigValue_EMCVdd2VoltageUV));
+                Board::SetVoltage(HocClkVoltage_EMCVDD2, this->config->GetConfigValue(HocClkConfigValue_EMCVdd2VoltageUV));
             else
-                set_sd1_voltage(this->config->GetConfigValue(HocClkConfigValue_EMCVdd2VoltageUVStockErista));
+                Board::SetVoltage(HocClkVoltage_EMCVDD2, this->config->GetConfigValue(HocClkConfigValue_EMCVdd2VoltageUVStockErista));
         }
     }
 
+    // Early returns below leave it to Tick to close the phase
+    TICK_PHASE(Limits);
     if(this->config->GetConfigValue(HocClkConfigValue_HandheldTDP) && opMode == AppletOperationMode_Handheld) {
             if(Board::GetSocType() == SysClkSocType_MarikoLite) {
                 if(Board::GetPowerMw(SysClkPowerSensor_Avg) < -(int)this->config->GetConfigValue(HocClkConfigValue_LiteTDPLimit)) {
                     if(!HAS_TDP_BEEN_FIRED)
-                        writeNotification("Horizon OC\nTDP has been activated");
+                        Notifications::Post("Horizon OC\nTDP has been activated");
                     HAS_TDP_BEEN_FIRED = true;
                     ResetToStockClocks();
                     return;
@@ -273,7 +448,7 @@ void ClockManager::Tick()
             } else {
                 if(Board::GetPowerMw(SysClkPowerSensor_Avg) < -(int)this->config->GetConfigValue(HocClkConfigValue_HandheldTDPLimit)) {
                     if(!HAS_TDP_BEEN_FIRED)
-                        writeNotification("Horizon OC\nTDP has been activated");
+                        Notifications::Post("Horizon OC\nTDP has been activated");
                     HAS_TDP_BEEN_FIRED = true;
                     ResetToStockClocks();
                     return;
@@ -284,7 +459,7 @@ void ClockManager::Tick()
     } else if(opMode == AppletOperationMode_Console && this->config->GetConfigValue(HocClkConfigValue_EnforceBoardLimit)) {
         if(Board::GetPowerMw(SysClkPowerSensor_Avg) < 0) {
             if(!HAS_EBL_BEEN_FIRED)
-                writeNotification("Horizon OC\nBoard Limit has been exeeded");
+                Notifications::Post("Horizon OC\nBoard Limit has been exeeded");
             HAS_EBL_BEEN_FIRED = true;
             ResetToStockClocks();
             return;
@@ -294,9 +469,9 @@ void ClockManager::Tick()
     }
 
     if(this->config->GetConfigValue(HocClkConfigValue_ThermalThrottle)) {
-        if(tmp451TempSoc() / 1000 > (int)this->config->GetConfigValue(HocClkConfigValue_ThermalThrottleThreshold)) {
+        if(Board::GetTemperatureMilli(SysClkThermalSensor_SOC) / 1000 > this->config->GetConfigValue(HocClkConfigValue_ThermalThrottleThreshold)) {
             if(!HAS_TT_BEEN_FIRED)
-                writeNotification("Horizon OC\nThermal Throttle has started");
+                Notifications::Post("Horizon OC\nThermal Throttle has started");
             HAS_TT_BEEN_FIRED = true;
             ResetToStockClocks();
             return;
@@ -305,15 +480,23 @@ void ClockManager::Tick()
         }
     }
 
+    TICK_PHASE_END();
+
     std::scoped_lock lock{this->contextMutex};
-    if (this->RefreshContext() || this->config->Refresh())
+    bool hasChanged = this->RefreshContext();
+    TICK_PHASE(ConfigRefresh);
+    hasChanged |= this->config->Refresh();
+    TICK_PHASE_END();
+    hasChanged |= this->UpdateLoadBurst(boostMode);
+    if (hasChanged)
     {
         std::uint32_t targetHz = 0;
         std::uint32_t maxHz = 0;
         std::uint32_t nearestHz = 0;
 
-        if(apmExtIsBoostMode(mode) && !this->config->GetConfigValue(HocClkConfigValue_OverwriteBoostMode)) {
+        if(boostMode && !this->burstApplied && !this->config->GetConfigValue(HocClkConfigValue_OverwriteBoostMode)) {
             ResetToStockClocks();
+            this->PublishContext();
             return;
         }
 
@@ -331,11 +514,21 @@ void ClockManager::Tick()
                 if (!targetHz)
                 {
                     targetHz = this->config->GetAutoClockHz(this->context->applicationId, (SysClkModule)module, this->context->profile);
+
+                    if (this->burstApplied)
+                    {
+                        // Leave the GPU to the boost configuration, it drops it on purpose
+                        if (boostMode && module == SysClkModule_GPU)
+                        {
+                            continue;
+                        }
+                        targetHz = std::max(targetHz, this->GetBurstHz((SysClkModule)module));
+                    }
                 }
 
                 if (targetHz)
                 {
-                    maxHz = this->GetMaxAllowedHz((SysClkModule)module, this->context->profile);
+                    maxHz = this->GetMaxAllowedHz((SysClkModule)module);
                     nearestHz = this->GetNearestHz((SysClkModule)module, targetHz, maxHz);
                     if (nearestHz != this->context->freqs[module] && this->context->enabled) {
                         FileUtils::LogLine(
@@ -344,13 +537,17 @@ void ClockManager::Tick()
                             nearestHz / 1000000, nearestHz / 100000 - nearestHz / 1000000 * 10,
                             targetHz / 1000000, targetHz / 100000 - targetHz / 1000000 * 10);
 
+                        TICK_PHASE(SetHz);
                         Board::SetHz((SysClkModule)module, nearestHz);
+                        TICK_PHASE_END();
                         this->context->freqs[module] = nearestHz;
                 }
                 }
 
         }
     }
+
+    this->PublishContext();
 }
 
 void ClockManager::ResetToStockClocks() {
@@ -360,11 +557,19 @@ void ClockManager::ResetToStockClocks() {
 
 void ClockManager::WaitForNextTick()
 {
-    svcSleepThread(this->GetConfig()->GetConfigValue(SysClkConfigValue_PollingIntervalMs) * 1000000ULL);
+    // A batch staged during the tick already used up the wake-up
+    if (this->config->HasStagedBatches())
+    {
+        return;
+    }
+
+    // Cut short when a batch of changes has to be applied
+    waitSingle(waiterForUEvent(&this->tickEvent), this->GetConfig()->GetConfigValue(SysClkConfigValue_PollingIntervalMs) * 1000000ULL);
 }
 
 bool ClockManager::RefreshContext()
 {
+    TICK_PHASE(Context);
     bool hasChanged = false;
 
     bool enabled = this->GetConfig()->Enabled();
@@ -397,7 +602,11 @@ bool ClockManager::RefreshContext()
     {
         // this->rnxSync->ToggleSync(this->GetConfig()->GetConfigValue(HocClkConfigValue_SyncReverseNXMode));
         Board::ResetToStock();
+
+        // Settling time, not the context's
+        TICK_PHASE_END();
         this->WaitForNextTick();
+        TICK_PHASE(Context);
     }
 
     std::uint32_t hz = 0;
@@ -439,6 +648,7 @@ bool ClockManager::RefreshContext()
         }
     }
 
+    TICK_PHASE(Sensors);
     std::uint64_t ns = armTicksToNs(armGetSystemTick());
 
     // temperatures do not and should not force a refresh, hasChanged untouched
@@ -466,8 +676,10 @@ bool ClockManager::RefreshContext()
         }
         this->context->power[sensor] = mw;
     }
+    hasChanged |= this->UpdatePowerBudget(ns);
 
     // real freqs do not and should not force a refresh, hasChanged untouched
+    TICK_PHASE(RealFreqs);
     std::uint32_t realHz = 0;
     bool shouldLogFreq = this->ConfigIntervalTimeout(SysClkConfigValue_FreqLogIntervalMs, ns, &this->lastFreqLogNs);
     for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
@@ -481,75 +693,414 @@ bool ClockManager::RefreshContext()
     }
 
     // ram load do not and should not force a refresh, hasChanged untouched
+    TICK_PHASE(Sensors);
     for (unsigned int loadSource = 0; loadSource < SysClkPartLoad_EnumMax; loadSource++)
     {
+        // Sampled over time below
+        if (loadSource == HocClkPartLoad_GPU || loadSource == HocClkPartLoad_CPU)
+        {
+            continue;
+        }
         this->context->partLoad[loadSource] = Board::GetPartLoad((SysClkPartLoad)loadSource);
     }
+    this->UpdateCpuLoad();
+    this->UpdateGpuLoad(ns);
+    this->UpdateEmcProfiler();
 
     for (unsigned int voltageSource = 0; voltageSource < HocClkVoltage_EnumMax; voltageSource++)
     {
         this->context->voltages[voltageSource] = Board::GetVoltage((HocClkVoltage)voltageSource);
     }
 
+    TICK_PHASE(Models);
     if (this->ConfigIntervalTimeout(SysClkConfigValue_CsvWriteIntervalMs, ns, &this->lastCsvWriteNs))
     {
         FileUtils::WriteContextToCsv(this->context);
     }
 
+    this->UpdatePowerModel(ns);
+    this->UpdateProfileLearner(ns);
+    TICK_PHASE_END();
+
     return hasChanged;
 }
 
+void ClockManager::UpdateCpuLoad()
+{
+    std::uint64_t idleTicks[HOCCLK_CPU_CORE_COUNT];
+    if (!Board::GetCpuIdleTicks(idleTicks))
+    {
+        return;
+    }
+
+    this->cpuSampler.AddSample(armGetSystemTick(), idleTicks);
+
+    std::uint64_t windowTicks = armNsToTicks(this->config->GetConfigValue(HocClkConfigValue_CpuLoadWindowMs) * 1000000ULL);
+    this->cpuSampler.GetLoad(windowTicks, this->context->cpuCoreLoad, &this->context->partLoad[HocClkPartLoad_CPU]);
+}
+
+void ClockManager::UpdateGpuLoad(std::uint64_t ns)
+{
+    this->gpuLoadSmoother.SetParams(
+        this->config->GetConfigValue(HocClkConfigValue_GpuLoadSmoothing) ? LoadSmoother_Window : LoadSmoother_Ema,
+        this->config->GetConfigValue(HocClkConfigValue_GpuLoadSmoothMs) * 1000000ULL,
+        this->config->GetConfigValue(HocClkConfigValue_GpuLoadIntervalMs) * 1000000ULL);
+
+    std::uint32_t load = 0;
+    if (this->gpuLoadSmoother.Due(ns) && Board::GetGpuLoad(&load))
+    {
+        this->gpuLoadSmoother.AddSample(ns, load);
+    }
+
+    this->context->partLoad[HocClkPartLoad_GPU] = this->gpuLoadSmoother.Get();
+}
+
+void ClockManager::UpdateEmcProfiler()
+{
+    this->emcProfiler->SetApplicationId(this->context->applicationId);
+    this->emcProfiler->SetIntervalMs(this->config->GetConfigValue(HocClkConfigValue_EmcProfilerIntervalMs));
+    this->emcProfiler->SetEnabled(this->config->GetConfigValue(HocClkConfigValue_EmcProfiler));
+}
+
+bool ClockManager::UpdatePowerBudget(std::uint64_t ns)
+{
+    bool changed = this->powerBudget.SetCpuMemCaps(this->config->GetConfigValue(HocClkConfigValue_PowerBudgetCpuMemCaps));
+    changed |= this->powerBudget.SetBatteryAware(this->config->GetConfigValue(HocClkConfigValue_PowerBudgetBattery));
+
+    PowerBudgetInputs inputs;
+    if (!Board::GetChargeStatus(&inputs.contractMw, &inputs.chargeMw, &inputs.batteryPcm))
+    {
+        // Firmware without the charge info, or psm failing for now: the per profile caps
+        if (this->powerBudget.UpdateFallback(Board::GetSocType(), this->context->profile))
+        {
+            FileUtils::LogLine("[mgr] Power budget: no charge info, profile caps, max GPU %u MHz (0: uncapped)",
+                this->powerBudget.GetMaxHz(SysClkModule_GPU) / 1000000);
+            return true;
+        }
+        return changed;
+    }
+    inputs.batteryMw = this->context->power[SysClkPowerSensor_Avg];
+
+    if (!this->powerBudget.Update(Board::GetSocType(), &inputs, ns) && !changed)
+    {
+        return false;
+    }
+
+    FileUtils::LogLine("[mgr] Power budget: %d mW (charger %d mW, battery %u%%), max CPU %u MHz, GPU %u MHz, MEM %u MHz (0: uncapped)",
+        this->powerBudget.GetBudgetMw(), inputs.contractMw, inputs.batteryPcm / 1000,
+        this->powerBudget.GetMaxHz(SysClkModule_CPU) / 1000000, this->powerBudget.GetMaxHz(SysClkModule_GPU) / 1000000,
+        this->powerBudget.GetMaxHz(SysClkModule_MEM) / 1000000);
+    return true;
+}
+
+void ClockManager::UpdatePowerModel(std::uint64_t ns)
+{
+    // Only the battery discharge is the board's own draw, a charger hides it
+    if (this->context->profile == SysClkProfile_Handheld && this->context->power[SysClkPowerSensor_Now] < 0)
+    {
+        std::uint32_t hz[SysClkModule_EnumMax];
+        this->GetSampledHz(hz);
+
+        std::uint32_t uv[SysClkModule_EnumMax];
+        uv[SysClkModule_CPU] = this->context->voltages[HocClkVoltage_CPU];
+        uv[SysClkModule_GPU] = this->context->voltages[HocClkVoltage_GPU];
+        uv[SysClkModule_MEM] = this->context->voltages[HocClkVoltage_EMCVDD2];
+
+        std::scoped_lock lock{this->powerModelMutex};
+        this->powerModel->AddSample(hz, uv, -this->context->power[SysClkPowerSensor_Now]);
+    }
+
+    std::scoped_lock lock{this->powerModelMutex};
+    if (this->powerModel->IsDirty() && (ns - this->lastPowerModelSaveNs) > LEARNED_STATE_SAVE_INTERVAL_NS)
+    {
+        this->lastPowerModelSaveNs = ns;
+        if (!this->powerModel->Save(FILE_POWER_MODEL_PATH))
+        {
+            FileUtils::LogLine("[mgr] Power model save failed");
+        }
+    }
+}
+
+void ClockManager::GetSampledHz(std::uint32_t* hz)
+{
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        hz[module] = this->context->realFreqs[module] ? this->context->realFreqs[module] : this->context->freqs[module];
+    }
+}
+
+std::uint32_t ClockManager::GetLoadPermille(std::uint32_t* load)
+{
+    // Bit per module that has a load source
+    std::uint32_t mask = 0;
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        load[module] = 0;
+    }
+
+    load[SysClkModule_CPU] = this->context->partLoad[HocClkPartLoad_CPU];
+    mask |= 1 << SysClkModule_CPU;
+    if (this->gpuLoadSmoother.Primed())
+    {
+        load[SysClkModule_GPU] = this->context->partLoad[HocClkPartLoad_GPU];
+        mask |= 1 << SysClkModule_GPU;
+    }
+    load[SysClkModule_MEM] = this->context->partLoad[SysClkPartLoad_EMC];
+    mask |= 1 << SysClkModule_MEM;
+
+    return mask;
+}
+
+void ClockManager::UpdateProfileLearner(std::uint64_t ns)
+{
+    std::uint32_t load[SysClkModule_EnumMax];
+    std::uint32_t loadMask = this->GetLoadPermille(load);
+    this->learnerLoadMask = loadMask;
+
+    std::scoped_lock lock{this->learnerMutex};
+    std::uint64_t tid = this->context->applicationId;
+    if (this->context->enabled && tid && tid != PROCESS_MANAGEMENT_QLAUNCH_TID &&
+        this->config->GetConfigValue(HocClkConfigValue_ProfileLearning))
+    {
+        std::uint32_t hz[SysClkModule_EnumMax];
+        this->GetSampledHz(hz);
+
+        this->profileLearner->AddSample(tid, this->context->profile, hz, load, loadMask);
+    }
+
+    if (this->profileLearner->IsDirty() && (ns - this->lastProfileLearnerSaveNs) > LEARNED_STATE_SAVE_INTERVAL_NS)
+    {
+        this->lastProfileLearnerSaveNs = ns;
+        if (!this->profileLearner->Save(FILE_LEARNED_PROFILES_PATH))
+        {
+            FileUtils::LogLine("[mgr] Learned profiles save failed");
+        }
+    }
+}
+
+bool ClockManager::UpdateLoadBurst(bool boostMode)
+{
+    bool active = false;
+
+    if (this->context->enabled && this->config->GetConfigValue(HocClkConfigValue_LoadBurst))
+    {
+        std::uint32_t tdpLimitMw = this->config->GetConfigValue(Board::GetSocType() == SysClkSocType_MarikoLite ? HocClkConfigValue_LiteTDPLimit : HocClkConfigValue_HandheldTDPLimit);
+        std::uint32_t thermalLimitMilli = this->config->GetConfigValue(HocClkConfigValue_ThermalThrottleThreshold) * 1000;
+
+        BurstSample sample;
+        sample.ns = armTicksToNs(armGetSystemTick());
+        sample.emcLoad = this->context->partLoad[SysClkPartLoad_EMC];
+        sample.emcCpuLoad = this->context->partLoad[SysClkPartLoad_EMCCpu];
+        // Load screens usually decompress on one or two threads, the busiest core tells
+        sample.cpuLoad = 0;
+        for (unsigned int core = 0; core < CPU_SAMPLER_APPLICATION_CORES; core++)
+        {
+            sample.cpuLoad = std::max(sample.cpuLoad, this->context->cpuCoreLoad[core]);
+        }
+        sample.hasCpuLoad = true;
+        sample.boostMode = boostMode;
+        // Same limits as the thermal throttle and TDP, whether those are enabled or not
+        sample.guarded = this->context->temps[SysClkThermalSensor_SOC] + LOAD_BURST_THERMAL_MARGIN_MILLI >= thermalLimitMilli ||
+                         (this->context->profile == SysClkProfile_Handheld && this->context->power[SysClkPowerSensor_Avg] < -(std::int32_t)tdpLimitMw);
+
+        active = this->burstDetector.Update(&sample, this->config->GetConfigValue(HocClkConfigValue_LoadBurstMaxMs) * 1000000ULL);
+    }
+    else
+    {
+        this->burstDetector.Reset();
+    }
+
+    if (active == this->burstApplied)
+    {
+        return false;
+    }
+
+    this->burstApplied = active;
+    if (active)
+    {
+        FileUtils::LogLine("[mgr] Load burst started (%s)", boostMode ? "boost" : "load");
+    }
+    else
+    {
+        FileUtils::LogLine("[mgr] Load burst ended after %u ms", (std::uint32_t)(this->burstDetector.GetLastBurstNs() / 1000000ULL));
+
+        // Modules without a profile keep whatever was last set, hand them back
+        Board::ResetToStockCpu();
+        Board::ResetToStockMem();
+        this->context->freqs[SysClkModule_CPU] = Board::GetHz(SysClkModule_CPU);
+        this->context->freqs[SysClkModule_MEM] = Board::GetHz(SysClkModule_MEM);
+    }
+
+    return true;
+}
+
+std::uint32_t ClockManager::GetBurstHz(SysClkModule module)
+{
+    switch (module)
+    {
+    case SysClkModule_CPU:
+        return this->config->GetConfigValue(HocClkConfigValue_LoadBurstCpuMHz) * 1000000;
+    case SysClkModule_MEM:
+        return this->config->GetConfigValue(HocClkConfigValue_LoadBurstMemMHz) * 1000000;
+    default:
+        return 0;
+    }
+}
+
+void ClockManager::GetLearnedProfiles(std::uint64_t tid, HocClkLearnedProfileList* out_learned)
+{
+    // Only the learner's own lock, the IPC thread never waits for a tick
+    std::scoped_lock lock{this->learnerMutex};
+
+    std::uint32_t loadMask = this->learnerLoadMask;
+    std::uint32_t headroom = this->config->GetConfigValue(HocClkConfigValue_ProfileLearningHeadroom);
+
+    memset(out_learned, 0, sizeof(*out_learned));
+    for (unsigned int profile = 0; profile < SysClkProfile_EnumMax; profile++)
+    {
+        std::uint32_t samples = UINT32_MAX;
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            if (!(loadMask & (1 << module)))
+            {
+                continue;
+            }
+
+            samples = std::min(samples, this->profileLearner->GetSampleCount(tid, (SysClkProfile)profile, (SysClkModule)module));
+            out_learned->profiles.mhzMap[profile][module] = this->profileLearner->ProposeMHz(tid, (SysClkProfile)profile, (SysClkModule)module, headroom,
+                                                                                             this->freqTable[module].list, this->freqTable[module].count);
+        }
+        out_learned->samples[profile] = samples == UINT32_MAX ? 0 : samples;
+    }
+}
+
+std::int32_t ClockManager::EstimatePowerMw(const std::uint32_t* hz)
+{
+    // The model's own lock, the IPC thread never waits for a tick
+    std::scoped_lock lock{this->powerModelMutex};
+    return this->powerModel->EstimateMw(hz);
+}
+
+bool ClockManager::FindCheapestOperatingPoint(const std::uint32_t* minHz, std::uint32_t* outHz, std::int32_t* outMw)
+{
+    std::scoped_lock lock{this->powerModelMutex};
+    return this->powerModel->FindCheapest(minHz, outHz, outMw);
+}
+
 void ClockManager::SetRNXRTMode(ReverseNXMode mode)
 {
     this->rnxSync->SetRTMode(mode);
 }
 
-void ClockManager::set_sd1_voltage(uint32_t voltage_uv)
-{
-	// SD1 parameters
-	const u32 uv_step = 12500;
-	const u32 uv_min = 600000;
-	const u32 uv_max = 1237500;
-	const u8 volt_addr = 0x17;      // MAX77620_REG_SD1
-	const u8 volt_mask = 0x7F;      // MAX77620_SD1_VOLT_MASK
-
-	if (voltage_uv < uv_min || voltage_uv > uv_max)
-		return;
-
-	u32 mult = (voltage_uv + uv_step - 1 - uv_min) / uv_step;
-	mult = mult & volt_mask;
-
-	I2cSession session;
-	Result res = i2cOpenSession(&session, I2cDevice_Max77620Pmic);
-	if (R_FAILED(res)) {
-		return;
-	}
-
-	u8 current_val = 0;
-	res = i2csessionSendAuto(&session, &volt_addr, 1, I2cTransactionOption_Start);
-	if (R_FAILED(res)) {
-        writeNotification("I2C write failed. This may be a hardware issue");
-		i2csessionClose(&session);
-		return;
-	}
-
-	res = i2csessionReceiveAuto(&session, &current_val, 1, I2cTransactionOption_Stop);
-	if (R_FAILED(res)) {
-        writeNotification("I2C read failed. This may be a hardware issue");
-		i2csessionClose(&session);
-		return;
-	}
-
-	// Mask in the new voltage bits, preserving other bits
-	u8 new_val = (current_val & ~volt_mask) | mult;
-
-	// Write back register with START and STOP conditions
-	u8 write_buf[2] = {volt_addr, new_val};
-	res = i2csessionSendAuto(&session, write_buf, sizeof(write_buf), I2cTransactionOption_All);
-	if (R_FAILED(res)) {
-        writeNotification("I2C write failed. This may be a hardware issue");
-		i2csessionClose(&session);
-		return;
-	}
-	i2csessionClose(&session);
-}
\ No newline at end of file
+void ClockManager::GetEmcProfile(std::uint64_t tid, HocClkEmcProfile* out_profile)
+{
+    this->emcProfiler->GetProfile(tid, out_profile);
+}
+
+void ClockManager::PublishContext()
+{
+    {
+        // Any difference at all moves the field to the new generation
+        static const HocClkContextSubscription exact = {HOCCLK_CONTEXT_FIELD_ALL, 0, 0, 0, 0, 0};
+
+        std::scoped_lock lock{this->publishedMutex};
+        hocClkContextBump(&this->publishedGenerations, sysclkContextChangedFields(&this->publishedContext, this->context, &exact));
+        this->publishedContext = *this->context;
+    }
+
+    std::scoped_lock lock{this->subscriptionMutex};
+    std::uint32_t signal = this->subscriptions.Update(this->context, armTicksToNs(armGetSystemTick()));
+    for (unsigned int slot = 0; slot < CONTEXT_SUBSCRIPTION_SLOTS; slot++)
+    {
+        if (signal & (1 << slot))
+        {
+            eventFire(&this->subscriberEvents[slot]);
+        }
+    }
+}
+
+bool ClockManager::SubscribeContext(const HocClkContextSubscription* sub, std::uint32_t* outId, Handle* outEvent)
+{
+    // Measured against the last published context, what the subscriptions saw too
+    SysClkContext published = this->GetCurrentContext();
+    std::scoped_lock lock{this->subscriptionMutex};
+
+    unsigned int slot;
+    if (!this->subscriptions.Add(sub, &published, armTicksToNs(armGetSystemTick()), outId, &slot))
+    {
+        return false;
+    }
+
+    // A taken over slot still holds the event of the client that went away
+    eventClose(&this->subscriberEvents[slot]);
+    Result rc = eventCreate(&this->subscriberEvents[slot], false);
+    if (R_FAILED(rc))
+    {
+        this->subscriptions.Remove(*outId, &slot);
+        FileUtils::LogLine("[mgr] Subscription event: [0x%x]", rc);
+        return false;
+    }
+
+    *outEvent = this->subscriberEvents[slot].revent;
+    return true;
+}
+
+bool ClockManager::UnsubscribeContext(std::uint32_t id)
+{
+    std::scoped_lock lock{this->subscriptionMutex};
+
+    unsigned int slot;
+    if (!this->subscriptions.Remove(id, &slot))
+    {
+        return false;
+    }
+
+    eventClose(&this->subscriberEvents[slot]);
+    return true;
+}
+
+bool ClockManager::GetContextChanges(std::uint32_t id, HocClkContextChanges* out_changes)
+{
+    SysClkContext published = this->GetCurrentContext();
+    std::scoped_lock lock{this->subscriptionMutex};
+
+    if (!this->subscriptions.Collect(id, &published, out_changes))
+    {
+        return false;
+    }
+
+    eventClear(&this->subscriberEvents[id % CONTEXT_SUBSCRIPTION_SLOTS]);
+    return true;
+}
+
+bool ClockManager::ApplyBatch(const HocClkBatchOp* ops, std::uint32_t count, HocClkBatchResult* out_result)
+{
+    if (!hocClkCheckBatch(ops, count, out_result))
+    {
+        FileUtils::LogLine("[mgr] Batch of %u changes rejected", count);
+        return false;
+    }
+
+    // The tick applies it before anything else, so it sees all of the batch or none
+    // of it, and the IPC thread never waits for a tick in progress
+    if (!this->config->StageBatch(ops, count))
+    {
+        for (std::uint32_t i = 0; i < count; i++)
+        {
+            out_result->status[i] = SYSCLK_ERROR(BatchQueueFull);
+        }
+        FileUtils::LogLine("[mgr] Batch of %u changes dropped, the tick is behind", count);
+        return false;
+    }
+
+    ueventSignal(&this->tickEvent);
+    return true;
+}
+
+std::size_t ClockManager::GetContextDelta(std::uint32_t since, HocClkContextDelta* out_delta)
+{
+    std::scoped_lock lock{this->publishedMutex};
+
+    std::uint32_t fields = hocClkContextFieldsSince(&this->publishedGenerations, since);
+    return hocClkEncodeContextDelta(&this->publishedContext, fields, this->publishedGenerations.generation, out_delta);
+}
@@ -35,6 +35,16 @@
 #include "board.h"
 #include <nxExt/cpp/lockable_mutex.h>
 #include "integrations.h"
+#include "power_model.h"
+#include "power_budget.h"
+#include "profile_learner.h"
+#include "burst_detector.h"
+#include "cpu_sampler.h"
+#include "load_smoother.h"
+#include "emc_profiler.h"
+#include "context_subscriptions.h"
+#include "tick_stats.h"
+#include "tick_trace.h"
 
 class ReverseNXSync;
 
@@ -58,6 +68,16 @@ class ClockManager
     void ResetToStockClocks();
     void WaitForNextTick();
     void SetRNXRTMode(ReverseNXMode mode);
+    std::int32_t EstimatePowerMw(const std::uint32_t* hz);
+    bool FindCheapestOperatingPoint(const std::uint32_t* minHz, std::uint32_t* outHz, std::int32_t* outMw);
+    void GetLearnedProfiles(std::uint64_t tid, HocClkLearnedProfileList* out_learned);
+    void GetEmcProfile(std::uint64_t tid, HocClkEmcProfile* out_profile);
+    bool SubscribeContext(const HocClkContextSubscription* sub, std::uint32_t* outId, Handle* outEvent);
+    bool UnsubscribeContext(std::uint32_t id);
+    bool GetContextChanges(std::uint32_t id, HocClkContextChanges* out_changes);
+    bool ApplyBatch(const HocClkBatchOp* ops, std::uint32_t count, HocClkBatchResult* out_result);
+    std::size_t GetContextDelta(std::uint32_t since, HocClkContextDelta* out_delta);
+    bool GetTickStats(HocClkTickStats* out_stats);
     struct {
       std::uint32_t count;
       std::uint32_t list[SYSCLK_FREQ_LIST_MAX];
@@ -65,22 +85,66 @@ class ClockManager
 
   protected:
     bool IsAssignableHz(SysClkModule module, std::uint32_t hz);
-    std::uint32_t GetMaxAllowedHz(SysClkModule module, SysClkProfile profile);
+    std::uint32_t GetMaxAllowedHz(SysClkModule module);
     std::uint32_t GetNearestHz(SysClkModule module, std::uint32_t inHz, std::uint32_t maxHz);
     bool ConfigIntervalTimeout(SysClkConfigValue intervalMsConfigValue, std::uint64_t ns, std::uint64_t* lastLogNs);
     void RefreshFreqTableRow(SysClkModule module);
     bool RefreshContext();
-    void set_sd1_voltage(uint32_t voltage_uv);
+    void UpdateCpuLoad();
+    void UpdateGpuLoad(std::uint64_t ns);
+    void UpdateEmcProfiler();
+    bool UpdatePowerBudget(std::uint64_t ns);
+    void UpdatePowerModel(std::uint64_t ns);
+    void UpdateProfileLearner(std::uint64_t ns);
+    void GetSampledHz(std::uint32_t* hz);
+    std::uint32_t GetLoadPermille(std::uint32_t* load);
+    bool UpdateLoadBurst(bool boostMode);
+    std::uint32_t GetBurstHz(SysClkModule module);
+    void PublishContext();
+    void RunTick();
+    void BeginTickTrace();
+    void EndTickTrace();
+#ifdef HOCCLK_TICK_STATS
+    void MarkTickPhase(HocClkTickPhase next);
+#endif
 
     static ClockManager *instance;
 
     std::atomic_bool running;
     LockableMutex contextMutex;
+    LockableMutex publishedMutex;
+    LockableMutex learnerMutex;
+    LockableMutex powerModelMutex;
+    LockableMutex subscriptionMutex;
     Config* config;
     SysClkContext* context;
     std::uint64_t lastTempLogNs;
     std::uint64_t lastFreqLogNs;
     std::uint64_t lastPowerLogNs;
     std::uint64_t lastCsvWriteNs;
+    std::uint64_t lastPowerModelSaveNs;
+    std::uint64_t lastProfileLearnerSaveNs;
     ReverseNXSync *rnxSync;
+    PowerModel* powerModel;
+    PowerBudget powerBudget;
+    ProfileLearner* profileLearner;
+    std::atomic_uint32_t learnerLoadMask;
+    EmcProfiler* emcProfiler;
+    BurstDetector burstDetector;
+    CpuSampler cpuSampler;
+    LoadSmoother gpuLoadSmoother;
+    bool burstApplied;
+    ContextSubscriptions subscriptions;
+    Event subscriberEvents[CONTEXT_SUBSCRIPTION_SLOTS];
+    SysClkContext publishedContext;
+    HocClkContextGenerations publishedGenerations;
+    UEvent tickEvent;
+    TickTraceRow tickTrace;
+#ifdef HOCCLK_TICK_STATS
+    TickStats tickStats;
+    LockableMutex tickStatsMutex;
+    HocClkTickPhase tickPhase;
+    std::uint64_t tickPhaseStart;
+    std::uint64_t lastTickStatsLogNs;
+#endif
 };
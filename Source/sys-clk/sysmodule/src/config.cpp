@@ -39,10 +39,14 @@ Config::Config(std::string path)
 {
     this->path = path;
     this->loaded = false;
-    this->profileMHzMap = std::map<std::tuple<std::uint64_t, SysClkProfile, SysClkModule>, std::uint32_t>();
-    this->profileCountMap = std::map<std::uint64_t, std::uint8_t>();
     this->mtime = 0;
     this->enabled = false;
+    this->writing = false;
+    this->changed = false;
+    this->writerRunning = false;
+    this->stagedCount[0] = 0;
+    this->stagedCount[1] = 0;
+    this->stagingSlot = 0;
     for(unsigned int i = 0; i < SysClkModule_EnumMax; i++)
     {
         this->overrideFreqs[i] = 0;
@@ -56,6 +60,17 @@ Config::Config(std::string path)
 
 Config::~Config()
 {
+    if(this->writerRunning)
+    {
+        this->writerRunning = false;
+        ueventSignal(&this->writerEvent);
+        threadWaitForExit(&this->writerThread);
+        threadClose(&this->writerThread);
+    }
+
+    // Whatever is still waiting for its delay goes out now
+    this->WritePending(true);
+
     std::scoped_lock lock{this->configMutex};
     this->Close();
 }
@@ -86,8 +101,7 @@ void Config::Load()
 void Config::Close()
 {
     this->loaded = false;
-    this->profileMHzMap.clear();
-    this->profileCountMap.clear();
+    this->profiles.Clear();
 
     for(unsigned int i = 0; i < SysClkConfigValue_EnumMax; i++)
     {
@@ -98,12 +112,23 @@ void Config::Close()
 bool Config::Refresh()
 {
     std::scoped_lock lock{this->configMutex};
+
+    // Changes made through IPC count as a reload
+    bool changed = this->changed;
+    this->changed = false;
+
+    // Until the writer caught up, the file is older than what's in memory
+    if (this->loaded && (this->writing || this->writeQueue.Pending()))
+    {
+        return changed;
+    }
+
     if (!this->loaded || this->mtime != this->CheckModificationTime())
     {
         this->Load();
         return true;
     }
-    return false;
+    return changed;
 }
 
 bool Config::HasProfilesLoaded()
@@ -128,11 +153,7 @@ std::uint32_t Config::FindClockMHz(std::uint64_t tid, SysClkModule module, SysCl
 {
     if (this->loaded)
     {
-        std::map<std::tuple<std::uint64_t, SysClkProfile, SysClkModule>, std::uint32_t>::const_iterator it = this->profileMHzMap.find(std::make_tuple(tid, profile, module));
-        if (it != this->profileMHzMap.end())
-        {
-            return it->second;
-        }
+        return this->profiles.Find(tid, module, profile);
     }
 
     return 0;
@@ -192,11 +213,8 @@ void Config::GetProfiles(std::uint64_t tid, SysClkTitleProfileList* out_profiles
     }
 }
 
-bool Config::SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles, bool immediate)
+bool Config::PersistProfiles(std::uint64_t tid, const SysClkTitleProfileList* profiles)
 {
-    std::scoped_lock lock{this->configMutex};
-    uint8_t numProfiles = 0;
-
     // String pointer array passed to ini
     char* iniKeys[SysClkProfile_EnumMax * SysClkModule_EnumMax + 1];
     char* iniValues[SysClkProfile_EnumMax * SysClkModule_EnumMax + 1];
@@ -211,7 +229,7 @@ bool Config::SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles, bo
     char** iv = &iniValues[0];
     char* sk = &keysStr[0];
     char* sv = &valuesStr[0];
-    std::uint32_t* mhz = &profiles->mhz[0];
+    const std::uint32_t* mhz = &profiles->mhz[0];
 
     snprintf(section, sizeof(section), "%016lX", tid);
 
@@ -221,8 +239,6 @@ bool Config::SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles, bo
         {
             if(*mhz)
             {
-                numProfiles++;
-
                 // Put key and value as string
                 snprintf(sk, 0x40, "%s_%s", Board::GetProfileName((SysClkProfile)profile, false), Board::GetModuleName((SysClkModule)module, false));
                 snprintf(sv, 0x10, "%d", *mhz);
@@ -245,45 +261,59 @@ bool Config::SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles, bo
     *ik = NULL;
     *iv = NULL;
 
-    if(!ini_putsection(section, (const char**)iniKeys, (const char**)iniValues, this->path.c_str()))
+    return ini_putsection(section, (const char**)iniKeys, (const char**)iniValues, this->path.c_str());
+}
+
+void Config::SetClockMHz(std::uint64_t tid, SysClkModule module, SysClkProfile profile, std::uint32_t mhz)
+{
+    if(!this->profiles.Set(tid, module, profile, mhz))
     {
-        return false;
+        FileUtils::LogLine("[cfg] Too many titles with profiles, ignoring %016lX", tid);
     }
+}
 
-    // Only actually apply changes in memory after a succesful save
-    if(immediate)
+bool Config::QueueProfiles(std::uint64_t tid)
+{
+    if(this->writeQueue.MarkProfiles(tid, armTicksToNs(armGetSystemTick())))
     {
-        mhz = &profiles->mhz[0];
-        this->profileCountMap[tid] = numProfiles;
-        for(unsigned int profile = 0; profile < SysClkProfile_EnumMax; profile++)
+        return true;
+    }
+
+    // Too many titles waiting already, this one can't be deferred
+    SysClkTitleProfileList profiles;
+    for(unsigned int profile = 0; profile < SysClkProfile_EnumMax; profile++)
+    {
+        for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
         {
-            for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
-            {
-                if(*mhz)
-                {
-                    this->profileMHzMap[std::make_tuple(tid, (SysClkProfile)profile, (SysClkModule)module)] = *mhz;
-                }
-                else
-                {
-                    this->profileMHzMap.erase(std::make_tuple(tid, (SysClkProfile)profile, (SysClkModule)module));
-                }
-                mhz++;
-            }
+            profiles.mhzMap[profile][module] = this->FindClockMHz(tid, (SysClkModule)module, (SysClkProfile)profile);
         }
     }
 
-    return true;
+    return this->PersistProfiles(tid, &profiles);
 }
 
-std::uint8_t Config::GetProfileCount(std::uint64_t tid)
+bool Config::SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles)
 {
-    std::map<std::uint64_t, std::uint8_t>::iterator it = this->profileCountMap.find(tid);
-    if (it == this->profileCountMap.end())
+    std::scoped_lock lock{this->configMutex};
+
+    // Applied right away, config.ini catches up from the writer thread
+    for(unsigned int profile = 0; profile < SysClkProfile_EnumMax; profile++)
     {
-        return 0;
+        for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            this->SetClockMHz(tid, (SysClkModule)module, (SysClkProfile)profile, profiles->mhzMap[profile][module]);
+        }
     }
+    this->changed = true;
+
+    bool queued = this->QueueProfiles(tid);
+    this->WakeWriter();
+    return queued;
+}
 
-    return it->second;
+std::uint8_t Config::GetProfileCount(std::uint64_t tid)
+{
+    return this->profiles.GetCount(tid);
 }
 
 int Config::BrowseIniFunc(const char* section, const char* key, const char* value, void* userdata)
@@ -357,15 +387,9 @@ int Config::BrowseIniFunc(const char* section, const char* key, const char* valu
         return 1;
     }
 
-    config->profileMHzMap[std::make_tuple(tid, parsedProfile, parsedModule)] = mhz;
-    std::map<std::uint64_t, std::uint8_t>::iterator it = config->profileCountMap.find(tid);
-    if (it == config->profileCountMap.end())
-    {
-        config->profileCountMap[tid] = 1;
-    }
-    else
+    if(!config->profiles.Set(tid, parsedModule, parsedProfile, mhz))
     {
-        it->second++;
+        FileUtils::LogLine("[cfg] Skipping section '%s': Too many titles with profiles", section);
     }
 
     return 1;
@@ -427,10 +451,8 @@ void Config::GetConfigValues(SysClkConfigValueList* out_configValues)
     }
 }
 
-bool Config::SetConfigValues(SysClkConfigValueList* configValues, bool immediate)
+bool Config::PersistConfigValues(const std::uint64_t* values)
 {
-    std::scoped_lock lock{this->configMutex};
-
     // String pointer array passed to ini
     const char* iniKeys[SysClkConfigValue_EnumMax + 1];
     char* iniValues[SysClkConfigValue_EnumMax + 1];
@@ -445,14 +467,14 @@ bool Config::SetConfigValues(SysClkConfigValueList* configValues, bool immediate
 
     for(unsigned int kval = 0; kval < SysClkConfigValue_EnumMax; kval++)
     {
-        if(!sysclkValidConfigValue((SysClkConfigValue)kval, configValues->values[kval]) || configValues->values[kval] == sysclkDefaultConfigValue((SysClkConfigValue)kval))
+        if(!sysclkValidConfigValue((SysClkConfigValue)kval, values[kval]) || values[kval] == sysclkDefaultConfigValue((SysClkConfigValue)kval))
         {
             continue;
         }
 
         // Put key and value as string
         // And add them to the ini key/value str arrays
-        snprintf(sv, 0x20, "%ld", configValues->values[kval]);
+        snprintf(sv, 0x20, "%ld", values[kval]);
         *ik = sysclkFormatConfigValue((SysClkConfigValue)kval, false);
         *iv = sv;
 
@@ -465,26 +487,203 @@ bool Config::SetConfigValues(SysClkConfigValueList* configValues, bool immediate
     *ik = NULL;
     *iv = NULL;
 
-    if(!ini_putsection(CONFIG_VAL_SECTION, (const char**)iniKeys, (const char**)iniValues, this->path.c_str()))
+    return ini_putsection(CONFIG_VAL_SECTION, (const char**)iniKeys, (const char**)iniValues, this->path.c_str());
+}
+
+bool Config::SetConfigValues(SysClkConfigValueList* configValues)
+{
+    std::scoped_lock lock{this->configMutex};
+
+    for(unsigned int kval = 0; kval < SysClkConfigValue_EnumMax; kval++)
+    {
+        if(sysclkValidConfigValue((SysClkConfigValue)kval, configValues->values[kval]))
+        {
+            this->configValues[kval] = configValues->values[kval];
+        }
+        else
+        {
+            this->configValues[kval] = sysclkDefaultConfigValue((SysClkConfigValue)kval);
+        }
+    }
+
+    this->changed = true;
+    this->writeQueue.MarkValues(armTicksToNs(armGetSystemTick()));
+    this->WakeWriter();
+    return true;
+}
+
+void Config::ApplyBatch(const HocClkBatchOp* ops, std::uint32_t count)
+{
+    std::scoped_lock lock{this->configMutex};
+
+    for(std::uint32_t i = 0; i < count; i++)
+    {
+        const HocClkBatchOp* op = &ops[i];
+        switch(op->type)
+        {
+            case HocClkBatchOp_ConfigValue:
+                this->configValues[op->key] = op->value;
+                this->writeQueue.MarkValues(armTicksToNs(armGetSystemTick()));
+                break;
+            case HocClkBatchOp_Override:
+                this->SetOverrideHz((SysClkModule)op->key, op->value);
+                break;
+            case HocClkBatchOp_Profile:
+                this->SetClockMHz(op->tid, HOCCLK_BATCH_MODULE(op->key), HOCCLK_BATCH_PROFILE(op->key), op->value);
+                this->QueueProfiles(op->tid);
+                break;
+            case HocClkBatchOp_Enabled:
+                this->SetEnabled(op->value);
+                break;
+        }
+    }
+
+    // One write for the whole batch, once the writer's delay is up
+    this->changed = true;
+    if(this->writeQueue.Pending())
+    {
+        this->WakeWriter();
+    }
+}
+
+bool Config::StageBatch(const HocClkBatchOp* ops, std::uint32_t count)
+{
+    std::scoped_lock lock{this->stagedMutex};
+
+    std::uint32_t* stagedCount = &this->stagedCount[this->stagingSlot];
+    if(*stagedCount + count > CONFIG_STAGED_BATCH_OPS)
     {
         return false;
     }
 
-    // Only actually apply changes in memory after a succesful save
-    if(immediate)
+    memcpy(&this->staged[this->stagingSlot][*stagedCount], ops, count * sizeof(HocClkBatchOp));
+    *stagedCount += count;
+    return true;
+}
+
+bool Config::ApplyStagedBatches()
+{
+    std::uint32_t slot;
     {
-        for(unsigned int kval = 0; kval < SysClkConfigValue_EnumMax; kval++)
+        std::scoped_lock lock{this->stagedMutex};
+        slot = this->stagingSlot;
+        if(!this->stagedCount[slot])
         {
-            if(sysclkValidConfigValue((SysClkConfigValue)kval, configValues->values[kval]))
-            {
-                this->configValues[kval] = configValues->values[kval];
-            }
-            else
+            return false;
+        }
+
+        // New batches go to the other slot while this one is applied
+        this->stagingSlot ^= 1;
+    }
+
+    this->ApplyBatch(this->staged[slot], this->stagedCount[slot]);
+
+    std::scoped_lock lock{this->stagedMutex};
+    this->stagedCount[slot] = 0;
+    return true;
+}
+
+bool Config::HasStagedBatches()
+{
+    std::scoped_lock lock{this->stagedMutex};
+    return this->stagedCount[this->stagingSlot] != 0;
+}
+
+void Config::WakeWriter()
+{
+    if(!this->writerRunning)
+    {
+        // Started on the first change, read-only instances never get one
+        ueventCreate(&this->writerEvent, true);
+        this->writerRunning = true;
+        Result rc = threadCreate(&this->writerThread, &Config::WriterThreadFunc, this, NULL, 0x4000, 0x3F, -2);
+        ASSERT_RESULT_OK(rc, "threadCreate");
+        rc = threadStart(&this->writerThread);
+        ASSERT_RESULT_OK(rc, "threadStart");
+    }
+
+    ueventSignal(&this->writerEvent);
+}
+
+void Config::WriterThreadFunc(void* arg)
+{
+    Config* config = (Config*)arg;
+
+    while(config->writerRunning)
+    {
+        std::uint64_t waitNs;
+        {
+            std::scoped_lock lock{config->configMutex};
+            waitNs = config->writeQueue.WaitNs(armTicksToNs(armGetSystemTick()));
+        }
+
+        if(waitNs)
+        {
+            // Woken early by every new change, which pushes the write back
+            waitSingle(waiterForUEvent(&config->writerEvent), waitNs);
+        }
+        else
+        {
+            config->WritePending(false);
+        }
+    }
+}
+
+void Config::WritePending(bool flush)
+{
+    ConfigWriteBatch batch;
+    std::uint64_t values[SysClkConfigValue_EnumMax];
+    SysClkTitleProfileList profiles[CONFIG_WRITE_QUEUE_TIDS];
+
+    {
+        std::scoped_lock lock{this->configMutex};
+        bool taken = flush ? this->writeQueue.TakeAll(&batch) : this->writeQueue.Take(armTicksToNs(armGetSystemTick()), &batch);
+        if(!taken)
+        {
+            return;
+        }
+
+        memcpy(values, this->configValues, sizeof(values));
+        for(std::uint32_t i = 0; i < batch.tidCount; i++)
+        {
+            for(unsigned int profile = 0; profile < SysClkProfile_EnumMax; profile++)
             {
-                this->configValues[kval] = sysclkDefaultConfigValue((SysClkConfigValue)kval);
+                for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+                {
+                    profiles[i].mhzMap[profile][module] = FindClockMHz(batch.tids[i], (SysClkModule)module, (SysClkProfile)profile);
+                }
             }
         }
+
+        this->writing = true;
     }
 
-    return true;
-}
\ No newline at end of file
+    // Rewriting the file takes a while on SD, nothing waits on it
+    ConfigWriteBatch failed = {};
+    if(batch.values && !this->PersistConfigValues(values))
+    {
+        failed.values = true;
+    }
+    for(std::uint32_t i = 0; i < batch.tidCount; i++)
+    {
+        if(!this->PersistProfiles(batch.tids[i], &profiles[i]))
+        {
+            failed.tids[failed.tidCount++] = batch.tids[i];
+        }
+    }
+
+    std::scoped_lock lock{this->configMutex};
+    this->writing = false;
+
+    // Our own write, nothing to load back
+    this->mtime = this->CheckModificationTime();
+
+    if(failed.values || failed.tidCount)
+    {
+        FileUtils::LogLine("[cfg] Error writing %s (%u titles, values: %u)", this->path.c_str(), failed.tidCount, failed.values);
+        if(!flush)
+        {
+            this->writeQueue.Requeue(&failed, armTicksToNs(armGetSystemTick()));
+        }
+    }
+}
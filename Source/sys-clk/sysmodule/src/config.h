@@ -36,8 +36,11 @@
 #include <minIni.h>
 #include <nxExt.h>
 #include "board.h"
+#include "config_write_queue.h"
+#include "profile_table.h"
 
 #define CONFIG_VAL_SECTION "values"
+#define CONFIG_STAGED_BATCH_OPS (HOCCLK_BATCH_MAX_OPS * 4)
 
 class Config
 {
@@ -53,7 +56,7 @@ class Config
 
     std::uint8_t GetProfileCount(std::uint64_t tid);
     void GetProfiles(std::uint64_t tid, SysClkTitleProfileList* out_profiles);
-    bool SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles, bool immediate);
+    bool SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles);
     std::uint32_t GetAutoClockHz(std::uint64_t tid, SysClkModule module, SysClkProfile profile);
 
     void SetEnabled(bool enabled);
@@ -64,24 +67,48 @@ class Config
     std::uint64_t GetConfigValue(SysClkConfigValue val);
     const char* GetConfigValueName(SysClkConfigValue val, bool pretty);
     void GetConfigValues(SysClkConfigValueList* out_configValues);
-    bool SetConfigValues(SysClkConfigValueList* configValues, bool immediate);
+    bool SetConfigValues(SysClkConfigValueList* configValues);
+    // Ops must have been checked, see hocClkCheckBatch
+    void ApplyBatch(const HocClkBatchOp* ops, std::uint32_t count);
+    // Held for the tick to apply whole, false when there's no room left
+    bool StageBatch(const HocClkBatchOp* ops, std::uint32_t count);
+    // Applies everything staged so far in order, true if there was anything
+    bool ApplyStagedBatches();
+    bool HasStagedBatches();
   protected:
     void Load();
     void Close();
 
     time_t CheckModificationTime();
+    void SetClockMHz(std::uint64_t tid, SysClkModule module, SysClkProfile profile, std::uint32_t mhz);
+    bool QueueProfiles(std::uint64_t tid);
     std::uint32_t FindClockMHz(std::uint64_t tid, SysClkModule module, SysClkProfile profile);
     std::uint32_t FindClockHzFromProfiles(std::uint64_t tid, SysClkModule module, std::initializer_list<SysClkProfile> profiles);
     static int BrowseIniFunc(const char* section, const char* key, const char* value, void* userdata);
 
-    std::map<std::tuple<std::uint64_t, SysClkProfile, SysClkModule>, std::uint32_t> profileMHzMap;
-    std::map<std::uint64_t, std::uint8_t> profileCountMap;
+    bool PersistProfiles(std::uint64_t tid, const SysClkTitleProfileList* profiles);
+    bool PersistConfigValues(const std::uint64_t* values);
+    void WakeWriter();
+    void WritePending(bool flush);
+    static void WriterThreadFunc(void* arg);
+
+    ProfileTable profiles;
     bool loaded;
     std::string path;
     time_t mtime;
     LockableMutex configMutex;
     LockableMutex overrideMutex;
+    LockableMutex stagedMutex;
+    HocClkBatchOp staged[2][CONFIG_STAGED_BATCH_OPS];
+    std::uint32_t stagedCount[2];
+    std::uint32_t stagingSlot; // IPC stages here, the tick applies the other one
     std::atomic_bool enabled;
     std::uint32_t overrideFreqs[SysClkModule_EnumMax];
     std::uint64_t configValues[SysClkConfigValue_EnumMax];
+    ConfigWriteQueue writeQueue;
+    bool writing;
+    bool changed;
+    std::atomic_bool writerRunning;
+    Thread writerThread;
+    UEvent writerEvent;
 };
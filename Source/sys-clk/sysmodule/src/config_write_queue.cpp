@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "config_write_queue.h"
+#include <cstring>
+
+ConfigWriteQueue::ConfigWriteQueue()
+{
+    memset(&this->pending, 0, sizeof(this->pending));
+    this->firstNs = 0;
+    this->lastNs = 0;
+}
+
+void ConfigWriteQueue::Touch(std::uint64_t ns)
+{
+    if (!this->Pending())
+    {
+        this->firstNs = ns;
+    }
+    this->lastNs = ns;
+}
+
+void ConfigWriteQueue::MarkValues(std::uint64_t ns)
+{
+    this->Touch(ns);
+    this->pending.values = true;
+}
+
+bool ConfigWriteQueue::MarkProfiles(std::uint64_t tid, std::uint64_t ns)
+{
+    for (std::uint32_t i = 0; i < this->pending.tidCount; i++)
+    {
+        if (this->pending.tids[i] == tid)
+        {
+            this->Touch(ns);
+            return true;
+        }
+    }
+
+    if (this->pending.tidCount >= CONFIG_WRITE_QUEUE_TIDS)
+    {
+        return false;
+    }
+
+    this->Touch(ns);
+    this->pending.tids[this->pending.tidCount++] = tid;
+    return true;
+}
+
+bool ConfigWriteQueue::Pending()
+{
+    return this->pending.values || this->pending.tidCount;
+}
+
+std::uint64_t ConfigWriteQueue::WaitNs(std::uint64_t ns)
+{
+    if (!this->Pending())
+    {
+        return UINT64_MAX;
+    }
+
+    std::uint64_t quietAt = this->lastNs + CONFIG_WRITE_QUIET_NS;
+    std::uint64_t deadline = this->firstNs + CONFIG_WRITE_MAX_DELAY_NS;
+    std::uint64_t dueAt = quietAt < deadline ? quietAt : deadline;
+
+    return ns >= dueAt ? 0 : dueAt - ns;
+}
+
+bool ConfigWriteQueue::Take(std::uint64_t ns, ConfigWriteBatch* out)
+{
+    if (this->WaitNs(ns))
+    {
+        return false;
+    }
+
+    return this->TakeAll(out);
+}
+
+bool ConfigWriteQueue::TakeAll(ConfigWriteBatch* out)
+{
+    if (!this->Pending())
+    {
+        return false;
+    }
+
+    *out = this->pending;
+    memset(&this->pending, 0, sizeof(this->pending));
+    return true;
+}
+
+void ConfigWriteQueue::Requeue(const ConfigWriteBatch* batch, std::uint64_t ns)
+{
+    if (batch->values)
+    {
+        this->MarkValues(ns);
+    }
+
+    // Newer marks are already in, they hold the same titles or others that fit first
+    for (std::uint32_t i = 0; i < batch->tidCount; i++)
+    {
+        this->MarkProfiles(batch->tids[i], ns);
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#define CONFIG_WRITE_QUEUE_TIDS 16
+#define CONFIG_WRITE_QUIET_NS 250000000ULL      // write once nothing changed for this long
+#define CONFIG_WRITE_MAX_DELAY_NS 2000000000ULL // but no later than this after the first change
+
+typedef struct
+{
+    bool values;
+    std::uint32_t tidCount;
+    std::uint64_t tids[CONFIG_WRITE_QUEUE_TIDS];
+} ConfigWriteBatch;
+
+/*
+ * What config.ini still has to be told.
+ *
+ * Settings are applied in memory right away and only marked here: the
+ * values section and the title sections that changed. Marks coalesce, a
+ * title changed ten times is written once, and the write is held back
+ * until the changes settle so a burst of overlay toggles costs one SD
+ * rewrite. Not thread safe, callers serialize access.
+ */
+class ConfigWriteQueue
+{
+  public:
+    ConfigWriteQueue();
+
+    void MarkValues(std::uint64_t ns);
+    // False when the title can't be queued, the caller writes it itself
+    bool MarkProfiles(std::uint64_t tid, std::uint64_t ns);
+
+    bool Pending();
+    // 0 when due, UINT64_MAX when there is nothing to write
+    std::uint64_t WaitNs(std::uint64_t ns);
+
+    // Take waits for the batch to be due, TakeAll doesn't
+    bool Take(std::uint64_t ns, ConfigWriteBatch* out);
+    bool TakeAll(ConfigWriteBatch* out);
+
+    // Puts back what failed to write, retried after the usual delay
+    void Requeue(const ConfigWriteBatch* batch, std::uint64_t ns);
+
+  protected:
+    void Touch(std::uint64_t ns);
+
+    ConfigWriteBatch pending;
+    std::uint64_t firstNs;
+    std::uint64_t lastNs;
+};
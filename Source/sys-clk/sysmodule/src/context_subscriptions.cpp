@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "context_subscriptions.h"
+#include <cstring>
+
+ContextSubscriptions::ContextSubscriptions()
+{
+    memset(this->slots, 0, sizeof(this->slots));
+    this->generation = 0;
+}
+
+ContextSubscriptions::Slot* ContextSubscriptions::Find(std::uint32_t id)
+{
+    unsigned int index = id % CONTEXT_SUBSCRIPTION_SLOTS;
+    Slot* slot = &this->slots[index];
+    return slot->used && slot->id == id ? slot : nullptr;
+}
+
+bool ContextSubscriptions::Add(const HocClkContextSubscription* sub, const SysClkContext* context, std::uint64_t ns, std::uint32_t* outId, unsigned int* outSlot)
+{
+    Slot* free = nullptr;
+    Slot* stale = nullptr;
+
+    for (unsigned int i = 0; i < CONTEXT_SUBSCRIPTION_SLOTS; i++)
+    {
+        Slot* slot = &this->slots[i];
+        if (!slot->used)
+        {
+            free = slot;
+            break;
+        }
+
+        if (slot->pending && ns - slot->pendingSinceNs >= CONTEXT_SUBSCRIPTION_STALE_NS &&
+            (!stale || slot->pendingSinceNs < stale->pendingSinceNs))
+        {
+            stale = slot;
+        }
+    }
+
+    Slot* slot = free ? free : stale;
+    if (!slot)
+    {
+        return false;
+    }
+
+    unsigned int index = slot - this->slots;
+    this->generation++;
+
+    slot->used = true;
+    slot->id = this->generation * CONTEXT_SUBSCRIPTION_SLOTS + index;
+    slot->sub = *sub;
+    slot->sent = *context;
+    slot->pending = 0;
+    slot->pendingSinceNs = 0;
+
+    *outId = slot->id;
+    *outSlot = index;
+    return true;
+}
+
+bool ContextSubscriptions::Remove(std::uint32_t id, unsigned int* outSlot)
+{
+    Slot* slot = this->Find(id);
+    if (!slot)
+    {
+        return false;
+    }
+
+    slot->used = false;
+    *outSlot = slot - this->slots;
+    return true;
+}
+
+std::uint32_t ContextSubscriptions::Update(const SysClkContext* context, std::uint64_t ns)
+{
+    std::uint32_t signal = 0;
+
+    for (unsigned int i = 0; i < CONTEXT_SUBSCRIPTION_SLOTS; i++)
+    {
+        Slot* slot = &this->slots[i];
+        if (!slot->used)
+        {
+            continue;
+        }
+
+        std::uint32_t changed = sysclkContextChangedFields(&slot->sent, context, &slot->sub);
+        if (changed && !slot->pending)
+        {
+            slot->pendingSinceNs = ns;
+            signal |= 1 << i;
+        }
+        slot->pending |= changed;
+    }
+
+    return signal;
+}
+
+bool ContextSubscriptions::Collect(std::uint32_t id, const SysClkContext* context, HocClkContextChanges* out)
+{
+    memset(out, 0, sizeof(*out));
+
+    Slot* slot = this->Find(id);
+    if (!slot)
+    {
+        return false;
+    }
+
+    // Whatever moved since the last update counts too, a field that went back
+    // where it was is still reported so the client sees the current value
+    out->changed = slot->pending | sysclkContextChangedFields(&slot->sent, context, &slot->sub);
+    sysclkContextCopyFields(&out->context, context, out->changed);
+    sysclkContextCopyFields(&slot->sent, context, out->changed);
+    slot->pending = 0;
+    return true;
+}
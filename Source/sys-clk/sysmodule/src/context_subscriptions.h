@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sysclk.h>
+
+#define CONTEXT_SUBSCRIPTION_SLOTS 4
+#define CONTEXT_SUBSCRIPTION_STALE_NS 30000000000ULL
+
+/*
+ * Context change subscriptions.
+ *
+ * Each subscriber remembers the context it was last given. After every
+ * tick, Update compares the new context against it with the subscriber's
+ * field mask and thresholds, and reports the subscribers that just went
+ * from nothing pending to something pending: those are the ones whose
+ * event needs signalling. Collect hands the pending fields over and makes
+ * the current context the new reference.
+ *
+ * Ids carry a generation so an id from a recycled slot is refused. A
+ * slot whose changes have gone uncollected for
+ * CONTEXT_SUBSCRIPTION_STALE_NS may be taken over by a new subscriber,
+ * for clients that went away without unsubscribing. Not thread safe,
+ * callers serialize access.
+ */
+class ContextSubscriptions
+{
+  public:
+    ContextSubscriptions();
+
+    // Slot index through outSlot, false when every slot is taken
+    bool Add(const HocClkContextSubscription* sub, const SysClkContext* context, std::uint64_t ns, std::uint32_t* outId, unsigned int* outSlot);
+    bool Remove(std::uint32_t id, unsigned int* outSlot);
+
+    // Mask of the slots to signal
+    std::uint32_t Update(const SysClkContext* context, std::uint64_t ns);
+
+    bool Collect(std::uint32_t id, const SysClkContext* context, HocClkContextChanges* out);
+
+  protected:
+    struct Slot
+    {
+        bool used;
+        std::uint32_t id;
+        HocClkContextSubscription sub;
+        SysClkContext sent;
+        std::uint32_t pending;
+        std::uint64_t pendingSinceNs;
+    };
+
+    Slot* Find(std::uint32_t id);
+
+    Slot slots[CONTEXT_SUBSCRIPTION_SLOTS];
+    std::uint32_t generation;
+};
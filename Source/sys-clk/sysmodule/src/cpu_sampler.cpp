@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cpu_sampler.h"
+
+CpuSampler::CpuSampler()
+{
+    this->Reset();
+}
+
+void CpuSampler::Reset()
+{
+    this->head = 0;
+    this->count = 0;
+}
+
+void CpuSampler::AddSample(std::uint64_t tick, const std::uint64_t* idleTicks)
+{
+    if (this->count)
+    {
+        const Snapshot* last = &this->history[this->head];
+        bool wrapped = tick <= last->tick;
+        for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+        {
+            wrapped |= idleTicks[core] < last->idle[core];
+        }
+
+        if (wrapped)
+        {
+            this->Reset();
+        }
+    }
+
+    this->head = this->count ? (this->head + 1) % CPU_SAMPLER_HISTORY : 0;
+    if (this->count < CPU_SAMPLER_HISTORY)
+    {
+        this->count++;
+    }
+
+    Snapshot* snapshot = &this->history[this->head];
+    snapshot->tick = tick;
+    for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+    {
+        snapshot->idle[core] = idleTicks[core];
+    }
+}
+
+bool CpuSampler::GetLoad(std::uint64_t windowTicks, std::uint32_t* outCoreLoad, std::uint32_t* outApplicationLoad)
+{
+    if (this->count < 2)
+    {
+        return false;
+    }
+
+    const Snapshot* newest = &this->history[this->head];
+    const Snapshot* oldest = nullptr;
+
+    // Walk back to the first snapshot covering the window, at least one interval
+    for (std::uint32_t i = 1; i < this->count; i++)
+    {
+        oldest = &this->history[(this->head + CPU_SAMPLER_HISTORY - i) % CPU_SAMPLER_HISTORY];
+        if (newest->tick - oldest->tick >= windowTicks)
+        {
+            break;
+        }
+    }
+
+    std::uint64_t elapsed = newest->tick - oldest->tick;
+    std::uint32_t applicationLoad = 0;
+
+    for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+    {
+        std::uint64_t idle = newest->idle[core] - oldest->idle[core];
+        outCoreLoad[core] = idle < elapsed ? (elapsed - idle) * 1000 / elapsed : 0;
+
+        if (core < CPU_SAMPLER_APPLICATION_CORES)
+        {
+            applicationLoad += outCoreLoad[core];
+        }
+    }
+
+    *outApplicationLoad = applicationLoad / CPU_SAMPLER_APPLICATION_CORES;
+    return true;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sysclk.h>
+
+#define CPU_SAMPLER_HISTORY 32              // snapshots, 9.6 s at the default polling interval
+#define CPU_SAMPLER_APPLICATION_CORES 3     // cores 0-2 run the application, core 3 the system
+
+/*
+ * CPU utilisation from the kernel's cumulative per core idle tick counters.
+ *
+ * Each tick a snapshot of the system tick and of every core's idle ticks is
+ * kept in a small ring, and the load over a window is the busy share between
+ * the newest snapshot and the newest one at least the window older (or the
+ * oldest one kept). Counters going backwards drop the history.
+ */
+class CpuSampler
+{
+  public:
+    CpuSampler();
+
+    void Reset();
+
+    // tick and idleTicks (HOCCLK_CPU_CORE_COUNT) are cumulative, in system ticks
+    void AddSample(std::uint64_t tick, const std::uint64_t* idleTicks);
+
+    // Busy permille per core and the mean over the application cores, false until two snapshots
+    bool GetLoad(std::uint64_t windowTicks, std::uint32_t* outCoreLoad, std::uint32_t* outApplicationLoad);
+
+  protected:
+    struct Snapshot
+    {
+        std::uint64_t tick;
+        std::uint64_t idle[HOCCLK_CPU_CORE_COUNT];
+    };
+
+    Snapshot history[CPU_SAMPLER_HISTORY];
+    std::uint32_t head;
+    std::uint32_t count;
+};
@@ -20,11 +20,11 @@ EMCpatcher* EMCpatcher::GetInstance()
     return instance;
 }
 
-void EMCpatcher::Initialize()
+void EMCpatcher::Initialize(Config* config)
 {
     if (!instance)
     {
-        instance = new EMCpatcher();
+        instance = new EMCpatcher(config);
         FileUtils::LogLine("[emc] Initialized EMCpatcher");
     }
 }
@@ -44,22 +44,21 @@ void EMCpatcher::Exit()
     }
 }
 
-EMCpatcher::EMCpatcher()
+// Shares ClockManager's config rather than parsing the INI a second time
+EMCpatcher::EMCpatcher(Config* config)
 {
-    this->config = Config::CreateDefault();
+    this->config = config;
 }
 
-
-
 EMCpatcher::~EMCpatcher()
 {
-    delete this->config;
 }
 
 void EMCpatcher::Run()
 {
+    // The shared config is refreshed by the ClockManager tick, refreshing it
+    // here would eat the change before the tick re-evaluates the clocks
     std::scoped_lock lock{this->patcherMutex};
-    this->config->Refresh();
     this->ApplyEMCPatch();
 }
 
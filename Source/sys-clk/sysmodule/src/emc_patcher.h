@@ -61,11 +61,11 @@ private:
 
 public:
     static EMCpatcher* GetInstance();
-    static void Initialize();
+    static void Initialize(Config* config);
     Config *GetConfig();
     static void Exit();
 
-    EMCpatcher();
+    EMCpatcher(Config* config);
     ~EMCpatcher();
 
     void Run();
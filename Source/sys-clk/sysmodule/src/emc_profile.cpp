@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "emc_profile.h"
+#include <cstring>
+
+EmcProfileTable::EmcProfileTable()
+{
+    this->Reset();
+}
+
+void EmcProfileTable::Reset()
+{
+    memset(this->slots, 0, sizeof(this->slots));
+    this->sequence = 0;
+    this->burstSlot = nullptr;
+    this->burstStartNs = 0;
+    this->lastNs = 0;
+}
+
+void EmcProfileTable::Forget(std::uint64_t tid)
+{
+    Slot* slot = this->FindSlot(tid, false);
+    if (slot)
+    {
+        if (slot == this->burstSlot)
+        {
+            this->burstSlot = nullptr;
+        }
+        memset(slot, 0, sizeof(*slot));
+    }
+}
+
+std::uint32_t EmcProfileTable::Bucket(std::uint32_t permille)
+{
+    std::uint32_t bucket = permille * HOCCLK_EMC_PROFILE_BUCKETS / 1000;
+    return bucket < HOCCLK_EMC_PROFILE_BUCKETS ? bucket : HOCCLK_EMC_PROFILE_BUCKETS - 1;
+}
+
+EmcProfileTable::Slot* EmcProfileTable::FindSlot(std::uint64_t tid, bool create)
+{
+    Slot* oldest = &this->slots[0];
+
+    for (unsigned int i = 0; i < EMC_PROFILE_SLOTS; i++)
+    {
+        Slot* slot = &this->slots[i];
+        if (slot->samples && slot->tid == tid)
+        {
+            return slot;
+        }
+
+        if (slot->lastUsed < oldest->lastUsed)
+        {
+            oldest = slot;
+        }
+    }
+
+    if (!create)
+    {
+        return nullptr;
+    }
+
+    if (oldest == this->burstSlot)
+    {
+        this->burstSlot = nullptr;
+    }
+    memset(oldest, 0, sizeof(*oldest));
+    oldest->tid = tid;
+    return oldest;
+}
+
+void EmcProfileTable::EndBurst(std::uint64_t ns)
+{
+    if (this->burstSlot)
+    {
+        std::uint64_t length = ns - this->burstStartNs;
+        if (length > this->burstSlot->longestBurstNs)
+        {
+            this->burstSlot->longestBurstNs = length;
+        }
+        this->burstSlot = nullptr;
+    }
+}
+
+void EmcProfileTable::AddSample(std::uint64_t tid, std::uint64_t ns, std::uint32_t allPermille, std::uint32_t cpuPermille, std::uint32_t memHz)
+{
+    allPermille = allPermille < 1000 ? allPermille : 1000;
+    cpuPermille = cpuPermille < allPermille ? cpuPermille : allPermille;
+
+    Slot* slot = this->FindSlot(tid, true);
+    slot->lastUsed = ++this->sequence;
+    slot->samples++;
+    slot->histogram[Bucket(allPermille)]++;
+    slot->cpuHistogram[Bucket(cpuPermille)]++;
+    slot->allSum += allPermille;
+    slot->cpuSum += cpuPermille;
+    slot->memKhzSum += memHz / 1000;
+    if (allPermille > slot->peak)
+    {
+        slot->peak = allPermille;
+    }
+
+    // A burst runs until the first unsaturated sample, or until another title shows up
+    if (this->burstSlot && this->burstSlot != slot)
+    {
+        this->EndBurst(this->lastNs);
+    }
+
+    if (allPermille >= HOCCLK_EMC_PROFILE_SATURATED)
+    {
+        slot->saturated++;
+        if (!this->burstSlot)
+        {
+            slot->bursts++;
+            this->burstSlot = slot;
+            this->burstStartNs = ns;
+        }
+    }
+    else
+    {
+        this->EndBurst(ns);
+    }
+
+    this->lastNs = ns;
+}
+
+bool EmcProfileTable::Get(std::uint64_t tid, std::uint32_t intervalUs, HocClkEmcProfile* out)
+{
+    memset(out, 0, sizeof(*out));
+    out->applicationId = tid;
+    out->intervalUs = intervalUs;
+
+    Slot* slot = this->FindSlot(tid, false);
+    if (!slot)
+    {
+        return false;
+    }
+
+    out->samples = slot->samples;
+    memcpy(out->histogram, slot->histogram, sizeof(out->histogram));
+    memcpy(out->cpuHistogram, slot->cpuHistogram, sizeof(out->cpuHistogram));
+    out->meanPermille = slot->allSum / slot->samples;
+    out->cpuMeanPermille = slot->cpuSum / slot->samples;
+    out->peakPermille = slot->peak;
+    out->saturatedSamples = slot->saturated;
+    out->bursts = slot->bursts;
+    out->meanMemMHz = slot->memKhzSum / slot->samples / 1000;
+
+    // Count the burst in progress as it stands
+    std::uint64_t longest = slot->longestBurstNs;
+    if (slot == this->burstSlot && this->lastNs - this->burstStartNs > longest)
+    {
+        longest = this->lastNs - this->burstStartNs;
+    }
+    out->longestBurstMs = longest / 1000000ULL;
+
+    return true;
+}
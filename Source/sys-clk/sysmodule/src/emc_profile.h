@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sysclk.h>
+
+#define EMC_PROFILE_SLOTS 8
+
+/*
+ * Per title EMC bandwidth statistics.
+ *
+ * Fed with the EMC utilisation of single actmon periods, keeps for every
+ * title a histogram of the total and CPU utilisation and the saturation
+ * runs (bursts). A title that spends a good share of its samples saturated
+ * is memory bound and should feel an EMC overclock; one that never gets
+ * near it won't. Slots are recycled least recently used first, not thread
+ * safe.
+ */
+class EmcProfileTable
+{
+  public:
+    EmcProfileTable();
+
+    void Reset();
+    void Forget(std::uint64_t tid);
+
+    void AddSample(std::uint64_t tid, std::uint64_t ns, std::uint32_t allPermille, std::uint32_t cpuPermille, std::uint32_t memHz);
+
+    // False if nothing was sampled for the title
+    bool Get(std::uint64_t tid, std::uint32_t intervalUs, HocClkEmcProfile* out);
+
+  protected:
+    struct Slot
+    {
+        std::uint64_t tid;
+        std::uint32_t lastUsed;
+        std::uint32_t samples;
+        std::uint32_t histogram[HOCCLK_EMC_PROFILE_BUCKETS];
+        std::uint32_t cpuHistogram[HOCCLK_EMC_PROFILE_BUCKETS];
+        std::uint64_t allSum;
+        std::uint64_t cpuSum;
+        std::uint64_t memKhzSum;
+        std::uint32_t peak;
+        std::uint32_t saturated;
+        std::uint32_t bursts;
+        std::uint64_t longestBurstNs;
+    };
+
+    Slot* FindSlot(std::uint64_t tid, bool create);
+    void EndBurst(std::uint64_t ns);
+    static std::uint32_t Bucket(std::uint32_t permille);
+
+    Slot slots[EMC_PROFILE_SLOTS];
+    std::uint32_t sequence;
+
+    // The burst in progress, for the title sampled last
+    Slot* burstSlot;
+    std::uint64_t burstStartNs;
+    std::uint64_t lastNs;
+};
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "emc_profiler.h"
+#include <algorithm>
+#include "board.h"
+#include "errors.h"
+
+#define EMC_PROFILER_IDLE_NS 500000000ULL
+
+EmcProfiler::EmcProfiler()
+{
+    this->running = false;
+    this->enabled = false;
+    this->intervalMs = Board::GetActmonPeriodMs();
+    this->applicationId = 0;
+
+    // Lowest priority, preemptive core: only ever runs on spare time
+    Result rc = threadCreate(&this->thread, &EmcProfiler::ProcessThreadFunc, this, NULL, 0x2000, 0x3F, -2);
+    ASSERT_RESULT_OK(rc, "threadCreate");
+}
+
+EmcProfiler::~EmcProfiler()
+{
+    this->SetRunning(false);
+    Result rc = threadClose(&this->thread);
+    ASSERT_RESULT_OK(rc, "threadClose");
+}
+
+void EmcProfiler::SetRunning(bool running)
+{
+    std::scoped_lock lock{this->threadMutex};
+    if (this->running == running)
+    {
+        return;
+    }
+
+    this->running = running;
+
+    if (running)
+    {
+        Result rc = threadStart(&this->thread);
+        ASSERT_RESULT_OK(rc, "threadStart");
+    }
+    else
+    {
+        threadWaitForExit(&this->thread);
+    }
+}
+
+void EmcProfiler::SetEnabled(bool enabled)
+{
+    this->enabled = enabled;
+}
+
+void EmcProfiler::SetIntervalMs(std::uint32_t intervalMs)
+{
+    // Faster than actmon only reads the same period again
+    this->intervalMs = std::max(intervalMs, Board::GetActmonPeriodMs());
+}
+
+void EmcProfiler::SetApplicationId(std::uint64_t tid)
+{
+    this->applicationId = tid;
+}
+
+void EmcProfiler::GetProfile(std::uint64_t tid, HocClkEmcProfile* out)
+{
+    std::scoped_lock lock{this->tableMutex};
+    this->table.Get(tid, this->intervalMs * 1000, out);
+}
+
+void EmcProfiler::Sample()
+{
+    std::uint64_t tid = this->applicationId;
+    std::uint32_t all, cpu, memHz;
+
+    if (!tid || !Board::GetEmcLoadRaw(&all, &cpu, &memHz))
+    {
+        return;
+    }
+
+    std::scoped_lock lock{this->tableMutex};
+    this->table.AddSample(tid, armTicksToNs(armGetSystemTick()), all, cpu, memHz);
+}
+
+void EmcProfiler::ProcessThreadFunc(void* arg)
+{
+    EmcProfiler* profiler = (EmcProfiler*)arg;
+
+    while (profiler->running)
+    {
+        if (profiler->enabled)
+        {
+            profiler->Sample();
+            svcSleepThread(profiler->intervalMs * 1000000ULL);
+        }
+        else
+        {
+            svcSleepThread(EMC_PROFILER_IDLE_NS);
+        }
+    }
+}
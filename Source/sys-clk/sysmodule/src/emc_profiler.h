@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <switch.h>
+#include <nxExt/cpp/lockable_mutex.h>
+#include "emc_profile.h"
+
+/*
+ * EMC bandwidth profiler.
+ *
+ * A low priority thread reading the actmon MC counters once per actmon
+ * period, so short saturation bursts that the 8 sample average used by
+ * the governor smooths away still show up. Samples are filed under the
+ * running title, see EmcProfileTable. The thread lives as long as the
+ * profiler and idles while disabled.
+ */
+class EmcProfiler
+{
+  public:
+    EmcProfiler();
+    virtual ~EmcProfiler();
+
+    void SetRunning(bool running);
+    void SetEnabled(bool enabled);
+    void SetIntervalMs(std::uint32_t intervalMs);
+    void SetApplicationId(std::uint64_t tid);
+    void GetProfile(std::uint64_t tid, HocClkEmcProfile* out);
+
+  protected:
+    static void ProcessThreadFunc(void* arg);
+    void Sample();
+
+    Thread thread;
+    LockableMutex threadMutex;
+    LockableMutex tableMutex;
+    std::atomic_bool running;
+    std::atomic_bool enabled;
+    std::atomic_uint32_t intervalMs;
+    std::atomic_uint64_t applicationId;
+    EmcProfileTable table;
+};
@@ -32,6 +32,7 @@ static LockableMutex g_log_mutex;
 static LockableMutex g_csv_mutex;
 static std::atomic_bool g_has_initialized = false;
 static bool g_log_enabled = false;
+static bool g_tick_trace_enabled = false;
 static std::uint64_t g_last_flag_check = 0;
 
 extern "C" void __libnx_init_time(void);
@@ -76,6 +77,18 @@ void FileUtils::LogLine(const char* format, ...)
     va_end(args);
 }
 
+bool FileUtils::IsTickTraceEnabled()
+{
+    if (!g_has_initialized)
+    {
+        return false;
+    }
+
+    std::scoped_lock lock{g_log_mutex};
+    FileUtils::RefreshFlags(false);
+    return g_tick_trace_enabled;
+}
+
 void FileUtils::WriteContextToCsv(const SysClkContext* context)
 {
     std::scoped_lock lock{g_csv_mutex};
@@ -109,6 +122,16 @@ void FileUtils::WriteContextToCsv(const SysClkContext* context)
                 fprintf(file, ",%s_mw", sysclkFormatPowerSensor((SysClkPowerSensor)sensor, false));
             }
 
+            for (unsigned int loadSource = 0; loadSource < SysClkPartLoad_EnumMax; loadSource++)
+            {
+                fprintf(file, ",%s_load", sysclkFormatPartLoad((SysClkPartLoad)loadSource, false));
+            }
+
+            for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+            {
+                fprintf(file, ",cpu%u_load", core);
+            }
+
             fprintf(file, "\n");
         }
 
@@ -137,6 +160,94 @@ void FileUtils::WriteContextToCsv(const SysClkContext* context)
             fprintf(file, ",%d", context->power[sensor]);
         }
 
+        for (unsigned int loadSource = 0; loadSource < SysClkPartLoad_EnumMax; loadSource++)
+        {
+            fprintf(file, ",%u", context->partLoad[loadSource]);
+        }
+
+        for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+        {
+            fprintf(file, ",%u", context->cpuCoreLoad[core]);
+        }
+
+        fprintf(file, "\n");
+        fclose(file);
+    }
+}
+
+void FileUtils::WriteTickTrace(const TickTraceRow* row)
+{
+    std::scoped_lock lock{g_csv_mutex};
+
+    FILE* file = fopen(FILE_TICK_TRACE_PATH, "a");
+
+    if (file)
+    {
+        // Names as host/context_trace.cpp looks them up
+        if(!ftell(file))
+        {
+            fprintf(file, "tick_ns,app_tid,soc_type,profile,operation_mode,charger_type,apm_configuration,contract_mw,charge_mw,battery_pcm");
+
+            for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+            {
+                fprintf(file, ",%s_hz_in", sysclkFormatModule((SysClkModule)module, false));
+            }
+
+            for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+            {
+                fprintf(file, ",%s_milliC", sysclkFormatThermalSensor((SysClkThermalSensor)sensor, false));
+            }
+
+            for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
+            {
+                fprintf(file, ",%s_mw", sysclkFormatPowerSensor((SysClkPowerSensor)sensor, false));
+            }
+
+            fprintf(file, ",emc_load,emc_cpu_load,gpu_load");
+
+            for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+            {
+                fprintf(file, ",cpu%u_idle_ticks", core);
+            }
+
+            for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+            {
+                fprintf(file, ",%s_hz", sysclkFormatModule((SysClkModule)module, false));
+            }
+
+            fprintf(file, "\n");
+        }
+
+        fprintf(file, "%lu,%016lx,%u,%s,%u,%u,%08x,%d,%d,%u", row->ns, row->applicationId, row->socType, sysclkFormatProfile(row->profile, false),
+            row->operationMode, row->chargerType, row->apmConfiguration, row->contractMw, row->chargeMw, row->batteryPcm);
+
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            fprintf(file, ",%u", row->hzIn[module]);
+        }
+
+        for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+        {
+            fprintf(file, ",%u", row->temps[sensor]);
+        }
+
+        for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
+        {
+            fprintf(file, ",%d", row->power[sensor]);
+        }
+
+        fprintf(file, ",%u,%u,%u", row->emcLoad, row->emcCpuLoad, row->gpuLoad);
+
+        for (unsigned int core = 0; core < HOCCLK_CPU_CORE_COUNT; core++)
+        {
+            fprintf(file, ",%lu", row->cpuIdleTicks[core]);
+        }
+
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            fprintf(file, ",%u", row->hz[module]);
+        }
+
         fprintf(file, "\n");
         fclose(file);
     }
@@ -159,6 +270,15 @@ void FileUtils::RefreshFlags(bool force)
         g_log_enabled = false;
     }
 
+    file = fopen(FILE_TICK_TRACE_FLAG_PATH, "r");
+    if (file)
+    {
+        g_tick_trace_enabled = true;
+        fclose(file);
+    } else {
+        g_tick_trace_enabled = false;
+    }
+
     g_last_flag_check = now;
 }
 
@@ -210,6 +330,7 @@ void FileUtils::Exit()
 
     g_has_initialized = false;
     g_log_enabled = false;
+    g_tick_trace_enabled = false;
 
     fsdevUnmountAll();
     fsExit();
@@ -33,12 +33,20 @@
 #include <atomic>
 #include <cstdarg>
 #include <sysclk.h>
+#include "tick_trace.h"
 
+// The host simulator points it at a scratch directory
+#ifndef FILE_CONFIG_DIR
 #define FILE_CONFIG_DIR "/config/" TARGET
+#endif
 #define FILE_FLAG_CHECK_INTERVAL_NS 5000000000ULL
 #define FILE_CONTEXT_CSV_PATH FILE_CONFIG_DIR "/context.csv"
 #define FILE_LOG_FLAG_PATH FILE_CONFIG_DIR "/log.flag"
 #define FILE_LOG_FILE_PATH FILE_CONFIG_DIR "/log.txt"
+#define FILE_TICK_TRACE_FLAG_PATH FILE_CONFIG_DIR "/trace.flag"
+#define FILE_TICK_TRACE_PATH FILE_CONFIG_DIR "/tick_trace.csv"
+#define FILE_POWER_MODEL_PATH FILE_CONFIG_DIR "/power_model.bin"
+#define FILE_LEARNED_PROFILES_PATH FILE_CONFIG_DIR "/learned_profiles.bin"
 
 class FileUtils
 {
@@ -47,9 +55,11 @@ class FileUtils
     static Result Initialize();
     static bool IsInitialized();
     static bool IsLogEnabled();
+    static bool IsTickTraceEnabled();
     static void InitializeAsync();
     static void LogLine(const char* format, ...);
     static void WriteContextToCsv(const SysClkContext* context);
+    static void WriteTickTrace(const TickTraceRow* row);
   protected:
     static void RefreshFlags(bool force);
 };
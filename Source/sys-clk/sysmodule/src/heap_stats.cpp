@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "heap_stats.h"
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+static std::atomic<std::uint32_t> g_heap_size = 0;
+static std::atomic<std::uint32_t> g_used_bytes = 0;
+static std::atomic<std::uint32_t> g_peak_bytes = 0;
+static std::atomic<std::uint32_t> g_alloc_count = 0;
+static std::atomic<std::uint32_t> g_free_count = 0;
+
+static void* _HeapStats_Alloc(std::size_t size)
+{
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    std::uint32_t used = g_used_bytes += malloc_usable_size(ptr);
+    std::uint32_t peak = g_peak_bytes;
+    while (used > peak && !g_peak_bytes.compare_exchange_weak(peak, used))
+    {
+    }
+    g_alloc_count++;
+    return ptr;
+}
+
+static void _HeapStats_Free(void* ptr)
+{
+    if (ptr)
+    {
+        g_used_bytes -= malloc_usable_size(ptr);
+        g_free_count++;
+        free(ptr);
+    }
+}
+
+void HeapStats::SetHeapSize(std::size_t size)
+{
+    g_heap_size = size;
+}
+
+void HeapStats::GetStats(HocClkHeapStats* out_stats)
+{
+    out_stats->heapSize = g_heap_size;
+    out_stats->usedBytes = g_used_bytes;
+    out_stats->peakBytes = g_peak_bytes;
+    out_stats->allocCount = g_alloc_count;
+    out_stats->freeCount = g_free_count;
+}
+
+std::uint32_t HeapStats::GetAllocCount()
+{
+    return g_alloc_count;
+}
+
+void* operator new(std::size_t size)
+{
+    return _HeapStats_Alloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return _HeapStats_Alloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    _HeapStats_Free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    _HeapStats_Free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    _HeapStats_Free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    _HeapStats_Free(ptr);
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <sysclk.h>
+
+/*
+ * Counts what goes through operator new and delete, which this unit
+ * replaces for the whole sysmodule. Sizes are the allocator's usable size,
+ * what the heap actually lost. Lock free, safe from any thread.
+ */
+class HeapStats
+{
+  public:
+    // main sets it to the inner heap it hands newlib
+    static void SetHeapSize(std::size_t size);
+    static void GetStats(HocClkHeapStats* out_stats);
+    // For checks that a code path does not allocate
+    static std::uint32_t GetAllocCount();
+};
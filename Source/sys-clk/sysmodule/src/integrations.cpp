@@ -50,14 +50,13 @@ ReverseNXMode ReverseNXSync::RecheckToolMode() {
     ReverseNXMode mode = ReverseNX_NotFound;
     if (this->m_tool_enabled) {
         const char* fileName = "_ZN2nn2oe18GetPerformanceModeEv.asm64"; // or _ZN2nn2oe18GetPerformanceModeEv.asm64
-        const char* filePath = new char[72];
-        SCOPE_EXIT { delete[] filePath; };
+        char filePath[72];
         /* Check per-game patch */
-        snprintf((char*)filePath, 72, "/SaltySD/patches/%016lX/%s", this->m_app_id, fileName);
+        snprintf(filePath, sizeof(filePath), "/SaltySD/patches/%016lX/%s", this->m_app_id, fileName);
         mode = this->GetToolModeFromPatch(filePath);
         if (!mode) {
             /* Check global patch */
-            snprintf((char*)filePath, 72, "/SaltySD/patches/%s", fileName);
+            snprintf(filePath, sizeof(filePath), "/SaltySD/patches/%s", fileName);
             mode = this->GetToolModeFromPatch(filePath);
         }
     }
@@ -32,6 +32,17 @@
 #include "errors.h"
 #include "clock_manager.h"
 #include "emc_patcher.h"
+#include "heap_stats.h"
+
+// Replies returned inline, anything bigger goes through a buffer
+static_assert(sizeof(SysClkContext) <= IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE, "context doesn't fit an IPC response");
+static_assert(sizeof(SysClkTitleProfileList) <= IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE, "profile list doesn't fit an IPC response");
+static_assert(sizeof(HocClkLearnedProfileList) <= IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE, "learned profiles don't fit an IPC response");
+static_assert(sizeof(HocClkEmcProfile) <= IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE, "EMC profile doesn't fit an IPC response");
+static_assert(sizeof(HocClkContextChanges) <= IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE, "context changes don't fit an IPC response");
+static_assert(sizeof(HocClkBatchResult) <= IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE, "batch result doesn't fit an IPC response");
+static_assert(sizeof(HocClkHeapStats) <= IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE, "heap stats don't fit an IPC response");
+static_assert(sizeof(HocClkOperatingPoint) <= IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE, "operating point doesn't fit an IPC response");
 
 IpcService::IpcService(ClockManager* clockMgr)
 {
@@ -99,7 +110,7 @@ void IpcService::ProcessThreadFunc(void* arg)
     }
 }
 
-Result IpcService::ServiceHandlerFunc(void* arg, const IpcServerRequest* r, u8* out_data, size_t* out_dataSize)
+Result IpcService::ServiceHandlerFunc(void* arg, const IpcServerRequest* r, u8* out_data, size_t* out_dataSize, Handle* out_handle)
 {
     IpcService* ipcSrv = (IpcService*)arg;
 
@@ -118,6 +129,9 @@ Result IpcService::ServiceHandlerFunc(void* arg, const IpcServerRequest* r, u8*
                 );
             }
             break;
+        case HocClkIpcCmd_GetHeapStats:
+            *out_dataSize = sizeof(HocClkHeapStats);
+            return ipcSrv->GetHeapStats((HocClkHeapStats*)out_data);
 
         case SysClkIpcCmd_GetCurrentContext:
             *out_dataSize = sizeof(SysClkContext);
@@ -164,13 +178,23 @@ Result IpcService::ServiceHandlerFunc(void* arg, const IpcServerRequest* r, u8*
             break;
 
         case SysClkIpcCmd_GetConfigValues:
-            *out_dataSize = sizeof(SysClkConfigValueList); // bug in stock sys-clk. really stupid bug :skull:
-            return ipcSrv->GetConfigValues((SysClkConfigValueList*)out_data);
+            // The list outgrew the inline reply, it goes through a buffer both ways
+            if(r->hipc.meta.num_recv_buffers >= 1)
+            {
+                return ipcSrv->GetConfigValues(
+                    (SysClkConfigValueList*)hipcGetBufferAddress(r->hipc.data.recv_buffers),
+                    hipcGetBufferSize(r->hipc.data.recv_buffers)
+                );
+            }
+            break;
 
         case SysClkIpcCmd_SetConfigValues:
-            if(r->data.size >= sizeof(SysClkConfigValueList))
+            if(r->hipc.meta.num_send_buffers >= 1)
             {
-                return ipcSrv->SetConfigValues((SysClkConfigValueList*)r->data.ptr);
+                return ipcSrv->SetConfigValues(
+                    (const SysClkConfigValueList*)hipcGetBufferAddress(r->hipc.data.send_buffers),
+                    hipcGetBufferSize(r->hipc.data.send_buffers)
+                );
             }
             break;
         case SysClkIpcCmd_GetFreqList:
@@ -194,6 +218,80 @@ Result IpcService::ServiceHandlerFunc(void* arg, const IpcServerRequest* r, u8*
         case HocClkIpcCmd_UpdateEMCRegs: // Trigger, not data
             return ipcSrv->PatchEmcRegs();
             break;
+        case HocClkIpcCmd_GetLearnedProfiles:
+            if(r->data.size >= sizeof(std::uint64_t))
+            {
+                *out_dataSize = sizeof(HocClkLearnedProfileList);
+                return ipcSrv->GetLearnedProfiles((std::uint64_t*)r->data.ptr, (HocClkLearnedProfileList*)out_data);
+            }
+            break;
+        case HocClkIpcCmd_GetEmcProfile:
+            if(r->data.size >= sizeof(std::uint64_t))
+            {
+                *out_dataSize = sizeof(HocClkEmcProfile);
+                return ipcSrv->GetEmcProfile((std::uint64_t*)r->data.ptr, (HocClkEmcProfile*)out_data);
+            }
+            break;
+        case HocClkIpcCmd_SubscribeContext:
+            if(r->data.size >= sizeof(HocClkContextSubscription))
+            {
+                *out_dataSize = sizeof(std::uint32_t);
+                return ipcSrv->SubscribeContext((HocClkContextSubscription*)r->data.ptr, (std::uint32_t*)out_data, out_handle);
+            }
+            break;
+        case HocClkIpcCmd_GetContextChanges:
+            if(r->data.size >= sizeof(std::uint32_t))
+            {
+                *out_dataSize = sizeof(HocClkContextChanges);
+                return ipcSrv->GetContextChanges((std::uint32_t*)r->data.ptr, (HocClkContextChanges*)out_data);
+            }
+            break;
+        case HocClkIpcCmd_UnsubscribeContext:
+            if(r->data.size >= sizeof(std::uint32_t))
+            {
+                return ipcSrv->UnsubscribeContext((std::uint32_t*)r->data.ptr);
+            }
+            break;
+        case HocClkIpcCmd_GetContextDelta:
+            if(r->data.size >= sizeof(std::uint32_t))
+            {
+                return ipcSrv->GetContextDelta((std::uint32_t*)r->data.ptr, (HocClkContextDelta*)out_data, out_dataSize);
+            }
+            break;
+        case HocClkIpcCmd_ApplyBatch:
+            if(r->hipc.meta.num_send_buffers >= 1)
+            {
+                *out_dataSize = sizeof(HocClkBatchResult);
+                return ipcSrv->ApplyBatch(
+                    (const HocClkBatchOp*)hipcGetBufferAddress(r->hipc.data.send_buffers),
+                    hipcGetBufferSize(r->hipc.data.send_buffers),
+                    (HocClkBatchResult*)out_data
+                );
+            }
+            break;
+        case HocClkIpcCmd_EstimatePower:
+            if(r->data.size >= sizeof(HocClkIpc_EstimatePower_Args))
+            {
+                *out_dataSize = sizeof(std::int32_t);
+                return ipcSrv->EstimatePower((HocClkIpc_EstimatePower_Args*)r->data.ptr, (std::int32_t*)out_data);
+            }
+            break;
+        case HocClkIpcCmd_FindCheapestOperatingPoint:
+            if(r->data.size >= sizeof(HocClkIpc_FindCheapest_Args))
+            {
+                *out_dataSize = sizeof(HocClkOperatingPoint);
+                return ipcSrv->FindCheapestOperatingPoint((HocClkIpc_FindCheapest_Args*)r->data.ptr, (HocClkOperatingPoint*)out_data);
+            }
+            break;
+        case HocClkIpcCmd_GetTickStats:
+            if(r->hipc.meta.num_recv_buffers >= 1)
+            {
+                return ipcSrv->GetTickStats(
+                    (HocClkTickStats*)hipcGetBufferAddress(r->hipc.data.recv_buffers),
+                    hipcGetBufferSize(r->hipc.data.recv_buffers)
+                );
+            }
+            break;
     }
 
     return SYSCLK_ERROR(Generic);
@@ -267,7 +365,7 @@ Result IpcService::SetProfiles(SysClkIpc_SetProfiles_Args* args)
 
     SysClkTitleProfileList profiles = args->profiles;
 
-    if(!config->SetProfiles(args->tid, &profiles, true))
+    if(!config->SetProfiles(args->tid, &profiles))
     {
         return SYSCLK_ERROR(ConfigSaveFailed); // 0x584
     }
@@ -299,8 +397,13 @@ Result IpcService::SetOverride(SysClkIpc_SetOverride_Args* args)
     return 0;
 }
 
-Result IpcService::GetConfigValues(SysClkConfigValueList* out_configValues)
+Result IpcService::GetConfigValues(SysClkConfigValueList* out_configValues, std::size_t size)
 {
+    if(size < sizeof(SysClkConfigValueList))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
     Config* config = this->clockMgr->GetConfig();
     if(!config->HasProfilesLoaded())
     {
@@ -312,8 +415,13 @@ Result IpcService::GetConfigValues(SysClkConfigValueList* out_configValues)
     return 0;
 }
 
-Result IpcService::SetConfigValues(SysClkConfigValueList* configValues)
+Result IpcService::SetConfigValues(const SysClkConfigValueList* configValues, std::size_t size)
 {
+    if(size < sizeof(SysClkConfigValueList))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
     Config* config = this->clockMgr->GetConfig();
     if(!config->HasProfilesLoaded())
     {
@@ -322,7 +430,7 @@ Result IpcService::SetConfigValues(SysClkConfigValueList* configValues)
 
     SysClkConfigValueList configValuesCopy = *configValues;
 
-    if(!config->SetConfigValues(&configValuesCopy, true))
+    if(!config->SetConfigValues(&configValuesCopy))
     {
         return SYSCLK_ERROR(ConfigSaveFailed);
     }
@@ -357,3 +465,108 @@ Result IpcService::PatchEmcRegs() {
     EMCpatcher::GetInstance()->Run();
     return 0;
 }
+
+Result IpcService::GetLearnedProfiles(std::uint64_t* tid, HocClkLearnedProfileList* out_learned)
+{
+    this->clockMgr->GetLearnedProfiles(*tid, out_learned);
+    return 0;
+}
+
+Result IpcService::GetEmcProfile(std::uint64_t* tid, HocClkEmcProfile* out_profile)
+{
+    this->clockMgr->GetEmcProfile(*tid, out_profile);
+    return 0;
+}
+
+Result IpcService::SubscribeContext(HocClkContextSubscription* sub, std::uint32_t* out_id, Handle* out_event)
+{
+    if(!this->clockMgr->SubscribeContext(sub, out_id, out_event))
+    {
+        return SYSCLK_ERROR(SubscriptionsFull);
+    }
+    return 0;
+}
+
+Result IpcService::GetContextChanges(std::uint32_t* id, HocClkContextChanges* out_changes)
+{
+    if(!this->clockMgr->GetContextChanges(*id, out_changes))
+    {
+        return SYSCLK_ERROR(NoSuchSubscription);
+    }
+    return 0;
+}
+
+Result IpcService::UnsubscribeContext(std::uint32_t* id)
+{
+    if(!this->clockMgr->UnsubscribeContext(*id))
+    {
+        return SYSCLK_ERROR(NoSuchSubscription);
+    }
+    return 0;
+}
+
+static_assert(sizeof(HocClkContextDelta) <= IPC_SERVER_EXT_RESPONSE_MAX_DATA_SIZE, "context delta doesn't fit an IPC response");
+
+Result IpcService::GetContextDelta(std::uint32_t* since, HocClkContextDelta* out_delta, size_t* out_size)
+{
+    // Only the fields that changed go back, the reply shrinks with them
+    *out_size = this->clockMgr->GetContextDelta(*since, out_delta);
+    return 0;
+}
+
+Result IpcService::ApplyBatch(const HocClkBatchOp* ops, std::size_t size, HocClkBatchResult* out_result)
+{
+    std::uint32_t count = size / sizeof(HocClkBatchOp);
+    if(!count || count > HOCCLK_BATCH_MAX_OPS || size % sizeof(HocClkBatchOp))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    if(!this->clockMgr->GetConfig()->HasProfilesLoaded())
+    {
+        return SYSCLK_ERROR(ConfigNotLoaded);
+    }
+
+    // Rejected batches still succeed, the status of each op says why
+    this->clockMgr->ApplyBatch(ops, count, out_result);
+    return 0;
+}
+
+Result IpcService::GetTickStats(HocClkTickStats* out_stats, std::size_t size)
+{
+    if(size < sizeof(HocClkTickStats))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    if(!this->clockMgr->GetTickStats(out_stats))
+    {
+        return SYSCLK_ERROR(TickStatsDisabled);
+    }
+    return 0;
+}
+
+Result IpcService::GetHeapStats(HocClkHeapStats* out_stats)
+{
+    HeapStats::GetStats(out_stats);
+    return 0;
+}
+
+Result IpcService::EstimatePower(HocClkIpc_EstimatePower_Args* args, std::int32_t* out_mw)
+{
+    *out_mw = this->clockMgr->EstimatePowerMw(args->hz);
+    if(*out_mw < 0)
+    {
+        return SYSCLK_ERROR(NoPowerEstimate);
+    }
+    return 0;
+}
+
+Result IpcService::FindCheapestOperatingPoint(HocClkIpc_FindCheapest_Args* args, HocClkOperatingPoint* out_point)
+{
+    if(!this->clockMgr->FindCheapestOperatingPoint(args->minHz, out_point->hz, &out_point->mw))
+    {
+        return SYSCLK_ERROR(NoPowerEstimate);
+    }
+    return 0;
+}
@@ -39,7 +39,7 @@ class IpcService
     virtual ~IpcService();
     void SetRunning(bool running);
     static void ProcessThreadFunc(void* arg);
-    static Result ServiceHandlerFunc(void* arg, const IpcServerRequest* r, std::uint8_t* out_data, size_t* out_dataSize);
+    static Result ServiceHandlerFunc(void* arg, const IpcServerRequest* r, std::uint8_t* out_data, size_t* out_dataSize, Handle* out_handle);
 
     Result GetApiVersion(u32* out_version);
     Result GetVersionString(char* out_buf, size_t bufSize);
@@ -50,12 +50,23 @@ class IpcService
     Result SetProfiles(SysClkIpc_SetProfiles_Args* args);
     Result SetEnabled(std::uint8_t* enabled);
     Result SetOverride(SysClkIpc_SetOverride_Args* args);
-    Result GetConfigValues(SysClkConfigValueList* out_configValues);
-    Result SetConfigValues(SysClkConfigValueList* configValues);
+    Result GetConfigValues(SysClkConfigValueList* out_configValues, std::size_t size);
+    Result SetConfigValues(const SysClkConfigValueList* configValues, std::size_t size);
     Result GetFreqList(SysClkIpc_GetFreqList_Args* args, std::uint32_t* out_list, std::size_t size, std::uint32_t* out_count);
     Result SetReverseNXRTMode(ReverseNXMode mode);
     
     Result PatchEmcRegs();
+    Result GetLearnedProfiles(std::uint64_t* tid, HocClkLearnedProfileList* out_learned);
+    Result GetEmcProfile(std::uint64_t* tid, HocClkEmcProfile* out_profile);
+    Result SubscribeContext(HocClkContextSubscription* sub, std::uint32_t* out_id, Handle* out_event);
+    Result GetContextChanges(std::uint32_t* id, HocClkContextChanges* out_changes);
+    Result UnsubscribeContext(std::uint32_t* id);
+    Result GetContextDelta(std::uint32_t* since, HocClkContextDelta* out_delta, size_t* out_size);
+    Result ApplyBatch(const HocClkBatchOp* ops, std::size_t size, HocClkBatchResult* out_result);
+    Result GetTickStats(HocClkTickStats* out_stats, std::size_t size);
+    Result GetHeapStats(HocClkHeapStats* out_stats);
+    Result EstimatePower(HocClkIpc_EstimatePower_Args* args, std::int32_t* out_mw);
+    Result FindCheapestOperatingPoint(HocClkIpc_FindCheapest_Args* args, HocClkOperatingPoint* out_point);
 
     bool running;
     Thread thread;
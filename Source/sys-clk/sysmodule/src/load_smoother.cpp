@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "load_smoother.h"
+#include <cmath>
+
+LoadSmoother::LoadSmoother()
+{
+    this->mode = LoadSmoother_Ema;
+    this->spanNs = 0;
+    this->minIntervalNs = 0;
+    this->Reset();
+}
+
+void LoadSmoother::Reset()
+{
+    this->primed = false;
+    this->lastNs = 0;
+    this->ema = 0;
+    this->windowHead = 0;
+    this->windowCount = 0;
+}
+
+void LoadSmoother::SetParams(LoadSmootherMode mode, std::uint64_t spanNs, std::uint64_t minIntervalNs)
+{
+    if (mode != this->mode)
+    {
+        this->Reset();
+    }
+
+    this->mode = mode;
+    this->spanNs = spanNs;
+    this->minIntervalNs = minIntervalNs;
+}
+
+bool LoadSmoother::Primed()
+{
+    return this->primed;
+}
+
+bool LoadSmoother::Due(std::uint64_t ns)
+{
+    return !this->primed || ns - this->lastNs >= this->minIntervalNs;
+}
+
+void LoadSmoother::AddSample(std::uint64_t ns, std::uint32_t load)
+{
+    if (this->mode == LoadSmoother_Ema)
+    {
+        if (!this->primed || !this->spanNs)
+        {
+            this->ema = load;
+        }
+        else
+        {
+            float alpha = 1.f - expf(-(float)(ns - this->lastNs) / (float)this->spanNs);
+            this->ema += alpha * ((float)load - this->ema);
+        }
+    }
+    else
+    {
+        this->windowHead = this->windowCount ? (this->windowHead + 1) % LOAD_SMOOTHER_WINDOW_SAMPLES : 0;
+        if (this->windowCount < LOAD_SMOOTHER_WINDOW_SAMPLES)
+        {
+            this->windowCount++;
+        }
+        this->windowNs[this->windowHead] = ns;
+        this->windowLoad[this->windowHead] = load;
+    }
+
+    this->primed = true;
+    this->lastNs = ns;
+}
+
+std::uint32_t LoadSmoother::Get()
+{
+    if (!this->primed)
+    {
+        return 0;
+    }
+
+    if (this->mode == LoadSmoother_Ema)
+    {
+        return (std::uint32_t)(this->ema + .5f);
+    }
+
+    // The newest read always counts, older ones while inside the span
+    std::uint64_t newestNs = this->windowNs[this->windowHead];
+    std::uint64_t sum = 0;
+    std::uint32_t count = 0;
+    for (std::uint32_t i = 0; i < this->windowCount; i++)
+    {
+        std::uint32_t index = (this->windowHead + LOAD_SMOOTHER_WINDOW_SAMPLES - i) % LOAD_SMOOTHER_WINDOW_SAMPLES;
+        if (i && newestNs - this->windowNs[index] >= this->spanNs)
+        {
+            break;
+        }
+        sum += this->windowLoad[index];
+        count++;
+    }
+
+    return (sum + count / 2) / count;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#define LOAD_SMOOTHER_WINDOW_SAMPLES 32
+
+typedef enum
+{
+    LoadSmoother_Ema = 0,
+    LoadSmoother_Window,
+} LoadSmootherMode;
+
+/*
+ * Smoothing and rate limiting for a polled load counter.
+ *
+ * Due() caps how often the source gets read, so callers can ask on every
+ * tick (or faster) and only pay for a read once per minIntervalNs. The EMA
+ * weights by elapsed time rather than by sample, so the time constant holds
+ * whatever the read rate ends up being; the window mode is the plain mean of
+ * the reads within the last spanNs.
+ */
+class LoadSmoother
+{
+  public:
+    LoadSmoother();
+
+    void Reset();
+    void SetParams(LoadSmootherMode mode, std::uint64_t spanNs, std::uint64_t minIntervalNs);
+
+    bool Primed();
+    bool Due(std::uint64_t ns);
+    void AddSample(std::uint64_t ns, std::uint32_t load);
+    std::uint32_t Get();
+
+  protected:
+    LoadSmootherMode mode;
+    std::uint64_t spanNs;
+    std::uint64_t minIntervalNs;
+
+    bool primed;
+    std::uint64_t lastNs;
+    float ema;
+
+    std::uint64_t windowNs[LOAD_SMOOTHER_WINDOW_SAMPLES];
+    std::uint32_t windowLoad[LOAD_SMOOTHER_WINDOW_SAMPLES];
+    std::uint32_t windowHead;
+    std::uint32_t windowCount;
+};
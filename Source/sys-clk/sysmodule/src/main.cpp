@@ -39,6 +39,8 @@
 #include "ipc_service.h"
 #include "fancontrol.h"
 #include "emc_patcher.h"
+#include "heap_stats.h"
+#include "notification.h"
 
 #define INNER_HEAP_SIZE 0x50000
 
@@ -50,6 +52,10 @@ extern "C"
     TimeServiceType __nx_time_service_type = TimeServiceType_System;
     std::uint32_t __nx_fs_num_sessions = 1;
 
+    // Only the GPU load ioctl goes through nvdrv, the default 8 MiB transfer memory doesn't fit the heap
+    NvServiceType __nx_nv_service_type = NvServiceType_Factory;
+    u32 __nx_nv_transfermem_size = 0x8000;
+
     size_t nx_inner_heap_size = INNER_HEAP_SIZE;
     char nx_inner_heap[INNER_HEAP_SIZE];
 
@@ -64,6 +70,7 @@ extern "C"
 
         fake_heap_start = (char*)addr;
         fake_heap_end = (char*)addr + size;
+        HeapStats::SetHeapSize(size);
     }
 
     void __appInit(void)
@@ -117,6 +124,7 @@ int main(int argc, char** argv)
 
     try
     {
+        Notifications::Initialize();
         Board::Initialize();
         ProcessManagement::Initialize();
 
@@ -124,6 +132,7 @@ int main(int argc, char** argv)
 
         ClockManager* clockMgr = new ClockManager();
         IpcService* ipcSrv = new IpcService(clockMgr);
+        EMCpatcher::Initialize(clockMgr->GetConfig());
 
         FileUtils::LogLine("Starting Horizon OC Sysmodule");
 
@@ -143,9 +152,11 @@ int main(int argc, char** argv)
 
         ipcSrv->SetRunning(false);
         delete ipcSrv;
+        EMCpatcher::Exit();
         delete clockMgr;
         ProcessManagement::Exit();
         Board::Exit();
+        Notifications::Exit();
     }
     catch (const std::exception &ex)
     {
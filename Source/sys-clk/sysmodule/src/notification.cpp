@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "notification.h"
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <nxExt.h>
+#include "errors.h"
+#include "file_utils.h"
+#include "notification_queue.h"
+
+static LockableMutex g_queue_mutex;
+static NotificationQueue g_queue;
+static std::atomic_bool g_running = false;
+static Thread g_thread;
+static UEvent g_event;
+static bool g_flag_enabled = false;
+static std::uint64_t g_last_flag_check = 0;
+
+void Notifications::Initialize()
+{
+    ueventCreate(&g_event, true);
+
+    // Lowest priority, preemptive core: notifications can wait
+    Result rc = threadCreate(&g_thread, &Notifications::ThreadFunc, NULL, NULL, 0x2000, 0x3F, -2);
+    ASSERT_RESULT_OK(rc, "threadCreate");
+
+    g_running = true;
+    rc = threadStart(&g_thread);
+    ASSERT_RESULT_OK(rc, "threadStart");
+}
+
+void Notifications::Exit()
+{
+    if (!g_running)
+    {
+        return;
+    }
+
+    // Whatever still waits is dropped, it would show after the fact
+    g_running = false;
+    ueventSignal(&g_event);
+    threadWaitForExit(&g_thread);
+    threadClose(&g_thread);
+}
+
+void Notifications::Post(const char* text)
+{
+    bool queued;
+    {
+        std::scoped_lock lock{g_queue_mutex};
+        queued = g_queue.Post(text, armTicksToNs(armGetSystemTick()));
+    }
+
+    if (queued && g_running)
+    {
+        ueventSignal(&g_event);
+    }
+}
+
+bool Notifications::IsEnabled()
+{
+    std::uint64_t now = armTicksToNs(armGetSystemTick());
+    if (g_last_flag_check && now - g_last_flag_check < FILE_FLAG_CHECK_INTERVAL_NS)
+    {
+        return g_flag_enabled;
+    }
+
+    FILE* file = fopen(NOTIFICATION_FLAG_PATH, "r");
+    g_flag_enabled = file;
+    if (file)
+    {
+        fclose(file);
+    }
+    g_last_flag_check = now;
+
+    return g_flag_enabled;
+}
+
+void Notifications::Write(const char* text)
+{
+    if (!Notifications::IsEnabled())
+    {
+        return;
+    }
+
+    char path[96];
+    snprintf(path, sizeof(path), NOTIFICATION_DIR "/Horzon OC -%lld.notify", (long long)std::time(nullptr));
+
+    char json[NOTIFICATION_TEXT_MAX + 64];
+    int size = snprintf(json, sizeof(json), "{\n  \"text\": \"%s\",\n  \"fontSize\": 28\n}\n", text);
+
+    FILE* file = fopen(path, "w");
+    if (file)
+    {
+        fwrite(json, 1, size, file);
+        fclose(file);
+    }
+}
+
+void Notifications::ThreadFunc(void* arg)
+{
+    char text[NOTIFICATION_TEXT_MAX];
+
+    while (g_running)
+    {
+        std::uint64_t waitNs;
+        bool taken;
+        {
+            std::scoped_lock lock{g_queue_mutex};
+            std::uint64_t ns = armTicksToNs(armGetSystemTick());
+            taken = g_queue.Take(ns, text);
+            waitNs = g_queue.WaitNs(ns);
+        }
+
+        if (taken)
+        {
+            Notifications::Write(text);
+        }
+        else
+        {
+            waitSingle(waiterForUEvent(&g_event), waitNs);
+        }
+    }
+}
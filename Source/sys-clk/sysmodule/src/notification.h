@@ -1,31 +1,25 @@
 #pragma once
 
-#include <string>
-#include <ctime>
-#include <cstdio>
+#include <switch.h>
 
-static void writeNotification(const std::string& message) {
-        const char* flagPath = "sdmc:/config/ultrahand/flags/NOTIFICATIONS.flag";
+#define NOTIFICATION_FLAG_PATH "sdmc:/config/ultrahand/flags/NOTIFICATIONS.flag"
+#define NOTIFICATION_DIR "sdmc:/config/ultrahand/notifications"
 
-        // Check if flag file exists
-        FILE* flagFile = fopen(flagPath, "r");
-        if (!flagFile) {
-            // Flag file does not exist, do nothing
-            return;
-        }
-        fclose(flagFile);
+/*
+ * Ultrahand notifications. Post only queues the text and wakes a lowest
+ * priority thread, which checks the flag (cached, see
+ * FILE_FLAG_CHECK_INTERVAL_NS) and writes the .notify file, so a limit
+ * tripping on the governor thread costs no SD access there.
+ */
+class Notifications
+{
+  public:
+    static void Initialize();
+    static void Exit();
+    static void Post(const char* text);
 
-        // Generate filename with timestamp
-        std::string filename = "Horzon OC -" + std::to_string(std::time(nullptr)) + ".notify";
-        std::string fullPath = "sdmc:/config/ultrahand/notifications/" + filename;
-
-        // Write JSON manually
-        FILE* file = fopen(fullPath.c_str(), "w");
-        if (file) {
-            fprintf(file, "{\n");
-            fprintf(file, "  \"text\": \"%s\",\n", message.c_str());
-            fprintf(file, "  \"fontSize\": 28\n");
-            fprintf(file, "}\n");
-            fclose(file);
-        }
-    }
+  protected:
+    static void ThreadFunc(void* arg);
+    static bool IsEnabled();
+    static void Write(const char* text);
+};
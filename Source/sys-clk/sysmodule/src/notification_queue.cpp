@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "notification_queue.h"
+#include <cstring>
+
+NotificationQueue::NotificationQueue()
+{
+    memset(this->slots, 0, sizeof(this->slots));
+    memset(&this->stats, 0, sizeof(this->stats));
+    this->hasSent = false;
+    this->lastSentNs = 0;
+}
+
+NotificationQueue::Slot* NotificationQueue::FindSlot(const char* text)
+{
+    for (Slot& slot : this->slots)
+    {
+        if (slot.used && !strncmp(slot.text, text, NOTIFICATION_TEXT_MAX - 1))
+        {
+            return &slot;
+        }
+    }
+
+    return nullptr;
+}
+
+NotificationQueue::Slot* NotificationQueue::FreeSlot()
+{
+    // Unused first, then the one shown the longest ago
+    Slot* oldest = nullptr;
+    for (Slot& slot : this->slots)
+    {
+        if (!slot.used)
+        {
+            return &slot;
+        }
+
+        if (!slot.pending && (!oldest || slot.sentNs < oldest->sentNs))
+        {
+            oldest = &slot;
+        }
+    }
+
+    return oldest;
+}
+
+bool NotificationQueue::Post(const char* text, std::uint64_t ns)
+{
+    this->stats.posted++;
+
+    Slot* slot = this->FindSlot(text);
+    if (slot && slot->pending)
+    {
+        this->stats.coalesced++;
+        return true;
+    }
+
+    if (slot && ns - slot->sentNs < NOTIFICATION_REPEAT_NS)
+    {
+        this->stats.suppressed++;
+        return false;
+    }
+
+    if (!slot)
+    {
+        slot = this->FreeSlot();
+        if (!slot)
+        {
+            this->stats.dropped++;
+            return false;
+        }
+
+        slot->used = true;
+        strncpy(slot->text, text, NOTIFICATION_TEXT_MAX - 1);
+        slot->text[NOTIFICATION_TEXT_MAX - 1] = '\0';
+    }
+
+    slot->pending = true;
+    slot->postedNs = ns;
+    return true;
+}
+
+bool NotificationQueue::Pending()
+{
+    for (Slot& slot : this->slots)
+    {
+        if (slot.pending)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::uint64_t NotificationQueue::WaitNs(std::uint64_t ns)
+{
+    if (!this->Pending())
+    {
+        return UINT64_MAX;
+    }
+
+    if (!this->hasSent)
+    {
+        return 0;
+    }
+
+    std::uint64_t dueAt = this->lastSentNs + NOTIFICATION_MIN_INTERVAL_NS;
+    return ns >= dueAt ? 0 : dueAt - ns;
+}
+
+bool NotificationQueue::Take(std::uint64_t ns, char* out)
+{
+    if (this->WaitNs(ns))
+    {
+        return false;
+    }
+
+    Slot* next = nullptr;
+    for (Slot& slot : this->slots)
+    {
+        if (slot.pending && (!next || slot.postedNs < next->postedNs))
+        {
+            next = &slot;
+        }
+    }
+
+    next->pending = false;
+    next->sentNs = ns;
+    this->hasSent = true;
+    this->lastSentNs = ns;
+    this->stats.sent++;
+
+    memcpy(out, next->text, NOTIFICATION_TEXT_MAX);
+    return true;
+}
+
+void NotificationQueue::GetStats(NotificationQueueStats* out_stats)
+{
+    *out_stats = this->stats;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#define NOTIFICATION_QUEUE_SLOTS 8
+#define NOTIFICATION_TEXT_MAX 96
+#define NOTIFICATION_MIN_INTERVAL_NS 2000000000ULL  // between two notifications, whatever they say
+#define NOTIFICATION_REPEAT_NS 60000000000ULL       // before the same text is shown again
+
+typedef struct
+{
+    std::uint32_t posted;
+    std::uint32_t coalesced;    // posted again while still waiting
+    std::uint32_t suppressed;   // posted again within NOTIFICATION_REPEAT_NS of being shown
+    std::uint32_t dropped;      // every slot was waiting
+    std::uint32_t sent;
+} NotificationQueueStats;
+
+/*
+ * Notifications waiting for the drain thread.
+ *
+ * A text posted while the same text still waits is merged into it, and a
+ * text shown less than NOTIFICATION_REPEAT_NS ago is dropped, so a limit
+ * flapping every tick costs one notification a minute. Whatever waits
+ * goes out oldest first, no closer than NOTIFICATION_MIN_INTERVAL_NS
+ * apart. Slots remember what was shown until they are needed for
+ * something new. Not thread safe, callers serialize access.
+ */
+class NotificationQueue
+{
+  public:
+    NotificationQueue();
+
+    // False when it won't be shown: a repeat, or no room
+    bool Post(const char* text, std::uint64_t ns);
+
+    bool Pending();
+    // 0 when one is due, UINT64_MAX when nothing waits
+    std::uint64_t WaitNs(std::uint64_t ns);
+    // out must hold NOTIFICATION_TEXT_MAX
+    bool Take(std::uint64_t ns, char* out);
+
+    void GetStats(NotificationQueueStats* out_stats);
+
+  protected:
+    typedef struct
+    {
+        bool used;
+        bool pending;
+        std::uint64_t postedNs;
+        std::uint64_t sentNs;
+        char text[NOTIFICATION_TEXT_MAX];
+    } Slot;
+
+    Slot* FindSlot(const char* text);
+    Slot* FreeSlot();
+
+    Slot slots[NOTIFICATION_QUEUE_SLOTS];
+    bool hasSent;
+    std::uint64_t lastSentNs;
+    NotificationQueueStats stats;
+};
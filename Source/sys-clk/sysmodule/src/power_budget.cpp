@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "power_budget.h"
+#include <algorithm>
+#include <cstdlib>
+
+#define POWER_BUDGET_ROWS(rows) (sizeof(rows) / sizeof(rows[0])), rows
+
+// Lowest rows are the battery running low, the second is stock handheld,
+// then charging over USB, an 18 W PD charger and the dock's own. The
+// handheld and USB rows stand in for the old GPU-only caps, so they leave
+// the CPU and MEM alone; only the low battery row has CPU/MEM ceilings,
+// applied when the CPU/MEM caps are enabled
+static const PowerBudgetRow g_erista_rows[] = {
+    {     0, { 1785000000, 384000000, 1331200000 } },
+    {  7000, { 0, 460800000, 0 } },
+    { 13000, { 0, 768000000, 0 } },
+    { 21000, { 0, 921600000, 0 } },
+    { 32000, { 0, 0, 0 } },
+};
+
+static const PowerBudgetRow g_mariko_rows[] = {
+    {     0, { 1785000000, 460800000, 1600000000 } },
+    {  6000, { 0, 614400000, 0 } },
+    { 12000, { 0, 768000000, 0 } },
+    { 20000, { 0, 1075200000, 0 } },
+    { 30000, { 0, 0, 0 } },
+};
+
+// No dock, only chargers
+static const PowerBudgetRow g_mariko_lite_rows[] = {
+    {     0, { 1785000000, 384000000, 1600000000 } },
+    {  5000, { 0, 537600000, 0 } },
+    { 10000, { 0, 768000000, 0 } },
+    { 16000, { 0, 0, 0 } },
+};
+
+static const PowerBudgetRow g_uncapped_rows[] = {
+    { 0, { 0, 0, 0 } },
+};
+
+static const PowerBudgetSoc g_erista = { 9000, POWER_BUDGET_ROWS(g_erista_rows) };
+static const PowerBudgetSoc g_mariko = { 8000, POWER_BUDGET_ROWS(g_mariko_rows) };
+static const PowerBudgetSoc g_mariko_lite = { 7000, POWER_BUDGET_ROWS(g_mariko_lite_rows) };
+static const PowerBudgetSoc g_uncapped = { 0, POWER_BUDGET_ROWS(g_uncapped_rows) };
+
+PowerBudget::PowerBudget()
+{
+    this->cpuMemCaps = false;
+    this->batteryAware = false;
+    this->Reset();
+}
+
+void PowerBudget::Reset()
+{
+    this->soc = &g_uncapped;
+    this->row = 0;
+    this->budgetMw = 0;
+    this->penaltyMw = 0;
+    this->contractMw = 0;
+    this->lastNs = 0;
+    this->settledAtNs = 0;
+}
+
+const PowerBudgetSoc* PowerBudget::GetSoc(SysClkSocType socType)
+{
+    switch (socType)
+    {
+        case SysClkSocType_Erista:
+            return &g_erista;
+        case SysClkSocType_Mariko:
+            return &g_mariko;
+        case SysClkSocType_MarikoLite:
+            return &g_mariko_lite;
+        default:
+            return &g_uncapped;
+    }
+}
+
+std::int32_t PowerBudget::GetDischargeMw(const PowerBudgetSoc* soc, std::uint32_t batteryPcm)
+{
+    if (batteryPcm <= POWER_BUDGET_DISCHARGE_EMPTY_PCM)
+    {
+        return 0;
+    }
+
+    if (batteryPcm >= POWER_BUDGET_DISCHARGE_FULL_PCM)
+    {
+        return soc->dischargeMw;
+    }
+
+    return (std::int64_t)soc->dischargeMw * (batteryPcm - POWER_BUDGET_DISCHARGE_EMPTY_PCM) /
+           (POWER_BUDGET_DISCHARGE_FULL_PCM - POWER_BUDGET_DISCHARGE_EMPTY_PCM);
+}
+
+std::uint32_t PowerBudget::SelectRow(std::int32_t budgetMw)
+{
+    std::uint32_t row = std::min(this->row, this->soc->rowCount - 1);
+
+    while (row > 0 && budgetMw < this->soc->rows[row].budgetMw)
+    {
+        row--;
+    }
+
+    while (row + 1 < this->soc->rowCount && budgetMw >= this->soc->rows[row + 1].budgetMw + POWER_BUDGET_HYSTERESIS_MW)
+    {
+        row++;
+    }
+
+    return row;
+}
+
+bool PowerBudget::Update(SysClkSocType socType, const PowerBudgetInputs* inputs, std::uint64_t ns)
+{
+    bool changed = false;
+    const PowerBudgetSoc* soc = PowerBudget::GetSoc(socType);
+    // New SoC, or the first reading after the fallback: the row carries over, the rest starts over
+    if (soc != this->soc || !this->lastNs)
+    {
+        std::uint32_t row = soc == this->soc ? this->row : 0;
+        this->Reset();
+        this->soc = soc;
+        this->row = row;
+        this->settledAtNs = ns + POWER_BUDGET_SETTLE_NS;
+        changed = true;
+    }
+
+    // A new charger starts over, the old penalty was about the old one
+    if (std::abs(inputs->contractMw - this->contractMw) >= POWER_BUDGET_HYSTERESIS_MW)
+    {
+        this->contractMw = inputs->contractMw;
+        this->penaltyMw = 0;
+        this->settledAtNs = ns + POWER_BUDGET_SETTLE_NS;
+    }
+
+    if (this->lastNs && ns > this->lastNs)
+    {
+        std::int64_t decay = (std::int64_t)POWER_BUDGET_PENALTY_DECAY_MW_PER_S * (ns - this->lastNs) / 1000000000ULL;
+        this->penaltyMw = std::max<std::int64_t>(0, this->penaltyMw - decay);
+    }
+    this->lastNs = ns;
+
+    std::int32_t dischargeMw = soc->dischargeMw;
+    std::int32_t reserveMw = 0;
+    if (this->batteryAware)
+    {
+        dischargeMw = PowerBudget::GetDischargeMw(soc, inputs->batteryPcm);
+        reserveMw = inputs->contractMw && inputs->batteryPcm < POWER_BUDGET_RESERVE_BELOW_PCM ? inputs->chargeMw : 0;
+    }
+    std::int32_t rawMw = std::max(0, inputs->contractMw * POWER_BUDGET_INPUT_EFFICIENCY / 100 - reserveMw + dischargeMw);
+
+    // The battery should be gaining the reserve, or losing no more than its headroom
+    std::int32_t expectedMw = reserveMw ? reserveMw : -dischargeMw;
+    std::int32_t overdrawMw = expectedMw - inputs->batteryMw;
+    if (this->batteryAware && ns >= this->settledAtNs && overdrawMw > POWER_BUDGET_HYSTERESIS_MW)
+    {
+        // Under the current row by what it overdrew
+        std::int32_t penaltyMw = rawMw - soc->rows[this->row].budgetMw + overdrawMw;
+        this->penaltyMw = std::max(this->penaltyMw, penaltyMw);
+    }
+    this->penaltyMw = std::min(this->penaltyMw, rawMw);
+    this->budgetMw = rawMw - this->penaltyMw;
+
+    std::uint32_t row = this->SelectRow(this->budgetMw);
+    if (row != this->row)
+    {
+        this->row = row;
+        this->settledAtNs = ns + POWER_BUDGET_SETTLE_NS;
+        changed = true;
+    }
+
+    return changed;
+}
+
+bool PowerBudget::UpdateFallback(SysClkSocType socType, SysClkProfile profile)
+{
+    const PowerBudgetSoc* soc = PowerBudget::GetSoc(socType);
+    std::uint32_t row = soc->rowCount - 1;
+    if (profile < SysClkProfile_HandheldCharging)
+    {
+        row = POWER_BUDGET_ROW_HANDHELD;
+    }
+    else if (profile <= SysClkProfile_HandheldChargingUSB)
+    {
+        row = POWER_BUDGET_ROW_USB;
+    }
+    row = std::min(row, soc->rowCount - 1);
+
+    if (soc == this->soc && row == this->row)
+    {
+        return false;
+    }
+
+    // Update starts over from this row once the charger info is back
+    this->Reset();
+    this->soc = soc;
+    this->row = row;
+    this->budgetMw = soc->rows[row].budgetMw;
+    return true;
+}
+
+bool PowerBudget::SetCpuMemCaps(bool enabled)
+{
+    if (enabled == this->cpuMemCaps)
+    {
+        return false;
+    }
+
+    this->cpuMemCaps = enabled;
+    return true;
+}
+
+bool PowerBudget::SetBatteryAware(bool enabled)
+{
+    if (enabled == this->batteryAware)
+    {
+        return false;
+    }
+
+    // What the fuel gauge taught doesn't hold with the full headroom
+    this->batteryAware = enabled;
+    this->penaltyMw = 0;
+    return true;
+}
+
+std::uint32_t PowerBudget::GetMaxHz(SysClkModule module)
+{
+    if (module != SysClkModule_GPU && !this->cpuMemCaps)
+    {
+        return 0;
+    }
+
+    return this->soc->rows[this->row].hz[module];
+}
+
+std::int32_t PowerBudget::GetBudgetMw()
+{
+    return this->budgetMw;
+}
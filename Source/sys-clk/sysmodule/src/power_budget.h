@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sysclk.h>
+
+#define POWER_BUDGET_INPUT_EFFICIENCY 90            // percent of the contract left after the charger circuit
+#define POWER_BUDGET_RESERVE_BELOW_PCM 80000        // below this charge, charging the battery comes first
+#define POWER_BUDGET_DISCHARGE_EMPTY_PCM 15000      // no battery headroom from here down
+#define POWER_BUDGET_DISCHARGE_FULL_PCM 50000       // full headroom from here up
+#define POWER_BUDGET_HYSTERESIS_MW 1000             // over a row's budget before stepping up to it
+#define POWER_BUDGET_SETTLE_NS 10000000000ULL       // fuel gauge average catching up after a change
+#define POWER_BUDGET_PENALTY_DECAY_MW_PER_S 100
+#define POWER_BUDGET_ROW_HANDHELD 1                 // stock handheld caps, in every SoC's table
+#define POWER_BUDGET_ROW_USB 2                      // charging over USB
+
+typedef struct
+{
+    std::int32_t contractMw;    // negotiated with the charger, 0 on battery
+    std::int32_t chargeMw;      // charging the battery at its current limit
+    std::uint32_t batteryPcm;   // charge, per cent-mille
+    std::int32_t batteryMw;     // fuel gauge average, negative while discharging
+} PowerBudgetInputs;
+
+typedef struct
+{
+    std::int32_t budgetMw;
+    std::uint32_t hz[SysClkModule_EnumMax];     // 0 leaves the module uncapped
+} PowerBudgetRow;
+
+typedef struct
+{
+    std::int32_t dischargeMw;   // what the battery may give on top of the charger, at full headroom
+    std::uint32_t rowCount;
+    const PowerBudgetRow* rows; // by budget, ascending, the first at 0 mW
+} PowerBudgetSoc;
+
+/*
+ * Clock ceilings from what the charger and the battery can supply.
+ *
+ * The budget is the charger's contract less conversion losses, less what
+ * charging a low battery takes, plus what the battery may give at its
+ * charge level. It picks the highest row of the SoC's table it covers,
+ * stepping up only with POWER_BUDGET_HYSTERESIS_MW to spare. The fuel
+ * gauge checks the estimate: once settled, a battery draining past its
+ * headroom (or charging below its reserve) moves the budget down by the
+ * difference, and that penalty fades so higher rows get retried.
+ *
+ * The charge level, the reserve and the fuel gauge check only count with
+ * SetBatteryAware (HocClkConfigValue_PowerBudgetBattery); without it the
+ * battery always gives its full headroom, so the caps never drop below
+ * the stock ones for the profile. Only the GPU ceilings apply by default,
+ * the CPU and MEM ones need SetCpuMemCaps
+ * (HocClkConfigValue_PowerBudgetCpuMemCaps).
+ */
+class PowerBudget
+{
+  public:
+    PowerBudget();
+
+    void Reset();
+    // True when the ceilings changed
+    bool Update(SysClkSocType socType, const PowerBudgetInputs* inputs, std::uint64_t ns);
+    // Without charger info, the caps the profile always had. True when the ceilings changed
+    bool UpdateFallback(SysClkSocType socType, SysClkProfile profile);
+    // True when the setting changed
+    bool SetCpuMemCaps(bool enabled);
+    // True when the setting changed, the budget follows on the next Update
+    bool SetBatteryAware(bool enabled);
+    std::uint32_t GetMaxHz(SysClkModule module);
+    std::int32_t GetBudgetMw();
+
+    static const PowerBudgetSoc* GetSoc(SysClkSocType socType);
+    static std::int32_t GetDischargeMw(const PowerBudgetSoc* soc, std::uint32_t batteryPcm);
+
+  protected:
+    std::uint32_t SelectRow(std::int32_t budgetMw);
+
+    const PowerBudgetSoc* soc;
+    bool cpuMemCaps;
+    bool batteryAware;
+    std::uint32_t row;
+    std::int32_t budgetMw;
+    std::int32_t penaltyMw;
+    std::int32_t contractMw;
+    std::uint64_t lastNs;
+    std::uint64_t settledAtNs;
+};
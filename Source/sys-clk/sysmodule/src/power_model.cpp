@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "power_model.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// ~2000 samples of memory, about 10 minutes at the default polling interval
+#define POWER_MODEL_FORGET 0.9995
+// Keeps the fit solvable while a rail sits at one operating point
+#define POWER_MODEL_RIDGE 0.01
+// Running means turn into moving averages past this many samples
+#define POWER_MODEL_MEAN_WINDOW 256
+
+PowerModel::PowerModel()
+{
+    this->Reset(0);
+}
+
+void PowerModel::Reset(std::uint64_t deviceId)
+{
+    memset(&this->state, 0, sizeof(this->state));
+    this->state.magic = POWER_MODEL_MAGIC;
+    this->state.version = POWER_MODEL_VERSION;
+    this->state.size = sizeof(this->state);
+    this->state.deviceId = deviceId;
+    this->dirty = false;
+}
+
+void PowerModel::Features(const std::uint32_t* hz, const float* uv, double* x)
+{
+    // f in GHz and V in volts keep every feature around 1
+    x[0] = 1.;
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        double v = uv[module] / 1000000.;
+        x[1 + module] = hz[module] / 1000000000. * v * v;
+    }
+}
+
+void PowerModel::AddSample(const std::uint32_t* hz, const std::uint32_t* uv, std::int32_t drawMw)
+{
+    if (drawMw <= 0)
+    {
+        return;
+    }
+
+    float fuv[SysClkModule_EnumMax];
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        if (!hz[module])
+        {
+            return;
+        }
+        fuv[module] = uv[module];
+        this->AddRailPoint((SysClkModule)module, hz[module], uv[module]);
+    }
+
+    double x[POWER_MODEL_FEATURES];
+    this->Features(hz, fuv, x);
+
+    for (unsigned int i = 0; i < POWER_MODEL_FEATURES; i++)
+    {
+        for (unsigned int j = 0; j < POWER_MODEL_FEATURES; j++)
+        {
+            this->state.xtx[i][j] = this->state.xtx[i][j] * POWER_MODEL_FORGET + x[i] * x[j];
+        }
+        this->state.xty[i] = this->state.xty[i] * POWER_MODEL_FORGET + x[i] * drawMw;
+    }
+
+    this->AddTuple(hz, drawMw);
+    this->state.samples++;
+    this->Solve();
+    this->dirty = true;
+}
+
+void PowerModel::Solve()
+{
+    double a[POWER_MODEL_FEATURES][POWER_MODEL_FEATURES + 1];
+
+    for (unsigned int i = 0; i < POWER_MODEL_FEATURES; i++)
+    {
+        for (unsigned int j = 0; j < POWER_MODEL_FEATURES; j++)
+        {
+            a[i][j] = this->state.xtx[i][j];
+        }
+        // The base draw is not regularized
+        if (i)
+        {
+            a[i][i] += POWER_MODEL_RIDGE;
+        }
+        a[i][POWER_MODEL_FEATURES] = this->state.xty[i];
+    }
+
+    // Gaussian elimination with partial pivoting
+    for (unsigned int col = 0; col < POWER_MODEL_FEATURES; col++)
+    {
+        unsigned int pivot = col;
+        for (unsigned int row = col + 1; row < POWER_MODEL_FEATURES; row++)
+        {
+            if (std::fabs(a[row][col]) > std::fabs(a[pivot][col]))
+            {
+                pivot = row;
+            }
+        }
+
+        if (std::fabs(a[pivot][col]) < 1e-12)
+        {
+            return;
+        }
+
+        if (pivot != col)
+        {
+            for (unsigned int j = 0; j <= POWER_MODEL_FEATURES; j++)
+            {
+                double tmp = a[col][j];
+                a[col][j] = a[pivot][j];
+                a[pivot][j] = tmp;
+            }
+        }
+
+        for (unsigned int row = col + 1; row < POWER_MODEL_FEATURES; row++)
+        {
+            double factor = a[row][col] / a[col][col];
+            for (unsigned int j = col; j <= POWER_MODEL_FEATURES; j++)
+            {
+                a[row][j] -= factor * a[col][j];
+            }
+        }
+    }
+
+    double coeffs[POWER_MODEL_FEATURES];
+    for (int row = POWER_MODEL_FEATURES - 1; row >= 0; row--)
+    {
+        double sum = a[row][POWER_MODEL_FEATURES];
+        for (unsigned int j = row + 1; j < POWER_MODEL_FEATURES; j++)
+        {
+            sum -= a[row][j] * coeffs[j];
+        }
+        coeffs[row] = sum / a[row][row];
+    }
+
+    memcpy(this->state.coeffs, coeffs, sizeof(coeffs));
+}
+
+PowerModel::Tuple* PowerModel::FindTuple(const std::uint32_t* hz)
+{
+    for (std::uint32_t i = 0; i < this->state.tupleCount; i++)
+    {
+        Tuple* tuple = &this->state.tuples[i];
+        bool match = true;
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            match &= tuple->key[module] == hz[module] / 100000;
+        }
+
+        if (match)
+        {
+            return tuple;
+        }
+    }
+
+    return nullptr;
+}
+
+void PowerModel::AddTuple(const std::uint32_t* hz, std::int32_t drawMw)
+{
+    Tuple* tuple = this->FindTuple(hz);
+
+    if (!tuple)
+    {
+        if (this->state.tupleCount < POWER_MODEL_TUPLES)
+        {
+            tuple = &this->state.tuples[this->state.tupleCount++];
+        }
+        else
+        {
+            // Full, the least visited tuple makes room
+            tuple = &this->state.tuples[0];
+            for (std::uint32_t i = 1; i < POWER_MODEL_TUPLES; i++)
+            {
+                if (this->state.tuples[i].samples < tuple->samples)
+                {
+                    tuple = &this->state.tuples[i];
+                }
+            }
+        }
+
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            tuple->key[module] = hz[module] / 100000;
+        }
+        tuple->samples = 0;
+        tuple->meanMw = 0;
+    }
+
+    tuple->samples++;
+    std::uint32_t n = tuple->samples < POWER_MODEL_MEAN_WINDOW ? tuple->samples : POWER_MODEL_MEAN_WINDOW;
+    tuple->meanMw += (drawMw - tuple->meanMw) / n;
+}
+
+void PowerModel::AddRailPoint(SysClkModule module, std::uint32_t hz, std::uint32_t uv)
+{
+    RailPoint* points = this->state.rails[module];
+    std::uint32_t* count = &this->state.railCount[module];
+
+    // Sorted by frequency
+    std::uint32_t i = 0;
+    while (i < *count && points[i].hz < hz)
+    {
+        i++;
+    }
+
+    if (i == *count || points[i].hz != hz)
+    {
+        if (*count == SYSCLK_FREQ_LIST_MAX)
+        {
+            return;
+        }
+
+        memmove(&points[i + 1], &points[i], (*count - i) * sizeof(points[0]));
+        points[i].hz = hz;
+        points[i].samples = 0;
+        points[i].uv = 0;
+        (*count)++;
+    }
+
+    points[i].samples++;
+    std::uint32_t n = points[i].samples < POWER_MODEL_MEAN_WINDOW ? points[i].samples : POWER_MODEL_MEAN_WINDOW;
+    points[i].uv += (uv - points[i].uv) / n;
+}
+
+bool PowerModel::GetRailUv(SysClkModule module, std::uint32_t hz, float* outUv)
+{
+    RailPoint* points = this->state.rails[module];
+    std::uint32_t count = this->state.railCount[module];
+
+    if (!count)
+    {
+        return false;
+    }
+
+    std::uint32_t i = 0;
+    while (i < count && points[i].hz < hz)
+    {
+        i++;
+    }
+
+    if (i == count)
+    {
+        // Above anything seen, the real voltage can only be higher
+        *outUv = points[count - 1].uv;
+    }
+    else if (points[i].hz == hz || i == 0)
+    {
+        *outUv = points[i].uv;
+    }
+    else
+    {
+        const RailPoint* lo = &points[i - 1];
+        const RailPoint* hi = &points[i];
+        *outUv = lo->uv + (hi->uv - lo->uv) * (float)(hz - lo->hz) / (float)(hi->hz - lo->hz);
+    }
+
+    return true;
+}
+
+bool PowerModel::Ready()
+{
+    return this->state.samples >= POWER_MODEL_MIN_SAMPLES;
+}
+
+bool PowerModel::IsDirty()
+{
+    return this->dirty;
+}
+
+std::uint32_t PowerModel::GetSampleCount()
+{
+    return this->state.samples;
+}
+
+std::int32_t PowerModel::EstimateMw(const std::uint32_t* hz)
+{
+    Tuple* tuple = this->FindTuple(hz);
+    if (tuple && tuple->samples >= POWER_MODEL_TUPLE_SAMPLES)
+    {
+        return (std::int32_t)tuple->meanMw;
+    }
+
+    std::int32_t rails[POWER_MODEL_FEATURES];
+    if (!this->GetRailMw(hz, rails))
+    {
+        return -1;
+    }
+
+    std::int32_t mw = 0;
+    for (unsigned int i = 0; i < POWER_MODEL_FEATURES; i++)
+    {
+        mw += rails[i];
+    }
+    return mw;
+}
+
+bool PowerModel::GetRailMw(const std::uint32_t* hz, std::int32_t* outMw)
+{
+    if (!this->Ready())
+    {
+        return false;
+    }
+
+    float uv[SysClkModule_EnumMax];
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        if (!this->GetRailUv((SysClkModule)module, hz[module], &uv[module]))
+        {
+            return false;
+        }
+    }
+
+    double x[POWER_MODEL_FEATURES];
+    this->Features(hz, uv, x);
+
+    // A rail never gives power back, whatever the fit made of noise
+    for (unsigned int i = 0; i < POWER_MODEL_FEATURES; i++)
+    {
+        double mw = this->state.coeffs[i] * x[i];
+        outMw[i] = mw > 0 ? (std::int32_t)mw : 0;
+    }
+
+    return true;
+}
+
+bool PowerModel::FindCheapest(const std::uint32_t* minHz, std::uint32_t* outHz, std::int32_t* outMw)
+{
+    std::uint32_t candidates[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX];
+    std::uint32_t counts[SysClkModule_EnumMax];
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        counts[module] = 0;
+        for (std::uint32_t i = 0; i < this->state.railCount[module]; i++)
+        {
+            if (this->state.rails[module][i].hz >= minHz[module])
+            {
+                candidates[module][counts[module]++] = this->state.rails[module][i].hz;
+            }
+        }
+
+        if (!counts[module])
+        {
+            return false;
+        }
+    }
+
+    std::int32_t bestMw = -1;
+    std::uint32_t hz[SysClkModule_EnumMax];
+    std::uint32_t index[SysClkModule_EnumMax] = {};
+
+    while (true)
+    {
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            hz[module] = candidates[module][index[module]];
+        }
+
+        std::int32_t mw = this->EstimateMw(hz);
+        if (mw >= 0 && (bestMw < 0 || mw < bestMw))
+        {
+            bestMw = mw;
+            memcpy(outHz, hz, sizeof(hz));
+        }
+
+        unsigned int module = 0;
+        while (module < SysClkModule_EnumMax && ++index[module] == counts[module])
+        {
+            index[module] = 0;
+            module++;
+        }
+
+        if (module == SysClkModule_EnumMax)
+        {
+            break;
+        }
+    }
+
+    if (outMw)
+    {
+        *outMw = bestMw;
+    }
+
+    return bestMw >= 0;
+}
+
+bool PowerModel::Load(const char* path, std::uint64_t deviceId)
+{
+    FILE* file = fopen(path, "rb");
+    bool loaded = false;
+
+    if (file)
+    {
+        loaded = fread(&this->state, sizeof(this->state), 1, file) == 1 &&
+                 this->state.magic == POWER_MODEL_MAGIC &&
+                 this->state.version == POWER_MODEL_VERSION &&
+                 this->state.size == sizeof(this->state) &&
+                 this->state.deviceId == deviceId;
+        fclose(file);
+    }
+
+    // Another console's measurements are worse than none
+    if (!loaded)
+    {
+        this->Reset(deviceId);
+    }
+
+    this->dirty = false;
+    return loaded;
+}
+
+bool PowerModel::Save(const char* path)
+{
+    char tmpPath[256];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE* file = fopen(tmpPath, "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool written = fwrite(&this->state, sizeof(this->state), 1, file) == 1;
+    written &= fclose(file) == 0;
+
+    if (written)
+    {
+        remove(path);
+        written = rename(tmpPath, path) == 0;
+    }
+
+    if (written)
+    {
+        this->dirty = false;
+    }
+
+    return written;
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sysclk.h>
+
+#define POWER_MODEL_MAGIC 0x4D57504F // "OPWM"
+#define POWER_MODEL_VERSION 1
+#define POWER_MODEL_TUPLES 64
+#define POWER_MODEL_FEATURES (1 + SysClkModule_EnumMax)
+#define POWER_MODEL_MIN_SAMPLES 64     // samples before the fit is trusted
+#define POWER_MODEL_TUPLE_SAMPLES 16   // samples before a tuple's own mean is trusted
+
+/*
+ * Online power model of the operating point.
+ *
+ * Battery draw is attributed to the rails with a recursive least squares fit
+ * of P = base + sum(k[module] * f * V^2), with exponential forgetting so it
+ * follows temperature and battery aging. Next to the fit the measured draw
+ * of every (CPU, GPU, MEM) tuple and the voltage of every rail frequency are
+ * accumulated, so operating points that were actually visited are answered
+ * from measurements and unvisited ones from the fit.
+ *
+ * The state is plain data so it can be saved and loaded in one go. Not
+ * thread safe, callers serialize access.
+ */
+class PowerModel
+{
+  public:
+    PowerModel();
+
+    void Reset(std::uint64_t deviceId);
+
+    // hz and uv are indexed by SysClkModule, drawMw is the positive battery discharge
+    void AddSample(const std::uint32_t* hz, const std::uint32_t* uv, std::int32_t drawMw);
+
+    bool Ready();
+    bool IsDirty();
+    std::uint32_t GetSampleCount();
+
+    // Estimated draw of an operating point, -1 if the model can't tell
+    std::int32_t EstimateMw(const std::uint32_t* hz);
+
+    // Base draw followed by the share of each rail, SysClkModule order
+    bool GetRailMw(const std::uint32_t* hz, std::int32_t* outMw);
+
+    // Cheapest known operating point running every module at least at minHz (0 = any)
+    bool FindCheapest(const std::uint32_t* minHz, std::uint32_t* outHz, std::int32_t* outMw);
+
+    bool Load(const char* path, std::uint64_t deviceId);
+    bool Save(const char* path);
+
+  protected:
+    struct Tuple
+    {
+        std::uint16_t key[SysClkModule_EnumMax]; // 100 kHz units
+        std::uint32_t samples;
+        float meanMw;
+    };
+
+    struct RailPoint
+    {
+        std::uint32_t hz;
+        std::uint32_t samples;
+        float uv;
+    };
+
+    struct State
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t size;
+        std::uint32_t samples;
+        std::uint64_t deviceId;
+        double xtx[POWER_MODEL_FEATURES][POWER_MODEL_FEATURES];
+        double xty[POWER_MODEL_FEATURES];
+        double coeffs[POWER_MODEL_FEATURES];
+        Tuple tuples[POWER_MODEL_TUPLES];
+        std::uint32_t tupleCount;
+        RailPoint rails[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX];
+        std::uint32_t railCount[SysClkModule_EnumMax];
+    };
+
+    void Features(const std::uint32_t* hz, const float* uv, double* x);
+    void AddTuple(const std::uint32_t* hz, std::int32_t drawMw);
+    Tuple* FindTuple(const std::uint32_t* hz);
+    void AddRailPoint(SysClkModule module, std::uint32_t hz, std::uint32_t uv);
+    bool GetRailUv(SysClkModule module, std::uint32_t hz, float* outUv);
+    void Solve();
+
+    State state;
+    bool dirty;
+};
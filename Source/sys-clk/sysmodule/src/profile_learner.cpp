@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "profile_learner.h"
+#include <cstdio>
+#include <cstring>
+
+ProfileLearner::ProfileLearner()
+{
+    this->Reset();
+}
+
+void ProfileLearner::Reset()
+{
+    memset(&this->state, 0, sizeof(this->state));
+    this->state.magic = PROFILE_LEARNER_MAGIC;
+    this->state.version = PROFILE_LEARNER_VERSION;
+    this->state.size = sizeof(this->state);
+    this->dirty = false;
+}
+
+std::uint32_t ProfileLearner::HzBucket(std::uint64_t khz)
+{
+    std::uint64_t bucket = khz / (PROFILE_LEARNER_HZ_BUCKET_MHZ * 1000);
+    return bucket < PROFILE_LEARNER_HZ_BUCKETS ? bucket : PROFILE_LEARNER_HZ_BUCKETS - 1;
+}
+
+ProfileLearner::Slot* ProfileLearner::FindSlot(std::uint64_t tid, SysClkProfile profile, bool create)
+{
+    Slot* oldest = &this->state.slots[0];
+
+    for (unsigned int i = 0; i < PROFILE_LEARNER_SLOTS; i++)
+    {
+        Slot* slot = &this->state.slots[i];
+        if (slot->tid == tid && slot->profile == (std::uint32_t)profile)
+        {
+            return slot;
+        }
+
+        if (slot->lastUsed < oldest->lastUsed)
+        {
+            oldest = slot;
+        }
+    }
+
+    if (!create)
+    {
+        return nullptr;
+    }
+
+    // Unused slots have lastUsed 0 and go first
+    memset(oldest, 0, sizeof(*oldest));
+    oldest->tid = tid;
+    oldest->profile = profile;
+    return oldest;
+}
+
+void ProfileLearner::AddToHistogram(ModuleHistogram* histogram, std::uint32_t loadBucket, std::uint32_t clockBucket, std::uint32_t demandBucket)
+{
+    if (histogram->load[loadBucket] == UINT16_MAX || histogram->clock[clockBucket] == UINT16_MAX || histogram->demand[demandBucket] == UINT16_MAX)
+    {
+        for (unsigned int i = 0; i < PROFILE_LEARNER_LOAD_BUCKETS; i++)
+        {
+            histogram->load[i] /= 2;
+        }
+        for (unsigned int i = 0; i < PROFILE_LEARNER_HZ_BUCKETS; i++)
+        {
+            histogram->clock[i] /= 2;
+            histogram->demand[i] /= 2;
+        }
+    }
+
+    histogram->load[loadBucket]++;
+    histogram->clock[clockBucket]++;
+    histogram->demand[demandBucket]++;
+    histogram->samples++;
+}
+
+void ProfileLearner::AddSample(std::uint64_t tid, SysClkProfile profile, const std::uint32_t* hz, const std::uint32_t* load, std::uint32_t loadMask)
+{
+    if (!tid || !loadMask)
+    {
+        return;
+    }
+
+    Slot* slot = this->FindSlot(tid, profile, true);
+    slot->lastUsed = ++this->state.sequence;
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        if (!(loadMask & (1 << module)) || !hz[module])
+        {
+            continue;
+        }
+
+        std::uint32_t permille = load[module] < 1000 ? load[module] : 1000;
+        std::uint32_t loadBucket = permille * PROFILE_LEARNER_LOAD_BUCKETS / 1001;
+        std::uint64_t khz = hz[module] / 1000;
+
+        AddToHistogram(&slot->modules[module], loadBucket, HzBucket(khz), HzBucket(khz * permille / 1000));
+    }
+
+    this->dirty = true;
+}
+
+std::uint32_t ProfileLearner::GetSampleCount(std::uint64_t tid, SysClkProfile profile, SysClkModule module)
+{
+    Slot* slot = this->FindSlot(tid, profile, false);
+    return slot ? slot->modules[module].samples : 0;
+}
+
+std::uint32_t ProfileLearner::ProposeMHz(std::uint64_t tid, SysClkProfile profile, SysClkModule module, std::uint32_t headroomPercent,
+                                         const std::uint32_t* freqs, std::uint32_t freqCount)
+{
+    Slot* slot = this->FindSlot(tid, profile, false);
+    if (!slot || !freqCount || !headroomPercent || slot->modules[module].samples < PROFILE_LEARNER_MIN_SAMPLES)
+    {
+        return 0;
+    }
+
+    const ModuleHistogram* histogram = &slot->modules[module];
+
+    std::uint64_t total = 0;
+    for (unsigned int i = 0; i < PROFILE_LEARNER_HZ_BUCKETS; i++)
+    {
+        total += histogram->demand[i];
+    }
+
+    if (!total)
+    {
+        return 0;
+    }
+
+    // Upper edge of the percentile bucket, rounding the demand up
+    std::uint64_t seen = 0;
+    unsigned int bucket = 0;
+    while (bucket < PROFILE_LEARNER_HZ_BUCKETS - 1)
+    {
+        seen += histogram->demand[bucket];
+        if (seen * 100 >= total * PROFILE_LEARNER_PERCENTILE)
+        {
+            break;
+        }
+        bucket++;
+    }
+
+    std::uint64_t demandHz = (std::uint64_t)(bucket + 1) * PROFILE_LEARNER_HZ_BUCKET_MHZ * 1000000;
+    std::uint64_t requiredHz = demandHz * 100 / headroomPercent;
+
+    for (std::uint32_t i = 0; i < freqCount; i++)
+    {
+        if (freqs[i] >= requiredHz)
+        {
+            return freqs[i] / 1000000;
+        }
+    }
+
+    return freqs[freqCount - 1] / 1000000;
+}
+
+void ProfileLearner::Forget(std::uint64_t tid)
+{
+    for (unsigned int i = 0; i < PROFILE_LEARNER_SLOTS; i++)
+    {
+        if (this->state.slots[i].tid == tid)
+        {
+            memset(&this->state.slots[i], 0, sizeof(this->state.slots[i]));
+            this->dirty = true;
+        }
+    }
+}
+
+bool ProfileLearner::IsDirty()
+{
+    return this->dirty;
+}
+
+bool ProfileLearner::Load(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    bool loaded = false;
+
+    if (file)
+    {
+        loaded = fread(&this->state, sizeof(this->state), 1, file) == 1 &&
+                 this->state.magic == PROFILE_LEARNER_MAGIC &&
+                 this->state.version == PROFILE_LEARNER_VERSION &&
+                 this->state.size == sizeof(this->state);
+        fclose(file);
+    }
+
+    if (!loaded)
+    {
+        this->Reset();
+    }
+
+    this->dirty = false;
+    return loaded;
+}
+
+bool ProfileLearner::Save(const char* path)
+{
+    char tmpPath[256];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE* file = fopen(tmpPath, "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool written = fwrite(&this->state, sizeof(this->state), 1, file) == 1;
+    written &= fclose(file) == 0;
+
+    if (written)
+    {
+        remove(path);
+        written = rename(tmpPath, path) == 0;
+    }
+
+    if (written)
+    {
+        this->dirty = false;
+    }
+
+    return written;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sysclk.h>
+
+#define PROFILE_LEARNER_MAGIC 0x4E524C50 // "PLRN"
+#define PROFILE_LEARNER_VERSION 1
+#define PROFILE_LEARNER_SLOTS 24
+#define PROFILE_LEARNER_LOAD_BUCKETS 10     // 10% each
+#define PROFILE_LEARNER_HZ_BUCKETS 64
+#define PROFILE_LEARNER_HZ_BUCKET_MHZ 50    // up to 3200 MHz
+#define PROFILE_LEARNER_MIN_SAMPLES 2000    // 10 minutes at the default polling interval
+#define PROFILE_LEARNER_PERCENTILE 95
+
+/*
+ * Per title clock profile learning.
+ *
+ * For every (application, profile) pair seen, keeps fixed-size histograms of
+ * each module's load, of the clock it ran at and of its demand, the clock
+ * that would have run it at 100% load (clock * load). A proposal picks, per
+ * module, the lowest available clock that keeps the 95th percentile demand
+ * under the headroom target.
+ *
+ * Counters are 16 bits and halve together when one saturates, so old play
+ * sessions fade out. Slots are recycled least recently used first.
+ * Not thread safe, callers serialize access.
+ */
+class ProfileLearner
+{
+  public:
+    ProfileLearner();
+
+    void Reset();
+
+    // hz and load (permille) are indexed by SysClkModule, modules missing from loadMask are skipped
+    void AddSample(std::uint64_t tid, SysClkProfile profile, const std::uint32_t* hz, const std::uint32_t* load, std::uint32_t loadMask);
+
+    std::uint32_t GetSampleCount(std::uint64_t tid, SysClkProfile profile, SysClkModule module);
+
+    // Proposed MHz out of a freq list (Hz, ascending), 0 if there isn't enough data
+    std::uint32_t ProposeMHz(std::uint64_t tid, SysClkProfile profile, SysClkModule module, std::uint32_t headroomPercent,
+                             const std::uint32_t* freqs, std::uint32_t freqCount);
+
+    void Forget(std::uint64_t tid);
+
+    bool IsDirty();
+    bool Load(const char* path);
+    bool Save(const char* path);
+
+  protected:
+    struct ModuleHistogram
+    {
+        std::uint32_t samples;
+        std::uint16_t load[PROFILE_LEARNER_LOAD_BUCKETS];
+        std::uint16_t clock[PROFILE_LEARNER_HZ_BUCKETS];
+        std::uint16_t demand[PROFILE_LEARNER_HZ_BUCKETS];
+    };
+
+    struct Slot
+    {
+        std::uint64_t tid;
+        std::uint32_t lastUsed;
+        std::uint32_t profile;
+        ModuleHistogram modules[SysClkModule_EnumMax];
+    };
+
+    struct State
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t size;
+        std::uint32_t sequence;
+        Slot slots[PROFILE_LEARNER_SLOTS];
+    };
+
+    Slot* FindSlot(std::uint64_t tid, SysClkProfile profile, bool create);
+    static void AddToHistogram(ModuleHistogram* histogram, std::uint32_t loadBucket, std::uint32_t clockBucket, std::uint32_t demandBucket);
+    static std::uint32_t HzBucket(std::uint64_t khz);
+
+    State state;
+    bool dirty;
+};
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "profile_table.h"
+#include <cstring>
+
+ProfileTable::ProfileTable()
+{
+    this->Clear();
+}
+
+void ProfileTable::Clear()
+{
+    this->rowCount = 0;
+}
+
+std::uint32_t ProfileTable::LowerBound(std::uint64_t tid)
+{
+    std::uint32_t lo = 0;
+    std::uint32_t hi = this->rowCount;
+    while (lo < hi)
+    {
+        std::uint32_t mid = (lo + hi) / 2;
+        if (this->rows[mid].tid < tid)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+ProfileTableRow* ProfileTable::FindRow(std::uint64_t tid)
+{
+    std::uint32_t i = this->LowerBound(tid);
+    if (i < this->rowCount && this->rows[i].tid == tid)
+    {
+        return &this->rows[i];
+    }
+
+    return nullptr;
+}
+
+std::uint32_t ProfileTable::Find(std::uint64_t tid, SysClkModule module, SysClkProfile profile)
+{
+    ProfileTableRow* row = this->FindRow(tid);
+    return row ? row->mhz[profile][module] : 0;
+}
+
+bool ProfileTable::Set(std::uint64_t tid, SysClkModule module, SysClkProfile profile, std::uint32_t mhz)
+{
+    std::uint32_t i = this->LowerBound(tid);
+    ProfileTableRow* row = (i < this->rowCount && this->rows[i].tid == tid) ? &this->rows[i] : nullptr;
+
+    if (!row)
+    {
+        if (!mhz)
+        {
+            return true;
+        }
+
+        if (this->rowCount >= PROFILE_TABLE_TITLES)
+        {
+            return false;
+        }
+
+        memmove(&this->rows[i + 1], &this->rows[i], (this->rowCount - i) * sizeof(ProfileTableRow));
+        this->rowCount++;
+        row = &this->rows[i];
+        memset(row, 0, sizeof(ProfileTableRow));
+        row->tid = tid;
+    }
+
+    std::uint32_t previous = row->mhz[profile][module];
+    row->mhz[profile][module] = mhz;
+    row->count += !previous && mhz;
+    row->count -= previous && !mhz;
+
+    if (!row->count)
+    {
+        this->rowCount--;
+        memmove(&this->rows[i], &this->rows[i + 1], (this->rowCount - i) * sizeof(ProfileTableRow));
+    }
+
+    return true;
+}
+
+std::uint8_t ProfileTable::GetCount(std::uint64_t tid)
+{
+    ProfileTableRow* row = this->FindRow(tid);
+    return row ? row->count : 0;
+}
+
+std::uint32_t ProfileTable::GetTitleCount()
+{
+    return this->rowCount;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sysclk.h>
+
+#define PROFILE_TABLE_TITLES 256
+
+typedef struct
+{
+    std::uint64_t tid;
+    std::uint8_t count;
+    std::uint32_t mhz[SysClkProfile_EnumMax][SysClkModule_EnumMax];
+} ProfileTableRow;
+
+/*
+ * Per title clock profiles, as read from config.ini.
+ *
+ * Rows live in a fixed array kept sorted by title id, so lookups are a
+ * binary search and neither a reload nor an overlay edit touches the heap.
+ * A title whose last clock is cleared gives its row back. Not thread safe,
+ * callers serialize access.
+ */
+class ProfileTable
+{
+  public:
+    ProfileTable();
+
+    void Clear();
+    // 0 when the title has no clock set for this profile and module
+    std::uint32_t Find(std::uint64_t tid, SysClkModule module, SysClkProfile profile);
+    // False when the table is full and the title isn't in it yet
+    bool Set(std::uint64_t tid, SysClkModule module, SysClkProfile profile, std::uint32_t mhz);
+    std::uint8_t GetCount(std::uint64_t tid);
+    std::uint32_t GetTitleCount();
+
+  protected:
+    // Index of the row, or where it would be inserted
+    std::uint32_t LowerBound(std::uint64_t tid);
+    ProfileTableRow* FindRow(std::uint64_t tid);
+
+    std::uint32_t rowCount;
+    ProfileTableRow rows[PROFILE_TABLE_TITLES];
+};
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifdef HOCCLK_TICK_STATS
+
+#include "tick_stats.h"
+#include <cstring>
+
+TickStats::TickStats()
+{
+    this->Reset();
+}
+
+void TickStats::Reset()
+{
+    memset(&this->stats, 0, sizeof(this->stats));
+    this->BeginTick();
+}
+
+void TickStats::BeginTick()
+{
+    memset(this->pendingNs, 0, sizeof(this->pendingNs));
+    this->pendingMask = 0;
+}
+
+void TickStats::AddPhase(HocClkTickPhase phase, std::uint64_t ns)
+{
+    this->pendingNs[phase] += ns;
+    this->pendingMask |= 1 << phase;
+}
+
+void TickStats::EndTick(std::uint64_t totalNs)
+{
+    this->AddPhase(HocClkTickPhase_Total, totalNs);
+
+    for (unsigned int phase = 0; phase < HocClkTickPhase_EnumMax; phase++)
+    {
+        if (this->pendingMask & (1 << phase))
+        {
+            Record(&this->stats.phases[phase], this->pendingNs[phase]);
+        }
+    }
+
+    this->BeginTick();
+}
+
+void TickStats::Record(HocClkTickPhaseStats* phase, std::uint64_t ns)
+{
+    std::uint64_t us = ns / 1000;
+    phase->lastUs = us < UINT32_MAX ? us : UINT32_MAX;
+    if (phase->lastUs > phase->maxUs)
+    {
+        phase->maxUs = phase->lastUs;
+    }
+
+    // Halve everything rather than wrap, old ticks fade out
+    std::uint32_t bucket = hocClkTickStatsBucket(phase->lastUs);
+    if (phase->histogram[bucket] == UINT32_MAX)
+    {
+        for (unsigned int i = 0; i < HOCCLK_TICK_STATS_BUCKETS; i++)
+        {
+            phase->histogram[i] /= 2;
+        }
+    }
+
+    phase->histogram[bucket]++;
+    if (phase->count < UINT32_MAX)
+    {
+        phase->count++;
+    }
+}
+
+void TickStats::GetStats(HocClkTickStats* out_stats)
+{
+    memcpy(out_stats, &this->stats, sizeof(this->stats));
+}
+
+#endif
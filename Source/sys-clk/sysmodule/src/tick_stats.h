@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <sysclk.h>
+
+/*
+ * Where the time of a ClockManager tick goes.
+ *
+ * Phases add their time to the running tick, EndTick then records each
+ * phase that ran into a log2 microsecond histogram along with its last
+ * and max values. A phase entered twice in one tick counts once, with the
+ * sum of both. Only built with HOCCLK_TICK_STATS (make TICK_STATS=1).
+ * Not thread safe, callers serialize access.
+ */
+class TickStats
+{
+  public:
+    TickStats();
+
+    void Reset();
+
+    void BeginTick();
+    void AddPhase(HocClkTickPhase phase, std::uint64_t ns);
+    void EndTick(std::uint64_t totalNs);
+
+    void GetStats(HocClkTickStats* out_stats);
+
+  protected:
+    static void Record(HocClkTickPhaseStats* phase, std::uint64_t ns);
+
+    HocClkTickStats stats;
+    std::uint64_t pendingNs[HocClkTickPhase_EnumMax];
+    std::uint32_t pendingMask;
+};
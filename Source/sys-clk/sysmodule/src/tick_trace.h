@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Souldbminer and Horizon OC Contributors
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <switch.h>
+#include <sysclk.h>
+
+/*
+ * One row of tick_trace.csv, what a ClockManager tick read from the board
+ * and what it left the clocks at.
+ *
+ * Inputs are read right before the tick. hzIn are the clocks it started
+ * from, so a difference with the previous row's hz is something else
+ * (the OS, a boost mode request) changing them in between. Recorded while
+ * trace.flag exists in the config directory, replayed on the host by
+ * host/sim/sim_replay.
+ */
+typedef struct
+{
+    std::uint64_t ns;
+    std::uint64_t applicationId;
+    SysClkSocType socType;
+    SysClkProfile profile;
+    AppletOperationMode operationMode;
+    PsmChargerType chargerType;
+    std::uint32_t apmConfiguration;
+    std::int32_t contractMw;    // see Board::GetChargeStatus
+    std::int32_t chargeMw;
+    std::uint32_t batteryPcm;
+    std::uint32_t hzIn[SysClkModule_EnumMax];
+    std::uint32_t temps[SysClkThermalSensor_EnumMax];
+    std::int32_t power[SysClkPowerSensor_EnumMax];
+    std::uint32_t emcLoad;
+    std::uint32_t emcCpuLoad;
+    std::uint32_t gpuLoad;      // raw, before ClockManager smooths it
+    std::uint64_t cpuIdleTicks[HOCCLK_CPU_CORE_COUNT];
+    std::uint32_t hz[SysClkModule_EnumMax];
+} TickTraceRow;